@@ -0,0 +1,306 @@
+﻿/*+===================================================================
+  File:      MAIN.CPP
+  Summary:   Offline asset baker. Imports models with Assimp and
+             writes the baked mesh files the game loads at startup,
+             and bakes their textures to DDS files with full mip
+             chains
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+
+#include "Model/Model.h"
+#include "Texture/Texture.h"
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: isImageFile
+  Summary:  Returns whether an argument is an image to bake as a
+            texture rather than a model to import
+  Args:     const std::filesystem::path& filePath
+              Path given to the baker
+  Returns:  BOOL
+              TRUE for the image formats WIC decodes
+-----------------------------------------------------------------F-F*/
+BOOL isImageFile(_In_ const std::filesystem::path& filePath)
+{
+    static const WCHAR* s_aszExtensions[] = { L".bmp", L".gif", L".jpeg", L".jpg", L".png", L".tif", L".tiff" };
+
+    for (const WCHAR* pszExtension : s_aszExtensions)
+    {
+        if (_wcsicmp(filePath.extension().c_str(), pszExtension) == 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: parseTextureFormat
+  Summary:  Returns the format of baked textures named by the
+            argument of -format
+  Args:     const WCHAR* pszName
+              rgba, bc1, bc3, bc4, bc5 or bc7
+            library::eDdsFormat& outFormat
+              Receives the format
+  Modifies: [outFormat].
+  Returns:  BOOL
+              TRUE if the name is a known format
+-----------------------------------------------------------------F-F*/
+BOOL parseTextureFormat(_In_z_ const WCHAR* pszName, _Out_ library::eDdsFormat& outFormat)
+{
+    static const struct
+    {
+        const WCHAR* pszName;
+        library::eDdsFormat format;
+    } s_aFormats[] =
+    {
+        { L"rgba", library::eDdsFormat::R8G8B8A8_UNORM },
+        { L"bc1", library::eDdsFormat::BC1_UNORM },
+        { L"bc3", library::eDdsFormat::BC3_UNORM },
+        { L"bc4", library::eDdsFormat::BC4_UNORM },
+        { L"bc5", library::eDdsFormat::BC5_UNORM },
+        { L"bc7", library::eDdsFormat::BC7_UNORM },
+    };
+
+    for (const auto& entry : s_aFormats)
+    {
+        if (_wcsicmp(pszName, entry.pszName) == 0)
+        {
+            outFormat = entry.format;
+            return TRUE;
+        }
+    }
+
+    outFormat = library::eDdsFormat::UNKNOWN;
+    return FALSE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: getTextureFormatName
+  Summary:  Returns the name of the format of baked textures
+  Args:     library::eDdsFormat format
+              Format of the texture
+  Returns:  const WCHAR*
+              Name printed after baking
+-----------------------------------------------------------------F-F*/
+const WCHAR* getTextureFormatName(_In_ library::eDdsFormat format)
+{
+    switch (format)
+    {
+    case library::eDdsFormat::BC1_UNORM:
+        return L"BC1";
+    case library::eDdsFormat::BC3_UNORM:
+        return L"BC3";
+    case library::eDdsFormat::BC4_UNORM:
+        return L"BC4";
+    case library::eDdsFormat::BC5_UNORM:
+        return L"BC5";
+    case library::eDdsFormat::BC7_UNORM:
+        return L"BC7";
+    default:
+        return L"RGBA8";
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: bakeTexture
+  Summary:  Bakes an image to a DDS file with its mip chain next to
+            itself, unless it was already baked in this run, as
+            materials of several models often share textures
+  Args:     const std::filesystem::path& filePath
+              Path to the image
+            const library::TextureBakeOptions& options
+              Filter, color space and format of the mips
+            std::set<std::filesystem::path>& bakedPaths
+              Images already baked
+  Returns:  BOOL
+              TRUE if the image was baked
+-----------------------------------------------------------------F-F*/
+BOOL bakeTexture(
+    _In_ const std::filesystem::path& filePath,
+    _In_ const library::TextureBakeOptions& options,
+    _Inout_ std::set<std::filesystem::path>& bakedPaths
+)
+{
+    std::error_code error;
+    std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, error);
+    if (error)
+    {
+        canonicalPath = filePath.lexically_normal();
+    }
+
+    if (!bakedPaths.insert(canonicalPath).second)
+    {
+        return TRUE;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    library::Texture texture(filePath);
+    HRESULT hr = texture.Bake(options);
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (FAILED(hr))
+    {
+        wprintf(L"Failed to bake %s (0x%08lX)\n", filePath.c_str(), static_cast<ULONG>(hr));
+        return FALSE;
+    }
+
+    wprintf(L"Baked %s -> %s in %.1f ms (%s mips, %s, %s)\n", filePath.c_str(),
+        library::DdsFile::GetBakedPath(filePath).c_str(), elapsed.count(),
+        options.filter == library::eMipFilter::KAISER ? L"Kaiser" : L"box", options.bSrgb ? L"sRGB" : L"linear",
+        getTextureFormatName(options.format));
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+  Summary:  Entry point to the baker. Every argument is a model file
+            that is baked next to itself with the ".mesh" extension
+            appended, with its textures baked with the ".dds"
+            extension appended, or an image baked as a color texture.
+            -nooverdraw skips the overdraw pass and -box filters mips
+            with a box instead of a Kaiser filter, for the files after
+            them. Color textures are encoded to BC7 and specular maps
+            to BC1, unless -format <rgba|bc1|bc3|bc4|bc5|bc7> sets the
+            format of every texture after it
+  Args:     INT argc
+              Number of arguments
+            WCHAR* argv[]
+              Program name followed by the model paths
+  Returns:  INT
+              0 if every model was baked, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+    if (argc < 2)
+    {
+        wprintf(L"Usage: AssetBaker [-nooverdraw] [-box] [-format <rgba|bc1|bc3|bc4|bc5|bc7>] <model or image file> "
+            L"[<model or image file> ...]\n");
+        return 1;
+    }
+
+    INT iResult = 0;
+    BOOL bOptimizeOverdraw = TRUE;
+    library::eMipFilter mipFilter = library::eMipFilter::KAISER;
+    library::eDdsFormat colorFormat = library::eDdsFormat::BC7_UNORM;
+    library::eDdsFormat specularFormat = library::eDdsFormat::BC1_UNORM;
+    library::eDdsFormat normalFormat = library::eDdsFormat::BC5_UNORM;
+    std::set<std::filesystem::path> bakedTexturePaths;
+
+    for (INT i = 1; i < argc; ++i)
+    {
+        if (wcscmp(argv[i], L"-nooverdraw") == 0)
+        {
+            bOptimizeOverdraw = FALSE;
+            continue;
+        }
+
+        if (wcscmp(argv[i], L"-box") == 0)
+        {
+            mipFilter = library::eMipFilter::BOX;
+            continue;
+        }
+
+        if (wcscmp(argv[i], L"-format") == 0)
+        {
+            if (i + 1 >= argc || !parseTextureFormat(argv[i + 1], colorFormat))
+            {
+                wprintf(L"Unknown texture format %s\n", i + 1 < argc ? argv[i + 1] : L"");
+                return 1;
+            }
+
+            specularFormat = colorFormat;
+            normalFormat = colorFormat;
+            ++i;
+            continue;
+        }
+
+        std::filesystem::path filePath(argv[i]);
+
+        if (isImageFile(filePath))
+        {
+            if (!bakeTexture(filePath, library::TextureBakeOptions{ .filter = mipFilter, .bSrgb = TRUE, .format = colorFormat },
+                bakedTexturePaths))
+            {
+                iResult = 1;
+            }
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        library::Model model(filePath);
+        library::VertexCacheStats statsBefore = {};
+        library::VertexCacheStats statsAfter = {};
+        HRESULT hr = model.Bake(bOptimizeOverdraw, &statsBefore, &statsAfter);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (FAILED(hr))
+        {
+            wprintf(L"Failed to bake %s (0x%08lX)\n", filePath.c_str(), static_cast<ULONG>(hr));
+            iResult = 1;
+            continue;
+        }
+
+        wprintf(L"Baked %s -> %s in %.1f ms\n", filePath.c_str(),
+            library::MeshFile::GetBakedPath(filePath).c_str(), elapsed.count());
+        wprintf(L"  %u triangles, %u vertices, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+            statsAfter.uNumTriangles, statsAfter.uNumVertices,
+            library::MeshOptimizer::GetAcmr(statsBefore), library::MeshOptimizer::GetAcmr(statsAfter),
+            library::MeshOptimizer::GetAtvr(statsBefore), library::MeshOptimizer::GetAtvr(statsAfter));
+
+        // Textures are listed by the baked file, relative to the model.
+        // Diffuse maps hold colors, specular and normal maps data. Normal
+        // maps keep X and Y only, which BC5 stores in two channels
+        library::MeshFile meshFile;
+        hr = meshFile.Open(library::MeshFile::GetBakedPath(filePath));
+        if (FAILED(hr))
+        {
+            wprintf(L"Failed to open %s (0x%08lX)\n", library::MeshFile::GetBakedPath(filePath).c_str(), static_cast<ULONG>(hr));
+            iResult = 1;
+            continue;
+        }
+
+        std::filesystem::path parentDirectory = filePath.parent_path();
+
+        for (UINT j = 0u; j < meshFile.GetHeader().uNumMaterials; ++j)
+        {
+            const library::MeshFileMaterial& material = meshFile.GetMaterials()[j];
+
+            if (material.szDiffuse[0] != '\0'
+                && !bakeTexture(parentDirectory / material.szDiffuse,
+                    library::TextureBakeOptions{ .filter = mipFilter, .bSrgb = TRUE, .format = colorFormat }, bakedTexturePaths))
+            {
+                iResult = 1;
+            }
+
+            if (material.szSpecular[0] != '\0'
+                && !bakeTexture(parentDirectory / material.szSpecular,
+                    library::TextureBakeOptions{ .filter = mipFilter, .bSrgb = FALSE, .format = specularFormat },
+                    bakedTexturePaths))
+            {
+                iResult = 1;
+            }
+
+            if (material.szNormal[0] != '\0'
+                && !bakeTexture(parentDirectory / material.szNormal,
+                    library::TextureBakeOptions{ .filter = mipFilter, .bSrgb = FALSE, .format = normalFormat },
+                    bakedTexturePaths))
+            {
+                iResult = 1;
+            }
+        }
+    }
+
+    return iResult;
+}
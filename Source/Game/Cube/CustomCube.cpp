@@ -1,5 +1,17 @@
 #include "CustomCube.h"
 
+void CustomCube::InitializeTransform(_In_ library::TransformHierarchy& transforms) {
+
+	// The orbit rotates around the x-axis, the cube spins at (0, 3, 0) under it
+	m_uOrbitNode = transforms.AddNode();
+	UINT uNode = transforms.AddNode(m_uOrbitNode);
+
+	transforms.SetTranslation(uNode, XMFLOAT3(0.0f, 3.0f, 0.0f));
+	transforms.SetScale(uNode, XMFLOAT3(0.5f, 0.5f, 0.5f));
+
+	AttachTransform(&transforms, uNode);
+}
+
 void CustomCube::Update(_In_ FLOAT deltaTime) {
 
 	angle += deltaTime;
@@ -8,15 +20,10 @@ void CustomCube::Update(_In_ FLOAT deltaTime) {
 		angle -= 360;
 	}
 
-	XMMATRIX mSpin = XMMatrixIdentity();
-	XMMATRIX mTranslation = XMMatrixIdentity();
-	XMMATRIX mScale = XMMatrixIdentity();
-	XMMATRIX mOrbit = XMMatrixIdentity();
-
-	mTranslation = XMMatrixTranslation(0.0f, 3.0f, 0.0f);
-	mSpin *= XMMatrixRotationY(-angle * 0.5f);
-	mScale = XMMatrixScaling(0.5f, 0.5f, 0.5f);
-	mOrbit = XMMatrixRotationX(angle * 3.0f);
+	if (!m_pTransforms) {
+		return;
+	}
 
-	m_world = mScale * mSpin * mTranslation * mOrbit;
+	m_pTransforms->SetRotation(m_uTransformNode, XMQuaternionRotationRollPitchYaw(0.0f, -angle * 0.5f, 0.0f));
+	m_pTransforms->SetRotation(m_uOrbitNode, XMQuaternionRotationRollPitchYaw(angle * 3.0f, 0.0f, 0.0f));
 }
\ No newline at end of file
@@ -1,5 +1,17 @@
 #include "OrbitCube.h"
 
+void OrbitCube::InitializeTransform(_In_ library::TransformHierarchy& transforms) {
+
+	// The orbit rotates around the origin, the cube spins at (-4, 0, 0) under it
+	m_uOrbitNode = transforms.AddNode();
+	UINT uNode = transforms.AddNode(m_uOrbitNode);
+
+	transforms.SetTranslation(uNode, XMFLOAT3(-4.0f, 0.0f, 0.0f));
+	transforms.SetScale(uNode, XMFLOAT3(0.3f, 0.3f, 0.3f));
+
+	AttachTransform(&transforms, uNode);
+}
+
 void OrbitCube::Update(_In_ FLOAT deltaTime) {
 
 	angle += deltaTime;
@@ -8,15 +20,10 @@ void OrbitCube::Update(_In_ FLOAT deltaTime) {
 		angle -= 360;
 	}
 
-	XMMATRIX mSpin = XMMatrixIdentity();
-	XMMATRIX mTranslate = XMMatrixIdentity();
-	XMMATRIX mOrbit = XMMatrixIdentity();
-	XMMATRIX mScale = XMMatrixIdentity();
-
-	mSpin *= XMMatrixRotationZ(-angle);
-	mTranslate = XMMatrixTranslation(-4.0f, 0.0f, 0.0f);
-	mOrbit *= XMMatrixRotationY(-angle * 2.0f);
-	mScale = XMMatrixScaling(0.3f, 0.3f, 0.3f);
+	if (!m_pTransforms) {
+		return;
+	}
 
-	m_world = mScale * mSpin * mTranslate * mOrbit;
+	m_pTransforms->SetRotation(m_uTransformNode, XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, -angle));
+	m_pTransforms->SetRotation(m_uOrbitNode, XMQuaternionRotationRollPitchYaw(0.0f, -angle * 2.0f, 0.0f));
 }
\ No newline at end of file
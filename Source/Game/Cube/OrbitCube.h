@@ -14,7 +14,9 @@ public:
 	OrbitCube& operator=(OrbitCube&& other) = delete;
 	~OrbitCube() = default;
 
+	virtual void InitializeTransform(_In_ library::TransformHierarchy& transforms) override;
 	virtual void Update(_In_ FLOAT deltaTime) override;
 private:
 	FLOAT angle = 0;
+	UINT m_uOrbitNode = library::TransformHierarchy::INVALID_NODE;
 };
\ No newline at end of file
@@ -2,19 +2,33 @@
 
 RotatingCube::RotatingCube(const XMFLOAT4& outputColor)
     : BaseCube(outputColor)
+    , m_t(0.0f)
+    , m_uOrbitNode(library::TransformHierarchy::INVALID_NODE)
 {
 }
 
+void RotatingCube::InitializeTransform(_In_ library::TransformHierarchy& transforms)
+{
+    // The orbit rotates around the origin, the cube spins at (0, 0, -5) under it
+    m_uOrbitNode = transforms.AddNode();
+    UINT uNode = transforms.AddNode(m_uOrbitNode);
+
+    transforms.SetTranslation(uNode, XMFLOAT3(0.0f, 0.0f, -5.0f));
+    transforms.SetScale(uNode, XMFLOAT3(0.3f, 0.3f, 0.3f));
+
+    AttachTransform(&transforms, uNode);
+}
+
 void RotatingCube::Update(_In_ FLOAT deltaTime)
 {
     // Rotate cube around the origin
-    static FLOAT t = 0.0f;
-    t += deltaTime;
+    m_t += deltaTime;
 
-    XMMATRIX mSpin = XMMatrixRotationZ(-t);
-    XMMATRIX mOrbit = XMMatrixRotationY(-t * 2.0f);
-    XMMATRIX mTranslate = XMMatrixTranslation(0.0f, 0.0f, -5.0f);
-    XMMATRIX mScale = XMMatrixScaling(0.3f, 0.3f, 0.3f);
+    if (!m_pTransforms)
+    {
+        return;
+    }
 
-    m_world = mScale * mSpin * mTranslate * mOrbit;
+    m_pTransforms->SetRotation(m_uTransformNode, XMQuaternionRotationRollPitchYaw(0.0f, 0.0f, -m_t));
+    m_pTransforms->SetRotation(m_uOrbitNode, XMQuaternionRotationRollPitchYaw(0.0f, -m_t * 2.0f, 0.0f));
 }
\ No newline at end of file
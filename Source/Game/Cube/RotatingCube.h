@@ -23,5 +23,10 @@ public:
     RotatingCube& operator=(RotatingCube&& other) = delete;
     ~RotatingCube() = default;
 
+    virtual void InitializeTransform(_In_ library::TransformHierarchy& transforms) override;
     virtual void Update(_In_ FLOAT deltaTime) override;
+
+private:
+    FLOAT m_t;
+    UINT m_uOrbitNode;
 };
\ No newline at end of file
@@ -47,14 +47,17 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 
     std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Assignment 2: Voxel Map");
 
-    // Phong
-    std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
+    // Phong over the quantized 16-byte vertices. Nothing is drawn
+    // instanced yet, so the vertex shader has a single variant; the pixel
+    // shader has one per light count and material
+    std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhongCompact", "vs_5_0",
+        library::eVertexFormat::COMPACT);
     if (FAILED(game->GetRenderer()->AddVertexShader(L"PhongShader", phongVertexShader)))
     {
         return 0;
     }
-    // Light Cube
-    std::shared_ptr<library::VertexShader> lightVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
+    // Light Cube, the unlit and untextured Phong variant
+    std::shared_ptr<library::VertexShader> lightVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
     if (FAILED(game->GetRenderer()->AddVertexShader(L"LightShader", lightVertexShader)))
     {
         return 0;
@@ -69,13 +72,14 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     */
 
     // Phong
-    std::shared_ptr<library::PixelShader> phongPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
+    std::shared_ptr<library::PixelShader> phongPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0",
+        library::Shader::FEATURE_LIGHTS | library::Shader::FEATURE_TEXTURING | library::Shader::FEATURE_NORMAL_MAPPING);
     if (FAILED(game->GetRenderer()->AddPixelShader(L"PhongShader", phongPixelShader)))
     {
         return 0;
     }
     // Light Cube
-    std::shared_ptr<library::PixelShader> lightPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCube", "ps_5_0");
+    std::shared_ptr<library::PixelShader> lightPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSPhong", "ps_5_0");
     if (FAILED(game->GetRenderer()->AddPixelShader(L"LightShader", lightPixelShader)))
     {
         return 0;
@@ -89,7 +93,11 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     }
     */
 
+    // The suit is the largest object in the scene, so it is rasterized
+    // as an occluder and the objects behind it are culled
     std::shared_ptr<library::Model> NanoSuitModel = std::make_shared<library::Model>(L"nanosuit/nanosuit.obj");
+    NanoSuitModel->SetOccluder(TRUE);
+    NanoSuitModel->SetVertexFormat(library::eVertexFormat::COMPACT);
     if (FAILED(game->GetRenderer()->AddRenderable(L"NanoSuit", NanoSuitModel)))
     {
         return 0;
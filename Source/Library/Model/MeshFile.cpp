@@ -0,0 +1,411 @@
+#include "Model/MeshFile.h"
+
+#include <fstream>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::MeshFile
+      Summary:  Constructor
+      Modifies: [m_hFile, m_hMapping, m_pData, m_pHeader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshFile::MeshFile() :
+        m_hFile(INVALID_HANDLE_VALUE),
+        m_hMapping(nullptr),
+        m_pData(nullptr),
+        m_pHeader(nullptr)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::~MeshFile
+      Summary:  Destructor. Unmaps the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    MeshFile::~MeshFile()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::Open
+      Summary:  Maps a baked mesh file and checks that the header and
+                every table fit in the file, and that every index of a
+                mesh or LOD points at a vertex of that mesh
+      Args:     const std::filesystem::path& filePath
+                  Path to the baked mesh file
+      Modifies: [m_hFile, m_hMapping, m_pData, m_pHeader].
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if an index is out of range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MeshFile::Open(_In_ const std::filesystem::path& filePath)
+    {
+        Close();
+
+        m_hFile = CreateFile(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(MeshFileHeader))
+            || fileSize.QuadPart > static_cast<LONGLONG>(UINT_MAX))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        m_hMapping = CreateFileMapping(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pData = static_cast<const BYTE*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pData)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pHeader = reinterpret_cast<const MeshFileHeader*>(m_pData);
+
+        if (m_pHeader->uMagic != MAGIC || m_pHeader->uVersion != VERSION)
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        UINT64 uFileSize = static_cast<UINT64>(fileSize.QuadPart);
+
+        auto fits = [uFileSize](UINT uOffset, UINT uCount, UINT64 uElementSize)
+        {
+            return uOffset % 16u == 0u && uOffset + static_cast<UINT64>(uCount) * uElementSize <= uFileSize;
+        };
+
+        if (!fits(m_pHeader->uVertexOffset, m_pHeader->uNumVertices, sizeof(SimpleVertex))
+            || !fits(m_pHeader->uIndexOffset, m_pHeader->uNumIndices, sizeof(UINT))
+            || !fits(m_pHeader->uMeshOffset, m_pHeader->uNumMeshes, sizeof(MeshFileMesh))
+            || !fits(m_pHeader->uMaterialOffset, m_pHeader->uNumMaterials, sizeof(MeshFileMaterial))
+            || !fits(m_pHeader->uMeshletOffset, m_pHeader->uNumMeshlets, sizeof(Meshlet)))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        // Indices are relative to the first vertex of their mesh, and
+        // are narrowed to 16 bits when a mesh has few enough vertices
+        auto indicesFit = [this](UINT uBaseIndex, UINT uNumIndices, UINT uNumVertices)
+        {
+            const UINT* pIndices = GetIndices() + uBaseIndex;
+
+            for (UINT k = 0u; k < uNumIndices; ++k)
+            {
+                if (pIndices[k] >= uNumVertices)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        // Reject meshes that would read past the tables and paths that
+        // are not terminated
+        for (UINT i = 0u; i < m_pHeader->uNumMeshes; ++i)
+        {
+            const MeshFileMesh& mesh = GetMeshes()[i];
+
+            if (static_cast<UINT64>(mesh.uBaseVertex) + mesh.uNumVertices > m_pHeader->uNumVertices
+                || static_cast<UINT64>(mesh.uBaseIndex) + mesh.uNumIndices > m_pHeader->uNumIndices
+                || mesh.uNumLods > MAX_MESH_LODS
+                || static_cast<UINT64>(mesh.uFirstMeshlet) + mesh.uNumMeshlets > m_pHeader->uNumMeshlets)
+            {
+                Close();
+                return E_FAIL;
+            }
+
+            if (!indicesFit(mesh.uBaseIndex, mesh.uNumIndices, mesh.uNumVertices))
+            {
+                Close();
+                return E_INVALIDARG;
+            }
+
+            for (UINT j = 0u; j < mesh.uNumLods; ++j)
+            {
+                if (static_cast<UINT64>(mesh.aLods[j].uBaseIndex) + mesh.aLods[j].uNumIndices > m_pHeader->uNumIndices)
+                {
+                    Close();
+                    return E_FAIL;
+                }
+
+                if (!indicesFit(mesh.aLods[j].uBaseIndex, mesh.aLods[j].uNumIndices, mesh.uNumVertices))
+                {
+                    Close();
+                    return E_INVALIDARG;
+                }
+            }
+
+            for (UINT j = 0u; j < mesh.uNumMeshlets; ++j)
+            {
+                const Meshlet& meshlet = GetMeshlets()[mesh.uFirstMeshlet + j];
+
+                if (static_cast<UINT64>(meshlet.uFirstIndex) + meshlet.uNumIndices > mesh.uNumIndices)
+                {
+                    Close();
+                    return E_FAIL;
+                }
+            }
+        }
+
+        for (UINT i = 0u; i < m_pHeader->uNumMaterials; ++i)
+        {
+            const MeshFileMaterial& material = GetMaterials()[i];
+
+            if (material.szDiffuse[MAX_PATH - 1] != '\0' || material.szSpecular[MAX_PATH - 1] != '\0'
+                || material.szNormal[MAX_PATH - 1] != '\0')
+            {
+                Close();
+                return E_FAIL;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::Close
+      Summary:  Unmaps the file and closes its handles
+      Modifies: [m_hFile, m_hMapping, m_pData, m_pHeader].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshFile::Close()
+    {
+        if (m_pData)
+        {
+            UnmapViewOfFile(m_pData);
+            m_pData = nullptr;
+        }
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+
+        m_pHeader = nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetHeader
+      Summary:  Returns the header of the opened file
+      Returns:  const MeshFileHeader&
+                  Header
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const MeshFileHeader& MeshFile::GetHeader() const
+    {
+        assert(m_pHeader);
+        return *m_pHeader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetVertices
+      Summary:  Returns the vertex table
+      Returns:  const SimpleVertex*
+                  Vertices of every mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SimpleVertex* MeshFile::GetVertices() const
+    {
+        return reinterpret_cast<const SimpleVertex*>(m_pData + GetHeader().uVertexOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetIndices
+      Summary:  Returns the index table
+      Returns:  const UINT*
+                  Indices of every mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const UINT* MeshFile::GetIndices() const
+    {
+        return reinterpret_cast<const UINT*>(m_pData + GetHeader().uIndexOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetMeshes
+      Summary:  Returns the mesh table
+      Returns:  const MeshFileMesh*
+                  Meshes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const MeshFileMesh* MeshFile::GetMeshes() const
+    {
+        return reinterpret_cast<const MeshFileMesh*>(m_pData + GetHeader().uMeshOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetMaterials
+      Summary:  Returns the material table
+      Returns:  const MeshFileMaterial*
+                  Materials
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const MeshFileMaterial* MeshFile::GetMaterials() const
+    {
+        return reinterpret_cast<const MeshFileMaterial*>(m_pData + GetHeader().uMaterialOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetMeshlets
+      Summary:  Returns the meshlet table
+      Returns:  const Meshlet*
+                  Meshlets of every mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Meshlet* MeshFile::GetMeshlets() const
+    {
+        return reinterpret_cast<const Meshlet*>(m_pData + GetHeader().uMeshletOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::Write
+      Summary:  Writes a baked mesh file: the header followed by the
+                vertex, index, mesh, material and meshlet tables
+      Args:     const std::filesystem::path& filePath
+                  Path to write to
+                const SimpleVertex* pVertices
+                  Vertices of every mesh
+                UINT uNumVertices
+                  Number of vertices
+                const UINT* pIndices
+                  Indices of every mesh
+                UINT uNumIndices
+                  Number of indices
+                const MeshFileMesh* pMeshes
+                  Meshes
+                UINT uNumMeshes
+                  Number of meshes
+                const MeshFileMaterial* pMaterials
+                  Materials
+                UINT uNumMaterials
+                  Number of materials
+                const Meshlet* pMeshlets
+                  Meshlets of every mesh
+                UINT uNumMeshlets
+                  Number of meshlets
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT MeshFile::Write(
+        _In_ const std::filesystem::path& filePath,
+        _In_reads_(uNumVertices) const SimpleVertex* pVertices,
+        _In_ UINT uNumVertices,
+        _In_reads_(uNumIndices) const UINT* pIndices,
+        _In_ UINT uNumIndices,
+        _In_reads_(uNumMeshes) const MeshFileMesh* pMeshes,
+        _In_ UINT uNumMeshes,
+        _In_reads_(uNumMaterials) const MeshFileMaterial* pMaterials,
+        _In_ UINT uNumMaterials,
+        _In_reads_(uNumMeshlets) const Meshlet* pMeshlets,
+        _In_ UINT uNumMeshlets
+    )
+    {
+        auto align = [](UINT64 uOffset) { return (uOffset + 15ull) & ~15ull; };
+
+        UINT64 uVertexOffset = align(sizeof(MeshFileHeader));
+        UINT64 uIndexOffset = align(uVertexOffset + sizeof(SimpleVertex) * static_cast<UINT64>(uNumVertices));
+        UINT64 uMeshOffset = align(uIndexOffset + sizeof(UINT) * static_cast<UINT64>(uNumIndices));
+        UINT64 uMaterialOffset = align(uMeshOffset + sizeof(MeshFileMesh) * static_cast<UINT64>(uNumMeshes));
+        UINT64 uMeshletOffset = align(uMaterialOffset + sizeof(MeshFileMaterial) * static_cast<UINT64>(uNumMaterials));
+        UINT64 uFileSize = uMeshletOffset + sizeof(Meshlet) * static_cast<UINT64>(uNumMeshlets);
+
+        if (uFileSize > UINT_MAX)
+        {
+            return E_INVALIDARG;
+        }
+
+        std::vector<BYTE> aData(static_cast<size_t>(uFileSize));
+
+        MeshFileHeader header = {
+            .uMagic = MAGIC,
+            .uVersion = VERSION,
+            .uNumVertices = uNumVertices,
+            .uNumIndices = uNumIndices,
+            .uNumMeshes = uNumMeshes,
+            .uNumMaterials = uNumMaterials,
+            .uVertexOffset = static_cast<UINT>(uVertexOffset),
+            .uIndexOffset = static_cast<UINT>(uIndexOffset),
+            .uMeshOffset = static_cast<UINT>(uMeshOffset),
+            .uMaterialOffset = static_cast<UINT>(uMaterialOffset),
+            .uNumMeshlets = uNumMeshlets,
+            .uMeshletOffset = static_cast<UINT>(uMeshletOffset)
+        };
+
+        memcpy(aData.data(), &header, sizeof(header));
+        memcpy(aData.data() + uVertexOffset, pVertices, sizeof(SimpleVertex) * uNumVertices);
+        memcpy(aData.data() + uIndexOffset, pIndices, sizeof(UINT) * uNumIndices);
+        memcpy(aData.data() + uMeshOffset, pMeshes, sizeof(MeshFileMesh) * uNumMeshes);
+        memcpy(aData.data() + uMaterialOffset, pMaterials, sizeof(MeshFileMaterial) * uNumMaterials);
+        memcpy(aData.data() + uMeshletOffset, pMeshlets, sizeof(Meshlet) * uNumMeshlets);
+
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return E_FAIL;
+        }
+
+        file.write(reinterpret_cast<const char*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+
+        return file ? S_OK : E_FAIL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::GetBakedPath
+      Summary:  Returns the path of the baked file of a source model,
+                which is the source path followed by ".mesh"
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source model
+      Returns:  std::filesystem::path
+                  Path to the baked mesh file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path MeshFile::GetBakedPath(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::filesystem::path bakedPath = sourcePath;
+        bakedPath += L".mesh";
+
+        return bakedPath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshFile::IsUpToDate
+      Summary:  Returns whether the baked file of a source model exists
+                and is not older than the source. A baked file without
+                its source is up to date, so only baked files can ship
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source model
+      Returns:  BOOL
+                  Whether the baked file can be loaded instead
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL MeshFile::IsUpToDate(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type bakedTime = std::filesystem::last_write_time(GetBakedPath(sourcePath), error);
+        if (error)
+        {
+            return FALSE;
+        }
+
+        std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, error);
+        if (error)
+        {
+            return TRUE;
+        }
+
+        return bakedTime >= sourceTime ? TRUE : FALSE;
+    }
+}
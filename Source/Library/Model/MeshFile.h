@@ -0,0 +1,161 @@
+/*+===================================================================
+  File:      MESHFILE.H
+  Summary:   MeshFile header file contains declarations of MeshFile
+             class used to read and write baked models that load
+             without Assimp.
+  Classes: MeshFile
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Model/MeshletBuilder.h"
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshFileHeader
+      Summary:  Header at the start of a baked mesh file. Offsets are in
+                bytes from the start of the file and aligned to 16 bytes
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshFileHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        UINT uNumVertices;
+        UINT uNumIndices;
+        UINT uNumMeshes;
+        UINT uNumMaterials;
+        UINT uVertexOffset;
+        UINT uIndexOffset;
+        UINT uMeshOffset;
+        UINT uMaterialOffset;
+        UINT uNumMeshlets;
+        UINT uMeshletOffset;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshFileLod
+      Summary:  One simplified level of a mesh. Its indices are in the
+                index table and use the vertices of the mesh
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshFileLod
+    {
+        UINT uNumIndices;
+        UINT uBaseIndex;
+        FLOAT fError;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshFileMesh
+      Summary:  One mesh of the model, its levels of detail and its
+                range of the meshlet table. Indices are 32-bit and
+                relative to the base vertex
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshFileMesh
+    {
+        UINT uNumIndices;
+        UINT uBaseVertex;
+        UINT uBaseIndex;
+        UINT uMaterialIndex;
+        UINT uNumVertices;
+        UINT uNumLods;
+        MeshFileLod aLods[MAX_MESH_LODS];
+        UINT uFirstMeshlet;
+        UINT uNumMeshlets;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshFileMaterial
+      Summary:  Texture paths of one material, relative to the model's
+                directory. An empty string means no texture
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshFileMaterial
+    {
+        CHAR szDiffuse[MAX_PATH];
+        CHAR szSpecular[MAX_PATH];
+        CHAR szNormal[MAX_PATH];
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshFile
+      Summary:  Read-only view of a baked mesh file. The file is mapped
+                into memory and the vertex, index, mesh, material and
+                meshlet tables are used in place
+      Methods:  Open
+                  Maps a baked mesh file and validates its header
+                Close
+                  Unmaps the file
+                GetHeader
+                  Returns the header
+                GetVertices
+                  Returns the vertex table
+                GetIndices
+                  Returns the index table
+                GetMeshes
+                  Returns the mesh table
+                GetMaterials
+                  Returns the material table
+                GetMeshlets
+                  Returns the meshlet table
+                Write
+                  Writes a baked mesh file
+                GetBakedPath
+                  Returns the baked file path of a source model
+                IsUpToDate
+                  Returns whether the baked file of a source model
+                  exists and is not older than the source
+                MeshFile
+                  Constructor.
+                ~MeshFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshFile final
+    {
+    public:
+        static constexpr const UINT MAGIC = 0x4853454Du; // "MESH"
+        static constexpr const UINT VERSION = 4u;
+
+    public:
+        MeshFile();
+        MeshFile(const MeshFile& other) = delete;
+        MeshFile(MeshFile&& other) = delete;
+        MeshFile& operator=(const MeshFile& other) = delete;
+        MeshFile& operator=(MeshFile&& other) = delete;
+        ~MeshFile();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        void Close();
+
+        const MeshFileHeader& GetHeader() const;
+        const SimpleVertex* GetVertices() const;
+        const UINT* GetIndices() const;
+        const MeshFileMesh* GetMeshes() const;
+        const MeshFileMaterial* GetMaterials() const;
+        const Meshlet* GetMeshlets() const;
+
+        static HRESULT Write(
+            _In_ const std::filesystem::path& filePath,
+            _In_reads_(uNumVertices) const SimpleVertex* pVertices,
+            _In_ UINT uNumVertices,
+            _In_reads_(uNumIndices) const UINT* pIndices,
+            _In_ UINT uNumIndices,
+            _In_reads_(uNumMeshes) const MeshFileMesh* pMeshes,
+            _In_ UINT uNumMeshes,
+            _In_reads_(uNumMaterials) const MeshFileMaterial* pMaterials,
+            _In_ UINT uNumMaterials,
+            _In_reads_(uNumMeshlets) const Meshlet* pMeshlets,
+            _In_ UINT uNumMeshlets
+        );
+        static std::filesystem::path GetBakedPath(_In_ const std::filesystem::path& sourcePath);
+        static BOOL IsUpToDate(_In_ const std::filesystem::path& sourcePath);
+
+    private:
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+        const BYTE* m_pData;
+        const MeshFileHeader* m_pHeader;
+    };
+}
@@ -0,0 +1,464 @@
+#include "Model/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FifoCache
+          Summary:  Post-transform vertex cache of fixed size with first in
+                    first out replacement, as on the hardware Tipsify and
+                    ACMR are defined for. A vertex is cached if it missed
+                    within the last uCacheSize misses
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FifoCache
+        {
+            FifoCache(std::uint32_t uNumVertices, std::uint32_t uCacheSize) :
+                aTimestamps(uNumVertices, 0u),
+                uTime(uCacheSize),
+                uSize(uCacheSize)
+            {
+            }
+
+            bool Access(std::uint32_t uVertex)
+            {
+                if (uTime - aTimestamps[uVertex] < uSize)
+                {
+                    return true;
+                }
+
+                aTimestamps[uVertex] = ++uTime;
+                return false;
+            }
+
+            std::vector<std::uint32_t> aTimestamps;
+            std::uint32_t uTime;
+            std::uint32_t uSize;
+        };
+
+        const float* position(const void* pPositions, std::uint32_t uStride, std::uint32_t uVertex)
+        {
+            return reinterpret_cast<const float*>(static_cast<const unsigned char*>(pPositions)
+                + static_cast<std::size_t>(uVertex) * uStride);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeVertexCache
+      Summary:  Reorders the triangles with Tipsify (Sander, Nehab and
+                Barczak 2007). Triangles are fanned around one vertex
+                at a time, and the next fanning vertex is the neighbour
+                that is still in the cache and will not fall out of it
+                while its remaining triangles are emitted. Runs in time
+                linear in the number of indices
+      Args:     std::uint32_t* pIndices
+                  Triangle list to reorder in place
+                std::uint32_t uNumIndices
+                  Number of indices, a multiple of 3
+                std::uint32_t uNumVertices
+                  Number of vertices the indices refer to
+                std::uint32_t uCacheSize
+                  Number of entries of the target vertex cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeVertexCache(std::uint32_t* pIndices, std::uint32_t uNumIndices, std::uint32_t uNumVertices,
+        std::uint32_t uCacheSize)
+    {
+        std::uint32_t uNumTriangles = uNumIndices / 3u;
+
+        if (uNumTriangles == 0u || uNumVertices == 0u)
+        {
+            return;
+        }
+
+        // Triangles around each vertex, and how many are not emitted yet
+        std::vector<std::uint32_t> aLiveTriangles(uNumVertices, 0u);
+        for (std::uint32_t i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            ++aLiveTriangles[pIndices[i]];
+        }
+
+        std::vector<std::uint32_t> aAdjacencyOffsets(uNumVertices + 1u, 0u);
+        for (std::uint32_t v = 0u; v < uNumVertices; ++v)
+        {
+            aAdjacencyOffsets[v + 1u] = aAdjacencyOffsets[v] + aLiveTriangles[v];
+        }
+
+        std::vector<std::uint32_t> aAdjacency(uNumTriangles * 3u);
+        std::vector<std::uint32_t> aFill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+        for (std::uint32_t i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            aAdjacency[aFill[pIndices[i]]++] = i / 3u;
+        }
+
+        std::vector<std::uint32_t> aCacheTimes(uNumVertices, 0u);
+        std::vector<bool> abEmitted(uNumTriangles, false);
+        std::vector<std::uint32_t> aDeadEnds;
+        std::vector<std::uint32_t> aCandidates;
+        std::vector<std::uint32_t> aOutput;
+        aDeadEnds.reserve(uNumTriangles * 3u);
+        aOutput.reserve(uNumTriangles * 3u);
+
+        std::uint32_t uTime = uCacheSize + 1u;
+        std::uint32_t uCursor = 0u;
+        std::uint32_t uFanning = 0u;
+
+        auto skipDeadEnd = [&]() -> std::uint32_t
+        {
+            while (!aDeadEnds.empty())
+            {
+                std::uint32_t uVertex = aDeadEnds.back();
+                aDeadEnds.pop_back();
+
+                if (aLiveTriangles[uVertex] > 0u)
+                {
+                    return uVertex;
+                }
+            }
+
+            for (; uCursor < uNumVertices; ++uCursor)
+            {
+                if (aLiveTriangles[uCursor] > 0u)
+                {
+                    return uCursor;
+                }
+            }
+
+            return INVALID_INDEX;
+        };
+
+        while (uFanning != INVALID_INDEX)
+        {
+            aCandidates.clear();
+
+            for (std::uint32_t a = aAdjacencyOffsets[uFanning]; a < aAdjacencyOffsets[uFanning + 1u]; ++a)
+            {
+                std::uint32_t uTriangle = aAdjacency[a];
+
+                if (abEmitted[uTriangle])
+                {
+                    continue;
+                }
+
+                for (std::uint32_t k = 0u; k < 3u; ++k)
+                {
+                    std::uint32_t uVertex = pIndices[uTriangle * 3u + k];
+
+                    aOutput.push_back(uVertex);
+                    aDeadEnds.push_back(uVertex);
+                    aCandidates.push_back(uVertex);
+                    --aLiveTriangles[uVertex];
+
+                    if (uTime - aCacheTimes[uVertex] > uCacheSize)
+                    {
+                        aCacheTimes[uVertex] = uTime++;
+                    }
+                }
+
+                abEmitted[uTriangle] = true;
+            }
+
+            // Prefer the candidate that entered the cache earliest among
+            // those whose remaining triangles still fit before eviction
+            std::uint32_t uNext = INVALID_INDEX;
+            std::uint32_t uBestPriority = 0u;
+
+            for (std::uint32_t uVertex : aCandidates)
+            {
+                if (aLiveTriangles[uVertex] == 0u)
+                {
+                    continue;
+                }
+
+                std::uint32_t uPriority = 1u;
+                if (uTime - aCacheTimes[uVertex] + 2u * aLiveTriangles[uVertex] <= uCacheSize)
+                {
+                    uPriority = uTime - aCacheTimes[uVertex] + 1u;
+                }
+
+                if (uPriority > uBestPriority)
+                {
+                    uBestPriority = uPriority;
+                    uNext = uVertex;
+                }
+            }
+
+            uFanning = uNext != INVALID_INDEX ? uNext : skipDeadEnd();
+        }
+
+        std::memcpy(pIndices, aOutput.data(), aOutput.size() * sizeof(std::uint32_t));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeOverdraw
+      Summary:  Splits a cache optimized triangle list into clusters at
+                the triangles that miss the cache on all three vertices,
+                where the cache is flushed anyway, and sorts the
+                clusters so those facing away from the mesh center are
+                drawn first and occlude the rest. The vertex cache
+                efficiency within each cluster is kept. Normals follow
+                the clockwise front faces of this renderer
+      Args:     std::uint32_t* pIndices
+                  Triangle list to reorder in place
+                std::uint32_t uNumIndices
+                  Number of indices, a multiple of 3
+                const void* pPositions
+                  Position of the first vertex, three floats
+                std::uint32_t uStride
+                  Bytes between two positions
+                std::uint32_t uNumVertices
+                  Number of vertices
+                std::uint32_t uCacheSize
+                  Number of entries of the target vertex cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeOverdraw(std::uint32_t* pIndices, std::uint32_t uNumIndices, const void* pPositions,
+        std::uint32_t uStride, std::uint32_t uNumVertices, std::uint32_t uCacheSize)
+    {
+        std::uint32_t uNumTriangles = uNumIndices / 3u;
+
+        if (uNumTriangles < 2u)
+        {
+            return;
+        }
+
+        std::vector<std::uint32_t> aClusterStarts;
+        FifoCache cache(uNumVertices, uCacheSize);
+
+        for (std::uint32_t t = 0u; t < uNumTriangles; ++t)
+        {
+            bool bHit0 = cache.Access(pIndices[t * 3u + 0u]);
+            bool bHit1 = cache.Access(pIndices[t * 3u + 1u]);
+            bool bHit2 = cache.Access(pIndices[t * 3u + 2u]);
+
+            if (t == 0u || (!bHit0 && !bHit1 && !bHit2))
+            {
+                aClusterStarts.push_back(t);
+            }
+        }
+
+        aClusterStarts.push_back(uNumTriangles);
+
+        std::uint32_t uNumClusters = static_cast<std::uint32_t>(aClusterStarts.size()) - 1u;
+
+        if (uNumClusters < 2u)
+        {
+            return;
+        }
+
+        // Area weighted centroid of the mesh
+        float afMeshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+        float fMeshArea = 0.0f;
+
+        std::vector<float> aClusterCentroids(uNumClusters * 3u, 0.0f);
+        std::vector<float> aClusterNormals(uNumClusters * 3u, 0.0f);
+
+        for (std::uint32_t c = 0u; c < uNumClusters; ++c)
+        {
+            float fClusterArea = 0.0f;
+
+            for (std::uint32_t t = aClusterStarts[c]; t < aClusterStarts[c + 1u]; ++t)
+            {
+                const float* a = position(pPositions, uStride, pIndices[t * 3u + 0u]);
+                const float* b = position(pPositions, uStride, pIndices[t * 3u + 1u]);
+                const float* d = position(pPositions, uStride, pIndices[t * 3u + 2u]);
+
+                float afEdge0[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+                float afEdge1[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+                float afNormal[3] =
+                {
+                    afEdge0[1] * afEdge1[2] - afEdge0[2] * afEdge1[1],
+                    afEdge0[2] * afEdge1[0] - afEdge0[0] * afEdge1[2],
+                    afEdge0[0] * afEdge1[1] - afEdge0[1] * afEdge1[0],
+                };
+                float fArea = std::sqrt(afNormal[0] * afNormal[0] + afNormal[1] * afNormal[1] + afNormal[2] * afNormal[2]);
+
+                for (std::uint32_t k = 0u; k < 3u; ++k)
+                {
+                    float fCentroid = (a[k] + b[k] + d[k]) / 3.0f;
+
+                    aClusterCentroids[c * 3u + k] += fCentroid * fArea;
+                    aClusterNormals[c * 3u + k] += afNormal[k];
+                    afMeshCentroid[k] += fCentroid * fArea;
+                }
+
+                fClusterArea += fArea;
+            }
+
+            if (fClusterArea > 0.0f)
+            {
+                for (std::uint32_t k = 0u; k < 3u; ++k)
+                {
+                    aClusterCentroids[c * 3u + k] /= fClusterArea;
+                }
+            }
+
+            fMeshArea += fClusterArea;
+        }
+
+        if (fMeshArea > 0.0f)
+        {
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                afMeshCentroid[k] /= fMeshArea;
+            }
+        }
+
+        std::vector<float> aSortKeys(uNumClusters, 0.0f);
+
+        for (std::uint32_t c = 0u; c < uNumClusters; ++c)
+        {
+            const float* pNormal = &aClusterNormals[c * 3u];
+            float fLength = std::sqrt(pNormal[0] * pNormal[0] + pNormal[1] * pNormal[1] + pNormal[2] * pNormal[2]);
+
+            if (fLength > 0.0f)
+            {
+                aSortKeys[c] = ((aClusterCentroids[c * 3u + 0u] - afMeshCentroid[0]) * pNormal[0]
+                    + (aClusterCentroids[c * 3u + 1u] - afMeshCentroid[1]) * pNormal[1]
+                    + (aClusterCentroids[c * 3u + 2u] - afMeshCentroid[2]) * pNormal[2]) / fLength;
+            }
+        }
+
+        std::vector<std::uint32_t> aOrder(uNumClusters);
+        for (std::uint32_t c = 0u; c < uNumClusters; ++c)
+        {
+            aOrder[c] = c;
+        }
+
+        std::stable_sort(aOrder.begin(), aOrder.end(),
+            [&aSortKeys](std::uint32_t uA, std::uint32_t uB) { return aSortKeys[uA] > aSortKeys[uB]; });
+
+        std::vector<std::uint32_t> aOutput;
+        aOutput.reserve(uNumTriangles * 3u);
+
+        for (std::uint32_t c : aOrder)
+        {
+            aOutput.insert(aOutput.end(), pIndices + aClusterStarts[c] * 3u, pIndices + aClusterStarts[c + 1u] * 3u);
+        }
+
+        std::memcpy(pIndices, aOutput.data(), aOutput.size() * sizeof(std::uint32_t));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::OptimizeVertexFetch
+      Summary:  Reorders the vertices in the order the triangles first
+                use them, so vertex fetch reads memory sequentially, and
+                rewrites the indices. Unused vertices are moved to the
+                end, keeping the number of vertices
+      Args:     void* pVertices
+                  Vertices to reorder in place
+                std::uint32_t uStride
+                  Size of a vertex in bytes
+                std::uint32_t uNumVertices
+                  Number of vertices
+                std::uint32_t* pIndices
+                  Triangle list to rewrite in place
+                std::uint32_t uNumIndices
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::OptimizeVertexFetch(void* pVertices, std::uint32_t uStride, std::uint32_t uNumVertices,
+        std::uint32_t* pIndices, std::uint32_t uNumIndices)
+    {
+        std::vector<std::uint32_t> aRemap(uNumVertices, INVALID_INDEX);
+        std::uint32_t uNext = 0u;
+
+        for (std::uint32_t i = 0u; i < uNumIndices; ++i)
+        {
+            if (aRemap[pIndices[i]] == INVALID_INDEX)
+            {
+                aRemap[pIndices[i]] = uNext++;
+            }
+        }
+
+        for (std::uint32_t v = 0u; v < uNumVertices; ++v)
+        {
+            if (aRemap[v] == INVALID_INDEX)
+            {
+                aRemap[v] = uNext++;
+            }
+        }
+
+        unsigned char* pBytes = static_cast<unsigned char*>(pVertices);
+        std::vector<unsigned char> aSource(pBytes, pBytes + static_cast<std::size_t>(uNumVertices) * uStride);
+
+        for (std::uint32_t v = 0u; v < uNumVertices; ++v)
+        {
+            std::memcpy(pBytes + static_cast<std::size_t>(aRemap[v]) * uStride,
+                aSource.data() + static_cast<std::size_t>(v) * uStride, uStride);
+        }
+
+        for (std::uint32_t i = 0u; i < uNumIndices; ++i)
+        {
+            pIndices[i] = aRemap[pIndices[i]];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::AnalyzeVertexCache
+      Summary:  Simulates a FIFO post-transform vertex cache over a
+                triangle list and adds the counters to stats
+      Args:     const std::uint32_t* pIndices
+                  Triangle list
+                std::uint32_t uNumIndices
+                  Number of indices, a multiple of 3
+                std::uint32_t uNumVertices
+                  Number of vertices
+                std::uint32_t uCacheSize
+                  Number of entries of the simulated cache
+                VertexCacheStats& stats
+                  Counters to add to
+      Modifies: [stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshOptimizer::AnalyzeVertexCache(const std::uint32_t* pIndices, std::uint32_t uNumIndices, std::uint32_t uNumVertices,
+        std::uint32_t uCacheSize, VertexCacheStats& stats)
+    {
+        FifoCache cache(uNumVertices, uCacheSize);
+
+        for (std::uint32_t i = 0u; i < uNumIndices; ++i)
+        {
+            if (!cache.Access(pIndices[i]))
+            {
+                ++stats.uNumTransformedVertices;
+            }
+        }
+
+        stats.uNumTriangles += uNumIndices / 3u;
+        stats.uNumVertices += uNumVertices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::GetAcmr
+      Summary:  Returns the average cache miss ratio: transformed
+                vertices per triangle. 0.5 is the ideal for a regular
+                grid and 3 means no reuse at all
+      Args:     const VertexCacheStats& stats
+                  Counters from AnalyzeVertexCache
+      Returns:  float
+                  Average cache miss ratio
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float MeshOptimizer::GetAcmr(const VertexCacheStats& stats)
+    {
+        return stats.uNumTriangles > 0u
+            ? static_cast<float>(stats.uNumTransformedVertices) / static_cast<float>(stats.uNumTriangles) : 0.0f;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshOptimizer::GetAtvr
+      Summary:  Returns the average transform to vertex ratio:
+                transformed vertices per vertex. 1 is the ideal
+      Args:     const VertexCacheStats& stats
+                  Counters from AnalyzeVertexCache
+      Returns:  float
+                  Average transform to vertex ratio
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float MeshOptimizer::GetAtvr(const VertexCacheStats& stats)
+    {
+        return stats.uNumVertices > 0u
+            ? static_cast<float>(stats.uNumTransformedVertices) / static_cast<float>(stats.uNumVertices) : 0.0f;
+    }
+}
@@ -0,0 +1,71 @@
+/*+===================================================================
+  File:      MESHOPTIMIZER.H
+  Summary:   MeshOptimizer header file contains declarations of
+             MeshOptimizer class used to reorder the triangles and
+             vertices of baked meshes for the GPU caches.
+  Classes: MeshOptimizer
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   VertexCacheStats
+      Summary:  Counters of a simulated post-transform vertex cache.
+                Several meshes can be accumulated into one
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct VertexCacheStats
+    {
+        std::uint32_t uNumTriangles;
+        std::uint32_t uNumVertices;
+        std::uint32_t uNumTransformedVertices;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshOptimizer
+      Summary:  Offline passes over an indexed triangle list. Indices
+                are 32-bit and relative to the first vertex of the mesh
+      Methods:  OptimizeVertexCache
+                  Reorders triangles for the post-transform vertex cache
+                  with Tipsify
+                OptimizeOverdraw
+                  Reorders vertex cache friendly clusters so outward
+                  facing ones are drawn first
+                OptimizeVertexFetch
+                  Reorders vertices in the order they are first used
+                AnalyzeVertexCache
+                  Accumulates FIFO cache counters of a mesh
+                GetAcmr
+                  Returns the average cache miss ratio
+                GetAtvr
+                  Returns the average transform to vertex ratio
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshOptimizer final
+    {
+    public:
+        static constexpr const std::uint32_t DEFAULT_CACHE_SIZE = 16u;
+
+    public:
+        MeshOptimizer() = delete;
+        MeshOptimizer(const MeshOptimizer& other) = delete;
+        MeshOptimizer(MeshOptimizer&& other) = delete;
+        MeshOptimizer& operator=(const MeshOptimizer& other) = delete;
+        MeshOptimizer& operator=(MeshOptimizer&& other) = delete;
+        ~MeshOptimizer() = delete;
+
+        static void OptimizeVertexCache(std::uint32_t* pIndices, std::uint32_t uNumIndices, std::uint32_t uNumVertices,
+            std::uint32_t uCacheSize = DEFAULT_CACHE_SIZE);
+        static void OptimizeOverdraw(std::uint32_t* pIndices, std::uint32_t uNumIndices, const void* pPositions,
+            std::uint32_t uStride, std::uint32_t uNumVertices, std::uint32_t uCacheSize = DEFAULT_CACHE_SIZE);
+        static void OptimizeVertexFetch(void* pVertices, std::uint32_t uStride, std::uint32_t uNumVertices,
+            std::uint32_t* pIndices, std::uint32_t uNumIndices);
+
+        static void AnalyzeVertexCache(const std::uint32_t* pIndices, std::uint32_t uNumIndices, std::uint32_t uNumVertices,
+            std::uint32_t uCacheSize, VertexCacheStats& stats);
+        static float GetAcmr(const VertexCacheStats& stats);
+        static float GetAtvr(const VertexCacheStats& stats);
+    };
+}
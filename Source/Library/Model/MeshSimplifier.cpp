@@ -0,0 +1,568 @@
+#include "Model/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace library
+{
+    namespace
+    {
+        // Open borders are pulled back onto their edge planes this much
+        // harder than faces are kept on theirs
+        constexpr const double BOUNDARY_WEIGHT = 10.0;
+
+        // Collapses may turn a triangle by at most ~84 degrees
+        constexpr const double MIN_NORMAL_COSINE = 0.1;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Quadric
+          Summary:  Sum of weighted squared distances to a set of planes
+                    (Garland and Heckbert 1997), stored as the symmetric
+                    matrix A, the vector b and the scalar c of
+                    x'Ax + 2b'x + c. Evaluate divides by the total weight,
+                    so the error is a mean squared distance
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Quadric
+        {
+            void AddPlane(const double (&aNormal)[3], double fDistance, double fWeight)
+            {
+                a00 += fWeight * aNormal[0] * aNormal[0];
+                a01 += fWeight * aNormal[0] * aNormal[1];
+                a02 += fWeight * aNormal[0] * aNormal[2];
+                a11 += fWeight * aNormal[1] * aNormal[1];
+                a12 += fWeight * aNormal[1] * aNormal[2];
+                a22 += fWeight * aNormal[2] * aNormal[2];
+                b0 += fWeight * aNormal[0] * fDistance;
+                b1 += fWeight * aNormal[1] * fDistance;
+                b2 += fWeight * aNormal[2] * fDistance;
+                c += fWeight * fDistance * fDistance;
+                w += fWeight;
+            }
+
+            void Add(const Quadric& other)
+            {
+                a00 += other.a00;
+                a01 += other.a01;
+                a02 += other.a02;
+                a11 += other.a11;
+                a12 += other.a12;
+                a22 += other.a22;
+                b0 += other.b0;
+                b1 += other.b1;
+                b2 += other.b2;
+                c += other.c;
+                w += other.w;
+            }
+
+            double Evaluate(const float* pPosition) const
+            {
+                double x = pPosition[0];
+                double y = pPosition[1];
+                double z = pPosition[2];
+
+                double fError = a00 * x * x + a11 * y * y + a22 * z * z
+                    + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                    + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+                return w > 0.0 ? std::fabs(fError) / w : std::fabs(fError);
+            }
+
+            double a00, a01, a02, a11, a12, a22;
+            double b0, b1, b2;
+            double c;
+            double w;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Collapse
+          Summary:  Candidate collapse of one position onto a neighbour
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Collapse
+        {
+            std::uint32_t uFrom;
+            std::uint32_t uTo;
+            double fError;
+        };
+
+        const float* vertexData(const void* pVertices, std::uint32_t uStride, std::uint32_t uVertex)
+        {
+            return reinterpret_cast<const float*>(static_cast<const unsigned char*>(pVertices)
+                + static_cast<std::size_t>(uVertex) * uStride);
+        }
+
+        void cross(const float* pA, const float* pB, const float* pC, double (&aOut)[3])
+        {
+            double aE1[3] = { pB[0] - pA[0], pB[1] - pA[1], pB[2] - pA[2] };
+            double aE2[3] = { pC[0] - pA[0], pC[1] - pA[1], pC[2] - pA[2] };
+
+            aOut[0] = aE1[1] * aE2[2] - aE1[2] * aE2[1];
+            aOut[1] = aE1[2] * aE2[0] - aE1[0] * aE2[2];
+            aOut[2] = aE1[0] * aE2[1] - aE1[1] * aE2[0];
+        }
+
+        double dot(const double (&aA)[3], const double (&aB)[3])
+        {
+            return aA[0] * aB[0] + aA[1] * aB[1] + aA[2] * aB[2];
+        }
+
+        std::uint64_t edgeKey(std::uint32_t uA, std::uint32_t uB)
+        {
+            return (static_cast<std::uint64_t>(uA) << 32u) | uB;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshSimplifier::Simplify
+      Summary:  Collapses edges in passes, cheapest first, until the
+                target index count or the error limit is reached.
+                Vertices sharing a position (texture or normal seams)
+                are collapsed together and each one is replaced by the
+                vertex of the target position whose other attributes
+                are closest, so seams stay closed. Seam vertices only
+                collapse onto seams and open border vertices only onto
+                borders. Collapses that would flip a triangle are
+                skipped, and within a pass the one-ring of a collapsed
+                vertex is locked so the checks stay valid
+      Args:     std::uint32_t* pDestination
+                  Receives the simplified indices, room for uNumIndices
+                const std::uint32_t* pIndices
+                  Triangle list to simplify
+                std::uint32_t uNumIndices
+                  Number of indices, a multiple of 3
+                const void* pVertices
+                  Vertices starting with a float3 position. The floats
+                  after it are compared to pick seam replacements
+                std::uint32_t uStride
+                  Size of a vertex in bytes
+                std::uint32_t uNumVertices
+                  Number of vertices
+                std::uint32_t uTargetNumIndices
+                  Index count to stop at
+                float fMaxRelativeError
+                  Largest error allowed, relative to the largest extent
+                  of the mesh
+                float* pOutError
+                  Receives the error of the result in the units of the
+                  positions, can be nullptr
+      Returns:  std::uint32_t
+                  Number of indices written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t MeshSimplifier::Simplify(std::uint32_t* pDestination, const std::uint32_t* pIndices, std::uint32_t uNumIndices,
+        const void* pVertices, std::uint32_t uStride, std::uint32_t uNumVertices, std::uint32_t uTargetNumIndices,
+        float fMaxRelativeError, float* pOutError)
+    {
+        if (pOutError)
+        {
+            *pOutError = 0.0f;
+        }
+
+        uNumIndices -= uNumIndices % 3u;
+        std::memmove(pDestination, pIndices, sizeof(std::uint32_t) * uNumIndices);
+
+        if (uNumIndices == 0u || uNumVertices == 0u)
+        {
+            return uNumIndices;
+        }
+
+        // Work in a unit box so the error limit does not depend on the
+        // scale of the model
+        float afMin[3] = { vertexData(pVertices, uStride, 0u)[0], vertexData(pVertices, uStride, 0u)[1],
+            vertexData(pVertices, uStride, 0u)[2] };
+        float afMax[3] = { afMin[0], afMin[1], afMin[2] };
+
+        for (std::uint32_t i = 1u; i < uNumVertices; ++i)
+        {
+            const float* pPosition = vertexData(pVertices, uStride, i);
+
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                afMin[k] = (std::min)(afMin[k], pPosition[k]);
+                afMax[k] = (std::max)(afMax[k], pPosition[k]);
+            }
+        }
+
+        float fExtent = (std::max)((std::max)(afMax[0] - afMin[0], afMax[1] - afMin[1]), afMax[2] - afMin[2]);
+        float fScale = fExtent > 0.0f ? 1.0f / fExtent : 1.0f;
+
+        std::vector<float> aPositions(static_cast<std::size_t>(uNumVertices) * 3u);
+
+        for (std::uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            const float* pPosition = vertexData(pVertices, uStride, i);
+
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                aPositions[i * 3u + k] = (pPosition[k] - afMin[k]) * fScale;
+            }
+        }
+
+        const float* pPositions = aPositions.data();
+
+        // Group the vertices that share a position. The first vertex of
+        // each group stands for the position
+        std::vector<std::uint32_t> aSorted(uNumVertices);
+        std::iota(aSorted.begin(), aSorted.end(), 0u);
+        std::sort(aSorted.begin(), aSorted.end(), [pPositions](std::uint32_t uA, std::uint32_t uB)
+            {
+                return std::lexicographical_compare(pPositions + uA * 3u, pPositions + uA * 3u + 3u,
+                    pPositions + uB * 3u, pPositions + uB * 3u + 3u);
+            });
+
+        std::vector<std::uint32_t> aRemap(uNumVertices);
+        std::vector<std::uint32_t> aWedgeBegin(uNumVertices, 0u);
+        std::vector<std::uint32_t> aWedgeSize(uNumVertices, 0u);
+
+        for (std::uint32_t uBegin = 0u; uBegin < uNumVertices;)
+        {
+            std::uint32_t uEnd = uBegin + 1u;
+
+            while (uEnd < uNumVertices
+                && std::memcmp(pPositions + aSorted[uEnd] * 3u, pPositions + aSorted[uBegin] * 3u, sizeof(float) * 3u) == 0)
+            {
+                ++uEnd;
+            }
+
+            std::uint32_t uCanonical = aSorted[uBegin];
+            aWedgeBegin[uCanonical] = uBegin;
+            aWedgeSize[uCanonical] = uEnd - uBegin;
+
+            for (std::uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                aRemap[aSorted[i]] = uCanonical;
+            }
+
+            uBegin = uEnd;
+        }
+
+        // Face quadrics weighted by area, and the directed edges to find
+        // the open borders with
+        std::vector<Quadric> aQuadrics(uNumVertices, Quadric{});
+        std::vector<std::uint64_t> aDirectedEdges;
+        aDirectedEdges.reserve(uNumIndices);
+
+        for (std::uint32_t t = 0u; t < uNumIndices; t += 3u)
+        {
+            std::uint32_t auCorners[3] = { aRemap[pDestination[t]], aRemap[pDestination[t + 1u]],
+                aRemap[pDestination[t + 2u]] };
+
+            if (auCorners[0] == auCorners[1] || auCorners[1] == auCorners[2] || auCorners[2] == auCorners[0])
+            {
+                continue;
+            }
+
+            double aNormal[3];
+            cross(pPositions + auCorners[0] * 3u, pPositions + auCorners[1] * 3u, pPositions + auCorners[2] * 3u, aNormal);
+
+            double fLength = std::sqrt(dot(aNormal, aNormal));
+
+            if (fLength > 0.0)
+            {
+                double aUnit[3] = { aNormal[0] / fLength, aNormal[1] / fLength, aNormal[2] / fLength };
+                const float* pCorner = pPositions + auCorners[0] * 3u;
+                double fDistance = -(aUnit[0] * pCorner[0] + aUnit[1] * pCorner[1] + aUnit[2] * pCorner[2]);
+
+                for (std::uint32_t uCorner : auCorners)
+                {
+                    aQuadrics[uCorner].AddPlane(aUnit, fDistance, fLength * 0.5);
+                }
+            }
+
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                aDirectedEdges.push_back(edgeKey(auCorners[k], auCorners[(k + 1u) % 3u]));
+            }
+        }
+
+        std::sort(aDirectedEdges.begin(), aDirectedEdges.end());
+
+        // An edge without its reverse is on an open border. Its plane
+        // contains the edge and is perpendicular to the face
+        std::vector<std::uint8_t> aBorder(uNumVertices, 0u);
+
+        for (std::uint32_t t = 0u; t < uNumIndices; t += 3u)
+        {
+            std::uint32_t auCorners[3] = { aRemap[pDestination[t]], aRemap[pDestination[t + 1u]],
+                aRemap[pDestination[t + 2u]] };
+
+            if (auCorners[0] == auCorners[1] || auCorners[1] == auCorners[2] || auCorners[2] == auCorners[0])
+            {
+                continue;
+            }
+
+            double aFaceNormal[3];
+            cross(pPositions + auCorners[0] * 3u, pPositions + auCorners[1] * 3u, pPositions + auCorners[2] * 3u, aFaceNormal);
+
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                std::uint32_t uA = auCorners[k];
+                std::uint32_t uB = auCorners[(k + 1u) % 3u];
+
+                if (std::binary_search(aDirectedEdges.begin(), aDirectedEdges.end(), edgeKey(uB, uA)))
+                {
+                    continue;
+                }
+
+                aBorder[uA] = 1u;
+                aBorder[uB] = 1u;
+
+                const float* pA = pPositions + uA * 3u;
+                const float* pB = pPositions + uB * 3u;
+                double aEdge[3] = { pB[0] - pA[0], pB[1] - pA[1], pB[2] - pA[2] };
+                double aNormal[3] =
+                {
+                    aEdge[1] * aFaceNormal[2] - aEdge[2] * aFaceNormal[1],
+                    aEdge[2] * aFaceNormal[0] - aEdge[0] * aFaceNormal[2],
+                    aEdge[0] * aFaceNormal[1] - aEdge[1] * aFaceNormal[0]
+                };
+
+                double fLength = std::sqrt(dot(aNormal, aNormal));
+
+                if (fLength > 0.0)
+                {
+                    double aUnit[3] = { aNormal[0] / fLength, aNormal[1] / fLength, aNormal[2] / fLength };
+                    double fDistance = -(aUnit[0] * pA[0] + aUnit[1] * pA[1] + aUnit[2] * pA[2]);
+                    double fWeight = dot(aEdge, aEdge) * BOUNDARY_WEIGHT;
+
+                    aQuadrics[uA].AddPlane(aUnit, fDistance, fWeight);
+                    aQuadrics[uB].AddPlane(aUnit, fDistance, fWeight);
+                }
+            }
+        }
+
+        std::uint32_t uNumAttributes = uStride / sizeof(float) > 3u ? uStride / sizeof(float) - 3u : 0u;
+
+        // Replacement for a vertex whose position collapsed: the vertex
+        // at the target position with the closest attributes
+        auto closestWedge = [&](std::uint32_t uTarget, std::uint32_t uVertex)
+            {
+                std::uint32_t uBest = uTarget;
+                float fBestDistance = -1.0f;
+                const float* pAttributes = vertexData(pVertices, uStride, uVertex) + 3u;
+
+                for (std::uint32_t i = 0u; i < aWedgeSize[uTarget] && uNumAttributes > 0u; ++i)
+                {
+                    std::uint32_t uCandidate = aSorted[aWedgeBegin[uTarget] + i];
+                    const float* pCandidate = vertexData(pVertices, uStride, uCandidate) + 3u;
+                    float fDistance = 0.0f;
+
+                    for (std::uint32_t k = 0u; k < uNumAttributes; ++k)
+                    {
+                        fDistance += (pCandidate[k] - pAttributes[k]) * (pCandidate[k] - pAttributes[k]);
+                    }
+
+                    if (fBestDistance < 0.0f || fDistance < fBestDistance)
+                    {
+                        uBest = uCandidate;
+                        fBestDistance = fDistance;
+                    }
+                }
+
+                return uBest;
+            };
+
+        double fMaxError = static_cast<double>(fMaxRelativeError) * fMaxRelativeError;
+        double fResultError = 0.0;
+        std::uint32_t uNumResultIndices = uNumIndices;
+
+        std::vector<std::uint32_t> aAdjacencyOffsets(uNumVertices + 1u);
+        std::vector<std::uint32_t> aAdjacency;
+        std::vector<std::uint64_t> aEdges;
+        std::vector<Collapse> aCandidates;
+        std::vector<std::uint32_t> aCollapse(uNumVertices);
+        std::vector<std::uint8_t> aLocked(uNumVertices);
+
+        while (uNumResultIndices > uTargetNumIndices)
+        {
+            std::uint32_t uNumTriangles = uNumResultIndices / 3u;
+
+            // Triangles around each position
+            std::fill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end(), 0u);
+
+            for (std::uint32_t i = 0u; i < uNumResultIndices; ++i)
+            {
+                ++aAdjacencyOffsets[aRemap[pDestination[i]] + 1u];
+            }
+
+            std::partial_sum(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end(), aAdjacencyOffsets.begin());
+            aAdjacency.resize(uNumResultIndices);
+
+            {
+                std::vector<std::uint32_t> aFill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+
+                for (std::uint32_t i = 0u; i < uNumResultIndices; ++i)
+                {
+                    aAdjacency[aFill[aRemap[pDestination[i]]]++] = i / 3u;
+                }
+            }
+
+            // Every edge once, collapsed in its cheaper allowed direction
+            aEdges.clear();
+
+            for (std::uint32_t i = 0u; i < uNumResultIndices; ++i)
+            {
+                std::uint32_t uA = aRemap[pDestination[i]];
+                std::uint32_t uB = aRemap[pDestination[i - i % 3u + (i + 1u) % 3u]];
+
+                if (uA != uB)
+                {
+                    aEdges.push_back(edgeKey((std::min)(uA, uB), (std::max)(uA, uB)));
+                }
+            }
+
+            std::sort(aEdges.begin(), aEdges.end());
+            aEdges.erase(std::unique(aEdges.begin(), aEdges.end()), aEdges.end());
+
+            auto isAllowed = [&](std::uint32_t uFrom, std::uint32_t uTo)
+                {
+                    return (aWedgeSize[uFrom] == 1u || aWedgeSize[uTo] > 1u) && (!aBorder[uFrom] || aBorder[uTo]);
+                };
+
+            aCandidates.clear();
+
+            for (std::uint64_t uEdge : aEdges)
+            {
+                std::uint32_t uA = static_cast<std::uint32_t>(uEdge >> 32u);
+                std::uint32_t uB = static_cast<std::uint32_t>(uEdge);
+
+                Quadric sum = aQuadrics[uA];
+                sum.Add(aQuadrics[uB]);
+
+                double fErrorAB = isAllowed(uA, uB) ? sum.Evaluate(pPositions + uB * 3u) : -1.0;
+                double fErrorBA = isAllowed(uB, uA) ? sum.Evaluate(pPositions + uA * 3u) : -1.0;
+
+                if (fErrorAB >= 0.0 && (fErrorBA < 0.0 || fErrorAB <= fErrorBA))
+                {
+                    aCandidates.push_back(Collapse{ .uFrom = uA, .uTo = uB, .fError = fErrorAB });
+                }
+                else if (fErrorBA >= 0.0)
+                {
+                    aCandidates.push_back(Collapse{ .uFrom = uB, .uTo = uA, .fError = fErrorBA });
+                }
+            }
+
+            std::sort(aCandidates.begin(), aCandidates.end(), [](const Collapse& a, const Collapse& b)
+                {
+                    return a.fError < b.fError;
+                });
+
+            std::iota(aCollapse.begin(), aCollapse.end(), 0u);
+            std::fill(aLocked.begin(), aLocked.end(), static_cast<std::uint8_t>(0u));
+
+            std::uint32_t uTargetTriangles = uTargetNumIndices / 3u;
+            std::uint32_t uNumCollapses = 0u;
+
+            for (const Collapse& collapse : aCandidates)
+            {
+                if (collapse.fError > fMaxError || uNumTriangles <= uTargetTriangles)
+                {
+                    break;
+                }
+
+                if (aLocked[collapse.uFrom] || aLocked[collapse.uTo])
+                {
+                    continue;
+                }
+
+                const float* pTo = pPositions + collapse.uTo * 3u;
+                std::uint32_t uNumRemoved = 0u;
+                bool bFlips = false;
+
+                for (std::uint32_t j = aAdjacencyOffsets[collapse.uFrom]; j < aAdjacencyOffsets[collapse.uFrom + 1u]; ++j)
+                {
+                    std::uint32_t t = aAdjacency[j] * 3u;
+                    std::uint32_t auCorners[3] = { aRemap[pDestination[t]], aRemap[pDestination[t + 1u]],
+                        aRemap[pDestination[t + 2u]] };
+
+                    if (auCorners[0] == collapse.uTo || auCorners[1] == collapse.uTo || auCorners[2] == collapse.uTo)
+                    {
+                        ++uNumRemoved;
+                        continue;
+                    }
+
+                    // Rotate the collapsing corner first, keeping the winding
+                    std::uint32_t k = auCorners[0] == collapse.uFrom ? 0u : auCorners[1] == collapse.uFrom ? 1u : 2u;
+                    const float* pB = pPositions + auCorners[(k + 1u) % 3u] * 3u;
+                    const float* pC = pPositions + auCorners[(k + 2u) % 3u] * 3u;
+
+                    double aBefore[3];
+                    double aAfter[3];
+                    cross(pPositions + collapse.uFrom * 3u, pB, pC, aBefore);
+                    cross(pTo, pB, pC, aAfter);
+
+                    double fLengths = std::sqrt(dot(aBefore, aBefore) * dot(aAfter, aAfter));
+
+                    if (fLengths <= 0.0 || dot(aBefore, aAfter) < MIN_NORMAL_COSINE * fLengths)
+                    {
+                        bFlips = true;
+                        break;
+                    }
+                }
+
+                if (bFlips)
+                {
+                    continue;
+                }
+
+                for (std::uint32_t j = aAdjacencyOffsets[collapse.uFrom]; j < aAdjacencyOffsets[collapse.uFrom + 1u]; ++j)
+                {
+                    std::uint32_t t = aAdjacency[j] * 3u;
+
+                    for (std::uint32_t k = 0u; k < 3u; ++k)
+                    {
+                        aLocked[aRemap[pDestination[t + k]]] = 1u;
+                    }
+                }
+
+                aCollapse[collapse.uFrom] = collapse.uTo;
+                aQuadrics[collapse.uTo].Add(aQuadrics[collapse.uFrom]);
+                fResultError = (std::max)(fResultError, collapse.fError);
+                uNumTriangles -= (std::min)(uNumRemoved, uNumTriangles);
+                ++uNumCollapses;
+            }
+
+            if (uNumCollapses == 0u)
+            {
+                break;
+            }
+
+            // Move the collapsed corners and drop the triangles that
+            // became degenerate
+            std::uint32_t uWrite = 0u;
+
+            for (std::uint32_t t = 0u; t < uNumResultIndices; t += 3u)
+            {
+                std::uint32_t auTriangle[3];
+
+                for (std::uint32_t k = 0u; k < 3u; ++k)
+                {
+                    std::uint32_t uVertex = pDestination[t + k];
+                    std::uint32_t uTarget = aCollapse[aRemap[uVertex]];
+
+                    auTriangle[k] = uTarget == aRemap[uVertex] ? uVertex : closestWedge(uTarget, uVertex);
+                }
+
+                if (aRemap[auTriangle[0]] == aRemap[auTriangle[1]] || aRemap[auTriangle[1]] == aRemap[auTriangle[2]]
+                    || aRemap[auTriangle[2]] == aRemap[auTriangle[0]])
+                {
+                    continue;
+                }
+
+                pDestination[uWrite++] = auTriangle[0];
+                pDestination[uWrite++] = auTriangle[1];
+                pDestination[uWrite++] = auTriangle[2];
+            }
+
+            uNumResultIndices = uWrite;
+        }
+
+        if (pOutError)
+        {
+            *pOutError = static_cast<float>(std::sqrt(fResultError)) * (fExtent > 0.0f ? fExtent : 1.0f);
+        }
+
+        return uNumResultIndices;
+    }
+}
@@ -0,0 +1,38 @@
+/*+===================================================================
+  File:      MESHSIMPLIFIER.H
+  Summary:   MeshSimplifier header file contains declarations of
+             MeshSimplifier class used to generate the levels of
+             detail of baked and imported meshes.
+  Classes: MeshSimplifier
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshSimplifier
+      Summary:  Reduces the triangle count of an indexed triangle list
+                with quadric error metrics. Only the index buffer is
+                rewritten: every level keeps using the vertices of the
+                full detail mesh
+      Methods:  Simplify
+                  Writes a simplified index buffer
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshSimplifier final
+    {
+    public:
+        MeshSimplifier() = delete;
+        MeshSimplifier(const MeshSimplifier& other) = delete;
+        MeshSimplifier(MeshSimplifier&& other) = delete;
+        MeshSimplifier& operator=(const MeshSimplifier& other) = delete;
+        MeshSimplifier& operator=(MeshSimplifier&& other) = delete;
+        ~MeshSimplifier() = delete;
+
+        static std::uint32_t Simplify(std::uint32_t* pDestination, const std::uint32_t* pIndices, std::uint32_t uNumIndices,
+            const void* pVertices, std::uint32_t uStride, std::uint32_t uNumVertices, std::uint32_t uTargetNumIndices,
+            float fMaxRelativeError, float* pOutError);
+    };
+}
@@ -0,0 +1,446 @@
+#include "Model/MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+        // Normal cones wider than ~84 degrees can never be backfacing
+        // as a whole, so they are not worth testing
+        constexpr const float MIN_CONE_DOT = 0.1f;
+
+        const float* vertexPosition(const void* pVertices, std::uint32_t uStride, std::uint32_t uVertex)
+        {
+            return reinterpret_cast<const float*>(static_cast<const std::uint8_t*>(pVertices)
+                + static_cast<std::size_t>(uStride) * uVertex);
+        }
+
+        float length(const float (&afVector)[3])
+        {
+            return std::sqrt(afVector[0] * afVector[0] + afVector[1] * afVector[1] + afVector[2] * afVector[2]);
+        }
+
+        // Fills the bounding sphere and the normal cone of a meshlet
+        // whose indices are already in place
+        void computeBounds(Meshlet& meshlet, const std::uint32_t* pIndices, const void* pPositions, std::uint32_t uStride)
+        {
+            const std::uint32_t* pMeshletIndices = pIndices + meshlet.uFirstIndex;
+
+            float afMin[3] = { (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)(),
+                (std::numeric_limits<float>::max)() };
+            float afMax[3] = { -afMin[0], -afMin[1], -afMin[2] };
+            float afNormalSum[3] = { 0.0f, 0.0f, 0.0f };
+
+            std::vector<float> afNormals;
+            afNormals.reserve(meshlet.uNumIndices);
+
+            for (std::uint32_t i = 0u; i < meshlet.uNumIndices; i += 3u)
+            {
+                const float* pA = vertexPosition(pPositions, uStride, pMeshletIndices[i]);
+                const float* pB = vertexPosition(pPositions, uStride, pMeshletIndices[i + 1u]);
+                const float* pC = vertexPosition(pPositions, uStride, pMeshletIndices[i + 2u]);
+
+                for (const float* pPosition : { pA, pB, pC })
+                {
+                    for (std::uint32_t k = 0u; k < 3u; ++k)
+                    {
+                        afMin[k] = (std::min)(afMin[k], pPosition[k]);
+                        afMax[k] = (std::max)(afMax[k], pPosition[k]);
+                    }
+                }
+
+                float afEdge0[3] = { pB[0] - pA[0], pB[1] - pA[1], pB[2] - pA[2] };
+                float afEdge1[3] = { pC[0] - pA[0], pC[1] - pA[1], pC[2] - pA[2] };
+                float afNormal[3] =
+                {
+                    afEdge0[1] * afEdge1[2] - afEdge0[2] * afEdge1[1],
+                    afEdge0[2] * afEdge1[0] - afEdge0[0] * afEdge1[2],
+                    afEdge0[0] * afEdge1[1] - afEdge0[1] * afEdge1[0]
+                };
+
+                // Degenerate triangles are never rasterized, so they do
+                // not widen the cone
+                float fLength = length(afNormal);
+                if (fLength <= 0.0f)
+                {
+                    continue;
+                }
+
+                for (std::uint32_t k = 0u; k < 3u; ++k)
+                {
+                    afNormal[k] /= fLength;
+                    afNormalSum[k] += afNormal[k];
+                    afNormals.push_back(afNormal[k]);
+                }
+            }
+
+            // The center of the box is close enough to the smallest
+            // sphere for clusters this small
+            float fRadiusSquared = 0.0f;
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                meshlet.afCenter[k] = (afMin[k] + afMax[k]) * 0.5f;
+            }
+
+            for (std::uint32_t i = 0u; i < meshlet.uNumIndices; ++i)
+            {
+                const float* pPosition = vertexPosition(pPositions, uStride, pMeshletIndices[i]);
+                float afOffset[3] = { pPosition[0] - meshlet.afCenter[0], pPosition[1] - meshlet.afCenter[1],
+                    pPosition[2] - meshlet.afCenter[2] };
+
+                fRadiusSquared = (std::max)(fRadiusSquared,
+                    afOffset[0] * afOffset[0] + afOffset[1] * afOffset[1] + afOffset[2] * afOffset[2]);
+            }
+            meshlet.fRadius = std::sqrt(fRadiusSquared);
+
+            // The cone opens around the average normal up to the normal
+            // furthest from it. A cutoff of 1 disables the test
+            meshlet.afConeAxis[0] = 0.0f;
+            meshlet.afConeAxis[1] = 0.0f;
+            meshlet.afConeAxis[2] = 0.0f;
+            meshlet.fConeCutoff = 1.0f;
+
+            float fSumLength = length(afNormalSum);
+            if (fSumLength <= 0.0f)
+            {
+                return;
+            }
+
+            float fMinDot = 1.0f;
+            for (std::size_t i = 0u; i < afNormals.size(); i += 3u)
+            {
+                float fDot = (afNormals[i] * afNormalSum[0] + afNormals[i + 1u] * afNormalSum[1]
+                    + afNormals[i + 2u] * afNormalSum[2]) / fSumLength;
+                fMinDot = (std::min)(fMinDot, fDot);
+            }
+
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                meshlet.afConeAxis[k] = afNormalSum[k] / fSumLength;
+            }
+
+            if (fMinDot > MIN_CONE_DOT)
+            {
+                meshlet.fConeCutoff = std::sqrt(1.0f - fMinDot * fMinDot);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshletBuilder::Build
+      Summary:  Grows meshlets one at a time from the first unassigned
+                triangle. Each step adds the neighbouring triangle that
+                brings the fewest new vertices, the one closest to the
+                meshlet on ties, until either limit is reached or the
+                meshlet has no neighbours left. Triangles are then
+                rewritten so every meshlet is a contiguous range, keeping
+                their original order inside a meshlet so the vertex
+                cache optimization of the mesh is mostly preserved
+      Args:     std::uint32_t* pIndices
+                  Triangle list, reordered in place
+                std::uint32_t uNumIndices
+                  Number of indices, a multiple of 3
+                const void* pPositions
+                  Vertices starting with a float3 position
+                std::uint32_t uStride
+                  Size of a vertex in bytes
+                std::uint32_t uNumVertices
+                  Number of vertices
+                std::vector<Meshlet>& aOutMeshlets
+                  Meshlets are appended here, their first index relative
+                  to pIndices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MeshletBuilder::Build(std::uint32_t* pIndices, std::uint32_t uNumIndices, const void* pPositions, std::uint32_t uStride,
+        std::uint32_t uNumVertices, std::vector<Meshlet>& aOutMeshlets)
+    {
+        std::uint32_t uNumTriangles = uNumIndices / 3u;
+        if (uNumTriangles == 0u || uNumVertices == 0u)
+        {
+            return;
+        }
+
+        // Vertex to triangle adjacency in compressed rows
+        std::vector<std::uint32_t> aAdjacencyOffsets(uNumVertices + 1u, 0u);
+        for (std::uint32_t i = 0u; i < uNumTriangles * 3u; ++i)
+        {
+            ++aAdjacencyOffsets[pIndices[i] + 1u];
+        }
+        for (std::uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            aAdjacencyOffsets[i + 1u] += aAdjacencyOffsets[i];
+        }
+
+        std::vector<std::uint32_t> aAdjacency(uNumTriangles * 3u);
+        {
+            std::vector<std::uint32_t> aFill(aAdjacencyOffsets.begin(), aAdjacencyOffsets.end() - 1);
+            for (std::uint32_t i = 0u; i < uNumTriangles * 3u; ++i)
+            {
+                aAdjacency[aFill[pIndices[i]]++] = i / 3u;
+            }
+        }
+
+        std::vector<float> afTriangleCenters(uNumTriangles * 3u);
+        for (std::uint32_t t = 0u; t < uNumTriangles; ++t)
+        {
+            for (std::uint32_t k = 0u; k < 3u; ++k)
+            {
+                afTriangleCenters[t * 3u + k] = (vertexPosition(pPositions, uStride, pIndices[t * 3u])[k]
+                    + vertexPosition(pPositions, uStride, pIndices[t * 3u + 1u])[k]
+                    + vertexPosition(pPositions, uStride, pIndices[t * 3u + 2u])[k]) / 3.0f;
+            }
+        }
+
+        std::vector<bool> abAssigned(uNumTriangles, false);
+        std::vector<std::uint32_t> aVertexMeshlet(uNumVertices, INVALID_INDEX);
+        std::vector<std::uint32_t> aCandidates;
+        std::vector<std::uint32_t> aTriangles;
+        std::vector<std::uint32_t> aReordered;
+        aReordered.reserve(uNumTriangles * 3u);
+
+        std::uint32_t uFirstMeshlet = static_cast<std::uint32_t>(aOutMeshlets.size());
+        std::uint32_t uMeshletId = 0u;
+
+        for (std::uint32_t uSeed = 0u; uSeed < uNumTriangles; ++uSeed)
+        {
+            if (abAssigned[uSeed])
+            {
+                continue;
+            }
+
+            std::uint32_t uNumMeshletVertices = 0u;
+            float afCentroidSum[3] = { 0.0f, 0.0f, 0.0f };
+
+            aCandidates.clear();
+            aTriangles.clear();
+
+            auto addTriangle = [&](std::uint32_t uTriangle)
+            {
+                abAssigned[uTriangle] = true;
+                aTriangles.push_back(uTriangle);
+
+                for (std::uint32_t k = 0u; k < 3u; ++k)
+                {
+                    std::uint32_t uVertex = pIndices[uTriangle * 3u + k];
+                    if (aVertexMeshlet[uVertex] == uMeshletId)
+                    {
+                        continue;
+                    }
+
+                    aVertexMeshlet[uVertex] = uMeshletId;
+                    ++uNumMeshletVertices;
+
+                    const float* pPosition = vertexPosition(pPositions, uStride, uVertex);
+                    afCentroidSum[0] += pPosition[0];
+                    afCentroidSum[1] += pPosition[1];
+                    afCentroidSum[2] += pPosition[2];
+
+                    for (std::uint32_t a = aAdjacencyOffsets[uVertex]; a < aAdjacencyOffsets[uVertex + 1u]; ++a)
+                    {
+                        if (!abAssigned[aAdjacency[a]])
+                        {
+                            aCandidates.push_back(aAdjacency[a]);
+                        }
+                    }
+                }
+            };
+
+            addTriangle(uSeed);
+
+            while (aTriangles.size() < MAX_TRIANGLES)
+            {
+                float afCentroid[3] = { afCentroidSum[0] / uNumMeshletVertices, afCentroidSum[1] / uNumMeshletVertices,
+                    afCentroidSum[2] / uNumMeshletVertices };
+
+                std::uint32_t uBest = INVALID_INDEX;
+                std::uint32_t uBestNewVertices = 4u;
+                float fBestDistance = (std::numeric_limits<float>::max)();
+
+                // Drop assigned candidates while scanning
+                std::size_t uKept = 0u;
+                for (std::size_t i = 0u; i < aCandidates.size(); ++i)
+                {
+                    std::uint32_t uTriangle = aCandidates[i];
+                    if (abAssigned[uTriangle])
+                    {
+                        continue;
+                    }
+                    aCandidates[uKept++] = uTriangle;
+
+                    std::uint32_t uNewVertices = 0u;
+                    for (std::uint32_t k = 0u; k < 3u; ++k)
+                    {
+                        uNewVertices += aVertexMeshlet[pIndices[uTriangle * 3u + k]] != uMeshletId ? 1u : 0u;
+                    }
+
+                    if (uNumMeshletVertices + uNewVertices > MAX_VERTICES || uNewVertices > uBestNewVertices)
+                    {
+                        continue;
+                    }
+
+                    float afOffset[3] = { afTriangleCenters[uTriangle * 3u] - afCentroid[0],
+                        afTriangleCenters[uTriangle * 3u + 1u] - afCentroid[1],
+                        afTriangleCenters[uTriangle * 3u + 2u] - afCentroid[2] };
+                    float fDistance = afOffset[0] * afOffset[0] + afOffset[1] * afOffset[1] + afOffset[2] * afOffset[2];
+
+                    if (uNewVertices < uBestNewVertices || fDistance < fBestDistance)
+                    {
+                        uBest = uTriangle;
+                        uBestNewVertices = uNewVertices;
+                        fBestDistance = fDistance;
+                    }
+                }
+                aCandidates.resize(uKept);
+
+                if (uBest == INVALID_INDEX)
+                {
+                    break;
+                }
+
+                addTriangle(uBest);
+            }
+
+            std::sort(aTriangles.begin(), aTriangles.end());
+
+            Meshlet meshlet = {};
+            meshlet.uFirstIndex = static_cast<std::uint32_t>(aReordered.size());
+            meshlet.uNumIndices = static_cast<std::uint32_t>(aTriangles.size()) * 3u;
+            meshlet.uNumVertices = uNumMeshletVertices;
+
+            for (std::uint32_t uTriangle : aTriangles)
+            {
+                aReordered.push_back(pIndices[uTriangle * 3u]);
+                aReordered.push_back(pIndices[uTriangle * 3u + 1u]);
+                aReordered.push_back(pIndices[uTriangle * 3u + 2u]);
+            }
+
+            aOutMeshlets.push_back(meshlet);
+            ++uMeshletId;
+        }
+
+        std::copy(aReordered.begin(), aReordered.end(), pIndices);
+
+        for (std::size_t i = uFirstMeshlet; i < aOutMeshlets.size(); ++i)
+        {
+            computeBounds(aOutMeshlets[i], pIndices, pPositions, uStride);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MeshletBuilder::Cull
+      Summary:  Rejects meshlets whose normal cone faces away from the
+                camera or whose bounding sphere is outside one of the
+                frustum planes, and merges the survivors that follow
+                each other in the index buffer into one range
+      Args:     const Meshlet* pMeshlets
+                  Meshlets of one mesh, in index buffer order
+                std::uint32_t uNumMeshlets
+                  Number of meshlets
+                const float* pObjectToClip
+                  World * view * projection matrix of the mesh
+                const float* pCameraPosition
+                  Camera position in object space
+                MeshletRange* pOutRanges
+                  Receives the ranges to draw, room for uNumMeshlets
+                MeshletCullStats* pStats
+                  Counters to accumulate into, can be nullptr
+      Returns:  std::uint32_t
+                  Number of ranges written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t MeshletBuilder::Cull(const Meshlet* pMeshlets, std::uint32_t uNumMeshlets, const float* pObjectToClip,
+        const float* pCameraPosition, MeshletRange* pOutRanges, MeshletCullStats* pStats)
+    {
+        // Gribb and Hartmann: with row vectors, clip = p * M, so each
+        // plane is a sum of columns of M. D3D clips z to [0, w]
+        auto column = [pObjectToClip](std::uint32_t uColumn, std::uint32_t uRow)
+        {
+            return pObjectToClip[uRow * 4u + uColumn];
+        };
+
+        float aafPlanes[6][4] = {};
+        for (std::uint32_t uRow = 0u; uRow < 4u; ++uRow)
+        {
+            aafPlanes[0][uRow] = column(3u, uRow) + column(0u, uRow);
+            aafPlanes[1][uRow] = column(3u, uRow) - column(0u, uRow);
+            aafPlanes[2][uRow] = column(3u, uRow) + column(1u, uRow);
+            aafPlanes[3][uRow] = column(3u, uRow) - column(1u, uRow);
+            aafPlanes[4][uRow] = column(2u, uRow);
+            aafPlanes[5][uRow] = column(3u, uRow) - column(2u, uRow);
+        }
+
+        for (float (&afPlane)[4] : aafPlanes)
+        {
+            float fLength = std::sqrt(afPlane[0] * afPlane[0] + afPlane[1] * afPlane[1] + afPlane[2] * afPlane[2]);
+            if (fLength > 0.0f)
+            {
+                for (float& f : afPlane)
+                {
+                    f /= fLength;
+                }
+            }
+        }
+
+        std::uint32_t uNumRanges = 0u;
+
+        for (std::uint32_t i = 0u; i < uNumMeshlets; ++i)
+        {
+            const Meshlet& meshlet = pMeshlets[i];
+
+            if (pStats)
+            {
+                ++pStats->uNumTested;
+            }
+
+            float afToCenter[3] = { meshlet.afCenter[0] - pCameraPosition[0], meshlet.afCenter[1] - pCameraPosition[1],
+                meshlet.afCenter[2] - pCameraPosition[2] };
+            float fDot = afToCenter[0] * meshlet.afConeAxis[0] + afToCenter[1] * meshlet.afConeAxis[1]
+                + afToCenter[2] * meshlet.afConeAxis[2];
+
+            if (fDot > meshlet.fConeCutoff * length(afToCenter) + meshlet.fRadius)
+            {
+                if (pStats)
+                {
+                    ++pStats->uNumBackfacing;
+                }
+                continue;
+            }
+
+            bool bOutside = false;
+            for (const float (&afPlane)[4] : aafPlanes)
+            {
+                float fDistance = afPlane[0] * meshlet.afCenter[0] + afPlane[1] * meshlet.afCenter[1]
+                    + afPlane[2] * meshlet.afCenter[2] + afPlane[3];
+                if (fDistance < -meshlet.fRadius)
+                {
+                    bOutside = true;
+                    break;
+                }
+            }
+
+            if (bOutside)
+            {
+                if (pStats)
+                {
+                    ++pStats->uNumOutsideFrustum;
+                }
+                continue;
+            }
+
+            if (uNumRanges > 0u
+                && pOutRanges[uNumRanges - 1u].uFirstIndex + pOutRanges[uNumRanges - 1u].uNumIndices == meshlet.uFirstIndex)
+            {
+                pOutRanges[uNumRanges - 1u].uNumIndices += meshlet.uNumIndices;
+            }
+            else
+            {
+                pOutRanges[uNumRanges++] = MeshletRange{ meshlet.uFirstIndex, meshlet.uNumIndices };
+            }
+        }
+
+        return uNumRanges;
+    }
+}
@@ -0,0 +1,90 @@
+/*+===================================================================
+  File:      MESHLETBUILDER.H
+  Summary:   MeshletBuilder header file contains declarations of
+             MeshletBuilder class used to split meshes into small
+             triangle clusters that can be culled on their own.
+  Classes: MeshletBuilder
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+// Matrices are 16 floats in DirectXMath memory layout (row-major, row
+// vectors)
+#include <cstdint>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Meshlet
+      Summary:  A cluster of triangles stored contiguously in the index
+                buffer of its mesh, with a bounding sphere and a normal
+                cone in object space. The cluster faces away from every
+                camera position p with
+                dot(afCenter - p, afConeAxis)
+                    > fConeCutoff * |afCenter - p| + fRadius
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Meshlet
+    {
+        std::uint32_t uFirstIndex;
+        std::uint32_t uNumIndices;
+        std::uint32_t uNumVertices;
+        float afCenter[3];
+        float fRadius;
+        float afConeAxis[3];
+        float fConeCutoff;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshletRange
+      Summary:  Range of indices to draw, merged from adjacent visible
+                meshlets
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshletRange
+    {
+        std::uint32_t uFirstIndex;
+        std::uint32_t uNumIndices;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MeshletCullStats
+      Summary:  Counters of culling passes, accumulated by Cull
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MeshletCullStats
+    {
+        std::uint32_t uNumTested;
+        std::uint32_t uNumBackfacing;
+        std::uint32_t uNumOutsideFrustum;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MeshletBuilder
+      Summary:  Builds meshlets of at most MAX_VERTICES vertices and
+                MAX_TRIANGLES triangles and culls them against a camera
+      Methods:  Build
+                  Groups the triangles of a mesh into meshlets
+                Cull
+                  Returns the index ranges of the meshlets that can be
+                  visible
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MeshletBuilder final
+    {
+    public:
+        static constexpr const std::uint32_t MAX_VERTICES = 64u;
+        static constexpr const std::uint32_t MAX_TRIANGLES = 124u;
+
+    public:
+        MeshletBuilder() = delete;
+        MeshletBuilder(const MeshletBuilder& other) = delete;
+        MeshletBuilder(MeshletBuilder&& other) = delete;
+        MeshletBuilder& operator=(const MeshletBuilder& other) = delete;
+        MeshletBuilder& operator=(MeshletBuilder&& other) = delete;
+        ~MeshletBuilder() = delete;
+
+        static void Build(std::uint32_t* pIndices, std::uint32_t uNumIndices, const void* pPositions, std::uint32_t uStride,
+            std::uint32_t uNumVertices, std::vector<Meshlet>& aOutMeshlets);
+
+        static std::uint32_t Cull(const Meshlet* pMeshlets, std::uint32_t uNumMeshlets, const float* pObjectToClip,
+            const float* pCameraPosition, MeshletRange* pOutRanges, MeshletCullStats* pStats = nullptr);
+    };
+}
@@ -6,18 +6,39 @@
 
 namespace library
 {
+    namespace
+    {
+        // Every level targets half the triangles of the previous one
+        // and gives up past 5% of the mesh extent
+        constexpr const FLOAT LOD_MAX_RELATIVE_ERROR = 0.05f;
+
+        // Levels that remove less than this share of the previous
+        // level's triangles are not worth an extra draw range
+        constexpr const FLOAT LOD_MIN_REDUCTION = 0.15f;
+
+        // Meshes below this are already cheap
+        constexpr const UINT LOD_MIN_TRIANGLES = 64u;
+
+        // Diffuse textures are what TextureArray packs, and it skips
+        // streamed textures, so they load their whole mip chain
+        constexpr const TextureLoadOptions DIFFUSE_LOAD_OPTIONS = { .uMaxSize = 0u, .bGenerateMips = TRUE, .bStream = FALSE };
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Model
       Summary:  Constructor
       Args:     const std::filesystem::path& filePath
                   Path to the model to load
-      Modifies: [m_filePath, m_aVertices, m_aIndices].
+      Modifies: [m_filePath, m_aVertices, m_aIndices, m_aIndexData,
+                 m_bLoaded].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Model::Model(_In_ const std::filesystem::path& filePath) :
         Renderable({ 1.0f, 1.0f, 1.0f, 1.0f }),
         m_filePath(filePath),
         m_aVertices(std::vector<SimpleVertex>()),
-        m_aIndices(std::vector<WORD>()),
+        m_aIndices(std::vector<UINT>()),
+        m_aIndexData(std::vector<BYTE>()),
+        m_bLoaded(FALSE),
         m_padding()
     {
     }
@@ -35,8 +56,61 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Model::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
+        HRESULT hr = Load();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = initMaterials(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        return initialize(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::Load
+      Summary:  Loads the meshes and materials of the model and queues
+                its texture decodes without touching the device, so it
+                can run on a worker thread. Initialize calls it if it
+                has not been called yet
+      Modifies: [m_aVertices, m_aIndices, m_aIndexData, m_aMeshes,
+                 m_aMaterials, m_aMeshlets, m_bLoaded].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::Load()
+    {
+        if (m_bLoaded)
+        {
+            return S_OK;
+        }
+
         HRESULT hr = S_OK;
 
+        // A baked mesh file is mapped and used as is, keeping Assimp off
+        // the startup path
+        if (MeshFile::IsUpToDate(m_filePath))
+        {
+            MeshFile meshFile;
+
+            hr = meshFile.Open(MeshFile::GetBakedPath(m_filePath));
+            if (SUCCEEDED(hr))
+            {
+                loadFromMeshFile(meshFile, m_filePath);
+                m_bLoaded = TRUE;
+
+                return S_OK;
+            }
+
+            OutputDebugString(L"Error opening baked mesh file of ");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L", importing the model instead\n");
+        }
+
         // Create the buffers for the vertices attributes
 
         Assimp::Importer importer;
@@ -45,7 +119,8 @@ namespace library
 
         if (pScene)
         {
-            hr = initFromScene(pDevice, pImmediateContext, pScene, m_filePath);
+            loadFromScene(pScene, m_filePath);
+            m_bLoaded = TRUE;
         }
         else
         {
@@ -60,6 +135,172 @@ namespace library
         return hr;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::Bake
+      Summary:  Imports the model file with Assimp, optimizes its meshes,
+                generates their levels of detail and writes the
+                vertices, indices, meshes and texture paths to its baked
+                mesh file. No Direct3D device is needed
+      Args:     BOOL bOptimizeOverdraw
+                  Whether to sort triangle clusters for overdraw after
+                  the vertex cache pass
+                VertexCacheStats* pStatsBefore
+                  Receives the vertex cache counters of the imported
+                  meshes, can be nullptr
+                VertexCacheStats* pStatsAfter
+                  Receives the vertex cache counters of the baked
+                  meshes, can be nullptr
+      Modifies: [m_aVertices, m_aIndices, m_aMeshes, m_aMaterials,
+                 m_aMeshlets].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::Bake(
+        _In_ BOOL bOptimizeOverdraw,
+        _Out_opt_ VertexCacheStats* pStatsBefore,
+        _Out_opt_ VertexCacheStats* pStatsAfter
+    )
+    {
+        Assimp::Importer importer;
+
+        const aiScene* pScene = importer.ReadFile(m_filePath.string().c_str(), ASSIMP_LOAD_FLAGS);
+
+        if (!pScene)
+        {
+            OutputDebugString(L"Error parsing ");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L": ");
+            OutputDebugStringA(importer.GetErrorString());
+            OutputDebugString(L"\n");
+
+            return E_FAIL;
+        }
+
+        UINT uNumVertices = 0u;
+        UINT uNumIndices = 0u;
+
+        countVerticesAndIndices(uNumVertices, uNumIndices, pScene);
+
+        allocateSpace(uNumVertices, uNumIndices);
+
+        initAllMeshes(pScene);
+
+        VertexCacheStats statsBefore = {};
+        VertexCacheStats statsAfter = {};
+
+        optimizeMeshes(bOptimizeOverdraw, statsBefore, statsAfter);
+
+        generateLods();
+
+        buildMeshlets();
+
+        if (pStatsBefore)
+        {
+            *pStatsBefore = statsBefore;
+        }
+
+        if (pStatsAfter)
+        {
+            *pStatsAfter = statsAfter;
+        }
+
+        std::vector<MeshFileMesh> aMeshes(m_aMeshes.size());
+
+        for (size_t i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            aMeshes[i] = MeshFileMesh
+            {
+                .uNumIndices = m_aMeshes[i].uNumIndices,
+                .uBaseVertex = m_aMeshes[i].uBaseVertex,
+                .uBaseIndex = m_aMeshes[i].uBaseIndex,
+                .uMaterialIndex = m_aMeshes[i].uMaterialIndex,
+                .uNumVertices = m_aMeshes[i].uNumVertices,
+                .uNumLods = m_aMeshes[i].uNumLods,
+                .uFirstMeshlet = m_aMeshes[i].uFirstMeshlet,
+                .uNumMeshlets = m_aMeshes[i].uNumMeshlets
+            };
+
+            for (UINT j = 0u; j < m_aMeshes[i].uNumLods; ++j)
+            {
+                aMeshes[i].aLods[j] = MeshFileLod
+                {
+                    .uNumIndices = m_aMeshes[i].aLods[j].uNumIndices,
+                    .uBaseIndex = m_aMeshes[i].aLods[j].uBaseIndex,
+                    .fError = m_aMeshes[i].aLods[j].fError
+                };
+            }
+        }
+
+        std::vector<MeshFileMaterial> aMaterials(pScene->mNumMaterials);
+
+        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
+        {
+            std::string szDiffuse = getTexturePath(pScene->mMaterials[i], aiTextureType_DIFFUSE);
+            std::string szSpecular = getTexturePath(pScene->mMaterials[i], aiTextureType_SHININESS);
+            std::string szNormal = getNormalTexturePath(pScene->mMaterials[i]);
+
+            if (strcpy_s(aMaterials[i].szDiffuse, szDiffuse.c_str()) != 0
+                || strcpy_s(aMaterials[i].szSpecular, szSpecular.c_str()) != 0
+                || strcpy_s(aMaterials[i].szNormal, szNormal.c_str()) != 0)
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        return MeshFile::Write(MeshFile::GetBakedPath(m_filePath),
+            m_aVertices.data(), static_cast<UINT>(m_aVertices.size()),
+            m_aIndices.data(), static_cast<UINT>(m_aIndices.size()),
+            aMeshes.data(), static_cast<UINT>(aMeshes.size()),
+            aMaterials.data(), static_cast<UINT>(aMaterials.size()),
+            m_aMeshlets.data(), static_cast<UINT>(m_aMeshlets.size()));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SwapGeometry
+      Summary:  Swaps the meshes, materials, meshlets and buffers with
+                another model of the same file, such as one reloaded on
+                a worker thread and initialized after its file changed.
+                The shaders, transform and world matrix stay, so the
+                model is drawn the same way with its new geometry
+      Args:     Model& other
+                  Initialized model to swap with
+      Modifies: [m_vertexBuffer, m_indexBuffer, m_aMeshes, m_aMaterials,
+                 m_aMeshlets, m_positionScale, m_positionBias,
+                 m_quantizationError, m_localBoundsMin,
+                 m_localBoundsMax, m_aVertices, m_aIndices,
+                 m_aIndexData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SwapGeometry(_Inout_ Model& other)
+    {
+        m_vertexBuffer.Swap(other.m_vertexBuffer);
+        m_indexBuffer.Swap(other.m_indexBuffer);
+
+        m_aMeshes.swap(other.m_aMeshes);
+        m_aMaterials.swap(other.m_aMaterials);
+        m_aMeshlets.swap(other.m_aMeshlets);
+
+        std::swap(m_positionScale, other.m_positionScale);
+        std::swap(m_positionBias, other.m_positionBias);
+        std::swap(m_quantizationError, other.m_quantizationError);
+        std::swap(m_localBoundsMin, other.m_localBoundsMin);
+        std::swap(m_localBoundsMax, other.m_localBoundsMax);
+
+        m_aVertices.swap(other.m_aVertices);
+        m_aIndices.swap(other.m_aIndices);
+        m_aIndexData.swap(other.m_aIndexData);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetFilePath
+      Summary:  Returns the path of the model file
+      Returns:  const std::filesystem::path&
+                  Path to the model file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Model::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Update
       Summary:  Updates the cube every frame
@@ -93,6 +334,35 @@ namespace library
         return static_cast<UINT>(m_aIndices.size());
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::RasterizeOccluder
+      Summary:  Rasterizes the coarsest level of detail of every mesh
+                into an occlusion culler, with its base vertex and
+                32-bit indices. Meshes without levels of detail are
+                rasterized in full
+      Args:     OcclusionCuller& occlusionCuller
+                  Culler to rasterize into
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::RasterizeOccluder(_Inout_ OcclusionCuller& occlusionCuller) const
+    {
+        XMFLOAT4X4 world;
+        XMStoreFloat4x4(&world, GetWorldMatrix());
+
+        for (const BasicMeshEntry& mesh : m_aMeshes)
+        {
+            UINT uBaseIndex = mesh.uBaseIndex;
+            UINT uNumIndices = mesh.uNumIndices;
+
+            if (mesh.uNumLods > 0u)
+            {
+                uBaseIndex = mesh.aLods[mesh.uNumLods - 1u].uBaseIndex;
+                uNumIndices = mesh.aLods[mesh.uNumLods - 1u].uNumIndices;
+            }
+
+            occlusionCuller.RasterizeMesh(&world.m[0][0], &m_aVertices[mesh.uBaseVertex].Position, sizeof(SimpleVertex),
+                mesh.uNumVertices, m_aIndices.data() + uBaseIndex, uNumIndices);
+        }
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::countVerticesAndIndices
@@ -116,6 +386,7 @@ namespace library
             m_aMeshes[i].uNumIndices = pScene->mMeshes[i]->mNumFaces * 3u;
             m_aMeshes[i].uBaseVertex = uOutNumVertices;
             m_aMeshes[i].uBaseIndex = uOutNumIndices;
+            m_aMeshes[i].uNumVertices = pScene->mMeshes[i]->mNumVertices;
 
             uOutNumVertices += pScene->mMeshes[i]->mNumVertices;
             uOutNumIndices += m_aMeshes[i].uNumIndices;
@@ -135,125 +406,302 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::getIndices
-      Summary:  Returns the indices data
+      Summary:  Returns the 16-bit indices data. Model indices are kept
+                in 32 bits and packed per mesh by packIndices, so there
+                is no single 16-bit array
       Returns:  const WORD*
-                  Array of indices
+                  nullptr
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     const WORD* Model::getIndices() const
     {
-        return m_aIndices.data();
+        return nullptr;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::getIndexData
+      Summary:  Returns the packed index buffer data
+      Returns:  const void*
+                  Indices of every mesh in its own format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* Model::getIndexData() const
+    {
+        return m_aIndexData.data();
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::getIndices
-      Summary:  Initialize all meshes in a given assimp scene
+      Method:   Model::getIndexDataSize
+      Summary:  Returns the size of the packed index buffer data
+      Returns:  UINT
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::getIndexDataSize() const
+    {
+        return static_cast<UINT>(m_aIndexData.size());
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::generateLods
+      Summary:  Simplifies every mesh into up to MAX_MESH_LODS levels,
+                each aiming at half the triangles of the previous one.
+                Every level is simplified from the full detail indices,
+                reordered for the vertex cache and appended to
+                m_aIndices, so the levels share the vertices and later
+                the index buffer of the mesh
+      Modifies: [m_aIndices, m_aMeshes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::generateLods()
+    {
+        std::vector<UINT> aLodIndices;
+
+        for (BasicMeshEntry& mesh : m_aMeshes)
+        {
+            mesh.uNumLods = 0u;
+
+            UINT uPreviousNumIndices = mesh.uNumIndices;
+            FLOAT fPreviousError = 0.0f;
+
+            aLodIndices.resize(mesh.uNumIndices);
+
+            for (UINT uLod = 0u; uLod < MAX_MESH_LODS; ++uLod)
+            {
+                UINT uTargetNumIndices = (mesh.uNumIndices >> (uLod + 1u)) / 3u * 3u;
+
+                if (uTargetNumIndices < LOD_MIN_TRIANGLES * 3u)
+                {
+                    break;
+                }
+
+                FLOAT fError = 0.0f;
+                UINT uNumIndices = MeshSimplifier::Simplify(aLodIndices.data(), m_aIndices.data() + mesh.uBaseIndex,
+                    mesh.uNumIndices, &m_aVertices[mesh.uBaseVertex], sizeof(SimpleVertex), mesh.uNumVertices,
+                    uTargetNumIndices, LOD_MAX_RELATIVE_ERROR, &fError);
+
+                if (uNumIndices == 0u
+                    || static_cast<FLOAT>(uNumIndices) > static_cast<FLOAT>(uPreviousNumIndices) * (1.0f - LOD_MIN_REDUCTION))
+                {
+                    break;
+                }
+
+                MeshOptimizer::OptimizeVertexCache(aLodIndices.data(), uNumIndices, mesh.uNumVertices);
+
+                // Selection walks the levels until the error is too large,
+                // so the errors must not decrease
+                fPreviousError = (std::max)(fError, fPreviousError);
+
+                mesh.aLods[mesh.uNumLods++] = MeshLod
+                {
+                    .uNumIndices = uNumIndices,
+                    .uBaseIndex = static_cast<UINT>(m_aIndices.size()),
+                    .uIndexOffset = 0u,
+                    .fError = fPreviousError
+                };
+
+                m_aIndices.insert(m_aIndices.end(), aLodIndices.begin(), aLodIndices.begin() + uNumIndices);
+                uPreviousNumIndices = uNumIndices;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::buildMeshlets
+      Summary:  Splits the full detail indices of every mesh into
+                meshlets. The triangles of each mesh are reordered so
+                its meshlets are contiguous ranges of its indices
+      Modifies: [m_aIndices, m_aMeshes, m_aMeshlets].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::buildMeshlets()
+    {
+        m_aMeshlets.clear();
+
+        for (BasicMeshEntry& mesh : m_aMeshes)
+        {
+            mesh.uFirstMeshlet = static_cast<UINT>(m_aMeshlets.size());
+
+            MeshletBuilder::Build(m_aIndices.data() + mesh.uBaseIndex, mesh.uNumIndices, &m_aVertices[mesh.uBaseVertex].Position,
+                sizeof(SimpleVertex), mesh.uNumVertices, m_aMeshlets);
+
+            mesh.uNumMeshlets = static_cast<UINT>(m_aMeshlets.size()) - mesh.uFirstMeshlet;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initAllMeshes
+      Summary:  Initialize all meshes in a given assimp scene. The
+                vectors are already sized by allocateSpace and every
+                mesh owns the ranges countVerticesAndIndices gave it, so
+                the meshes are converted in parallel without locking
       Args:     const aiScene* pScene
                   Assimp scene
+      Modifies: [m_aVertices, m_aIndices].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Model::initAllMeshes(_In_ const aiScene* pScene)
     {
-        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        ThreadPool::GetShared().ParallelFor(static_cast<UINT>(m_aMeshes.size()), [this, pScene](UINT i)
+            {
+                initSingleMesh(pScene->mMeshes[i], m_aMeshes[i]);
+            });
+    }
+
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::loadFromMeshFile
+      Summary:  Loads the model from a mapped baked mesh file
+      Args:     const MeshFile& meshFile
+                  Opened baked mesh file
+                const std::filesystem::path& filePath
+                  Path to the model
+
+      Modifies: [m_aVertices, m_aIndices, m_aMeshes, m_aMaterials,
+                 m_aMeshlets].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::loadFromMeshFile(
+        _In_ const MeshFile& meshFile,
+        _In_ const std::filesystem::path& filePath
+    )
+    {
+        const MeshFileHeader& header = meshFile.GetHeader();
+
+        // The texture paths are known up front, so their decodes run on
+        // the thread pool while the mesh data is copied and packed
+        std::filesystem::path parentDirectory = filePath.parent_path();
+
+        m_aMaterials.resize(header.uNumMaterials);
+
+        for (UINT i = 0u; i < header.uNumMaterials; ++i)
         {
-            const aiMesh* pMesh = pScene->mMeshes[i];
-            initSingleMesh(pMesh);
+            const MeshFileMaterial& material = meshFile.GetMaterials()[i];
+
+            requestTextures(parentDirectory, i, material.szDiffuse, material.szSpecular, material.szNormal);
         }
-    }
 
+        m_aVertices.assign(meshFile.GetVertices(), meshFile.GetVertices() + header.uNumVertices);
+        m_aIndices.assign(meshFile.GetIndices(), meshFile.GetIndices() + header.uNumIndices);
+        m_aMeshlets.assign(meshFile.GetMeshlets(), meshFile.GetMeshlets() + header.uNumMeshlets);
+
+        m_aMeshes.resize(header.uNumMeshes);
+
+        for (UINT i = 0u; i < header.uNumMeshes; ++i)
+        {
+            const MeshFileMesh& mesh = meshFile.GetMeshes()[i];
+
+            m_aMeshes[i].uNumIndices = mesh.uNumIndices;
+            m_aMeshes[i].uBaseVertex = mesh.uBaseVertex;
+            m_aMeshes[i].uBaseIndex = mesh.uBaseIndex;
+            m_aMeshes[i].uMaterialIndex = mesh.uMaterialIndex;
+            m_aMeshes[i].uNumVertices = mesh.uNumVertices;
+            m_aMeshes[i].uNumLods = mesh.uNumLods;
+
+            m_aMeshes[i].uFirstMeshlet = mesh.uFirstMeshlet;
+            m_aMeshes[i].uNumMeshlets = mesh.uNumMeshlets;
+
+            for (UINT j = 0u; j < mesh.uNumLods; ++j)
+            {
+                m_aMeshes[i].aLods[j] = MeshLod
+                {
+                    .uNumIndices = mesh.aLods[j].uNumIndices,
+                    .uBaseIndex = mesh.aLods[j].uBaseIndex,
+                    .uIndexOffset = 0u,
+                    .fError = mesh.aLods[j].fError
+                };
+            }
+        }
+
+        packIndices();
+    }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::initFromScene
-      Summary:  Initialize all meshes in a given assimp scene
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const aiScene* pScene
+      Method:   Model::loadFromScene
+      Summary:  Loads all meshes in a given assimp scene
+      Args:     const aiScene* pScene
                   Assimp scene
                 const std::filesystem::path& filePath
                   Path to the model
-
-      Returns:  HRESULT
-                  Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::initFromScene(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
+    void Model::loadFromScene(
         _In_ const aiScene* pScene,
         _In_ const std::filesystem::path& filePath
     ) {
 
-        HRESULT hr = S_OK;
-
         UINT uNumVertices = 0u;
         UINT uNumIndices = 0u;
 
         countVerticesAndIndices(uNumVertices, uNumIndices, pScene);
 
-        reserveSpace(uNumVertices, uNumIndices);
+        // Start the texture decodes before the mesh conversion
+        requestMaterialTextures(pScene, filePath);
+
+        allocateSpace(uNumVertices, uNumIndices);
 
         initAllMeshes(pScene);
 
-        hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
-        if (FAILED(hr))
-            return hr;
+        generateLods();
 
-        hr = initialize(pDevice, pImmediateContext);
-        if (FAILED(hr))
-            return hr;
+        buildMeshlets();
 
-        return S_OK;
+        packIndices();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initMaterials
-      Summary:  Initialize all materials in a given assimp scene
+      Summary:  Creates the requested textures of every material on the
+                device thread, waiting for their decodes as needed.
+                Texture errors are reported but not fatal: the material
+                is left without that texture
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
-                const aiScene* pScene
-                  Assimp scene
-                const std::filesystem::path& filePath
-                  Path to the model
-
+      Modifies: [m_aMaterials].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Model::initMaterials(
         _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const aiScene* pScene,
-        _In_ const std::filesystem::path& filePath
+        _In_ ID3D11DeviceContext* pImmediateContext
     )
     {
-        HRESULT hr = S_OK;
-
-        // Extract the directory part from the file name
-        std::filesystem::path parentDirectory = filePath.parent_path();
-
-        // Initialize the materials
-        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
+        for (Material& material : m_aMaterials)
         {
-            const aiMaterial* pMaterial = pScene->mMaterials[i];
+            for (std::shared_ptr<Texture>* ppTexture : { &material.pDiffuse, &material.pSpecular, &material.pNormal })
+            {
+                if (!*ppTexture)
+                {
+                    continue;
+                }
+
+                if (FAILED((*ppTexture)->Initialize(pDevice, pImmediateContext)))
+                {
+                    OutputDebugString(L"Error loading texture \"");
+                    OutputDebugString((*ppTexture)->GetFilePath().c_str());
+                    OutputDebugString(L"\"\n");
 
-            loadTextures(pDevice, pImmediateContext, parentDirectory, pMaterial, i);
+                    ppTexture->reset();
+                }
+            }
         }
 
-        return hr;
+        return S_OK;
     }
 
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initSingleMesh
-      Summary:  Initialize single mesh from a given assimp mesh
+      Summary:  Initialize single mesh from a given assimp mesh, writing
+                its vertices and indices at the mesh's base vertex and
+                base index
       Args:     const aiMesh* pMesh
                   Point to an assimp mesh object
+                const BasicMeshEntry& mesh
+                  Entry of the mesh with its ranges
+      Modifies: [m_aVertices, m_aIndices].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::initSingleMesh(_In_ const aiMesh* pMesh) {
+    void Model::initSingleMesh(_In_ const aiMesh* pMesh, _In_ const BasicMeshEntry& mesh) {
 
         const aiVector3D zero3d(0.0f, 0.0f, 0.0f);
 
+        SimpleVertex* pVertices = m_aVertices.data() + mesh.uBaseVertex;
+        UINT* pIndices = m_aIndices.data() + mesh.uBaseIndex;
+
         // Populate the vertex attribute vectors
         for (UINT i = 0u; i < pMesh->mNumVertices; ++i)
         {
@@ -263,14 +711,12 @@ namespace library
                 pMesh->HasTextureCoords(0u) ?
                 pMesh->mTextureCoords[0][i] : zero3d;
 
-            m_aVertices.push_back(
-                SimpleVertex
-                {
-                    .Position = XMFLOAT3(position.x, position.y, position.z),
-                    .TexCoord = XMFLOAT2(texCoord.x, texCoord.y),
-                    .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
-                }
-            );
+            pVertices[i] = SimpleVertex
+            {
+                .Position = XMFLOAT3(position.x, position.y, position.z),
+                .TexCoord = XMFLOAT2(texCoord.x, texCoord.y),
+                .Normal = XMFLOAT3(normal.x, normal.y, normal.z)
+            };
         }
 
         // Populate the index buffer 
@@ -279,103 +725,130 @@ namespace library
             const aiFace& face = pMesh->mFaces[i];
             assert(face.mNumIndices == 3u);
 
-            m_aIndices.push_back(static_cast<WORD>(face.mIndices[0]));
-            m_aIndices.push_back(static_cast<WORD>(face.mIndices[1]));
-            m_aIndices.push_back(static_cast<WORD>(face.mIndices[2]));
+            pIndices[i * 3u] = face.mIndices[0];
+            pIndices[i * 3u + 1u] = face.mIndices[1];
+            pIndices[i * 3u + 2u] = face.mIndices[2];
         }
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::loadDiffuseTexture
-      Summary:  Load a diffuse texture from given path
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
-                  Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
+      Method:   Model::optimizeMeshes
+      Summary:  Reorders the triangles of every mesh for the vertex
+                cache, optionally for overdraw, and then its vertices
+                for fetch locality. Each mesh keeps its vertex and index
+                ranges
+      Args:     BOOL bOptimizeOverdraw
+                  Whether to sort triangle clusters for overdraw
+                VertexCacheStats& statsBefore
+                  Accumulates the counters before optimizing
+                VertexCacheStats& statsAfter
+                  Accumulates the counters after optimizing
+      Modifies: [m_aVertices, m_aIndices].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadDiffuseTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
+    void Model::optimizeMeshes(
+        _In_ BOOL bOptimizeOverdraw,
+        _Inout_ VertexCacheStats& statsBefore,
+        _Inout_ VertexCacheStats& statsAfter
     )
     {
-        HRESULT hr = S_OK;
-        m_aMaterials[uIndex].pDiffuse = nullptr;
-
-        if (pMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        for (const BasicMeshEntry& mesh : m_aMeshes)
         {
-            aiString aiPath;
+            UINT* pIndices = m_aIndices.data() + mesh.uBaseIndex;
+            SimpleVertex* pVertices = m_aVertices.data() + mesh.uBaseVertex;
+
+            MeshOptimizer::AnalyzeVertexCache(pIndices, mesh.uNumIndices, mesh.uNumVertices,
+                MeshOptimizer::DEFAULT_CACHE_SIZE, statsBefore);
+
+            MeshOptimizer::OptimizeVertexCache(pIndices, mesh.uNumIndices, mesh.uNumVertices);
 
-            if (pMaterial->GetTexture(aiTextureType_DIFFUSE, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
+            if (bOptimizeOverdraw)
             {
-                std::string szPath(aiPath.data);
+                MeshOptimizer::OptimizeOverdraw(pIndices, mesh.uNumIndices, &pVertices->Position, sizeof(SimpleVertex),
+                    mesh.uNumVertices);
+            }
 
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
+            MeshOptimizer::OptimizeVertexFetch(pVertices, sizeof(SimpleVertex), mesh.uNumVertices, pIndices, mesh.uNumIndices);
 
-                std::filesystem::path fullPath = parentDirectory / szPath;
+            MeshOptimizer::AnalyzeVertexCache(pIndices, mesh.uNumIndices, mesh.uNumVertices,
+                MeshOptimizer::DEFAULT_CACHE_SIZE, statsAfter);
+        }
+    }
 
-                m_aMaterials[uIndex].pDiffuse = std::make_shared<Texture>(fullPath);
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::packIndices
+      Summary:  Builds the index buffer data. Indices are relative to
+                the mesh's base vertex, so a mesh whose vertices fit in
+                16 bits is stored as WORD and only larger meshes pay
+                for 32-bit indices. The levels of detail of a mesh
+                follow it in the same format
+      Modifies: [m_aMeshes, m_aIndexData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::packIndices()
+    {
+        m_aIndexData.clear();
 
-                hr = m_aMaterials[uIndex].pDiffuse->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
+        auto pack = [this](DXGI_FORMAT indexFormat, UINT uBaseIndex, UINT uNumIndices)
+            {
+                const UINT* pIndices = m_aIndices.data() + uBaseIndex;
+                UINT uOffset = 0u;
+
+                if (indexFormat == DXGI_FORMAT_R16_UINT)
                 {
-                    OutputDebugString(L"Error loading diffuse texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
+                    uOffset = static_cast<UINT>(m_aIndexData.size());
+
+                    m_aIndexData.resize(uOffset + sizeof(WORD) * uNumIndices);
+                    WORD* pPacked = reinterpret_cast<WORD*>(m_aIndexData.data() + uOffset);
+
+                    for (UINT i = 0u; i < uNumIndices; ++i)
+                    {
+                        pPacked[i] = static_cast<WORD>(pIndices[i]);
+                    }
+                }
+                else
+                {
+                    // IASetIndexBuffer needs the offset aligned to the index size
+                    uOffset = (static_cast<UINT>(m_aIndexData.size()) + 3u) & ~3u;
 
-                    return hr;
+                    m_aIndexData.resize(uOffset + sizeof(UINT) * uNumIndices);
+                    memcpy(m_aIndexData.data() + uOffset, pIndices, sizeof(UINT) * uNumIndices);
                 }
 
-                OutputDebugString(L"Loaded diffuse texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
+                return uOffset;
+            };
+
+        for (BasicMeshEntry& mesh : m_aMeshes)
+        {
+            mesh.indexFormat = mesh.uNumVertices <= 0x10000u ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+            mesh.uIndexOffset = pack(mesh.indexFormat, mesh.uBaseIndex, mesh.uNumIndices);
+
+            for (UINT i = 0u; i < mesh.uNumLods; ++i)
+            {
+                mesh.aLods[i].uIndexOffset = pack(mesh.indexFormat, mesh.aLods[i].uBaseIndex, mesh.aLods[i].uNumIndices);
             }
         }
-
-        return hr;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::loadSpecularTexture
-      Summary:  Load a specular texture from given path
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
-                  Parent path to the model
-                const aiMaterial* pMaterial
+      Method:   Model::getTexturePath
+      Summary:  Returns the path of the first texture of a given type,
+                relative to the model's directory
+      Args:     const aiMaterial* pMaterial
                   Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
+                UINT uTextureType
+                  Assimp texture type
+      Returns:  std::string
+                  Relative path, empty if the material has no texture
+                  of the type
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadSpecularTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
+    std::string Model::getTexturePath(_In_ const aiMaterial* pMaterial, _In_ UINT uTextureType)
     {
-        HRESULT hr = S_OK;
-        m_aMaterials[uIndex].pSpecular = nullptr;
+        aiTextureType textureType = static_cast<aiTextureType>(uTextureType);
 
-        if (pMaterial->GetTextureCount(aiTextureType_SHININESS) > 0)
+        if (pMaterial->GetTextureCount(textureType) > 0)
         {
             aiString aiPath;
 
-            if (pMaterial->GetTexture(aiTextureType_SHININESS, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
+            if (pMaterial->GetTexture(textureType, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
             {
                 std::string szPath(aiPath.data);
 
@@ -384,76 +857,115 @@ namespace library
                     szPath = szPath.substr(2ull, szPath.size() - 2ull);
                 }
 
-                std::filesystem::path fullPath = parentDirectory / szPath;
-
-                m_aMaterials[uIndex].pSpecular = std::make_shared<Texture>(fullPath);
-
-                hr = m_aMaterials[uIndex].pSpecular->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading specular texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
-
-                    return hr;
-                }
-
-                OutputDebugString(L"Loaded specular texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
+                return szPath;
             }
         }
 
-        return hr;
+        return std::string();
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::loadTextures
-      Summary:  Load a specular texture from given path
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
-                  Parent path to the model
-                const aiMaterial* pMaterial
+      Method:   Model::getNormalTexturePath
+      Summary:  Returns the path of the normal map of a material. OBJ
+                files list normal maps as bump maps, which assimp
+                imports as height maps, so those are used when the
+                material has no normal texture
+      Args:     const aiMaterial* pMaterial
                   Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
+      Returns:  std::string
+                  Relative path, empty if the material has no normal
+                  map
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadTextures(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
+    std::string Model::getNormalTexturePath(_In_ const aiMaterial* pMaterial)
     {
-        HRESULT hr = loadDiffuseTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
-        if (FAILED(hr))
+        std::string szPath = getTexturePath(pMaterial, aiTextureType_NORMALS);
+
+        if (szPath.empty())
         {
-            return hr;
+            szPath = getTexturePath(pMaterial, aiTextureType_HEIGHT);
         }
 
-        hr = loadSpecularTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
-        if (FAILED(hr))
+        return szPath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::requestMaterialTextures
+      Summary:  Requests the textures of every material in a given
+                assimp scene
+      Args:     const aiScene* pScene
+                  Assimp scene
+                const std::filesystem::path& filePath
+                  Path to the model
+      Modifies: [m_aMaterials].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::requestMaterialTextures(_In_ const aiScene* pScene, _In_ const std::filesystem::path& filePath)
+    {
+        // Extract the directory part from the file name
+        std::filesystem::path parentDirectory = filePath.parent_path();
+
+        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
         {
-            return hr;
+            const aiMaterial* pMaterial = pScene->mMaterials[i];
+
+            requestTextures(parentDirectory, i, getTexturePath(pMaterial, aiTextureType_DIFFUSE),
+                getTexturePath(pMaterial, aiTextureType_SHININESS), getNormalTexturePath(pMaterial));
         }
+    }
 
-        return hr;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::requestTextures
+      Summary:  Takes the textures of a material from the shared texture
+                cache, so materials referencing the same file share one
+                texture. New textures start decoding on the thread pool
+                at once; initMaterials creates them later. Diffuse
+                textures are not streamed so they can be packed into
+                texture arrays
+      Args:     const std::filesystem::path& parentDirectory
+                  Parent path to the model
+                UINT uIndex
+                  Index to a material
+                const std::string& szDiffuse
+                  Diffuse texture path relative to the model, empty for
+                  none
+                const std::string& szSpecular
+                  Specular texture path relative to the model, empty for
+                  none
+                const std::string& szNormal
+                  Normal map path relative to the model, empty for none
+      Modifies: [m_aMaterials].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::requestTextures(
+        _In_ const std::filesystem::path& parentDirectory,
+        _In_ UINT uIndex,
+        _In_ const std::string& szDiffuse,
+        _In_ const std::string& szSpecular,
+        _In_ const std::string& szNormal
+    )
+    {
+        TextureCache& textureCache = TextureCache::GetShared();
+
+        m_aMaterials[uIndex].pDiffuse = szDiffuse.empty()
+            ? nullptr : textureCache.RequestTexture(parentDirectory / szDiffuse, DIFFUSE_LOAD_OPTIONS);
+        m_aMaterials[uIndex].pSpecular = szSpecular.empty()
+            ? nullptr : textureCache.RequestTexture(parentDirectory / szSpecular, TextureLoadOptions());
+        m_aMaterials[uIndex].pNormal = szNormal.empty()
+            ? nullptr : textureCache.RequestTexture(parentDirectory / szNormal, TextureLoadOptions());
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::reserveSpace
-      Summary:  Reserve space for vertices and indices vectors
+      Method:   Model::allocateSpace
+      Summary:  Sizes the vertices and indices vectors once for every
+                mesh, so they can be written in place
       Args:     UINT uNumVertices
                   Number of vertices
                 UINT uNumIndices
                   Number of indices
+      Modifies: [m_aVertices, m_aIndices].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void Model::reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices) {
-        m_aVertices.reserve(uNumVertices);
-        m_aIndices.reserve(uNumIndices);
+    void Model::allocateSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices) {
+        m_aVertices.clear();
+        m_aIndices.clear();
+        m_aVertices.resize(uNumVertices);
+        m_aIndices.resize(uNumIndices);
     }
 }
\ No newline at end of file
@@ -10,11 +10,17 @@
 
 #include "Common.h"
 
+#include "Model/MeshFile.h"
+#include "Model/MeshOptimizer.h"
+#include "Model/MeshSimplifier.h"
+#include "Model/MeshletBuilder.h"
 #include "Renderer/DataTypes.h"
 #include "Renderer/Renderable.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
+#include "Texture/TextureCache.h"
+#include "Thread/ThreadPool.h"
 
 struct aiScene;
 struct aiMesh;
@@ -30,6 +36,12 @@ namespace library
                 Update
                   Pure virtual function that updates the object each
                   frame
+                Load
+                  Loads the model without the device
+                Bake
+                  Imports and optimizes the model file, generates its
+                  levels of detail and meshlets and writes its baked
+                  mesh file
                 GetVertexBuffer
                   Returns the vertex buffer
                 GetIndexBuffer
@@ -44,6 +56,12 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                RasterizeOccluder
+                  Rasterizes the meshes into an occlusion culler
+                SwapGeometry
+                  Swaps the geometry with a reloaded model
+                GetFilePath
+                  Returns the path of the model file
                 Model
                   Constructor.
                 ~Model
@@ -62,58 +80,70 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         virtual void Update(_In_ FLOAT deltaTime) override;
+        HRESULT Load();
+        HRESULT Bake(
+            _In_ BOOL bOptimizeOverdraw = TRUE,
+            _Out_opt_ VertexCacheStats* pStatsBefore = nullptr,
+            _Out_opt_ VertexCacheStats* pStatsAfter = nullptr
+        );
 
         virtual UINT GetNumVertices() const override;
         virtual UINT GetNumIndices() const override;
 
+        virtual void RasterizeOccluder(_Inout_ OcclusionCuller& occlusionCuller) const override;
+
+        void SwapGeometry(_Inout_ Model& other);
+        const std::filesystem::path& GetFilePath() const;
+
     protected:
         void countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene);
         const virtual SimpleVertex* getVertices() const override;
         virtual const WORD* getIndices() const override;
+        virtual const void* getIndexData() const override;
+        virtual UINT getIndexDataSize() const override;
         void initAllMeshes(_In_ const aiScene* pScene);
-        HRESULT initFromScene(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const aiScene* pScene,
+        void generateLods();
+        void buildMeshlets();
+        void loadFromMeshFile(
+            _In_ const MeshFile& meshFile,
             _In_ const std::filesystem::path& filePath
         );
-        HRESULT initMaterials(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
+        void loadFromScene(
             _In_ const aiScene* pScene,
             _In_ const std::filesystem::path& filePath
         );
-        void initSingleMesh(_In_ const aiMesh* pMesh);
-        void loadColors(_In_ const aiMaterial* pMaterial, _In_ UINT uIndex);
-        HRESULT loadDiffuseTexture(
+        HRESULT initMaterials(
             _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
+            _In_ ID3D11DeviceContext* pImmediateContext
         );
-        HRESULT loadSpecularTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
+        void initSingleMesh(_In_ const aiMesh* pMesh, _In_ const BasicMeshEntry& mesh);
+        void loadColors(_In_ const aiMaterial* pMaterial, _In_ UINT uIndex);
+        static std::string getTexturePath(_In_ const aiMaterial* pMaterial, _In_ UINT uTextureType);
+        static std::string getNormalTexturePath(_In_ const aiMaterial* pMaterial);
+        void optimizeMeshes(
+            _In_ BOOL bOptimizeOverdraw,
+            _Inout_ VertexCacheStats& statsBefore,
+            _Inout_ VertexCacheStats& statsAfter
         );
-        HRESULT loadTextures(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
+        void packIndices();
+        void requestMaterialTextures(_In_ const aiScene* pScene, _In_ const std::filesystem::path& filePath);
+        void requestTextures(
             _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
+            _In_ UINT uIndex,
+            _In_ const std::string& szDiffuse,
+            _In_ const std::string& szSpecular,
+            _In_ const std::string& szNormal
         );
-        void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
+        void allocateSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
 
     protected:
         std::filesystem::path m_filePath;
 
         std::vector<SimpleVertex> m_aVertices;
-        std::vector<WORD> m_aIndices;
+        std::vector<UINT> m_aIndices;
+        std::vector<BYTE> m_aIndexData;
 
-        BYTE m_padding[8];
+        BOOL m_bLoaded;
+        BYTE m_padding[4];
     };
 }
\ No newline at end of file
@@ -2,10 +2,15 @@
 
 #include "Common.h"
 
+// Size of the light arrays, passed to the shaders as MAX_LIGHTS
 #ifndef NUM_LIGHTS
 #define NUM_LIGHTS (2)
 #endif
 
+#ifndef MAX_MESH_LODS
+#define MAX_MESH_LODS (3)
+#endif
+
 namespace library
 {
     /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
@@ -20,6 +25,32 @@ namespace library
         XMFLOAT3 Normal;
     };
 
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CompactVertex
+      Summary:  16-byte quantized form of SimpleVertex. Position is
+                UNORM16 relative to the bounds of the vertex buffer with
+                W fixed at 1, Normal is SNORM16 octahedral encoded and
+                TexCoord is half precision
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CompactVertex
+    {
+        UINT16 Position[4];
+        INT16 Normal[2];
+        UINT16 TexCoord[2];
+    };
+
+    static_assert(sizeof(CompactVertex) == 16u);
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+        Enum:     eVertexFormat
+        Summary:  Enumeration of vertex buffer formats
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eVertexFormat : BYTE
+    {
+        SIMPLE,
+        COMPACT,
+    };
+
     /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
       Struct:   InstanceData
       Summary:  Instance data containing a per instance transformation
@@ -51,12 +82,16 @@ namespace library
 
     /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
       Struct:   CBChangesEveryFrame
-      Summary:  Constant buffer containing world matrix
+      Summary:  Constant buffer containing world matrix. Position scale
+                and bias decode CompactVertex positions and are 1 and 0
+                for SimpleVertex
     S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
     struct CBChangesEveryFrame
     {
         XMMATRIX World;
         XMFLOAT4 OutputColor;
+        XMFLOAT4 PositionScale;
+        XMFLOAT4 PositionBias;
     };
 
     /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
@@ -68,4 +103,14 @@ namespace library
         XMFLOAT4 LightPositions[NUM_LIGHTS];
         XMFLOAT4 LightColors[NUM_LIGHTS];
     };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   CBTextureSlice
+      Summary:  Constant buffer containing the slice of the texture
+                array a draw samples
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct CBTextureSlice
+    {
+        UINT TextureSlice;
+    };
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "Renderer/DrawCommandList.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawCommandList::DrawCommandList
+      Summary:  Constructor
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DrawCommandList::DrawCommandList() :
+        m_aCommands()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawCommandList::Reset
+      Summary:  Removes all commands, keeping the memory for the next
+                frame
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DrawCommandList::Reset()
+    {
+        m_aCommands.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawCommandList::Add
+      Summary:  Appends a command
+      Args:     const DrawCommand& command
+                  Command to append
+      Modifies: [m_aCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DrawCommandList::Add(_In_ const DrawCommand& command)
+    {
+        m_aCommands.push_back(command);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawCommandList::Execute
+      Summary:  Replays the commands in order. Buffers, shaders and views
+                that match the previous command are not bound again.
+                The texture slice is bound as a range of the slice
+                constant buffer, so draws from one texture array only
+                differ by that range. Slice 0 is at the start of the
+                buffer and is bound whole; other slices need Direct3D
+                11.1. Every command is a single instance starting at 0
+      Args:     ID3D11DeviceContext* pContext
+                  Context to replay onto
+                ID3D11DeviceContext1* pContext1
+                  Same context as Direct3D 11.1 interface. Required when
+                  a command binds a constant buffer range or a texture
+                  slice other than 0
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DrawCommandList::Execute(_In_ ID3D11DeviceContext* pContext, _In_opt_ ID3D11DeviceContext1* pContext1) const
+    {
+        const DrawCommand* pPrevious = nullptr;
+
+        for (const DrawCommand& command : m_aCommands)
+        {
+            if (!pPrevious || pPrevious->pVertexBuffer != command.pVertexBuffer || pPrevious->uStride != command.uStride)
+            {
+                UINT uOffset = 0u;
+                pContext->IASetVertexBuffers(0u, 1u, &command.pVertexBuffer, &command.uStride, &uOffset);
+            }
+
+            if (!pPrevious || pPrevious->pIndexBuffer != command.pIndexBuffer
+                || pPrevious->indexFormat != command.indexFormat || pPrevious->uIndexOffset != command.uIndexOffset)
+            {
+                pContext->IASetIndexBuffer(command.pIndexBuffer, command.indexFormat, command.uIndexOffset);
+            }
+
+            if (!pPrevious || pPrevious->pInputLayout != command.pInputLayout)
+            {
+                pContext->IASetInputLayout(command.pInputLayout);
+            }
+
+            if (!pPrevious || pPrevious->pVertexShader != command.pVertexShader)
+            {
+                pContext->VSSetShader(command.pVertexShader, nullptr, 0u);
+            }
+
+            if (!pPrevious || pPrevious->pPixelShader != command.pPixelShader)
+            {
+                pContext->PSSetShader(command.pPixelShader, nullptr, 0u);
+            }
+
+            if (!pPrevious || pPrevious->pConstantBuffer != command.pConstantBuffer
+                || pPrevious->uFirstConstant != command.uFirstConstant || pPrevious->uNumConstants != command.uNumConstants)
+            {
+                if (command.uNumConstants > 0u)
+                {
+                    assert(pContext1);
+                    pContext1->VSSetConstantBuffers1(2u, 1u, &command.pConstantBuffer, &command.uFirstConstant, &command.uNumConstants);
+                    pContext1->PSSetConstantBuffers1(2u, 1u, &command.pConstantBuffer, &command.uFirstConstant, &command.uNumConstants);
+                }
+                else
+                {
+                    pContext->VSSetConstantBuffers(2u, 1u, &command.pConstantBuffer);
+                    pContext->PSSetConstantBuffers(2u, 1u, &command.pConstantBuffer);
+                }
+            }
+
+            if (command.pShaderResourceView
+                && (!pPrevious || pPrevious->pShaderResourceView != command.pShaderResourceView))
+            {
+                pContext->PSSetShaderResources(0u, 1u, &command.pShaderResourceView);
+            }
+
+            if (command.pSamplerState && (!pPrevious || pPrevious->pSamplerState != command.pSamplerState))
+            {
+                pContext->PSSetSamplers(0u, 1u, &command.pSamplerState);
+            }
+
+            if (command.pNormalResourceView
+                && (!pPrevious || pPrevious->pNormalResourceView != command.pNormalResourceView))
+            {
+                pContext->PSSetShaderResources(1u, 1u, &command.pNormalResourceView);
+            }
+
+            if (command.pTextureSliceBuffer
+                && (!pPrevious || pPrevious->pTextureSliceBuffer != command.pTextureSliceBuffer
+                    || pPrevious->uTextureSlice != command.uTextureSlice))
+            {
+                if (command.uTextureSlice > 0u)
+                {
+                    assert(pContext1);
+                    UINT uFirstConstant = command.uTextureSlice * TEXTURE_SLICE_CONSTANTS;
+                    UINT uNumConstants = TEXTURE_SLICE_CONSTANTS;
+                    pContext1->PSSetConstantBuffers1(4u, 1u, &command.pTextureSliceBuffer, &uFirstConstant, &uNumConstants);
+                }
+                else
+                {
+                    pContext->PSSetConstantBuffers(4u, 1u, &command.pTextureSliceBuffer);
+                }
+            }
+
+            pContext->DrawIndexedInstanced(command.uIndexCount, 1u, command.uStartIndex, command.iBaseVertex, 0u);
+
+            pPrevious = &command;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DrawCommandList::GetNumCommands
+      Summary:  Returns the number of commands
+      Returns:  UINT
+                  Number of commands
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT DrawCommandList::GetNumCommands() const
+    {
+        return static_cast<UINT>(m_aCommands.size());
+    }
+}
@@ -0,0 +1,92 @@
+/*+===================================================================
+  File:      DRAWCOMMANDLIST.H
+  Summary:   DrawCommandList header file contains declarations of
+             DrawCommand struct and DrawCommandList class used to
+             record draws on worker threads.
+  Classes: DrawCommandList
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   DrawCommand
+      Summary:  Everything one indexed draw binds. The pointers are not
+                referenced; the renderables that own them outlive the
+                frame the command is recorded for. uNumConstants of 0
+                binds the whole constant buffer. uTextureSlice is the
+                slice of the bound texture array the draw samples, and
+                selects its constants in pTextureSliceBuffer, bound at
+                b4. pShaderResourceView is bound at t0 and
+                pNormalResourceView at t1, each only when not null
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct DrawCommand
+    {
+        ID3D11Buffer* pVertexBuffer;
+        UINT uStride;
+        ID3D11Buffer* pIndexBuffer;
+        DXGI_FORMAT indexFormat;
+        UINT uIndexOffset;
+        ID3D11InputLayout* pInputLayout;
+        ID3D11VertexShader* pVertexShader;
+        ID3D11PixelShader* pPixelShader;
+        ID3D11Buffer* pConstantBuffer;
+        UINT uFirstConstant;
+        UINT uNumConstants;
+        ID3D11ShaderResourceView* pShaderResourceView;
+        ID3D11SamplerState* pSamplerState;
+        ID3D11ShaderResourceView* pNormalResourceView;
+        UINT uIndexCount;
+        UINT uStartIndex;
+        INT iBaseVertex;
+        ID3D11Buffer* pTextureSliceBuffer;
+        UINT uTextureSlice;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DrawCommandList
+      Summary:  CPU-side list of draw commands. A worker thread records
+                into its own list without touching Direct3D, and the
+                list is later replayed onto a deferred or the immediate
+                context, skipping state that is already bound
+      Methods:  Reset
+                  Removes all commands
+                Add
+                  Appends a command
+                Execute
+                  Replays the commands onto a device context
+                GetNumCommands
+                  Returns the number of commands
+                DrawCommandList
+                  Constructor.
+                ~DrawCommandList
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DrawCommandList final
+    {
+    public:
+        // 16-byte constants from one slice to the next in the texture
+        // slice buffer, the alignment of constant buffer ranges
+        static constexpr const UINT TEXTURE_SLICE_CONSTANTS = 16u;
+
+    public:
+        DrawCommandList();
+        DrawCommandList(const DrawCommandList& other) = delete;
+        DrawCommandList(DrawCommandList&& other) = default;
+        DrawCommandList& operator=(const DrawCommandList& other) = delete;
+        DrawCommandList& operator=(DrawCommandList&& other) = default;
+        ~DrawCommandList() = default;
+
+        void Reset();
+        void Add(_In_ const DrawCommand& command);
+        void Execute(_In_ ID3D11DeviceContext* pContext, _In_opt_ ID3D11DeviceContext1* pContext1) const;
+
+        UINT GetNumCommands() const;
+
+    private:
+        std::vector<DrawCommand> m_aCommands;
+    };
+}
@@ -0,0 +1,187 @@
+#include "Renderer/DynamicRingBuffer.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::DynamicRingBuffer
+      Summary:  Constructor
+      Args:     UINT uCapacity
+                  Size of the buffer in bytes
+                UINT uFrameLatency
+                  Number of frames the GPU may lag behind the CPU
+                UINT uBindFlags
+                  D3D11_BIND_FLAG of the buffer
+      Modifies: [m_uBindFlags, m_bNoOverwrite, m_immediateContext,
+                  m_buffer, m_aFences].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DynamicRingBuffer::DynamicRingBuffer(_In_ UINT uCapacity, _In_ UINT uFrameLatency, _In_ UINT uBindFlags) :
+        FrameRingBuffer(uCapacity, uFrameLatency),
+        m_uBindFlags(uBindFlags),
+        m_bNoOverwrite(TRUE),
+        m_immediateContext(),
+        m_buffer(),
+        m_aFences()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::Initialize
+      Summary:  Creates the dynamic buffer and one event query per frame
+                in flight
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffer
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to map the buffer
+      Modifies: [m_bNoOverwrite, m_uFrameLatency, m_immediateContext,
+                  m_buffer, m_aFences].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT DynamicRingBuffer::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        m_immediateContext = pImmediateContext;
+
+        if (m_uBindFlags & D3D11_BIND_CONSTANT_BUFFER)
+        {
+            D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+            hr = pDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+
+            m_bNoOverwrite = SUCCEEDED(hr) && options.MapNoOverwriteOnDynamicConstantBuffer;
+        }
+
+        if (!m_bNoOverwrite)
+        {
+            // Every frame is discarded, the driver keeps the old contents alive
+            m_uFrameLatency = 1u;
+        }
+
+        D3D11_BUFFER_DESC bd = {
+            .ByteWidth = m_allocator.GetCapacity(),
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = m_uBindFlags,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u
+        };
+
+        hr = pDevice->CreateBuffer(&bd, nullptr, m_buffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        D3D11_QUERY_DESC queryDesc = {
+            .Query = D3D11_QUERY_EVENT,
+            .MiscFlags = 0u
+        };
+
+        m_aFences.resize(static_cast<size_t>(m_uFrameLatency) + 1u);
+        for (ComPtr<ID3D11Query>& fence : m_aFences)
+        {
+            hr = pDevice->CreateQuery(&queryDesc, fence.ReleaseAndGetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::GetBuffer
+      Summary:  Returns the dynamic buffer
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Dynamic buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& DynamicRingBuffer::GetBuffer()
+    {
+        return m_buffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::map
+      Summary:  Maps the buffer for this frame's writes
+      Returns:  BYTE*
+                  Address of offset 0 of the buffer, nullptr on failure
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE* DynamicRingBuffer::map()
+    {
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+
+        HRESULT hr = m_immediateContext->Map(m_buffer.Get(), 0u,
+            m_bNoOverwrite ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD, 0u, &mapped);
+
+        if (FAILED(hr))
+        {
+            return nullptr;
+        }
+
+        return static_cast<BYTE*>(mapped.pData);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::unmap
+      Summary:  Unmaps the buffer so this frame's draws can read it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DynamicRingBuffer::unmap()
+    {
+        m_immediateContext->Unmap(m_buffer.Get(), 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::signalFrame
+      Summary:  Issues the event query of a finished frame. It completes
+                once the GPU has executed every command issued before it
+      Args:     UINT64 uFrameIndex
+                  Index of the finished frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DynamicRingBuffer::signalFrame(_In_ UINT64 uFrameIndex)
+    {
+        if (!m_bNoOverwrite)
+        {
+            return;
+        }
+
+        m_immediateContext->End(m_aFences[uFrameIndex % m_aFences.size()].Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DynamicRingBuffer::waitForFrame
+      Summary:  Waits for the event query of a finished frame. The GPU
+                is usually close behind, so the wait first spins with a
+                pause and then gives the rest of the time slice away
+      Args:     UINT64 uFrameIndex
+                  Index of the frame to wait for
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT DynamicRingBuffer::waitForFrame(_In_ UINT64 uFrameIndex)
+    {
+        if (!m_bNoOverwrite)
+        {
+            return S_OK;
+        }
+
+        ID3D11Query* pFence = m_aFences[uFrameIndex % m_aFences.size()].Get();
+
+        HRESULT hr = m_immediateContext->GetData(pFence, nullptr, 0u, 0u);
+        for (UINT uTries = 0u; hr == S_FALSE; ++uTries)
+        {
+            if (uTries < SPIN_TRIES)
+            {
+                YieldProcessor();
+            }
+            else
+            {
+                Sleep(0u);
+            }
+
+            hr = m_immediateContext->GetData(pFence, nullptr, 0u, 0u);
+        }
+
+        return FAILED(hr) ? hr : S_OK;
+    }
+}
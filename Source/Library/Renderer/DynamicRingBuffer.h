@@ -0,0 +1,67 @@
+/*+===================================================================
+  File:      DYNAMICRINGBUFFER.H
+  Summary:   DynamicRingBuffer header file contains declarations of
+             DynamicRingBuffer class used to stream per-frame data
+             through a Direct3D dynamic buffer.
+  Classes: DynamicRingBuffer
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/RingAllocator.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DynamicRingBuffer
+      Summary:  Frame ring buffer over a D3D11_USAGE_DYNAMIC buffer. The
+                buffer is mapped once per frame with
+                D3D11_MAP_WRITE_NO_OVERWRITE and every frame is fenced
+                with an event query, so space is reused only after the
+                GPU is done with it. If the runtime cannot map the buffer
+                without overwriting, the buffer is discarded every frame
+                and the driver does the renaming instead
+      Methods:  Initialize
+                  Creates the buffer and the frame fences
+                GetBuffer
+                  Returns the buffer
+                DynamicRingBuffer
+                  Constructor.
+                ~DynamicRingBuffer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DynamicRingBuffer : public FrameRingBuffer
+    {
+    public:
+        // Fence polls that only pause the core before yielding the thread
+        static constexpr const UINT SPIN_TRIES = 64u;
+
+    public:
+        DynamicRingBuffer() = delete;
+        DynamicRingBuffer(_In_ UINT uCapacity, _In_ UINT uFrameLatency, _In_ UINT uBindFlags);
+        DynamicRingBuffer(const DynamicRingBuffer& other) = delete;
+        DynamicRingBuffer(DynamicRingBuffer&& other) = delete;
+        DynamicRingBuffer& operator=(const DynamicRingBuffer& other) = delete;
+        DynamicRingBuffer& operator=(DynamicRingBuffer&& other) = delete;
+        virtual ~DynamicRingBuffer() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
+        ComPtr<ID3D11Buffer>& GetBuffer();
+
+    protected:
+        virtual BYTE* map() override;
+        virtual void unmap() override;
+        virtual void signalFrame(_In_ UINT64 uFrameIndex) override;
+        virtual HRESULT waitForFrame(_In_ UINT64 uFrameIndex) override;
+
+    protected:
+        UINT m_uBindFlags;
+        BOOL m_bNoOverwrite;
+        ComPtr<ID3D11DeviceContext> m_immediateContext;
+        ComPtr<ID3D11Buffer> m_buffer;
+        std::vector<ComPtr<ID3D11Query>> m_aFences;
+    };
+}
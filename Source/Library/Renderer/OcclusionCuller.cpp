@@ -0,0 +1,539 @@
+#include "Renderer/OcclusionCuller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_CULLER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    namespace
+    {
+        // Triangles and boxes with a corner closer than this in clip w are
+        // treated as crossing the near plane
+        constexpr const float NEAR_W = 1e-4f;
+
+        constexpr const std::uint16_t BOX_INDICES[] =
+        {
+            0, 2, 6,  0, 6, 4,
+            1, 3, 7,  1, 7, 5,
+            0, 1, 5,  0, 5, 4,
+            2, 3, 7,  2, 7, 6,
+            0, 1, 3,  0, 3, 2,
+            4, 5, 7,  4, 7, 6,
+        };
+
+        using Clock = std::chrono::high_resolution_clock;
+
+        double elapsedMilliseconds(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        void multiplyMatrices(const float* pA, const float* pB, float* pOut)
+        {
+            for (std::uint32_t r = 0u; r < 4u; ++r)
+            {
+                for (std::uint32_t c = 0u; c < 4u; ++c)
+                {
+                    pOut[r * 4u + c] = pA[r * 4u + 0u] * pB[0u * 4u + c] + pA[r * 4u + 1u] * pB[1u * 4u + c]
+                        + pA[r * 4u + 2u] * pB[2u * 4u + c] + pA[r * 4u + 3u] * pB[3u * 4u + c];
+                }
+            }
+        }
+
+        void boxCorners(const float* pMin, const float* pMax, float (&aCorners)[8][3])
+        {
+            for (std::uint32_t i = 0u; i < 8u; ++i)
+            {
+                aCorners[i][0] = (i & 1u) ? pMax[0] : pMin[0];
+                aCorners[i][1] = (i & 2u) ? pMax[1] : pMin[1];
+                aCorners[i][2] = (i & 4u) ? pMax[2] : pMin[2];
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::OcclusionCuller
+      Summary:  Constructor
+      Args:     std::uint32_t uWidth
+                  Width of the depth buffer, rounded up to a multiple
+                  of 4
+                std::uint32_t uHeight
+                  Height of the depth buffer
+      Modifies: [m_uWidth, m_uHeight, m_aViewProjection, m_aDepth,
+                  m_aScreenVertices, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::OcclusionCuller(std::uint32_t uWidth, std::uint32_t uHeight) :
+        m_uWidth((std::max)((uWidth + 3u) & ~3u, 4u)),
+        m_uHeight((std::max)(uHeight, 1u)),
+        m_aViewProjection(),
+        m_aDepth(),
+        m_aScreenVertices(),
+        m_stats()
+    {
+        m_aDepth.assign(static_cast<size_t>(m_uWidth) * m_uHeight, 1.0f);
+
+        for (std::uint32_t i = 0u; i < 4u; ++i)
+        {
+            m_aViewProjection[i * 5u] = 1.0f;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::BeginFrame
+      Summary:  Clears the depth buffer to the far plane, resets the
+                counters and sets the view projection of the frame
+      Args:     const float* pViewProjection
+                  View * projection matrix
+      Modifies: [m_aViewProjection, m_aDepth, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::BeginFrame(const float* pViewProjection)
+    {
+        std::memcpy(m_aViewProjection, pViewProjection, sizeof(m_aViewProjection));
+        std::fill(m_aDepth.begin(), m_aDepth.end(), 1.0f);
+        m_stats = {};
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::RasterizeMesh
+      Summary:  Rasterizes an occluder mesh with 16-bit indices
+      Args:     const float* pWorld
+                  World matrix of the mesh
+                const void* pPositions
+                  First vertex position, three floats
+                std::uint32_t uStride
+                  Bytes between two positions
+                std::uint32_t uNumVertices
+                  Number of vertices
+                const std::uint16_t* pIndices
+                  Triangle list indices
+                std::uint32_t uNumIndices
+                  Number of indices
+      Modifies: [m_aDepth, m_aScreenVertices, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::RasterizeMesh(const float* pWorld, const void* pPositions, std::uint32_t uStride,
+        std::uint32_t uNumVertices, const std::uint16_t* pIndices, std::uint32_t uNumIndices)
+    {
+        rasterizeIndexed(pWorld, pPositions, uStride, uNumVertices, pIndices, uNumIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::RasterizeMesh
+      Summary:  Rasterizes an occluder mesh with 32-bit indices
+      Args:     const float* pWorld
+                  World matrix of the mesh
+                const void* pPositions
+                  First vertex position, three floats
+                std::uint32_t uStride
+                  Bytes between two positions
+                std::uint32_t uNumVertices
+                  Number of vertices
+                const std::uint32_t* pIndices
+                  Triangle list indices
+                std::uint32_t uNumIndices
+                  Number of indices
+      Modifies: [m_aDepth, m_aScreenVertices, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::RasterizeMesh(const float* pWorld, const void* pPositions, std::uint32_t uStride,
+        std::uint32_t uNumVertices, const std::uint32_t* pIndices, std::uint32_t uNumIndices)
+    {
+        rasterizeIndexed(pWorld, pPositions, uStride, uNumVertices, pIndices, uNumIndices);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::RasterizeBox
+      Summary:  Rasterizes the twelve triangles of a box. Used for hulls
+                that are known to be solid, such as terrain chunks
+      Args:     const float* pWorld
+                  World matrix of the box
+                const float* pMin
+                  Minimum corner in local space
+                const float* pMax
+                  Maximum corner in local space
+      Modifies: [m_aDepth, m_aScreenVertices, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::RasterizeBox(const float* pWorld, const float* pMin, const float* pMax)
+    {
+        float aCorners[8][3];
+        boxCorners(pMin, pMax, aCorners);
+
+        rasterizeIndexed(pWorld, aCorners, sizeof(aCorners[0]), 8u, BOX_INDICES,
+            static_cast<std::uint32_t>(std::size(BOX_INDICES)));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::IsBoxVisible
+      Summary:  Tests a box against the depth buffer. The box is
+                projected to its screen rectangle and nearest depth; it
+                is hidden only if every pixel of the rectangle holds an
+                occluder nearer than that depth. Boxes entirely outside
+                the screen are rejected as well
+      Args:     const float* pWorld
+                  World matrix of the box
+                const float* pMin
+                  Minimum corner in local space
+                const float* pMax
+                  Maximum corner in local space
+      Modifies: [m_aScreenVertices, m_stats].
+      Returns:  bool
+                  true if the box may be visible
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionCuller::IsBoxVisible(const float* pWorld, const float* pMin, const float* pMax)
+    {
+        Clock::time_point start = Clock::now();
+        ++m_stats.uNumTestedBoxes;
+
+        float aCorners[8][3];
+        boxCorners(pMin, pMax, aCorners);
+        transformVertices(pWorld, aCorners, sizeof(aCorners[0]), 8u);
+
+        float fMinX = static_cast<float>(m_uWidth);
+        float fMinY = static_cast<float>(m_uHeight);
+        float fMaxX = 0.0f;
+        float fMaxY = 0.0f;
+        float fMinZ = 1.0f;
+
+        for (const ScreenVertex& vertex : m_aScreenVertices)
+        {
+            if (!vertex.bInFront)
+            {
+                m_stats.dTestMilliseconds += elapsedMilliseconds(start);
+                return true;
+            }
+
+            fMinX = (std::min)(fMinX, vertex.x);
+            fMinY = (std::min)(fMinY, vertex.y);
+            fMaxX = (std::max)(fMaxX, vertex.x);
+            fMaxY = (std::max)(fMaxY, vertex.y);
+            fMinZ = (std::min)(fMinZ, vertex.z);
+        }
+
+        std::int32_t iX0 = (std::max)(static_cast<std::int32_t>(std::floor(fMinX)), 0);
+        std::int32_t iY0 = (std::max)(static_cast<std::int32_t>(std::floor(fMinY)), 0);
+        std::int32_t iX1 = (std::min)(static_cast<std::int32_t>(std::ceil(fMaxX)), static_cast<std::int32_t>(m_uWidth) - 1);
+        std::int32_t iY1 = (std::min)(static_cast<std::int32_t>(std::ceil(fMaxY)), static_cast<std::int32_t>(m_uHeight) - 1);
+
+        bool bVisible = false;
+
+        if (iX0 <= iX1 && iY0 <= iY1 && fMinZ <= 1.0f)
+        {
+            for (std::int32_t y = iY0; y <= iY1 && !bVisible; ++y)
+            {
+                const float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                std::int32_t x = iX0 & ~3;
+
+#ifdef OCCLUSION_CULLER_SSE2
+                __m128 boxZ = _mm_set1_ps(fMinZ);
+                __m128i first = _mm_set1_epi32(iX0);
+                __m128i last = _mm_set1_epi32(iX1);
+
+                for (; x <= iX1; x += 4)
+                {
+                    __m128i lanes = _mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3));
+                    __m128i inside = _mm_andnot_si128(
+                        _mm_or_si128(_mm_cmplt_epi32(lanes, first), _mm_cmpgt_epi32(lanes, last)),
+                        _mm_set1_epi32(-1));
+                    __m128 farther = _mm_cmpge_ps(_mm_loadu_ps(pRow + x), boxZ);
+
+                    if (_mm_movemask_ps(_mm_and_ps(farther, _mm_castsi128_ps(inside))) != 0)
+                    {
+                        bVisible = true;
+                        break;
+                    }
+                }
+#else
+                for (x = iX0; x <= iX1; ++x)
+                {
+                    if (pRow[x] >= fMinZ)
+                    {
+                        bVisible = true;
+                        break;
+                    }
+                }
+#endif
+            }
+        }
+
+        if (!bVisible)
+        {
+            ++m_stats.uNumRejectedBoxes;
+        }
+
+        m_stats.dTestMilliseconds += elapsedMilliseconds(start);
+
+        return bVisible;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetStats
+      Summary:  Returns the counters of the current frame
+      Returns:  const OcclusionStats&
+                  Counters since the last BeginFrame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const OcclusionStats& OcclusionCuller::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetRejectionRate
+      Summary:  Returns the fraction of boxes tested this frame that were
+                rejected
+      Returns:  float
+                  Rejection rate in [0, 1]
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float OcclusionCuller::GetRejectionRate() const
+    {
+        if (m_stats.uNumTestedBoxes == 0u)
+        {
+            return 0.0f;
+        }
+
+        return static_cast<float>(m_stats.uNumRejectedBoxes) / static_cast<float>(m_stats.uNumTestedBoxes);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetWidth
+      Summary:  Returns the width of the depth buffer
+      Returns:  std::uint32_t
+                  Width in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetHeight
+      Summary:  Returns the height of the depth buffer
+      Returns:  std::uint32_t
+                  Height in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetDepthBuffer
+      Summary:  Returns the depth buffer, row by row, 0 at the near and
+                1 at the far plane
+      Returns:  const float*
+                  Width * height depth values
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const float* OcclusionCuller::GetDepthBuffer() const
+    {
+        return m_aDepth.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeIndexed
+      Summary:  Transforms the vertices of a mesh and rasterizes its
+                triangles. Triangles with a vertex in front of the near
+                plane are skipped
+      Args:     const float* pWorld
+                  World matrix of the mesh
+                const void* pPositions
+                  First vertex position, three floats
+                std::uint32_t uStride
+                  Bytes between two positions
+                std::uint32_t uNumVertices
+                  Number of vertices
+                const Index* pIndices
+                  Triangle list indices
+                std::uint32_t uNumIndices
+                  Number of indices
+      Modifies: [m_aDepth, m_aScreenVertices, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class Index>
+    void OcclusionCuller::rasterizeIndexed(const float* pWorld, const void* pPositions, std::uint32_t uStride,
+        std::uint32_t uNumVertices, const Index* pIndices, std::uint32_t uNumIndices)
+    {
+        Clock::time_point start = Clock::now();
+
+        transformVertices(pWorld, pPositions, uStride, uNumVertices);
+
+        for (std::uint32_t i = 0u; i + 2u < uNumIndices; i += 3u)
+        {
+            if (pIndices[i] >= uNumVertices || pIndices[i + 1u] >= uNumVertices || pIndices[i + 2u] >= uNumVertices)
+            {
+                continue;
+            }
+
+            const ScreenVertex& a = m_aScreenVertices[pIndices[i]];
+            const ScreenVertex& b = m_aScreenVertices[pIndices[i + 1u]];
+            const ScreenVertex& c = m_aScreenVertices[pIndices[i + 2u]];
+
+            if (!a.bInFront || !b.bInFront || !c.bInFront)
+            {
+                continue;
+            }
+
+            rasterizeTriangle(a, b, c);
+            ++m_stats.uNumOccluderTriangles;
+        }
+
+        m_stats.dRasterizeMilliseconds += elapsedMilliseconds(start);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::transformVertices
+      Summary:  Projects positions to depth buffer pixels and depth
+      Args:     const float* pWorld
+                  World matrix
+                const void* pPositions
+                  First vertex position, three floats
+                std::uint32_t uStride
+                  Bytes between two positions
+                std::uint32_t uNumVertices
+                  Number of vertices
+      Modifies: [m_aScreenVertices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::transformVertices(const float* pWorld, const void* pPositions, std::uint32_t uStride,
+        std::uint32_t uNumVertices)
+    {
+        float aWorldViewProjection[16];
+        multiplyMatrices(pWorld, m_aViewProjection, aWorldViewProjection);
+        const float* m = aWorldViewProjection;
+
+        float fHalfWidth = 0.5f * static_cast<float>(m_uWidth);
+        float fHalfHeight = 0.5f * static_cast<float>(m_uHeight);
+
+        m_aScreenVertices.resize(uNumVertices);
+
+        const std::uint8_t* pPosition = static_cast<const std::uint8_t*>(pPositions);
+
+        for (std::uint32_t i = 0u; i < uNumVertices; ++i, pPosition += uStride)
+        {
+            float p[3];
+            std::memcpy(p, pPosition, sizeof(p));
+
+            float x = p[0] * m[0] + p[1] * m[4] + p[2] * m[8] + m[12];
+            float y = p[0] * m[1] + p[1] * m[5] + p[2] * m[9] + m[13];
+            float z = p[0] * m[2] + p[1] * m[6] + p[2] * m[10] + m[14];
+            float w = p[0] * m[3] + p[1] * m[7] + p[2] * m[11] + m[15];
+
+            ScreenVertex& vertex = m_aScreenVertices[i];
+            vertex.bInFront = w > NEAR_W && z >= 0.0f;
+
+            if (!vertex.bInFront)
+            {
+                vertex.x = vertex.y = vertex.z = 0.0f;
+                continue;
+            }
+
+            float fInvW = 1.0f / w;
+            vertex.x = (x * fInvW + 1.0f) * fHalfWidth;
+            vertex.y = (1.0f - y * fInvW) * fHalfHeight;
+            vertex.z = z * fInvW;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeTriangle
+      Summary:  Rasterizes a triangle of either winding, keeping the
+                nearest depth. Barycentric weights are evaluated at
+                pixel centers, four pixels of a row at a time
+      Args:     const ScreenVertex& a
+                  First vertex
+                const ScreenVertex& b
+                  Second vertex
+                const ScreenVertex& c
+                  Third vertex
+      Modifies: [m_aDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c)
+    {
+        float fArea = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+        if (std::fabs(fArea) < 1e-8f)
+        {
+            return;
+        }
+
+        std::int32_t iX0 = (std::max)(static_cast<std::int32_t>(std::floor((std::min)({ a.x, b.x, c.x }))), 0);
+        std::int32_t iY0 = (std::max)(static_cast<std::int32_t>(std::floor((std::min)({ a.y, b.y, c.y }))), 0);
+        std::int32_t iX1 = (std::min)(static_cast<std::int32_t>(std::ceil((std::max)({ a.x, b.x, c.x }))),
+            static_cast<std::int32_t>(m_uWidth) - 1);
+        std::int32_t iY1 = (std::min)(static_cast<std::int32_t>(std::ceil((std::max)({ a.y, b.y, c.y }))),
+            static_cast<std::int32_t>(m_uHeight) - 1);
+
+        if (iX0 > iX1 || iY0 > iY1)
+        {
+            return;
+        }
+
+        // Weight of a vertex = edge function of the opposite edge / area,
+        // written as w = A * x + B * y + C
+        float fInvArea = 1.0f / fArea;
+        float fA0 = (b.y - c.y) * fInvArea, fB0 = (c.x - b.x) * fInvArea, fC0 = (b.x * c.y - b.y * c.x) * fInvArea;
+        float fA1 = (c.y - a.y) * fInvArea, fB1 = (a.x - c.x) * fInvArea, fC1 = (c.x * a.y - c.y * a.x) * fInvArea;
+        float fA2 = (a.y - b.y) * fInvArea, fB2 = (b.x - a.x) * fInvArea, fC2 = (a.x * b.y - a.y * b.x) * fInvArea;
+
+        // Depth is linear in screen space: z = Az * x + Bz * y + Cz
+        float fAz = fA0 * a.z + fA1 * b.z + fA2 * c.z;
+        float fBz = fB0 * a.z + fB1 * b.z + fB2 * c.z;
+        float fCz = fC0 * a.z + fC1 * b.z + fC2 * c.z;
+
+        for (std::int32_t y = iY0; y <= iY1; ++y)
+        {
+            float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+            float fY = static_cast<float>(y) + 0.5f;
+
+#ifdef OCCLUSION_CULLER_SSE2
+            __m128 row0 = _mm_set1_ps(fB0 * fY + fC0);
+            __m128 row1 = _mm_set1_ps(fB1 * fY + fC1);
+            __m128 row2 = _mm_set1_ps(fB2 * fY + fC2);
+            __m128 rowZ = _mm_set1_ps(fBz * fY + fCz);
+            __m128 a0 = _mm_set1_ps(fA0);
+            __m128 a1 = _mm_set1_ps(fA1);
+            __m128 a2 = _mm_set1_ps(fA2);
+            __m128 az = _mm_set1_ps(fAz);
+            __m128 zero = _mm_setzero_ps();
+
+            for (std::int32_t x = iX0 & ~3; x <= iX1; x += 4)
+            {
+                float fX = static_cast<float>(x) + 0.5f;
+                __m128 px = _mm_add_ps(_mm_set1_ps(fX), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+
+                __m128 w0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                __m128 w1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                __m128 w2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)),
+                    _mm_cmpge_ps(w2, zero));
+
+                if (_mm_movemask_ps(inside) == 0)
+                {
+                    continue;
+                }
+
+                __m128 z = _mm_add_ps(_mm_mul_ps(az, px), rowZ);
+                __m128 depth = _mm_loadu_ps(pRow + x);
+                __m128 nearest = _mm_min_ps(depth, z);
+                _mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, depth)));
+            }
+#else
+            for (std::int32_t x = iX0; x <= iX1; ++x)
+            {
+                float fX = static_cast<float>(x) + 0.5f;
+                float w0 = fA0 * fX + fB0 * fY + fC0;
+                float w1 = fA1 * fX + fB1 * fY + fC1;
+                float w2 = fA2 * fX + fB2 * fY + fC2;
+
+                if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f)
+                {
+                    float z = fAz * fX + fBz * fY + fCz;
+                    pRow[x] = (std::min)(pRow[x], z);
+                }
+            }
+#endif
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+  Summary:   OcclusionCuller header file contains declarations of
+             OcclusionCuller class used to reject objects hidden
+             behind occluders with a software depth buffer.
+  Classes: OcclusionCuller
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+// Matrices are 16 floats in DirectXMath memory layout (row-major, row
+// vectors)
+#include <cstdint>
+#include <vector>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   OcclusionStats
+      Summary:  Counters of the current frame
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct OcclusionStats
+    {
+        std::uint32_t uNumOccluderTriangles;
+        std::uint32_t uNumTestedBoxes;
+        std::uint32_t uNumRejectedBoxes;
+        double dRasterizeMilliseconds;
+        double dTestMilliseconds;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionCuller
+      Summary:  Low-resolution software depth buffer. Occluders are
+                rasterized four pixels at a time with SSE2 (scalar code
+                elsewhere), keeping the nearest depth. A box is visible
+                if any pixel under its screen rectangle is farther than
+                the box's nearest corner. Triangles crossing the near
+                plane are not rasterized and boxes crossing it are
+                always visible, so the test never rejects a visible
+                object because of clipping
+      Methods:  BeginFrame
+                  Clears the depth buffer and sets the view projection
+                RasterizeMesh
+                  Rasterizes an indexed occluder mesh
+                RasterizeBox
+                  Rasterizes an occluder box, such as a terrain chunk
+                  hull
+                IsBoxVisible
+                  Tests a box against the depth buffer
+                GetStats
+                  Returns the counters of the current frame
+                GetRejectionRate
+                  Returns the fraction of tested boxes rejected
+                GetWidth
+                  Returns the width of the depth buffer
+                GetHeight
+                  Returns the height of the depth buffer
+                GetDepthBuffer
+                  Returns the depth buffer
+                OcclusionCuller
+                  Constructor.
+                ~OcclusionCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionCuller final
+    {
+    public:
+        static constexpr const std::uint32_t DEFAULT_WIDTH = 256u;
+        static constexpr const std::uint32_t DEFAULT_HEIGHT = 128u;
+
+    public:
+        OcclusionCuller(std::uint32_t uWidth = DEFAULT_WIDTH, std::uint32_t uHeight = DEFAULT_HEIGHT);
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller() = default;
+
+        void BeginFrame(const float* pViewProjection);
+
+        void RasterizeMesh(const float* pWorld, const void* pPositions, std::uint32_t uStride, std::uint32_t uNumVertices,
+            const std::uint16_t* pIndices, std::uint32_t uNumIndices);
+        void RasterizeMesh(const float* pWorld, const void* pPositions, std::uint32_t uStride, std::uint32_t uNumVertices,
+            const std::uint32_t* pIndices, std::uint32_t uNumIndices);
+        void RasterizeBox(const float* pWorld, const float* pMin, const float* pMax);
+
+        bool IsBoxVisible(const float* pWorld, const float* pMin, const float* pMax);
+
+        const OcclusionStats& GetStats() const;
+        float GetRejectionRate() const;
+        std::uint32_t GetWidth() const;
+        std::uint32_t GetHeight() const;
+        const float* GetDepthBuffer() const;
+
+    private:
+        struct ScreenVertex
+        {
+            float x;
+            float y;
+            float z;
+            bool bInFront;
+        };
+
+        template <class Index>
+        void rasterizeIndexed(const float* pWorld, const void* pPositions, std::uint32_t uStride,
+            std::uint32_t uNumVertices, const Index* pIndices, std::uint32_t uNumIndices);
+        void transformVertices(const float* pWorld, const void* pPositions, std::uint32_t uStride,
+            std::uint32_t uNumVertices);
+        void rasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c);
+
+        std::uint32_t m_uWidth;
+        std::uint32_t m_uHeight;
+        float m_aViewProjection[16];
+        std::vector<float> m_aDepth;
+        std::vector<ScreenVertex> m_aScreenVertices;
+        OcclusionStats m_stats;
+    };
+}
@@ -14,7 +14,10 @@ namespace library
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
                  m_textureRV, m_samplerLinear, m_vertexShader,
                  m_pixelShader, m_textureFilePath, m_outputColor,
-                 m_world].
+                 m_world, m_pTransforms, m_uTransformNode,
+                 m_vertexFormat, m_positionScale, m_positionBias,
+                 m_quantizationError, m_localBoundsMin,
+                 m_localBoundsMax, m_bOccluder, m_aMeshlets].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Renderable::Renderable(_In_ const XMFLOAT4& outputColor) :
         m_vertexBuffer(),
@@ -22,23 +25,38 @@ namespace library
         m_constantBuffer(),
         m_vertexShader(),
         m_pixelShader(),
+        m_pTransforms(nullptr),
+        m_uTransformNode(TransformHierarchy::INVALID_NODE),
+        m_vertexFormat(eVertexFormat::SIMPLE),
+        m_positionScale(1.0f, 1.0f, 1.0f, 1.0f),
+        m_positionBias(0.0f, 0.0f, 0.0f, 0.0f),
+        m_quantizationError(),
+        m_localBoundsMin(0.0f, 0.0f, 0.0f),
+        m_localBoundsMax(0.0f, 0.0f, 0.0f),
+        m_bOccluder(FALSE),
         m_outputColor(outputColor),
         m_world(XMMatrixIdentity()),
         m_padding(),
         m_aMeshes(std::vector<BasicMeshEntry>()),
-        m_aMaterials(std::vector<Material>())
+        m_aMaterials(std::vector<Material>()),
+        m_aMeshlets(std::vector<Meshlet>())
     {
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::initialize
-      Summary:  Initializes the buffers and the world matrix
+      Summary:  Initializes the buffers, the world matrix and the local
+                bounding box. With the compact vertex format the
+                vertices are quantized before the vertex buffer is
+                created
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
       Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
-                  m_world].
+                  m_world, m_positionScale, m_positionBias,
+                  m_quantizationError, m_localBoundsMin,
+                  m_localBoundsMax].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -46,15 +64,27 @@ namespace library
 
         HRESULT hr = S_OK;
 
+        // The CPU keeps the full precision vertices for bounds and
+        // occlusion; only the GPU copy is quantized
+        std::vector<CompactVertex> aCompactVertices;
+        const void* pVertexData = getVertices();
+
+        if (m_vertexFormat == eVertexFormat::COMPACT) {
+            aCompactVertices.resize(GetNumVertices());
+            VertexQuantizer::Quantize(getVertices(), GetNumVertices(), aCompactVertices.data(),
+                m_positionScale, m_positionBias, &m_quantizationError);
+            pVertexData = aCompactVertices.data();
+        }
+
         D3D11_BUFFER_DESC bd = {
-            .ByteWidth = sizeof(SimpleVertex) * GetNumVertices(),
+            .ByteWidth = GetVertexStride() * GetNumVertices(),
             .Usage = D3D11_USAGE_DEFAULT,
             .BindFlags = D3D11_BIND_VERTEX_BUFFER,
             .CPUAccessFlags = 0u
         };
 
         D3D11_SUBRESOURCE_DATA sd = {
-            .pSysMem = getVertices()
+            .pSysMem = pVertexData
         };
 
         hr = pDevice->CreateBuffer(&bd, &sd, m_vertexBuffer.GetAddressOf());
@@ -63,16 +93,16 @@ namespace library
             return hr;
         }
 
-        UINT uStride = sizeof(SimpleVertex);
+        UINT uStride = GetVertexStride();
         UINT uOffset = 0;
         pImmediateContext->IASetVertexBuffers(0u, 1u, m_vertexBuffer.GetAddressOf(), &uStride, &uOffset);
 
-        bd.ByteWidth = sizeof(WORD) * GetNumIndices();
+        bd.ByteWidth = getIndexDataSize();
         bd.Usage = D3D11_USAGE_DEFAULT;
         bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
         bd.CPUAccessFlags = 0u;
 
-        sd.pSysMem = getIndices();
+        sd.pSysMem = getIndexData();
 
         hr = pDevice->CreateBuffer(&bd, &sd, m_indexBuffer.GetAddressOf());
 
@@ -80,7 +110,8 @@ namespace library
             return hr;
         }
 
-        pImmediateContext->IASetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0u);
+        pImmediateContext->IASetIndexBuffer(m_indexBuffer.Get(),
+            m_aMeshes.empty() ? DXGI_FORMAT_R16_UINT : m_aMeshes[0].indexFormat, 0u);
 
         bd.ByteWidth = sizeof(CBChangesEveryFrame);
         bd.Usage = D3D11_USAGE_DEFAULT;
@@ -93,6 +124,20 @@ namespace library
             return hr;
         }
 
+        if (GetNumVertices() > 0u) {
+            XMVECTOR boundsMin = XMLoadFloat3(&getVertices()[0].Position);
+            XMVECTOR boundsMax = boundsMin;
+
+            for (UINT i = 1u; i < GetNumVertices(); ++i) {
+                XMVECTOR position = XMLoadFloat3(&getVertices()[i].Position);
+                boundsMin = XMVectorMin(boundsMin, position);
+                boundsMax = XMVectorMax(boundsMax, position);
+            }
+
+            XMStoreFloat3(&m_localBoundsMin, boundsMin);
+            XMStoreFloat3(&m_localBoundsMax, boundsMax);
+        }
+
         return S_OK;
     }
 
@@ -120,34 +165,81 @@ namespace library
         m_pixelShader = pixelShader;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetVertexShaderObject
+      Summary:  Returns the vertex shader the object is drawn with
+      Returns:  const std::shared_ptr<VertexShader>&
+                  Vertex shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<VertexShader>& Renderable::GetVertexShaderObject() const {
+        return m_vertexShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetPixelShaderObject
+      Summary:  Returns the pixel shader the object is drawn with
+      Returns:  const std::shared_ptr<PixelShader>&
+                  Pixel shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::shared_ptr<PixelShader>& Renderable::GetPixelShaderObject() const {
+        return m_pixelShader;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::PrepareShaders
+      Summary:  Compiles the variants of the vertex and pixel shaders
+                for a key if they are not compiled yet
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the shaders
+                UINT uKey
+                  Shader::FEATURE_ bits the draw needs
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderable::PrepareShaders(_In_ ID3D11Device* pDevice, _In_ UINT uKey) {
+        HRESULT hr = m_vertexShader->PrepareVariant(pDevice, uKey);
+
+        if (FAILED(hr)) {
+            return hr;
+        }
+
+        return m_pixelShader->PrepareVariant(pDevice, uKey);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetVertexShader
-      Summary:  Returns the vertex shader
+      Summary:  Returns the vertex shader variant of a key
+      Args:     UINT uKey
+                  Shader::FEATURE_ bits the draw needs
       Returns:  ComPtr<ID3D11VertexShader>&
                   Vertex shader. Could be a nullptr
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11VertexShader>& Renderable::GetVertexShader() {
-        return m_vertexShader->GetVertexShader();
+    ComPtr<ID3D11VertexShader>& Renderable::GetVertexShader(_In_ UINT uKey) {
+        return m_vertexShader->GetVertexShader(uKey);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetPixelShader
-      Summary:  Returns the vertex shader
+      Summary:  Returns the pixel shader variant of a key
+      Args:     UINT uKey
+                  Shader::FEATURE_ bits the draw needs
       Returns:  ComPtr<ID3D11PixelShader>&
                   Pixel shader. Could be a nullptr
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11PixelShader>& Renderable::GetPixelShader() {
-        return m_pixelShader->GetPixelShader();
+    ComPtr<ID3D11PixelShader>& Renderable::GetPixelShader(_In_ UINT uKey) {
+        return m_pixelShader->GetPixelShader(uKey);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetVertexLayout
-      Summary:  Returns the vertex input layout
+      Summary:  Returns the vertex input layout variant of a key
+      Args:     UINT uKey
+                  Shader::FEATURE_ bits the draw needs
       Returns:  ComPtr<ID3D11InputLayout>&
                   Vertex input layout
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11InputLayout>& Renderable::GetVertexLayout() {
-        return m_vertexShader->GetVertexLayout();
+    ComPtr<ID3D11InputLayout>& Renderable::GetVertexLayout(_In_ UINT uKey) {
+        return m_vertexShader->GetVertexLayout(uKey);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -187,9 +279,194 @@ namespace library
                   World matrix
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     const XMMATRIX& Renderable::GetWorldMatrix() const {
+        if (m_pTransforms) {
+            return m_pTransforms->GetWorldMatrix(m_uTransformNode);
+        }
+
         return m_world;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetVertexFormat
+      Summary:  Selects the format of the vertex buffer. Must be called
+                before the renderable is initialized, and the vertex
+                shader must be created with the same format
+      Args:     eVertexFormat vertexFormat
+                  SIMPLE for full precision, COMPACT for the quantized
+                  16-byte vertices
+      Modifies: [m_vertexFormat].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetVertexFormat(_In_ eVertexFormat vertexFormat) {
+        m_vertexFormat = vertexFormat;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetVertexFormat
+      Summary:  Returns the format of the vertex buffer
+      Returns:  eVertexFormat
+                  Vertex format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eVertexFormat Renderable::GetVertexFormat() const {
+        return m_vertexFormat;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetVertexStride
+      Summary:  Returns the size of a vertex in the vertex buffer
+      Returns:  UINT
+                  Vertex stride in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::GetVertexStride() const {
+        return m_vertexFormat == eVertexFormat::COMPACT ? sizeof(CompactVertex) : sizeof(SimpleVertex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetPositionScale
+      Summary:  Returns the scale that decodes compact positions
+      Returns:  const XMFLOAT4&
+                  Extent of the vertex bounds, 1 for SimpleVertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& Renderable::GetPositionScale() const {
+        return m_positionScale;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetPositionBias
+      Summary:  Returns the bias that decodes compact positions
+      Returns:  const XMFLOAT4&
+                  Minimum of the vertex bounds, 0 for SimpleVertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT4& Renderable::GetPositionBias() const {
+        return m_positionBias;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetQuantizationError
+      Summary:  Returns the largest error of the compact vertices
+      Returns:  const QuantizationError&
+                  Error measured at initialization, zero for
+                  SimpleVertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const QuantizationError& Renderable::GetQuantizationError() const {
+        return m_quantizationError;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SetOccluder
+      Summary:  Marks the object as an occluder. Occluders are drawn into
+                the software depth buffer before the other objects are
+                tested against it; only large, solid objects are worth it
+      Args:     BOOL bOccluder
+                  TRUE to use the object as an occluder
+      Modifies: [m_bOccluder].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::SetOccluder(_In_ BOOL bOccluder) {
+        m_bOccluder = bOccluder;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::IsOccluder
+      Summary:  Returns whether the object is an occluder
+      Returns:  BOOL
+                  TRUE if the object is an occluder
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderable::IsOccluder() const {
+        return m_bOccluder;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetLocalBoundsMin
+      Summary:  Returns the minimum corner of the local bounding box
+      Returns:  const XMFLOAT3&
+                  Minimum corner in object space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT3& Renderable::GetLocalBoundsMin() const {
+        return m_localBoundsMin;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetLocalBoundsMax
+      Summary:  Returns the maximum corner of the local bounding box
+      Returns:  const XMFLOAT3&
+                  Maximum corner in object space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMFLOAT3& Renderable::GetLocalBoundsMax() const {
+        return m_localBoundsMax;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::RasterizeOccluder
+      Summary:  Rasterizes the triangles of the object with its current
+                world matrix into an occlusion culler
+      Args:     OcclusionCuller& occlusionCuller
+                  Culler to rasterize into
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::RasterizeOccluder(_Inout_ OcclusionCuller& occlusionCuller) const {
+        XMFLOAT4X4 world;
+        XMStoreFloat4x4(&world, GetWorldMatrix());
+
+        occlusionCuller.RasterizeMesh(&world.m[0][0], &getVertices()->Position, sizeof(SimpleVertex),
+            GetNumVertices(), getIndices(), GetNumIndices());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::getIndexData
+      Summary:  Returns the contents of the index buffer. By default
+                these are the 16-bit indices from getIndices
+      Returns:  const void*
+                  Index buffer data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const void* Renderable::getIndexData() const {
+        return getIndices();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::getIndexDataSize
+      Summary:  Returns the size of the index buffer
+      Returns:  UINT
+                  Size of getIndexData in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::getIndexDataSize() const {
+        return sizeof(WORD) * GetNumIndices();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::InitializeTransform
+      Summary:  Adds the nodes of the object to the transform hierarchy.
+                By default nothing is added and the world matrix is the
+                one built by RotateX, Translate, Scale and so on
+      Args:     TransformHierarchy& transforms
+                  Hierarchy owned by the renderer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::InitializeTransform(_In_ TransformHierarchy& transforms) {
+        UNREFERENCED_PARAMETER(transforms);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::AttachTransform
+      Summary:  Makes the world matrix follow a node of a hierarchy
+                instead of m_world
+      Args:     TransformHierarchy* pTransforms
+                  Hierarchy that owns the node, nullptr to detach
+                UINT uNode
+                  Index of the node
+      Modifies: [m_pTransforms, m_uTransformNode].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderable::AttachTransform(_In_ TransformHierarchy* pTransforms, _In_ UINT uNode) {
+        m_pTransforms = pTransforms;
+        m_uTransformNode = pTransforms ? uNode : TransformHierarchy::INVALID_NODE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetTransformNode
+      Summary:  Returns the attached hierarchy node
+      Returns:  UINT
+                  Index of the node, INVALID_NODE if not attached
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::GetTransformNode() const {
+        return m_uTransformNode;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetOutputColor
       Summary:  Returns the output color
@@ -226,6 +503,19 @@ namespace library
         return m_aMaterials[uIndex];
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::GetMaterial
+      Summary:  Returns a material at given index, to pack its textures
+      Returns:  Material&
+                  Material at given index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Material& Renderable::GetMaterial(UINT uIndex)
+    {
+        assert(uIndex < m_aMaterials.size());
+
+        return m_aMaterials[uIndex];
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::GetMesh
       Summary:  Returns a basic mesh entry at given index
@@ -239,6 +529,72 @@ namespace library
         return m_aMeshes[uIndex];
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::SelectMeshLod
+      Summary:  Returns the coarsest level of detail of a mesh whose
+                error does not exceed a given error. Levels are ordered
+                from fine to coarse with growing errors
+      Args:     UINT uMesh
+                  Index of the mesh
+                FLOAT fMaxError
+                  Largest acceptable error in object units
+      Returns:  UINT
+                  0 for the full detail mesh, otherwise one past the
+                  index of the level in BasicMeshEntry::aLods
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::SelectMeshLod(_In_ UINT uMesh, _In_ FLOAT fMaxError) const
+    {
+        const BasicMeshEntry& mesh = GetMesh(uMesh);
+
+        UINT uLod = 0u;
+
+        while (uLod < mesh.uNumLods && mesh.aLods[uLod].fError <= fMaxError)
+        {
+            ++uLod;
+        }
+
+        return uLod;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderable::CullMeshlets
+      Summary:  Culls the meshlets of the full detail level of a mesh
+                and returns the ranges of the index buffer to draw
+      Args:     UINT uMesh
+                  Index of the mesh
+                const XMFLOAT4X4& objectToClip
+                  World * view * projection matrix of the renderable
+                const XMFLOAT3& cameraPosition
+                  Camera position in object space
+                MeshletRange* pOutRanges
+                  Receives the ranges, in indices from the first index
+                  of the mesh. Room for the meshlets of the mesh
+                MeshletCullStats* pStats
+                  Counters to accumulate into, can be nullptr
+      Returns:  UINT
+                  Number of ranges written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderable::CullMeshlets(
+        _In_ UINT uMesh,
+        _In_ const XMFLOAT4X4& objectToClip,
+        _In_ const XMFLOAT3& cameraPosition,
+        _Out_writes_to_(GetMesh(uMesh).uNumMeshlets, return) MeshletRange* pOutRanges,
+        _Inout_opt_ MeshletCullStats* pStats
+    ) const
+    {
+        const BasicMeshEntry& mesh = GetMesh(uMesh);
+
+        if (mesh.uNumMeshlets == 0u)
+        {
+            return 0u;
+        }
+
+        const FLOAT afCameraPosition[3] = { cameraPosition.x, cameraPosition.y, cameraPosition.z };
+
+        return MeshletBuilder::Cull(m_aMeshlets.data() + mesh.uFirstMeshlet, mesh.uNumMeshlets, &objectToClip.m[0][0],
+            afCameraPosition, pOutRanges, pStats);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderable::RotateX
       Summary:  Rotates around the x-axis
@@ -10,7 +10,11 @@
 
 #include "Common.h"
 
+#include "Model/MeshletBuilder.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/TransformHierarchy.h"
+#include "Renderer/VertexQuantizer.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
@@ -25,14 +29,61 @@ namespace library
                 Update
                   Pure virtual function that updates the object each
                   frame
+                GetVertexShaderObject
+                  Returns the vertex shader the object is drawn with
+                GetPixelShaderObject
+                  Returns the pixel shader the object is drawn with
+                PrepareShaders
+                  Compiles the shader variants of a key
+                GetVertexShader
+                  Returns the vertex shader variant of a key
+                GetPixelShader
+                  Returns the pixel shader variant of a key
+                GetVertexLayout
+                  Returns the input layout variant of a key
                 GetVertexBuffer
                   Returns the vertex buffer
                 GetIndexBuffer
                   Returns the index buffer
                 GetConstantBuffer
                   Returns the constant buffer
+                InitializeTransform
+                  Virtual function that adds the nodes of the object to
+                  a transform hierarchy
+                AttachTransform
+                  Makes the world matrix follow a hierarchy node
+                GetTransformNode
+                  Returns the attached hierarchy node
                 GetWorldMatrix
                   Returns the world matrix
+                SetVertexFormat
+                  Selects the vertex buffer format
+                GetVertexFormat
+                  Returns the vertex buffer format
+                GetVertexStride
+                  Returns the size of a vertex in the vertex buffer
+                GetPositionScale
+                  Returns the scale that decodes compact positions
+                GetPositionBias
+                  Returns the bias that decodes compact positions
+                GetQuantizationError
+                  Returns the error of the compact vertices
+                SetOccluder
+                  Marks the object as an occluder for occlusion culling
+                IsOccluder
+                  Returns whether the object is an occluder
+                GetLocalBoundsMin
+                  Returns the minimum corner of the local bounding box
+                GetLocalBoundsMax
+                  Returns the maximum corner of the local bounding box
+                SelectMeshLod
+                  Returns the coarsest level of a mesh within an error
+                CullMeshlets
+                  Returns the index ranges of the meshlets of a mesh
+                  that can be visible
+                RasterizeOccluder
+                  Virtual function that rasterizes the triangles into an
+                  occlusion culler
                 GetNumVertices
                   Pure virtual function that returns the number of
                   vertices
@@ -48,6 +99,17 @@ namespace library
     {
     protected:
 #define INVALID_MATERIAL (0xFFFFFFFF)
+        // A simplified level of a mesh. It uses the vertices of the mesh
+        // and only has its own indices; fError is the geometric error in
+        // object units
+        struct MeshLod
+        {
+            UINT uNumIndices;
+            UINT uBaseIndex;
+            UINT uIndexOffset;
+            FLOAT fError;
+        };
+
         struct BasicMeshEntry
         {
             BasicMeshEntry()
@@ -55,6 +117,13 @@ namespace library
                 , uBaseVertex(0u)
                 , uBaseIndex(0u)
                 , uMaterialIndex(INVALID_MATERIAL)
+                , uNumVertices(0u)
+                , indexFormat(DXGI_FORMAT_R16_UINT)
+                , uIndexOffset(0u)
+                , uNumLods(0u)
+                , aLods()
+                , uFirstMeshlet(0u)
+                , uNumMeshlets(0u)
             {
             }
 
@@ -62,6 +131,13 @@ namespace library
             UINT uBaseVertex;
             UINT uBaseIndex;
             UINT uMaterialIndex;
+            UINT uNumVertices;
+            DXGI_FORMAT indexFormat;
+            UINT uIndexOffset;
+            UINT uNumLods;
+            MeshLod aLods[MAX_MESH_LODS];
+            UINT uFirstMeshlet;
+            UINT uNumMeshlets;
         };
 
     public:
@@ -74,22 +150,49 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) = 0;
         virtual void Update(_In_ FLOAT deltaTime) = 0;
+        virtual void InitializeTransform(_In_ TransformHierarchy& transforms);
+
+        void AttachTransform(_In_ TransformHierarchy* pTransforms, _In_ UINT uNode);
+        UINT GetTransformNode() const;
 
         void SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader);
         void SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader);
 
-        ComPtr<ID3D11VertexShader>& GetVertexShader();
-        ComPtr<ID3D11PixelShader>& GetPixelShader();
-        ComPtr<ID3D11InputLayout>& GetVertexLayout();
+        const std::shared_ptr<VertexShader>& GetVertexShaderObject() const;
+        const std::shared_ptr<PixelShader>& GetPixelShaderObject() const;
+        HRESULT PrepareShaders(_In_ ID3D11Device* pDevice, _In_ UINT uKey);
+        ComPtr<ID3D11VertexShader>& GetVertexShader(_In_ UINT uKey = 0u);
+        ComPtr<ID3D11PixelShader>& GetPixelShader(_In_ UINT uKey = 0u);
+        ComPtr<ID3D11InputLayout>& GetVertexLayout(_In_ UINT uKey = 0u);
         ComPtr<ID3D11Buffer>& GetVertexBuffer();
         ComPtr<ID3D11Buffer>& GetIndexBuffer();
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
 
         const XMMATRIX& GetWorldMatrix() const;
+        void SetVertexFormat(_In_ eVertexFormat vertexFormat);
+        eVertexFormat GetVertexFormat() const;
+        UINT GetVertexStride() const;
+        const XMFLOAT4& GetPositionScale() const;
+        const XMFLOAT4& GetPositionBias() const;
+        const QuantizationError& GetQuantizationError() const;
+        void SetOccluder(_In_ BOOL bOccluder);
+        BOOL IsOccluder() const;
+        const XMFLOAT3& GetLocalBoundsMin() const;
+        const XMFLOAT3& GetLocalBoundsMax() const;
+        virtual void RasterizeOccluder(_Inout_ OcclusionCuller& occlusionCuller) const;
         const XMFLOAT4& GetOutputColor() const;
         BOOL HasTexture() const;
         const Material& GetMaterial(UINT uIndex) const;
+        Material& GetMaterial(UINT uIndex);
         const BasicMeshEntry& GetMesh(UINT uIndex) const;
+        UINT SelectMeshLod(_In_ UINT uMesh, _In_ FLOAT fMaxError) const;
+        UINT CullMeshlets(
+            _In_ UINT uMesh,
+            _In_ const XMFLOAT4X4& objectToClip,
+            _In_ const XMFLOAT3& cameraPosition,
+            _Out_writes_to_(GetMesh(uMesh).uNumMeshlets, return) MeshletRange* pOutRanges,
+            _Inout_opt_ MeshletCullStats* pStats
+        ) const;
 
         void RotateX(_In_ FLOAT angle);
         void RotateY(_In_ FLOAT angle);
@@ -106,6 +209,8 @@ namespace library
     protected:
         const virtual SimpleVertex* getVertices() const = 0;
         virtual const WORD* getIndices() const = 0;
+        virtual const void* getIndexData() const;
+        virtual UINT getIndexDataSize() const;
         HRESULT initialize(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext
@@ -118,10 +223,23 @@ namespace library
 
         std::vector<BasicMeshEntry> m_aMeshes;
         std::vector<Material> m_aMaterials;
+        std::vector<Meshlet> m_aMeshlets;
 
         std::shared_ptr<VertexShader> m_vertexShader;
         std::shared_ptr<PixelShader> m_pixelShader;
 
+        TransformHierarchy* m_pTransforms;
+        UINT m_uTransformNode;
+
+        eVertexFormat m_vertexFormat;
+        XMFLOAT4 m_positionScale;
+        XMFLOAT4 m_positionBias;
+        QuantizationError m_quantizationError;
+
+        XMFLOAT3 m_localBoundsMin;
+        XMFLOAT3 m_localBoundsMax;
+        BOOL m_bOccluder;
+
         XMFLOAT4 m_outputColor;
         BYTE m_padding[8];
         XMMATRIX m_world;
@@ -1,5 +1,7 @@
 #include "Renderer/Renderer.h"
 
+#include <algorithm>
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -8,7 +10,9 @@ namespace library
       Modifies: [m_driverType, m_featureLevel, m_d3dDevice, m_d3dDevice1,
                   m_immediateContext, m_immediateContext1, m_swapChain,
                   m_swapChain1, m_renderTargetView, m_vertexShader,
-                  m_pixelShader, m_vertexLayout, m_vertexBuffer].
+                  m_pixelShader, m_vertexLayout, m_vertexBuffer,
+                  m_textureStreamer, m_textureSliceBuffer, m_assetWatcher,
+                  m_aPendingReloads, m_aDeferredReloads].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 
     Renderer::Renderer() :
@@ -24,11 +28,35 @@ namespace library
         m_depthStencilView(),
         m_camera(XMVectorSet(0.0f, 1.0f, -5.0f, 0.0f)),
         m_projection(XMMatrixIdentity()),
+        m_viewProjection(XMMatrixIdentity()),
+        m_dynamicConstantBuffer(DYNAMIC_CONSTANT_BUFFER_SIZE, FRAME_LATENCY, D3D11_BIND_CONSTANT_BUFFER),
+        m_bConstantBufferOffsetting(FALSE),
+        m_bCameraCached(FALSE),
+        m_bLightsCached(FALSE),
+        m_cbCameraCache(),
+        m_cbLightsCache(),
+        m_uLightFeatures(0u),
+        m_transforms(),
+        m_viewport(),
+        m_aDrawList(),
+        m_aDrawPixelsPerUnit(),
+        m_fLodPixelError(1.0f),
+        m_bMeshletCulling(TRUE),
+        m_aDrawCommandLists(),
+        m_aDeferredContexts(),
+        m_aCommandLists(),
+        m_occlusionCuller(),
+        m_bOcclusionCulling(TRUE),
+        m_textureStreamer(),
         m_renderables(std::unordered_map<std::wstring, std::shared_ptr<Renderable>>()),
         m_vertexShaders(std::unordered_map<std::wstring, std::shared_ptr<VertexShader>>()),
         m_pixelShaders(std::unordered_map<std::wstring, std::shared_ptr<PixelShader>>()),
         m_cbLights(),
-        m_aPointLights()
+        m_textureSliceBuffer(),
+        m_aPointLights(),
+        m_assetWatcher(),
+        m_aPendingReloads(),
+        m_aDeferredReloads()
     {
     }
 
@@ -40,7 +68,8 @@ namespace library
       Modifies: [m_d3dDevice, m_featureLevel, m_immediateContext,
                   m_d3dDevice1, m_immediateContext1, m_swapChain1,
                   m_swapChain, m_renderTargetView, m_vertexShader,
-                  m_vertexLayout, m_pixelShader, m_vertexBuffer].
+                  m_vertexLayout, m_pixelShader, m_vertexBuffer,
+                  m_textureSliceBuffer, m_assetWatcher].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -217,7 +246,7 @@ namespace library
 
         m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
 
-        D3D11_VIEWPORT vp = {
+        m_viewport = {
             .TopLeftX = 0,
             .TopLeftY = 0,
             .Width = (FLOAT)width,
@@ -226,7 +255,7 @@ namespace library
             .MaxDepth = 1.0f
         };
         
-        m_immediateContext->RSSetViewports(1, &vp);
+        m_immediateContext->RSSetViewports(1, &m_viewport);
         m_immediateContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
         float fovAngleY = XM_PIDIV2;
@@ -284,22 +313,28 @@ namespace library
         m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
         m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
 
+        // The shaders compile on the thread pool, so a cold start takes
+        // about as long as the slowest shader rather than all of them
+        std::vector<ShaderVariant> aShaderVariants;
+
         for (auto iVShader = m_vertexShaders.begin(); iVShader != m_vertexShaders.end(); iVShader++)
         {
-            hr = iVShader->second->Initialize(m_d3dDevice.Get());
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            aShaderVariants.push_back(ShaderVariant{ .pShader = iVShader->second.get(), .uKey = 0u });
         }
 
         for (auto iPShader = m_pixelShaders.begin(); iPShader != m_pixelShaders.end(); iPShader++)
         {
-            hr = iPShader->second->Initialize(m_d3dDevice.Get());
-            if (FAILED(hr))
-            {
-                return hr;
-            }
+            aShaderVariants.push_back(ShaderVariant{ .pShader = iPShader->second.get(), .uKey = 0u });
+        }
+
+        std::wstring szShaderErrors;
+        hr = compileShaders(aShaderVariants, szShaderErrors);
+        if (FAILED(hr))
+        {
+            szShaderErrors = L"The FX file cannot be compiled.  Please run this executable from the directory that contains the FX file.\n\n"
+                + szShaderErrors;
+            MessageBox(nullptr, szShaderErrors.c_str(), L"Error", MB_OK);
+            return hr;
         }
 
         hr = m_camera.Initialize(m_d3dDevice.Get());
@@ -309,6 +344,27 @@ namespace library
             return hr;
         }
 
+        // Object constants are suballocated from one large buffer and bound
+        // by offset, which needs Direct3D 11.1. Otherwise every renderable
+        // keeps updating its own constant buffer
+        if (m_immediateContext1)
+        {
+            D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+
+            if (SUCCEEDED(m_d3dDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)))
+                && options.ConstantBufferOffsetting)
+            {
+                hr = m_dynamicConstantBuffer.Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                m_bConstantBufferOffsetting = TRUE;
+            }
+        }
+
         D3D11_BUFFER_DESC bd = {
             .ByteWidth = sizeof(CBChangeOnResize),
             .Usage = D3D11_USAGE_DEFAULT,
@@ -322,6 +378,34 @@ namespace library
             return hr;
         }
 
+        // Slice i is written at constant range i, so a draw binding the
+        // range of its slice samples that slice of the texture array.
+        // Without ranges only slice 0 is bound, and textures stay unpacked
+        UINT uNumSlices = m_bConstantBufferOffsetting ? TextureArray::MAX_SLICES : 1u;
+        UINT uSliceSize = DrawCommandList::TEXTURE_SLICE_CONSTANTS * 16u;
+        std::vector<BYTE> aTextureSlices(static_cast<size_t>(uNumSlices) * uSliceSize);
+
+        for (UINT i = 0u; i < uNumSlices; ++i) {
+            reinterpret_cast<CBTextureSlice*>(&aTextureSlices[static_cast<size_t>(i) * uSliceSize])->TextureSlice = i;
+        }
+
+        D3D11_BUFFER_DESC sliceDesc = {
+            .ByteWidth = static_cast<UINT>(aTextureSlices.size()),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA sliceData = {
+            .pSysMem = aTextureSlices.data()
+        };
+
+        hr = m_d3dDevice->CreateBuffer(&sliceDesc, &sliceData, m_textureSliceBuffer.GetAddressOf());
+
+        if (FAILED(hr)) {
+            return hr;
+        }
+
         for (auto iRenderable = m_renderables.begin(); iRenderable != m_renderables.end(); iRenderable++)
         {
             hr = iRenderable->second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
@@ -331,19 +415,57 @@ namespace library
             }
         }
 
-        XMFLOAT4 camPos;
-        XMStoreFloat4(&camPos, m_camera.GetEye());
-        CBChangeOnCameraMovement cbCamera = {
-            .View = XMMatrixTranspose(m_camera.GetView()),
-            .CameraPosition = camPos
-        };
-        m_immediateContext->UpdateSubresource(m_camera.GetConstantBuffer().Get(), 0, nullptr, &cbCamera, 0, 0);
+        packTextures();
+
+        // One recorder per worker thread plus the rendering thread. Without
+        // deferred contexts the recorded lists are replayed on the
+        // immediate context
+        UINT uNumRecorders = ThreadPool::GetShared().GetNumThreads() + 1u;
+        m_aDrawCommandLists.resize(uNumRecorders);
+
+        if (m_d3dDevice1)
+        {
+            m_aDeferredContexts.resize(uNumRecorders);
+            m_aCommandLists.resize(uNumRecorders);
+
+            for (UINT i = 0u; i < uNumRecorders; ++i)
+            {
+                if (FAILED(m_d3dDevice1->CreateDeferredContext1(0u, m_aDeferredContexts[i].GetAddressOf())))
+                {
+                    m_aDeferredContexts.clear();
+                    m_aCommandLists.clear();
+                    break;
+                }
+            }
+        }
+
+        m_bCameraCached = FALSE;
+        m_bLightsCached = FALSE;
+        updateCameraConstantBuffer();
+        updateLightsConstantBuffer();
+
+        // Variants for the lights and materials set up so far are
+        // compiled now rather than on the first frames. One that fails is
+        // not fatal: its meshes are left out
+        aShaderVariants.clear();
+
+        for (auto iRenderable = m_renderables.begin(); iRenderable != m_renderables.end(); iRenderable++)
+        {
+            collectShaderVariants(iRenderable->second.get(), aShaderVariants);
+        }
+
+        if (FAILED(compileShaders(aShaderVariants, szShaderErrors)))
+        {
+            OutputDebugString(szShaderErrors.c_str());
+        }
 
         m_projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, width / (FLOAT)height, 0.01f, 100.0f);
         CBChangeOnResize cbChangesOnResize;
         cbChangesOnResize.Projection = XMMatrixTranspose(m_projection);
         m_immediateContext->UpdateSubresource(m_cbChangeOnResize.Get(), 0, nullptr, &cbChangesOnResize, 0, 0);
 
+        watchAssets();
+
         return S_OK;
     }
 
@@ -354,7 +476,7 @@ namespace library
                   Key of the renderable object
                 const std::shared_ptr<Renderable>& renderable
                   Unique pointer to the renderable object
-      Modifies: [m_renderables].
+      Modifies: [m_renderables, m_transforms].
       Returns:  HRESULT
                   Status code.
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
@@ -369,6 +491,7 @@ namespace library
         }
 
         m_renderables.insert(std::pair<std::wstring, std::shared_ptr<Renderable>>(pszRenderableName, renderable));
+        renderable->InitializeTransform(m_transforms);
 
         return S_OK;
     }
@@ -502,18 +625,25 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Renderer::Update
-      Summary:  Update the renderables each frame
+      Summary:  Swaps in the reloaded assets, updates the renderables
+                each frame, then recompute the world matrices of the
+                transforms they changed
       Args:     FLOAT deltaTime
                   Time difference of a frame
+      Modifies: [m_transforms, m_aPendingReloads, m_aDeferredReloads].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     void Renderer::Update(_In_ FLOAT deltaTime) {
 
+        reloadChangedAssets();
+
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>>::iterator it;
 
         for (it = m_renderables.begin(); it != m_renderables.end(); it++) {
             it->second->Update(deltaTime);
         }
 
+        m_transforms.Update();
+
         for (auto& light : m_aPointLights) {
             light->Update(deltaTime);
         }
@@ -529,69 +659,91 @@ namespace library
 
     void Renderer::Render() {
 
+        // If the ring cannot reclaim old frames, this frame updates the
+        // constant buffers of the renderables instead
+        BOOL bRingFrame = m_bConstantBufferOffsetting && SUCCEEDED(m_dynamicConstantBuffer.BeginFrame());
+
         m_immediateContext->ClearRenderTargetView(m_renderTargetView.Get(), Colors::MidnightBlue);
         m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
 
-        XMFLOAT4 camPos;
-        XMStoreFloat4(&camPos, m_camera.GetEye());
-        CBChangeOnCameraMovement cbCamera = {
-            .View = XMMatrixTranspose(m_camera.GetView()),
-            .CameraPosition = camPos
-        };
-        m_immediateContext->UpdateSubresource(m_camera.GetConstantBuffer().Get(), 0, nullptr, &cbCamera, 0, 0);
+        updateCameraConstantBuffer();
         m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
         m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
 
-        CBLights cbLights = {};
+        updateLightsConstantBuffer();
+        m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
 
-        for (int i = 0; i < NUM_LIGHTS; i++)
-        {
-            if (!m_aPointLights[i]) continue;
-            cbLights.LightPositions[i] = m_aPointLights[i]->GetPosition();
-            cbLights.LightColors[i] = m_aPointLights[i]->GetColor();
-        }
+        buildDrawList();
 
-        m_immediateContext->UpdateSubresource( m_cbLights.Get(), 0u, nullptr, &cbLights, 0u, 0u);
-        m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+        // Views of streamed textures change before any draw records them
+        m_textureStreamer.Update(m_d3dDevice.Get(), m_immediateContext.Get());
 
-        for (auto it = m_renderables.begin(); it != m_renderables.end(); it++) {
+        RingAllocation objectConstants = {};
+        BOOL bBatchedConstants = bRingFrame && allocateObjectConstants(objectConstants);
 
-            UINT uStride = sizeof(SimpleVertex);
-            UINT uOffset = 0;
-            m_immediateContext->IASetVertexBuffers(0u, 1u, it->second->GetVertexBuffer().GetAddressOf(),
-                &uStride, &uOffset);
-            m_immediateContext->IASetIndexBuffer(it->second->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
-            m_immediateContext->IASetInputLayout(it->second->GetVertexLayout().Get());
+        if (!bBatchedConstants) {
+            for (Renderable* pRenderable : m_aDrawList) {
+                CBChangesEveryFrame cb = {
+                    .World = XMMatrixTranspose(pRenderable->GetWorldMatrix()),
+                    .OutputColor = pRenderable->GetOutputColor(),
+                    .PositionScale = pRenderable->GetPositionScale(),
+                    .PositionBias = pRenderable->GetPositionBias()
+                };
 
-            CBChangesEveryFrame cb = {
-                .World = XMMatrixTranspose(it->second->GetWorldMatrix()),
-                .OutputColor = it->second->GetOutputColor()
-            };
+                m_immediateContext->UpdateSubresource(pRenderable->GetConstantBuffer().Get(), 0, nullptr, &cb, 0, 0);
+            }
+        }
 
-            m_immediateContext->UpdateSubresource(it->second->GetConstantBuffer().Get(), 0, nullptr, &cb, 0, 0);
-
-            m_immediateContext->VSSetShader(it->second->GetVertexShader().Get(), nullptr, 0);
-            m_immediateContext->VSSetConstantBuffers(2, 1, it->second->GetConstantBuffer().GetAddressOf());
-            m_immediateContext->PSSetShader(it->second->GetPixelShader().Get(), nullptr, 0);
-            m_immediateContext->PSSetConstantBuffers(2, 1, it->second->GetConstantBuffer().GetAddressOf());
-
-            if(it->second->HasTexture()){
-                for (UINT i = 0; i < it->second->GetNumMeshes(); ++i) {
-                    UINT materialIndex = it->second->GetMesh(i).uMaterialIndex;
-                    m_immediateContext->PSSetShaderResources(0, 1, 
-                        it->second->GetMaterial(materialIndex).pDiffuse->GetTextureResourceView().GetAddressOf());
-                    m_immediateContext->PSSetSamplers(0, 1, 
-                        it->second->GetMaterial(materialIndex).pDiffuse->GetSamplerState().GetAddressOf());
-                    m_immediateContext->DrawIndexed(it->second->GetMesh(i).uNumIndices,
-                        it->second->GetMesh(i).uBaseIndex, it->second->GetMesh(i).uBaseVertex);
-                }
+        // Small scenes are recorded by the calling thread alone, larger
+        // ones are split into one contiguous range per recorder
+        UINT uNumDraws = static_cast<UINT>(m_aDrawList.size());
+        UINT uNumChunks = (std::min)((uNumDraws + MIN_DRAWS_PER_RECORDER - 1u) / MIN_DRAWS_PER_RECORDER,
+            static_cast<UINT>(m_aDrawCommandLists.size()));
+        BOOL bDeferred = uNumChunks > 1u && !m_aDeferredContexts.empty();
+
+        ThreadPool::GetShared().ParallelFor(uNumChunks, [&](UINT uChunk) {
+            UINT uBegin = uChunk * uNumDraws / uNumChunks;
+            UINT uEnd = (uChunk + 1u) * uNumDraws / uNumChunks;
+
+            DrawCommandList& drawCommands = m_aDrawCommandLists[uChunk];
+            drawCommands.Reset();
+            recordDraws(drawCommands, uBegin, uEnd, bBatchedConstants ? &objectConstants : nullptr);
+
+            if (bDeferred) {
+                ID3D11DeviceContext1* pDeferredContext = m_aDeferredContexts[uChunk].Get();
+                bindFrameState(pDeferredContext);
+                drawCommands.Execute(pDeferredContext, pDeferredContext);
+                pDeferredContext->FinishCommandList(FALSE, m_aCommandLists[uChunk].ReleaseAndGetAddressOf());
+            }
+        });
+
+        // The constants have to be unmapped before any draw reading them
+        // reaches the immediate context
+        if (bRingFrame) {
+            m_dynamicConstantBuffer.Flush();
+        }
+
+        for (UINT uChunk = 0u; uChunk < uNumChunks; ++uChunk) {
+            if (bDeferred) {
+                m_immediateContext->ExecuteCommandList(m_aCommandLists[uChunk].Get(), FALSE);
+                m_aCommandLists[uChunk].Reset();
             }
 
             else {
-                m_immediateContext->DrawIndexed(it->second->GetNumIndices(), 0, 0);
+                m_aDrawCommandLists[uChunk].Execute(m_immediateContext.Get(), m_immediateContext1.Get());
             }
         }
 
+        // Executing a command list without restoring clears the state of
+        // the immediate context
+        if (bDeferred) {
+            bindFrameState(m_immediateContext.Get());
+        }
+
+        if (bRingFrame) {
+            m_dynamicConstantBuffer.EndFrame();
+        }
+
         m_swapChain->Present(0, 0);
         m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
     }
@@ -617,6 +769,10 @@ namespace library
             if (it->first == pszRenderableName) {
                 for (itVertex = m_vertexShaders.begin(); itVertex != m_vertexShaders.end(); itVertex++) {
                     if (itVertex->first == pszVertexShaderName) {
+                        // The input layout must match the vertex buffer the renderable was built with
+                        if (itVertex->second->GetVertexFormat() != it->second->GetVertexFormat()) {
+                            return E_INVALIDARG;
+                        }
                         it->second->SetVertexShader(itVertex->second);
                     }
                 }
@@ -675,9 +831,7 @@ namespace library
             if (it->first == pszSceneName) {
                 for (itVertex = m_vertexShaders.begin(); itVertex != m_vertexShaders.end(); itVertex++) {
                     if (itVertex->first == pszVertexShaderName) {
-                        for (std::vector<Voxel>::size_type i = 0; i < it->second->GetVoxels().size(); i++) {
-                            it->second->GetVoxels()[i]->SetVertexShader(itVertex->second);
-                        }
+                        it->second->SetVertexShader(itVertex->second);
                     }
                 }
             }
@@ -705,9 +859,7 @@ namespace library
             if (it->first == pszSceneName) {
                 for (itPixel = m_pixelShaders.begin(); itPixel != m_pixelShaders.end(); itPixel++) {
                     if (itPixel->first == pszPixelShaderName) {
-                        for (std::vector<Voxel>::size_type i = 0; i < it->second->GetVoxels().size(); i++) {
-                            it->second->GetVoxels()[i]->SetPixelShader(itPixel->second);
-                        }
+                        it->second->SetPixelShader(itPixel->second);
                     }
                 }
             }
@@ -725,4 +877,884 @@ namespace library
     D3D_DRIVER_TYPE Renderer::GetDriverType() const {
         return m_driverType;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetTransformHierarchy
+      Summary:  Returns the transform hierarchy. Renderables add their
+                nodes when they are added to the renderer, and the world
+                matrices are recomputed once per Update
+      Returns:  TransformHierarchy&
+                  Transform hierarchy of the renderables
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformHierarchy& Renderer::GetTransformHierarchy() {
+        return m_transforms;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetTextureStreamer
+      Summary:  Returns the texture streamer, to set its memory and
+                upload budgets or read its counters
+      Returns:  TextureStreamer&
+                  Texture streamer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer& Renderer::GetTextureStreamer() {
+        return m_textureStreamer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::updateCameraConstantBuffer
+      Summary:  Updates the camera constant buffer, skipping the update
+                when the view and eye position did not change
+      Modifies: [m_cbCameraCache, m_bCameraCached].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::updateCameraConstantBuffer() {
+        XMFLOAT4 camPos;
+        XMStoreFloat4(&camPos, m_camera.GetEye());
+        CBChangeOnCameraMovement cbCamera = {
+            .View = XMMatrixTranspose(m_camera.GetView()),
+            .CameraPosition = camPos
+        };
+
+        if (m_bCameraCached && memcmp(&cbCamera, &m_cbCameraCache, sizeof(cbCamera)) == 0) {
+            return;
+        }
+
+        m_immediateContext->UpdateSubresource(m_camera.GetConstantBuffer().Get(), 0, nullptr, &cbCamera, 0, 0);
+        m_cbCameraCache = cbCamera;
+        m_bCameraCached = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::updateLightsConstantBuffer
+      Summary:  Updates the lights constant buffer, skipping the update
+                when no light moved or changed color. The lights that
+                are set are packed at the front and counted, so shaders
+                loop over the active lights only
+      Modifies: [m_cbLightsCache, m_bLightsCached,
+                 m_uLightFeatures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::updateLightsConstantBuffer() {
+        CBLights cbLights = {};
+        UINT uNumLights = 0u;
+
+        for (int i = 0; i < NUM_LIGHTS; i++)
+        {
+            if (!m_aPointLights[i]) continue;
+            cbLights.LightPositions[uNumLights] = m_aPointLights[i]->GetPosition();
+            cbLights.LightColors[uNumLights] = m_aPointLights[i]->GetColor();
+            ++uNumLights;
+        }
+
+        m_uLightFeatures = Shader::GetLightBucket(uNumLights);
+
+        if (m_bLightsCached && memcmp(&cbLights, &m_cbLightsCache, sizeof(cbLights)) == 0) {
+            return;
+        }
+
+        m_immediateContext->UpdateSubresource(m_cbLights.Get(), 0u, nullptr, &cbLights, 0u, 0u);
+        m_cbLightsCache = cbLights;
+        m_bLightsCached = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetOcclusionCulling
+      Summary:  Enables or disables software occlusion culling
+      Args:     BOOL bOcclusionCulling
+                  TRUE to cull renderables hidden behind occluders
+      Modifies: [m_bOcclusionCulling].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetOcclusionCulling(_In_ BOOL bOcclusionCulling) {
+        m_bOcclusionCulling = bOcclusionCulling;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::GetOcclusionCuller
+      Summary:  Returns the occlusion culler, whose counters describe
+                the last rendered frame
+      Returns:  const OcclusionCuller&
+                  Occlusion culler
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const OcclusionCuller& Renderer::GetOcclusionCuller() const {
+        return m_occlusionCuller;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetLodPixelError
+      Summary:  Sets how far in pixels a simplified mesh level may
+                deviate from the full detail mesh on screen. Each frame
+                every mesh is drawn with its coarsest level within it
+      Args:     FLOAT fLodPixelError
+                  Error in pixels, 0 or less always draws full detail
+      Modifies: [m_fLodPixelError].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetLodPixelError(_In_ FLOAT fLodPixelError) {
+        m_fLodPixelError = fLodPixelError;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::SetMeshletCulling
+      Summary:  Enables or disables meshlet culling. When enabled, the
+                full detail level of a mesh with enough meshlets only
+                draws the meshlets that face the camera and are inside
+                the view frustum
+      Args:     BOOL bMeshletCulling
+                  TRUE to cull meshlets
+      Modifies: [m_bMeshletCulling].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::SetMeshletCulling(_In_ BOOL bMeshletCulling) {
+        m_bMeshletCulling = bMeshletCulling;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::buildDrawList
+      Summary:  Collects the renderables to draw this frame. When
+                occlusion culling is on and some renderables are marked
+                as occluders, the occluders are rasterized into the
+                software depth buffer and every renderable whose world
+                bounding box is hidden behind them is left out. For the
+                level of detail selection, the number of pixels one
+                object unit covers at the nearest point of the bounding
+                sphere is stored along. The diffuse and normal textures
+                of every renderable drawn are requested from the
+                texture streamer at the size of the bounding box
+                diagonal on screen, as if the texture was spread over
+                the object, and the shader variants its meshes need are
+                prepared before any draw is recorded
+      Modifies: [m_aDrawList, m_aDrawPixelsPerUnit, m_viewProjection,
+                 m_occlusionCuller, m_textureStreamer].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::buildDrawList() {
+        m_aDrawList.clear();
+        m_aDrawPixelsPerUnit.clear();
+
+        m_viewProjection = XMMatrixMultiply(m_camera.GetView(), m_projection);
+
+        XMFLOAT4X4 projection;
+        XMStoreFloat4x4(&projection, m_projection);
+
+        // Pixels covered by one unit at a distance of one unit
+        FLOAT fPixelsPerUnitAtOne = 0.5f * m_viewport.Height * projection._22;
+        XMVECTOR eye = m_camera.GetEye();
+
+        BOOL bCull = FALSE;
+
+        if (m_bOcclusionCulling) {
+            XMFLOAT4X4 viewProjection;
+            XMStoreFloat4x4(&viewProjection, m_viewProjection);
+            m_occlusionCuller.BeginFrame(&viewProjection.m[0][0]);
+
+            for (auto it = m_renderables.begin(); it != m_renderables.end(); it++) {
+                if (it->second->IsOccluder()) {
+                    it->second->RasterizeOccluder(m_occlusionCuller);
+                }
+            }
+
+            bCull = m_occlusionCuller.GetStats().uNumOccluderTriangles > 0u;
+        }
+
+        for (auto it = m_renderables.begin(); it != m_renderables.end(); it++) {
+            if (bCull) {
+                XMFLOAT4X4 world;
+                XMStoreFloat4x4(&world, it->second->GetWorldMatrix());
+
+                if (!m_occlusionCuller.IsBoxVisible(&world.m[0][0], &it->second->GetLocalBoundsMin().x,
+                    &it->second->GetLocalBoundsMax().x)) {
+                    continue;
+                }
+            }
+
+            const XMMATRIX& world = it->second->GetWorldMatrix();
+            XMVECTOR boundsMin = XMLoadFloat3(&it->second->GetLocalBoundsMin());
+            XMVECTOR boundsMax = XMLoadFloat3(&it->second->GetLocalBoundsMax());
+
+            FLOAT fScale = (std::max)((std::max)(XMVectorGetX(XMVector3Length(world.r[0])),
+                XMVectorGetX(XMVector3Length(world.r[1]))), XMVectorGetX(XMVector3Length(world.r[2])));
+            FLOAT fRadius = 0.5f * XMVectorGetX(XMVector3Length(boundsMax - boundsMin)) * fScale;
+            XMVECTOR center = XMVector3TransformCoord(0.5f * (boundsMin + boundsMax), world);
+            FLOAT fDistance = (std::max)(XMVectorGetX(XMVector3Length(center - eye)) - fRadius, LOD_MIN_DISTANCE);
+
+            m_aDrawList.push_back(it->second.get());
+            m_aDrawPixelsPerUnit.push_back(fPixelsPerUnitAtOne * fScale / fDistance);
+
+            FLOAT fScreenSize = XMVectorGetX(XMVector3Length(boundsMax - boundsMin)) * m_aDrawPixelsPerUnit.back();
+
+            for (UINT i = 0u; i < it->second->GetNumMaterials(); ++i) {
+                m_textureStreamer.RequestTexture(it->second->GetMaterial(i).pDiffuse, fScreenSize);
+                m_textureStreamer.RequestTexture(it->second->GetMaterial(i).pNormal, fScreenSize);
+            }
+
+            prepareShaders(it->second.get());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::getShaderKey
+      Summary:  Returns the shader variant key of a draw: the light
+                count bucket of the active lights, and texturing and
+                normal mapping when the material has those textures
+      Args:     const Material* pMaterial
+                  Material of the mesh, nullptr for none
+      Returns:  UINT
+                  Shader::FEATURE_ bits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Renderer::getShaderKey(_In_opt_ const Material* pMaterial) const {
+        UINT uKey = m_uLightFeatures;
+
+        if (pMaterial) {
+            if (pMaterial->pDiffuseArray || pMaterial->pDiffuse) {
+                uKey |= Shader::FEATURE_TEXTURING;
+            }
+
+            if (pMaterial->pNormal) {
+                uKey |= Shader::FEATURE_NORMAL_MAPPING;
+            }
+        }
+
+        return uKey;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::getMeshMaterial
+      Summary:  Returns the material a mesh of a renderable is drawn
+                with
+      Args:     const Renderable* pRenderable
+                  Renderable of the mesh
+                UINT uMesh
+                  Index of the mesh
+      Returns:  const Material*
+                  Material, nullptr if the mesh has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Material* Renderer::getMeshMaterial(_In_ const Renderable* pRenderable, _In_ UINT uMesh) const {
+        UINT uMaterialIndex = pRenderable->GetMesh(uMesh).uMaterialIndex;
+
+        if (!pRenderable->HasTexture() || uMaterialIndex >= pRenderable->GetNumMaterials()) {
+            return nullptr;
+        }
+
+        return &pRenderable->GetMaterial(uMaterialIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::prepareShaders
+      Summary:  Compiles the shader variants the meshes of a renderable
+                are drawn with, if they are not compiled yet. Compile
+                errors go to the debugger once, and the meshes of a
+                variant that failed are not drawn
+      Args:     Renderable* pRenderable
+                  Renderable to draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::prepareShaders(_In_ Renderable* pRenderable) {
+        UINT uNumMeshes = (std::max)(pRenderable->GetNumMeshes(), 1u);
+
+        for (UINT i = 0u; i < uNumMeshes; ++i) {
+            UINT uKey = getShaderKey(pRenderable->GetNumMeshes() > 0u ? getMeshMaterial(pRenderable, i) : nullptr);
+
+            pRenderable->PrepareShaders(m_d3dDevice.Get(), uKey);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::collectShaderVariants
+      Summary:  Adds the shader variants the meshes of a renderable are
+                drawn with to a list, unless they are listed already
+      Args:     const Renderable* pRenderable
+                  Renderable to draw
+                std::vector<ShaderVariant>& aVariants
+                  List of distinct variants
+      Modifies: [aVariants].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::collectShaderVariants(_In_ const Renderable* pRenderable, _Inout_ std::vector<ShaderVariant>& aVariants) const {
+        UINT uNumMeshes = (std::max)(pRenderable->GetNumMeshes(), 1u);
+
+        for (UINT i = 0u; i < uNumMeshes; ++i) {
+            UINT uKey = getShaderKey(pRenderable->GetNumMeshes() > 0u ? getMeshMaterial(pRenderable, i) : nullptr);
+
+            for (Shader* pShader : { static_cast<Shader*>(pRenderable->GetVertexShaderObject().get()),
+                static_cast<Shader*>(pRenderable->GetPixelShaderObject().get()) }) {
+                if (!pShader) {
+                    continue;
+                }
+
+                ShaderVariant variant = { .pShader = pShader, .uKey = pShader->GetVariantKey(uKey) };
+
+                if (std::find(aVariants.begin(), aVariants.end(), variant) == aVariants.end()) {
+                    aVariants.push_back(variant);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::compileShaders
+      Summary:  Compiles shader variants on the thread pool and creates
+                their device objects there too, as the device is free
+                threaded. The ShaderCache compiles each on its own
+                thread and only locks to look up and store bytecode.
+                Every failure is reported, not only the first, with its
+                file, entry point and compiler messages
+      Args:     const std::vector<ShaderVariant>& aVariants
+                  Distinct variants to compile
+                std::wstring& szErrors
+                  Receives the errors, one block per failed variant
+      Returns:  HRESULT
+                  Status code of the first failed variant, S_OK if all
+                  compiled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Renderer::compileShaders(_In_ const std::vector<ShaderVariant>& aVariants, _Out_ std::wstring& szErrors) {
+        std::vector<HRESULT> aResults(aVariants.size(), S_OK);
+
+        ThreadPool::GetShared().ParallelFor(static_cast<UINT>(aVariants.size()), [&](UINT i) {
+            aResults[i] = aVariants[i].pShader->PrepareVariant(m_d3dDevice.Get(), aVariants[i].uKey);
+        });
+
+        HRESULT hr = S_OK;
+        szErrors.clear();
+
+        for (size_t i = 0u; i < aVariants.size(); ++i) {
+            if (SUCCEEDED(aResults[i])) {
+                continue;
+            }
+
+            if (SUCCEEDED(hr)) {
+                hr = aResults[i];
+            }
+
+            Shader* pShader = aVariants[i].pShader;
+
+            WCHAR szHeader[MAX_PATH + 128];
+            swprintf_s(szHeader, L"%s (%S, variant 0x%02X): error 0x%08lX\n", pShader->GetFileName(),
+                pShader->GetEntryPoint(), aVariants[i].uKey, static_cast<ULONG>(aResults[i]));
+
+            // Compiler messages are ASCII
+            std::string szMessages = pShader->GetErrors(aVariants[i].uKey);
+            szErrors += szHeader;
+            szErrors.append(szMessages.begin(), szMessages.end());
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::allocateObjectConstants
+      Summary:  Allocates one contiguous block of the constant ring
+                buffer with a 256-byte slot for every renderable in the
+                draw list. The recorders fill disjoint ranges of slots
+      Args:     RingAllocation& outAllocation
+                  Receives the block
+      Modifies: [m_dynamicConstantBuffer].
+      Returns:  BOOL
+                  TRUE if the block was allocated, FALSE if the ring is
+                  out of space and the per-renderable buffers must be
+                  used
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Renderer::allocateObjectConstants(_Out_ RingAllocation& outAllocation) {
+        static_assert(sizeof(CBChangesEveryFrame) <= OBJECT_CONSTANTS_SIZE);
+
+        outAllocation = {};
+
+        if (m_aDrawList.empty()) {
+            return FALSE;
+        }
+
+        UINT uSize = static_cast<UINT>(m_aDrawList.size()) * OBJECT_CONSTANTS_SIZE;
+
+        return m_dynamicConstantBuffer.Allocate(uSize, OBJECT_CONSTANTS_SIZE, outAllocation);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::recordDraws
+      Summary:  Records the draws of a range of the draw list. Safe to
+                call from several threads for disjoint ranges: it only
+                reads the renderables and writes the constant slots of
+                its own range. Every mesh is drawn with its coarsest
+                level of detail within the pixel error. At full detail,
+                a mesh with enough meshlets only draws the ranges of
+                its visible meshlets
+      Args:     DrawCommandList& drawCommands
+                  List to record into
+                UINT uBegin
+                  First index in the draw list
+                UINT uEnd
+                  One past the last index in the draw list
+                const RingAllocation* pObjectConstants
+                  Constant block from allocateObjectConstants, nullptr
+                  to bind the per-renderable constant buffers
+      Modifies: [drawCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::recordDraws(_Inout_ DrawCommandList& drawCommands, _In_ UINT uBegin, _In_ UINT uEnd,
+        _In_opt_ const RingAllocation* pObjectConstants) {
+
+        std::vector<MeshletRange> aMeshletRanges;
+
+        for (UINT uDraw = uBegin; uDraw < uEnd; ++uDraw) {
+            Renderable* pRenderable = m_aDrawList[uDraw];
+
+            // The meshlet bounds are in object space, so the camera is
+            // brought into it once per renderable when first needed
+            BOOL bMeshletSpace = FALSE;
+            XMFLOAT4X4 objectToClip;
+            XMFLOAT3 objectCameraPosition;
+
+            // Largest error in object units that stays within the pixel
+            // error on screen
+            FLOAT fMaxLodError = m_fLodPixelError > 0.0f ? m_fLodPixelError / m_aDrawPixelsPerUnit[uDraw] : -1.0f;
+
+            UINT uKey = getShaderKey(nullptr);
+
+            DrawCommand command = {
+                .pVertexBuffer = pRenderable->GetVertexBuffer().Get(),
+                .uStride = pRenderable->GetVertexStride(),
+                .pIndexBuffer = pRenderable->GetIndexBuffer().Get(),
+                .indexFormat = DXGI_FORMAT_R16_UINT,
+                .uIndexOffset = 0u,
+                .pInputLayout = pRenderable->GetVertexLayout(uKey).Get(),
+                .pVertexShader = pRenderable->GetVertexShader(uKey).Get(),
+                .pPixelShader = pRenderable->GetPixelShader(uKey).Get(),
+                .pConstantBuffer = pRenderable->GetConstantBuffer().Get(),
+                .uFirstConstant = 0u,
+                .uNumConstants = 0u,
+                .pShaderResourceView = nullptr,
+                .pSamplerState = nullptr,
+                .pNormalResourceView = nullptr,
+                .uIndexCount = pRenderable->GetNumIndices(),
+                .uStartIndex = 0u,
+                .iBaseVertex = 0,
+                .pTextureSliceBuffer = m_textureSliceBuffer.Get(),
+                .uTextureSlice = 0u
+            };
+
+            if (pObjectConstants) {
+                UINT uSlotOffset = uDraw * OBJECT_CONSTANTS_SIZE;
+
+                CBChangesEveryFrame* pCb = reinterpret_cast<CBChangesEveryFrame*>(pObjectConstants->pData + uSlotOffset);
+                pCb->World = XMMatrixTranspose(pRenderable->GetWorldMatrix());
+                pCb->OutputColor = pRenderable->GetOutputColor();
+                pCb->PositionScale = pRenderable->GetPositionScale();
+                pCb->PositionBias = pRenderable->GetPositionBias();
+
+                // Offsets and sizes are counted in 16-byte constants
+                command.pConstantBuffer = m_dynamicConstantBuffer.GetBuffer().Get();
+                command.uFirstConstant = (pObjectConstants->uOffset + uSlotOffset) / 16u;
+                command.uNumConstants = OBJECT_CONSTANTS_SIZE / 16u;
+            }
+
+            if (pRenderable->GetNumMeshes() > 0u) {
+                for (UINT i = 0; i < pRenderable->GetNumMeshes(); ++i) {
+                    const auto& mesh = pRenderable->GetMesh(i);
+                    const Material* pMaterial = getMeshMaterial(pRenderable, i);
+
+                    // Nothing is inherited from the previous mesh, which
+                    // may have textures this one lacks
+                    command.pShaderResourceView = nullptr;
+                    command.pSamplerState = nullptr;
+                    command.pNormalResourceView = nullptr;
+                    command.uTextureSlice = 0u;
+
+                    if (pMaterial) {
+                        if (pMaterial->pDiffuseArray) {
+                            command.pShaderResourceView = pMaterial->pDiffuseArray->GetTextureResourceView().Get();
+                            command.pSamplerState = pMaterial->pDiffuseArray->GetSamplerState().Get();
+                            command.uTextureSlice = pMaterial->uDiffuseSlice;
+                        }
+                        else if (pMaterial->pDiffuse) {
+                            command.pShaderResourceView = pMaterial->pDiffuse->GetTextureResourceView().Get();
+                            command.pSamplerState = pMaterial->pDiffuse->GetSamplerState().Get();
+                            command.uTextureSlice = 0u;
+                        }
+
+                        if (pMaterial->pNormal) {
+                            command.pNormalResourceView = pMaterial->pNormal->GetTextureResourceView().Get();
+
+                            if (!command.pSamplerState) {
+                                command.pSamplerState = pMaterial->pNormal->GetSamplerState().Get();
+                            }
+                        }
+                    }
+
+                    // Each mesh runs the variant of its own textures; a
+                    // variant that failed to compile is not drawn
+                    uKey = getShaderKey(pMaterial);
+                    command.pInputLayout = pRenderable->GetVertexLayout(uKey).Get();
+                    command.pVertexShader = pRenderable->GetVertexShader(uKey).Get();
+                    command.pPixelShader = pRenderable->GetPixelShader(uKey).Get();
+
+                    if (!command.pVertexShader || !command.pPixelShader) {
+                        continue;
+                    }
+
+                    // Each mesh has its own index width, so the index buffer
+                    // is bound at the mesh's byte offset and drawn from 0
+                    command.indexFormat = mesh.indexFormat;
+                    command.uIndexOffset = mesh.uIndexOffset;
+                    command.uIndexCount = mesh.uNumIndices;
+                    command.uStartIndex = 0u;
+                    command.iBaseVertex = static_cast<INT>(mesh.uBaseVertex);
+
+                    UINT uLod = pRenderable->SelectMeshLod(i, fMaxLodError);
+
+                    if (uLod > 0u) {
+                        command.uIndexOffset = mesh.aLods[uLod - 1u].uIndexOffset;
+                        command.uIndexCount = mesh.aLods[uLod - 1u].uNumIndices;
+                    }
+                    else if (m_bMeshletCulling && mesh.uNumMeshlets >= MIN_MESHLETS_TO_CULL) {
+                        if (!bMeshletSpace) {
+                            const XMMATRIX& world = pRenderable->GetWorldMatrix();
+
+                            XMStoreFloat4x4(&objectToClip, XMMatrixMultiply(world, m_viewProjection));
+                            XMStoreFloat3(&objectCameraPosition,
+                                XMVector3TransformCoord(m_camera.GetEye(), XMMatrixInverse(nullptr, world)));
+                            bMeshletSpace = TRUE;
+                        }
+
+                        aMeshletRanges.resize(mesh.uNumMeshlets);
+
+                        UINT uNumRanges = pRenderable->CullMeshlets(i, objectToClip, objectCameraPosition,
+                            aMeshletRanges.data(), nullptr);
+
+                        for (UINT uRange = 0u; uRange < uNumRanges; ++uRange) {
+                            command.uStartIndex = aMeshletRanges[uRange].uFirstIndex;
+                            command.uIndexCount = aMeshletRanges[uRange].uNumIndices;
+
+                            drawCommands.Add(command);
+                        }
+
+                        continue;
+                    }
+
+                    drawCommands.Add(command);
+                }
+            }
+
+            else if (command.pVertexShader && command.pPixelShader) {
+                drawCommands.Add(command);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::bindFrameState
+      Summary:  Binds the state shared by every draw of the frame:
+                render targets, viewport, topology and the camera,
+                projection and light constant buffers. Deferred
+                contexts start from the default state and need it once
+                per frame
+      Args:     ID3D11DeviceContext* pContext
+                  Context to bind the state on
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::bindFrameState(_In_ ID3D11DeviceContext* pContext) {
+        pContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+        pContext->RSSetViewports(1, &m_viewport);
+        pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+        pContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+        pContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+        pContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
+        pContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+        pContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::packTextures
+      Summary:  Packs the diffuse textures of every renderable that share
+                a size, format and sampler into texture arrays, so their
+                draws only differ by slice. Called once the renderables
+                are initialized and after reloads, which replace models
+                and textures. Failing to pack leaves the textures bound
+                one by one, as does a device that cannot bind constant
+                buffer ranges, which slices other than 0 are bound with
+      Modifies: [m_renderables].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::packTextures() {
+        if (!m_bConstantBufferOffsetting) {
+            return;
+        }
+
+        std::vector<Material*> apMaterials;
+
+        for (const auto& [szName, renderable] : m_renderables) {
+            for (UINT i = 0u; i < renderable->GetNumMaterials(); ++i) {
+                apMaterials.push_back(&renderable->GetMaterial(i));
+            }
+        }
+
+        if (FAILED(TextureArray::Pack(m_d3dDevice.Get(), m_immediateContext.Get(), apMaterials))) {
+            OutputDebugString(L"Error packing textures into texture arrays\n");
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::watchAssets
+      Summary:  Watches the shader, model, texture and scene files of
+                the loaded assets and starts the watching thread.
+                Failing to watch only disables reloading
+      Modifies: [m_assetWatcher].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::watchAssets() {
+        for (const auto& [szName, vertexShader] : m_vertexShaders) {
+            m_assetWatcher.Watch(vertexShader->GetFileName());
+        }
+
+        for (const auto& [szName, pixelShader] : m_pixelShaders) {
+            m_assetWatcher.Watch(pixelShader->GetFileName());
+        }
+
+        // A model is loaded from its baked mesh file when it is up to
+        // date, so rebaking it also reloads the model
+        for (const auto& [szName, renderable] : m_renderables) {
+            if (const Model* pModel = dynamic_cast<const Model*>(renderable.get())) {
+                m_assetWatcher.Watch(pModel->GetFilePath());
+                m_assetWatcher.Watch(MeshFile::GetBakedPath(pModel->GetFilePath()));
+            }
+        }
+
+        std::vector<std::shared_ptr<Texture>> aTextures;
+        TextureCache::GetShared().GetTextures(aTextures);
+
+        for (const std::shared_ptr<Texture>& texture : aTextures) {
+            m_assetWatcher.Watch(texture->GetFilePath());
+        }
+
+        for (const auto& [szName, scene] : m_scenes) {
+            m_assetWatcher.Watch(scene->GetFilePath());
+        }
+
+        if (FAILED(m_assetWatcher.Start())) {
+            OutputDebugString(L"Error starting the asset watcher, assets will not be reloaded\n");
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::reloadChangedAssets
+      Summary:  Swaps in the reloaded assets that are ready, then queues
+                the reload of the files that changed. Nothing waits, so
+                the frame goes on with the old asset until the new one
+                is ready. A file changing again while it reloads, or a
+                texture whose decode is still running, is reloaded once
+                that work is done. A failed reload
+                keeps the old asset. Textures are packed again after
+                any reload
+      Modifies: [m_aPendingReloads, m_aDeferredReloads, m_renderables].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::reloadChangedAssets() {
+        BOOL bReloaded = FALSE;
+
+        for (auto it = m_aPendingReloads.begin(); it != m_aPendingReloads.end();) {
+            if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            HRESULT hr = it->result.get();
+            if (SUCCEEDED(hr)) {
+                hr = it->commit();
+            }
+
+            if (FAILED(hr)) {
+                OutputDebugString(L"Error reloading ");
+                OutputDebugString(it->filePath.c_str());
+                OutputDebugString(L", keeping the loaded asset\n");
+            }
+            else {
+                bReloaded = TRUE;
+            }
+
+            it = m_aPendingReloads.erase(it);
+        }
+
+        // Reloaded textures and models are out of the texture arrays
+        if (bReloaded) {
+            packTextures();
+        }
+
+        std::vector<std::filesystem::path> aChangedFiles;
+        m_assetWatcher.GetChangedFiles(aChangedFiles);
+
+        aChangedFiles.insert(aChangedFiles.begin(), m_aDeferredReloads.begin(), m_aDeferredReloads.end());
+        m_aDeferredReloads.clear();
+
+        std::vector<std::shared_ptr<Texture>> aTextures;
+        if (!aChangedFiles.empty()) {
+            TextureCache::GetShared().GetTextures(aTextures);
+        }
+
+        for (const std::filesystem::path& filePath : aChangedFiles) {
+            std::wstring szKey = AssetWatcher::MakeKey(filePath);
+
+            BOOL bPending = std::any_of(m_aPendingReloads.begin(), m_aPendingReloads.end(),
+                [&szKey](const PendingReload& reload) {
+                    return reload.szKey == szKey;
+                })
+                || std::any_of(aTextures.begin(), aTextures.end(),
+                    [&szKey](const std::shared_ptr<Texture>& texture) {
+                        return texture->IsDecoding() && AssetWatcher::MakeKey(texture->GetFilePath()) == szKey;
+                    });
+
+            if (bPending) {
+                if (std::find(m_aDeferredReloads.begin(), m_aDeferredReloads.end(), filePath) == m_aDeferredReloads.end()) {
+                    m_aDeferredReloads.push_back(filePath);
+                }
+                continue;
+            }
+
+            beginReload(filePath, szKey);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Renderer::beginReload
+      Summary:  Queues on the thread pool the rebuild of every asset
+                loaded from a file: shaders are recompiled, textures
+                decoded, models loaded into a staging model and scenes
+                parsed. Only the device objects are created when the
+                result is committed on the rendering thread
+      Args:     const std::filesystem::path& filePath
+                  Path to the changed file
+                const std::wstring& szKey
+                  Normalized path of the file
+      Modifies: [m_aPendingReloads].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Renderer::beginReload(_In_ const std::filesystem::path& filePath, _In_ const std::wstring& szKey) {
+        ThreadPool& threadPool = ThreadPool::GetShared();
+
+        // The device is free threaded, so the shaders are created on the
+        // worker and only swapped on this thread
+        for (const auto& [szName, vertexShader] : m_vertexShaders) {
+            if (AssetWatcher::MakeKey(vertexShader->GetFileName()) != szKey) {
+                continue;
+            }
+
+            m_aPendingReloads.push_back(PendingReload{
+                .filePath = filePath,
+                .szKey = szKey,
+                .result = threadPool.Submit([vertexShader, device = m_d3dDevice]() {
+                    return vertexShader->Recompile(device.Get());
+                }).share(),
+                .commit = [vertexShader]() {
+                    vertexShader->CommitRecompile();
+                    return S_OK;
+                }
+            });
+        }
+
+        for (const auto& [szName, pixelShader] : m_pixelShaders) {
+            if (AssetWatcher::MakeKey(pixelShader->GetFileName()) != szKey) {
+                continue;
+            }
+
+            m_aPendingReloads.push_back(PendingReload{
+                .filePath = filePath,
+                .szKey = szKey,
+                .result = threadPool.Submit([pixelShader, device = m_d3dDevice]() {
+                    return pixelShader->Recompile(device.Get());
+                }).share(),
+                .commit = [pixelShader]() {
+                    pixelShader->CommitRecompile();
+                    return S_OK;
+                }
+            });
+        }
+
+        // The staging model only lives until its geometry is swapped into
+        // the model being drawn, which keeps its shaders and transform
+        for (const auto& [szName, renderable] : m_renderables) {
+            std::shared_ptr<Model> model = std::dynamic_pointer_cast<Model>(renderable);
+            if (!model
+                || (AssetWatcher::MakeKey(model->GetFilePath()) != szKey
+                    && AssetWatcher::MakeKey(MeshFile::GetBakedPath(model->GetFilePath())) != szKey)) {
+                continue;
+            }
+
+            std::shared_ptr<Model> stagingModel = std::make_shared<Model>(model->GetFilePath());
+            stagingModel->SetVertexFormat(model->GetVertexFormat());
+
+            m_aPendingReloads.push_back(PendingReload{
+                .filePath = filePath,
+                .szKey = szKey,
+                .result = threadPool.Submit([stagingModel]() {
+                    return stagingModel->Load();
+                }).share(),
+                .commit = [this, model, stagingModel]() {
+                    HRESULT hr = stagingModel->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+                    if (FAILED(hr)) {
+                        return hr;
+                    }
+
+                    model->SwapGeometry(*stagingModel);
+
+                    for (UINT i = 0u; i < model->GetNumMaterials(); ++i) {
+                        const Material& material = model->GetMaterial(i);
+
+                        for (const std::shared_ptr<Texture>& texture : { material.pDiffuse, material.pSpecular, material.pNormal }) {
+                            if (texture) {
+                                m_assetWatcher.Watch(texture->GetFilePath());
+                            }
+                        }
+                    }
+
+                    return S_OK;
+                }
+            });
+        }
+
+        // A texture is shared through the cache, so every material using
+        // it sees the reloaded one
+        std::vector<std::shared_ptr<Texture>> aTextures;
+        TextureCache::GetShared().GetTextures(aTextures);
+
+        for (const std::shared_ptr<Texture>& texture : aTextures) {
+            if (AssetWatcher::MakeKey(texture->GetFilePath()) != szKey) {
+                continue;
+            }
+
+            m_aPendingReloads.push_back(PendingReload{
+                .filePath = filePath,
+                .szKey = szKey,
+                .result = texture->BeginReload(),
+                .commit = [this, texture]() {
+                    return texture->CommitReload(m_d3dDevice.Get(), m_immediateContext.Get());
+                }
+            });
+        }
+
+        for (const auto& [szName, scene] : m_scenes) {
+            if (AssetWatcher::MakeKey(scene->GetFilePath()) != szKey) {
+                continue;
+            }
+
+            std::shared_ptr<std::shared_ptr<Scene>> newScene = std::make_shared<std::shared_ptr<Scene>>();
+
+            m_aPendingReloads.push_back(PendingReload{
+                .filePath = filePath,
+                .szKey = szKey,
+                .result = threadPool.Submit([newScene, sceneFilePath = scene->GetFilePath()]() {
+                    *newScene = std::make_shared<Scene>(sceneFilePath);
+                    return S_OK;
+                }).share(),
+                .commit = [this, szSceneName = szName, newScene]() {
+                    auto it = m_scenes.find(szSceneName);
+                    if (it == m_scenes.end()) {
+                        return S_OK;
+                    }
+
+                    if (it->second->GetVertexShader()) {
+                        (*newScene)->SetVertexShader(it->second->GetVertexShader());
+                    }
+
+                    if (it->second->GetPixelShader()) {
+                        (*newScene)->SetPixelShader(it->second->GetPixelShader());
+                    }
+
+                    if (it->second->IsInitialized()) {
+                        HRESULT hr = (*newScene)->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+                        if (FAILED(hr)) {
+                            return hr;
+                        }
+                    }
+
+                    it->second = *newScene;
+                    return S_OK;
+                }
+            });
+        }
+    }
 }
\ No newline at end of file
@@ -14,10 +14,18 @@
 #include "Light/PointLight.h"
 #include "Model/Model.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/DrawCommandList.h"
+#include "Renderer/DynamicRingBuffer.h"
+#include "Renderer/OcclusionCuller.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/TransformHierarchy.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
+#include "Texture/TextureArray.h"
+#include "Texture/TextureStreamer.h"
+#include "Thread/AssetWatcher.h"
+#include "Thread/ThreadPool.h"
 #include "Window/MainWindow.h"
 
 namespace library
@@ -50,6 +58,53 @@ namespace library
                   Sets the pixel shader for a renderable
                 GetDriverType
                   Returns the Direct3D driver type
+                GetTransformHierarchy
+                  Returns the transform hierarchy of the renderables
+                SetOcclusionCulling
+                  Enables or disables software occlusion culling
+                GetOcclusionCuller
+                  Returns the occlusion culler and its counters
+                SetLodPixelError
+                  Sets the screen space error allowed for mesh levels
+                  of detail
+                SetMeshletCulling
+                  Enables or disables meshlet culling
+                GetTextureStreamer
+                  Returns the texture streamer, to set its budgets
+                updateCameraConstantBuffer
+                  Updates the camera constant buffer if the view changed
+                updateLightsConstantBuffer
+                  Updates the lights constant buffer if a light changed
+                buildDrawList
+                  Collects the renderables that are not occluded and
+                  their projected scale, and requests the mips of their
+                  textures
+                getShaderKey
+                  Returns the shader variant key of a material
+                getMeshMaterial
+                  Returns the material of a mesh, if any
+                prepareShaders
+                  Compiles the shader variants of a renderable
+                allocateObjectConstants
+                  Allocates one constant block for every renderable
+                recordDraws
+                  Records the draws of a range of renderables
+                bindFrameState
+                  Binds the state shared by every draw of the frame
+                packTextures
+                  Packs the diffuse textures of the renderables into
+                  texture arrays
+                watchAssets
+                  Watches the files of the loaded assets
+                reloadChangedAssets
+                  Reloads the assets whose files changed
+                beginReload
+                  Queues the reload of the assets loaded from a file
+                collectShaderVariants
+                  Lists the shader variants a renderable is drawn with
+                compileShaders
+                  Compiles shader variants in parallel and reports the
+                  errors together
                 Renderer
                   Constructor.
                 ~Renderer
@@ -84,8 +139,58 @@ namespace library
         HRESULT SetPixelShaderOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszPixelShaderName);
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        TransformHierarchy& GetTransformHierarchy();
+        void SetOcclusionCulling(_In_ BOOL bOcclusionCulling);
+        const OcclusionCuller& GetOcclusionCuller() const;
+        void SetLodPixelError(_In_ FLOAT fLodPixelError);
+        void SetMeshletCulling(_In_ BOOL bMeshletCulling);
+        TextureStreamer& GetTextureStreamer();
 
     private:
+        static constexpr const UINT FRAME_LATENCY = 3u;
+        static constexpr const UINT DYNAMIC_CONSTANT_BUFFER_SIZE = 2u * 1024u * 1024u;
+        static constexpr const UINT OBJECT_CONSTANTS_SIZE = 256u;
+        static constexpr const UINT MIN_DRAWS_PER_RECORDER = 64u;
+        static constexpr const FLOAT LOD_MIN_DISTANCE = 0.01f;
+        static constexpr const UINT MIN_MESHLETS_TO_CULL = 8u;
+
+        void updateCameraConstantBuffer();
+        void updateLightsConstantBuffer();
+        void buildDrawList();
+        UINT getShaderKey(_In_opt_ const Material* pMaterial) const;
+        const Material* getMeshMaterial(_In_ const Renderable* pRenderable, _In_ UINT uMesh) const;
+        void prepareShaders(_In_ Renderable* pRenderable);
+        BOOL allocateObjectConstants(_Out_ RingAllocation& outAllocation);
+        void recordDraws(_Inout_ DrawCommandList& drawCommands, _In_ UINT uBegin, _In_ UINT uEnd,
+            _In_opt_ const RingAllocation* pObjectConstants);
+        void bindFrameState(_In_ ID3D11DeviceContext* pContext);
+        void packTextures();
+        void watchAssets();
+        void reloadChangedAssets();
+        void beginReload(_In_ const std::filesystem::path& filePath, _In_ const std::wstring& szKey);
+
+        // One variant of a shader, by its Shader::GetVariantKey
+        struct ShaderVariant
+        {
+            Shader* pShader;
+            UINT uKey;
+
+            bool operator==(const ShaderVariant& other) const = default;
+        };
+
+        void collectShaderVariants(_In_ const Renderable* pRenderable, _Inout_ std::vector<ShaderVariant>& aVariants) const;
+        HRESULT compileShaders(_In_ const std::vector<ShaderVariant>& aVariants, _Out_ std::wstring& szErrors);
+
+        // An asset rebuilt on a worker thread, swapped in by commit on the
+        // rendering thread once result is ready
+        struct PendingReload
+        {
+            std::filesystem::path filePath;
+            std::wstring szKey;
+            std::shared_future<HRESULT> result;
+            std::function<HRESULT()> commit;
+        };
+
         D3D_DRIVER_TYPE m_driverType;
         D3D_FEATURE_LEVEL m_featureLevel;
         ComPtr<ID3D11Device> m_d3dDevice;
@@ -99,14 +204,40 @@ namespace library
         ComPtr<ID3D11DepthStencilView> m_depthStencilView;
         ComPtr<ID3D11Buffer> m_cbChangeOnResize;
         ComPtr<ID3D11Buffer> m_cbLights;
+        ComPtr<ID3D11Buffer> m_textureSliceBuffer;
         PCWSTR m_pszMainSceneName;
         Camera m_camera;
         XMMATRIX m_projection;
+        XMMATRIX m_viewProjection;
+        DynamicRingBuffer m_dynamicConstantBuffer;
+        BOOL m_bConstantBufferOffsetting;
+        BOOL m_bCameraCached;
+        BOOL m_bLightsCached;
+        CBChangeOnCameraMovement m_cbCameraCache;
+        CBLights m_cbLightsCache;
+        UINT m_uLightFeatures;
+        TransformHierarchy m_transforms;
+        D3D11_VIEWPORT m_viewport;
+
+        std::vector<Renderable*> m_aDrawList;
+        std::vector<FLOAT> m_aDrawPixelsPerUnit;
+        FLOAT m_fLodPixelError;
+        BOOL m_bMeshletCulling;
+        std::vector<DrawCommandList> m_aDrawCommandLists;
+        std::vector<ComPtr<ID3D11DeviceContext1>> m_aDeferredContexts;
+        std::vector<ComPtr<ID3D11CommandList>> m_aCommandLists;
+        OcclusionCuller m_occlusionCuller;
+        BOOL m_bOcclusionCulling;
+        TextureStreamer m_textureStreamer;
 
         std::unordered_map<std::wstring, std::shared_ptr<Renderable>> m_renderables;
         std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
         std::unordered_map<std::wstring, std::shared_ptr<VertexShader>> m_vertexShaders;
         std::unordered_map<std::wstring, std::shared_ptr<PixelShader>> m_pixelShaders;
         std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
+
+        AssetWatcher m_assetWatcher;
+        std::vector<PendingReload> m_aPendingReloads;
+        std::vector<std::filesystem::path> m_aDeferredReloads;
     };
 }
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "Renderer/RingAllocator.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::RingAllocator
+      Summary:  Constructor
+      Args:     UINT uCapacity
+                  Size of the ring in bytes
+      Modifies: [m_uCapacity, m_uHead, m_uTail, m_uUsedSize,
+                  m_uFrameSize, m_aFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RingAllocator::RingAllocator(_In_ UINT uCapacity) :
+        m_uCapacity(uCapacity),
+        m_uHead(0u),
+        m_uTail(0u),
+        m_uUsedSize(0u),
+        m_uFrameSize(0u),
+        m_aFrames()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::Allocate
+      Summary:  Suballocates a range from the head of the ring. When the
+                range does not fit before the end of the ring, the tail
+                end is skipped and the range starts at offset 0
+      Args:     UINT uSize
+                  Size of the range in bytes
+                UINT uAlignment
+                  Alignment of the offset, must be a power of two
+                UINT& uOutOffset
+                  Receives the offset of the range
+      Modifies: [m_uHead, m_uTail, m_uUsedSize, m_uFrameSize].
+      Returns:  BOOL
+                  TRUE if the range was allocated, FALSE if the ring is
+                  out of space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL RingAllocator::Allocate(_In_ UINT uSize, _In_ UINT uAlignment, _Out_ UINT& uOutOffset)
+    {
+        assert(uAlignment != 0u && (uAlignment & (uAlignment - 1u)) == 0u);
+
+        uOutOffset = 0u;
+
+        if (uSize == 0u || uSize > m_uCapacity)
+        {
+            return FALSE;
+        }
+
+        if (m_uUsedSize == 0u)
+        {
+            m_uHead = 0u;
+            m_uTail = 0u;
+        }
+
+        UINT64 uAligned = (static_cast<UINT64>(m_uHead) + uAlignment - 1u) & ~static_cast<UINT64>(uAlignment - 1u);
+        UINT uConsumed = 0u;
+
+        if (m_uHead > m_uTail || m_uUsedSize == 0u)
+        {
+            // Free space is [head, capacity) followed by [0, tail)
+            if (uAligned + uSize <= m_uCapacity)
+            {
+                uOutOffset = static_cast<UINT>(uAligned);
+                uConsumed = static_cast<UINT>(uAligned) + uSize - m_uHead;
+            }
+            else if (uSize <= m_uTail || m_uUsedSize == 0u)
+            {
+                uOutOffset = 0u;
+                uConsumed = m_uCapacity - m_uHead + uSize;
+            }
+            else
+            {
+                return FALSE;
+            }
+        }
+        else
+        {
+            // Free space is [head, tail), or nothing when the ring is full
+            if (m_uUsedSize == m_uCapacity || uAligned + uSize > m_uTail)
+            {
+                return FALSE;
+            }
+
+            uOutOffset = static_cast<UINT>(uAligned);
+            uConsumed = static_cast<UINT>(uAligned) + uSize - m_uHead;
+        }
+
+        m_uHead = uOutOffset + uSize;
+        m_uUsedSize += uConsumed;
+        m_uFrameSize += uConsumed;
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::FinishFrame
+      Summary:  Closes the allocations made since the last call so they
+                can be released together
+      Args:     UINT64 uFrameIndex
+                  Index of the frame that owns the allocations
+      Modifies: [m_uFrameSize, m_aFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RingAllocator::FinishFrame(_In_ UINT64 uFrameIndex)
+    {
+        m_aFrames.push_back(FrameMarker{ .uFrameIndex = uFrameIndex, .uSize = m_uFrameSize });
+        m_uFrameSize = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::ReleaseFrame
+      Summary:  Releases the oldest finished frame. Frames are released
+                in the order they were allocated, so the tail simply
+                advances by the bytes the frame consumed
+      Modifies: [m_uTail, m_uUsedSize, m_aFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RingAllocator::ReleaseFrame()
+    {
+        if (m_aFrames.empty())
+        {
+            return;
+        }
+
+        const FrameMarker& frame = m_aFrames.front();
+
+        assert(frame.uSize <= m_uUsedSize);
+
+        m_uTail = static_cast<UINT>((static_cast<UINT64>(m_uTail) + frame.uSize) % m_uCapacity);
+        m_uUsedSize -= frame.uSize;
+
+        m_aFrames.pop_front();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::GetCapacity
+      Summary:  Returns the size of the ring
+      Returns:  UINT
+                  Size of the ring in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RingAllocator::GetCapacity() const
+    {
+        return m_uCapacity;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::GetUsedSize
+      Summary:  Returns the bytes in use, including alignment padding and
+                the skipped end of the ring
+      Returns:  UINT
+                  Bytes in use
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RingAllocator::GetUsedSize() const
+    {
+        return m_uUsedSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::GetNumFramesInFlight
+      Summary:  Returns the number of finished, unreleased frames
+      Returns:  UINT
+                  Number of frames in flight
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT RingAllocator::GetNumFramesInFlight() const
+    {
+        return static_cast<UINT>(m_aFrames.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RingAllocator::GetOldestFrameIndex
+      Summary:  Returns the index of the oldest unreleased frame
+      Returns:  UINT64
+                  Frame index. Only valid if a frame is in flight
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 RingAllocator::GetOldestFrameIndex() const
+    {
+        assert(!m_aFrames.empty());
+
+        return m_aFrames.front().uFrameIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::FrameRingBuffer
+      Summary:  Constructor
+      Args:     UINT uCapacity
+                  Size of the ring in bytes
+                UINT uFrameLatency
+                  Number of frames that may still be in use when a new
+                  frame begins
+      Modifies: [m_allocator, m_uFrameIndex, m_uFrameLatency, m_pData,
+                  m_aStorage].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FrameRingBuffer::FrameRingBuffer(_In_ UINT uCapacity, _In_ UINT uFrameLatency) :
+        m_allocator(uCapacity),
+        m_uFrameIndex(0u),
+        m_uFrameLatency(uFrameLatency > 0u ? uFrameLatency : 1u),
+        m_pData(nullptr),
+        m_aStorage()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::BeginFrame
+      Summary:  Reclaims the space of old frames. Waits on the fence of
+                the oldest frame while the number of frames in flight
+                has reached the latency
+      Modifies: [m_allocator].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT FrameRingBuffer::BeginFrame()
+    {
+        while (m_allocator.GetNumFramesInFlight() >= m_uFrameLatency)
+        {
+            HRESULT hr = waitForFrame(m_allocator.GetOldestFrameIndex());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            m_allocator.ReleaseFrame();
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::Allocate
+      Summary:  Suballocates writable memory for this frame. The memory
+                is mapped on the first allocation of the frame
+      Args:     UINT uSize
+                  Size of the allocation in bytes
+                UINT uAlignment
+                  Alignment of the offset, must be a power of two
+                RingAllocation& outAllocation
+                  Receives the offset and CPU address of the allocation
+      Modifies: [m_allocator, m_pData].
+      Returns:  BOOL
+                  TRUE on success, FALSE if the ring is out of space
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL FrameRingBuffer::Allocate(_In_ UINT uSize, _In_ UINT uAlignment, _Out_ RingAllocation& outAllocation)
+    {
+        outAllocation = RingAllocation{ .uOffset = 0u, .uSize = 0u, .pData = nullptr };
+
+        UINT uOffset = 0u;
+        if (!m_allocator.Allocate(uSize, uAlignment, uOffset))
+        {
+            return FALSE;
+        }
+
+        if (!m_pData)
+        {
+            m_pData = map();
+            if (!m_pData)
+            {
+                return FALSE;
+            }
+        }
+
+        outAllocation.uOffset = uOffset;
+        outAllocation.uSize = uSize;
+        outAllocation.pData = m_pData + uOffset;
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::Flush
+      Summary:  Unmaps the memory so the data written so far can be read
+                by this frame's draws. Allocating again maps it again
+      Modifies: [m_pData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameRingBuffer::Flush()
+    {
+        if (m_pData)
+        {
+            unmap();
+            m_pData = nullptr;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::EndFrame
+      Summary:  Unmaps the memory, closes the frame in the allocator and
+                signals the frame fence. Call it after the last draw that
+                reads this frame's data
+      Modifies: [m_allocator, m_uFrameIndex, m_pData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameRingBuffer::EndFrame()
+    {
+        Flush();
+
+        m_allocator.FinishFrame(m_uFrameIndex);
+        signalFrame(m_uFrameIndex);
+
+        ++m_uFrameIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::GetAllocator
+      Summary:  Returns the underlying offset allocator
+      Returns:  const RingAllocator&
+                  Offset allocator
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const RingAllocator& FrameRingBuffer::GetAllocator() const
+    {
+        return m_allocator;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::GetFrameIndex
+      Summary:  Returns the index of the frame being recorded
+      Returns:  UINT64
+                  Frame index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 FrameRingBuffer::GetFrameIndex() const
+    {
+        return m_uFrameIndex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::GetFrameLatency
+      Summary:  Returns the maximum number of frames in flight
+      Returns:  UINT
+                  Frame latency
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FrameRingBuffer::GetFrameLatency() const
+    {
+        return m_uFrameLatency;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::map
+      Summary:  Returns the CPU address of the ring. The system memory
+                implementation allocates it on first use
+      Modifies: [m_aStorage].
+      Returns:  BYTE*
+                  Address of offset 0 of the ring
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BYTE* FrameRingBuffer::map()
+    {
+        if (m_aStorage.empty())
+        {
+            m_aStorage.resize(m_allocator.GetCapacity());
+        }
+
+        return m_aStorage.data();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::unmap
+      Summary:  Ends CPU writes for this frame. Nothing to do for system
+                memory
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameRingBuffer::unmap()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::signalFrame
+      Summary:  Signals the fence of a finished frame. System memory has
+                no consumer to fence against
+      Args:     UINT64 uFrameIndex
+                  Index of the finished frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameRingBuffer::signalFrame(_In_ UINT64 uFrameIndex)
+    {
+        UNREFERENCED_PARAMETER(uFrameIndex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameRingBuffer::waitForFrame
+      Summary:  Waits until a finished frame has been consumed. In system
+                memory a frame is consumed as soon as the latency has
+                passed
+      Args:     UINT64 uFrameIndex
+                  Index of the frame to wait for
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT FrameRingBuffer::waitForFrame(_In_ UINT64 uFrameIndex)
+    {
+        UNREFERENCED_PARAMETER(uFrameIndex);
+
+        return S_OK;
+    }
+}
@@ -0,0 +1,149 @@
+/*+===================================================================
+  File:      RINGALLOCATOR.H
+  Summary:   RingAllocator header file contains declarations of
+             RingAllocator and FrameRingBuffer classes used to
+             suballocate per-frame data from one large buffer.
+  Classes: RingAllocator, FrameRingBuffer
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <deque>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   RingAllocation
+      Summary:  Suballocation handed out by a frame ring buffer
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct RingAllocation
+    {
+        UINT uOffset;
+        UINT uSize;
+        BYTE* pData;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RingAllocator
+      Summary:  Offset bookkeeping of a ring of bytes. Allocations are
+                grouped per frame and released a whole frame at a time,
+                oldest first
+      Methods:  Allocate
+                  Suballocates a range from the head of the ring
+                FinishFrame
+                  Closes the allocations made since the last call
+                ReleaseFrame
+                  Releases the oldest finished frame
+                GetCapacity
+                  Returns the size of the ring in bytes
+                GetUsedSize
+                  Returns the bytes in use, including padding
+                GetNumFramesInFlight
+                  Returns the number of finished, unreleased frames
+                GetOldestFrameIndex
+                  Returns the index of the oldest unreleased frame
+                RingAllocator
+                  Constructor.
+                ~RingAllocator
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RingAllocator
+    {
+    public:
+        RingAllocator() = delete;
+        RingAllocator(_In_ UINT uCapacity);
+        RingAllocator(const RingAllocator& other) = delete;
+        RingAllocator(RingAllocator&& other) = delete;
+        RingAllocator& operator=(const RingAllocator& other) = delete;
+        RingAllocator& operator=(RingAllocator&& other) = delete;
+        virtual ~RingAllocator() = default;
+
+        BOOL Allocate(_In_ UINT uSize, _In_ UINT uAlignment, _Out_ UINT& uOutOffset);
+        void FinishFrame(_In_ UINT64 uFrameIndex);
+        void ReleaseFrame();
+
+        UINT GetCapacity() const;
+        UINT GetUsedSize() const;
+        UINT GetNumFramesInFlight() const;
+        UINT64 GetOldestFrameIndex() const;
+
+    private:
+        struct FrameMarker
+        {
+            UINT64 uFrameIndex;
+            UINT uSize;
+        };
+
+        UINT m_uCapacity;
+        UINT m_uHead;
+        UINT m_uTail;
+        UINT m_uUsedSize;
+        UINT m_uFrameSize;
+        std::deque<FrameMarker> m_aFrames;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrameRingBuffer
+      Summary:  Frame scoped ring buffer. Hands out suballocations during
+                a frame and reclaims them once the frame is known to be
+                consumed, at most uFrameLatency frames later. This base
+                class is backed by system memory and has no device
+                dependency; DynamicRingBuffer backs it with a Direct3D
+                dynamic buffer
+      Methods:  BeginFrame
+                  Reclaims the space of frames that are done
+                Allocate
+                  Suballocates aligned, writable memory for this frame
+                Flush
+                  Ends CPU writes so the GPU can read this frame's data
+                EndFrame
+                  Closes the frame and signals its fence
+                GetAllocator
+                  Returns the underlying offset allocator
+                GetFrameIndex
+                  Returns the index of the frame being recorded
+                GetFrameLatency
+                  Returns the maximum number of frames in flight
+                FrameRingBuffer
+                  Constructor.
+                ~FrameRingBuffer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FrameRingBuffer
+    {
+    public:
+        FrameRingBuffer() = delete;
+        FrameRingBuffer(_In_ UINT uCapacity, _In_ UINT uFrameLatency);
+        FrameRingBuffer(const FrameRingBuffer& other) = delete;
+        FrameRingBuffer(FrameRingBuffer&& other) = delete;
+        FrameRingBuffer& operator=(const FrameRingBuffer& other) = delete;
+        FrameRingBuffer& operator=(FrameRingBuffer&& other) = delete;
+        virtual ~FrameRingBuffer() = default;
+
+        HRESULT BeginFrame();
+        BOOL Allocate(_In_ UINT uSize, _In_ UINT uAlignment, _Out_ RingAllocation& outAllocation);
+        void Flush();
+        void EndFrame();
+
+        const RingAllocator& GetAllocator() const;
+        UINT64 GetFrameIndex() const;
+        UINT GetFrameLatency() const;
+
+    protected:
+        virtual BYTE* map();
+        virtual void unmap();
+        virtual void signalFrame(_In_ UINT64 uFrameIndex);
+        virtual HRESULT waitForFrame(_In_ UINT64 uFrameIndex);
+
+    protected:
+        RingAllocator m_allocator;
+        UINT64 m_uFrameIndex;
+        UINT m_uFrameLatency;
+        BYTE* m_pData;
+
+    private:
+        std::vector<BYTE> m_aStorage;
+    };
+}
@@ -0,0 +1,325 @@
+#include "Renderer/TransformHierarchy.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::TransformHierarchy
+      Summary:  Constructor
+      Modifies: [m_aParents, m_aTranslations, m_aRotations, m_aScales,
+                  m_aDirty, m_aLocalMatrices, m_aWorldMatrices,
+                  m_aLocalDirtyNodes, m_uNumUpdatedNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TransformHierarchy::TransformHierarchy() :
+        m_aParents(),
+        m_aTranslations(),
+        m_aRotations(),
+        m_aScales(),
+        m_aDirty(),
+        m_aLocalMatrices(),
+        m_aWorldMatrices(),
+        m_aLocalDirtyNodes(),
+        m_uNumUpdatedNodes(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::AddNode
+      Summary:  Adds an identity node under a parent. The parent must
+                already exist, which keeps parents in front of their
+                children in the arrays
+      Args:     UINT uParent
+                  Index of the parent node, or INVALID_NODE for a root
+      Modifies: [m_aParents, m_aTranslations, m_aRotations, m_aScales,
+                  m_aDirty, m_aLocalMatrices, m_aWorldMatrices].
+      Returns:  UINT
+                  Index of the new node
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::AddNode(_In_ UINT uParent)
+    {
+        assert(uParent == INVALID_NODE || uParent < GetNumNodes());
+
+        UINT uNode = GetNumNodes();
+
+        m_aParents.push_back(uParent);
+        m_aTranslations.push_back(XMFLOAT3(0.0f, 0.0f, 0.0f));
+        m_aRotations.push_back(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+        m_aScales.push_back(XMFLOAT3(1.0f, 1.0f, 1.0f));
+        m_aDirty.push_back(DIRTY_LOCAL);
+        m_aLocalMatrices.push_back(XMMatrixIdentity());
+        m_aWorldMatrices.push_back(XMMatrixIdentity());
+
+        return uNode;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetTranslation
+      Summary:  Sets the translation of a node relative to its parent
+      Args:     UINT uNode
+                  Index of the node
+                const XMFLOAT3& translation
+                  Translation
+      Modifies: [m_aTranslations, m_aDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetTranslation(_In_ UINT uNode, _In_ const XMFLOAT3& translation)
+    {
+        m_aTranslations[uNode] = translation;
+        m_aDirty[uNode] |= DIRTY_LOCAL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetRotation
+      Summary:  Sets the rotation of a node relative to its parent
+      Args:     UINT uNode
+                  Index of the node
+                FXMVECTOR quaternion
+                  Normalized rotation quaternion
+      Modifies: [m_aRotations, m_aDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetRotation(_In_ UINT uNode, _In_ FXMVECTOR quaternion)
+    {
+        XMStoreFloat4(&m_aRotations[uNode], quaternion);
+        m_aDirty[uNode] |= DIRTY_LOCAL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetRotationRollPitchYaw
+      Summary:  Sets the rotation of a node from Euler angles
+      Args:     UINT uNode
+                  Index of the node
+                FLOAT pitch
+                  Angle around the x-axis in radians
+                FLOAT yaw
+                  Angle around the y-axis in radians
+                FLOAT roll
+                  Angle around the z-axis in radians
+      Modifies: [m_aRotations, m_aDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetRotationRollPitchYaw(_In_ UINT uNode, _In_ FLOAT pitch, _In_ FLOAT yaw, _In_ FLOAT roll)
+    {
+        SetRotation(uNode, XMQuaternionRotationRollPitchYaw(pitch, yaw, roll));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::SetScale
+      Summary:  Sets the scale of a node
+      Args:     UINT uNode
+                  Index of the node
+                const XMFLOAT3& scale
+                  Scale along the x-axis, y-axis, and z-axis
+      Modifies: [m_aScales, m_aDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::SetScale(_In_ UINT uNode, _In_ const XMFLOAT3& scale)
+    {
+        m_aScales[uNode] = scale;
+        m_aDirty[uNode] |= DIRTY_LOCAL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::Update
+      Summary:  Propagates dirty flags from parents to children,
+                recomputes the local matrices of changed nodes in
+                batches of four and then the world matrices of every
+                node below a change, parents first
+      Modifies: [m_aDirty, m_aLocalMatrices, m_aWorldMatrices,
+                  m_aLocalDirtyNodes, m_uNumUpdatedNodes].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::Update()
+    {
+        UINT uNumNodes = GetNumNodes();
+
+        m_aLocalDirtyNodes.clear();
+        m_uNumUpdatedNodes = 0u;
+
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            if (m_aDirty[i] & DIRTY_LOCAL)
+            {
+                m_aDirty[i] |= DIRTY_WORLD;
+                m_aLocalDirtyNodes.push_back(i);
+            }
+
+            if (m_aParents[i] != INVALID_NODE && (m_aDirty[m_aParents[i]] & DIRTY_WORLD))
+            {
+                m_aDirty[i] |= DIRTY_WORLD;
+            }
+        }
+
+        UINT uNumLocal = static_cast<UINT>(m_aLocalDirtyNodes.size());
+
+        if (uNumLocal == 0u)
+        {
+            return;
+        }
+
+        // Pad the last batch by repeating the last node, recomputing the
+        // same matrix twice is harmless
+        while (m_aLocalDirtyNodes.size() % 4u != 0u)
+        {
+            m_aLocalDirtyNodes.push_back(m_aLocalDirtyNodes.back());
+        }
+
+        for (size_t i = 0u; i < m_aLocalDirtyNodes.size(); i += 4u)
+        {
+            computeLocalMatrices(&m_aLocalDirtyNodes[i]);
+        }
+
+        for (UINT i = 0u; i < uNumNodes; ++i)
+        {
+            if (!(m_aDirty[i] & DIRTY_WORLD))
+            {
+                continue;
+            }
+
+            if (m_aParents[i] == INVALID_NODE)
+            {
+                m_aWorldMatrices[i] = m_aLocalMatrices[i];
+            }
+            else
+            {
+                m_aWorldMatrices[i] = XMMatrixMultiply(m_aLocalMatrices[i], m_aWorldMatrices[m_aParents[i]]);
+            }
+
+            ++m_uNumUpdatedNodes;
+        }
+
+        // Flags are cleared only after every child has seen its parent's
+        std::fill(m_aDirty.begin(), m_aDirty.end(), static_cast<BYTE>(0u));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetParent
+      Summary:  Returns the parent of a node
+      Args:     UINT uNode
+                  Index of the node
+      Returns:  UINT
+                  Index of the parent, INVALID_NODE for a root
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::GetParent(_In_ UINT uNode) const
+    {
+        return m_aParents[uNode];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetWorldMatrix
+      Summary:  Returns the world matrix of a node as of the last Update
+      Args:     UINT uNode
+                  Index of the node
+      Returns:  const XMMATRIX&
+                  World matrix
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const XMMATRIX& TransformHierarchy::GetWorldMatrix(_In_ UINT uNode) const
+    {
+        return m_aWorldMatrices[uNode];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetNumNodes
+      Summary:  Returns the number of nodes
+      Returns:  UINT
+                  Number of nodes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::GetNumNodes() const
+    {
+        return static_cast<UINT>(m_aParents.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::GetNumUpdatedNodes
+      Summary:  Returns the number of world matrices recomputed by the
+                last Update
+      Returns:  UINT
+                  Number of updated nodes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TransformHierarchy::GetNumUpdatedNodes() const
+    {
+        return m_uNumUpdatedNodes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TransformHierarchy::computeLocalMatrices
+      Summary:  Computes scale * rotation * translation for four nodes at
+                once. The components are transposed so that each vector
+                lane holds one node, the rotation matrix is built from
+                the quaternions lane-wise, and the result is transposed
+                back into four row-major matrices
+      Args:     const UINT* auNodes
+                  Indices of the four nodes
+      Modifies: [m_aLocalMatrices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TransformHierarchy::computeLocalMatrices(_In_reads_(4) const UINT* auNodes)
+    {
+        XMMATRIX q(
+            XMLoadFloat4(&m_aRotations[auNodes[0]]),
+            XMLoadFloat4(&m_aRotations[auNodes[1]]),
+            XMLoadFloat4(&m_aRotations[auNodes[2]]),
+            XMLoadFloat4(&m_aRotations[auNodes[3]])
+        );
+        XMMATRIX s(
+            XMLoadFloat3(&m_aScales[auNodes[0]]),
+            XMLoadFloat3(&m_aScales[auNodes[1]]),
+            XMLoadFloat3(&m_aScales[auNodes[2]]),
+            XMLoadFloat3(&m_aScales[auNodes[3]])
+        );
+        XMMATRIX t(
+            XMVectorSetW(XMLoadFloat3(&m_aTranslations[auNodes[0]]), 1.0f),
+            XMVectorSetW(XMLoadFloat3(&m_aTranslations[auNodes[1]]), 1.0f),
+            XMVectorSetW(XMLoadFloat3(&m_aTranslations[auNodes[2]]), 1.0f),
+            XMVectorSetW(XMLoadFloat3(&m_aTranslations[auNodes[3]]), 1.0f)
+        );
+
+        // Lane i of every vector below belongs to node i
+        q = XMMatrixTranspose(q);
+        s = XMMatrixTranspose(s);
+
+        XMVECTOR x = q.r[0];
+        XMVECTOR y = q.r[1];
+        XMVECTOR z = q.r[2];
+        XMVECTOR w = q.r[3];
+
+        XMVECTOR x2 = XMVectorAdd(x, x);
+        XMVECTOR y2 = XMVectorAdd(y, y);
+        XMVECTOR z2 = XMVectorAdd(z, z);
+
+        XMVECTOR xx = XMVectorMultiply(x, x2);
+        XMVECTOR yy = XMVectorMultiply(y, y2);
+        XMVECTOR zz = XMVectorMultiply(z, z2);
+        XMVECTOR xy = XMVectorMultiply(x, y2);
+        XMVECTOR xz = XMVectorMultiply(x, z2);
+        XMVECTOR yz = XMVectorMultiply(y, z2);
+        XMVECTOR wx = XMVectorMultiply(w, x2);
+        XMVECTOR wy = XMVectorMultiply(w, y2);
+        XMVECTOR wz = XMVectorMultiply(w, z2);
+
+        XMVECTOR one = XMVectorSplatOne();
+
+        // Same layout as XMMatrixRotationQuaternion, each row scaled by
+        // the matching scale component
+        XMMATRIX row0(
+            XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(yy, zz)), s.r[0]),
+            XMVectorMultiply(XMVectorAdd(xy, wz), s.r[0]),
+            XMVectorMultiply(XMVectorSubtract(xz, wy), s.r[0]),
+            XMVectorZero()
+        );
+        XMMATRIX row1(
+            XMVectorMultiply(XMVectorSubtract(xy, wz), s.r[1]),
+            XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(xx, zz)), s.r[1]),
+            XMVectorMultiply(XMVectorAdd(yz, wx), s.r[1]),
+            XMVectorZero()
+        );
+        XMMATRIX row2(
+            XMVectorMultiply(XMVectorAdd(xz, wy), s.r[2]),
+            XMVectorMultiply(XMVectorSubtract(yz, wx), s.r[2]),
+            XMVectorMultiply(XMVectorSubtract(one, XMVectorAdd(xx, yy)), s.r[2]),
+            XMVectorZero()
+        );
+
+        row0 = XMMatrixTranspose(row0);
+        row1 = XMMatrixTranspose(row1);
+        row2 = XMMatrixTranspose(row2);
+
+        for (UINT i = 0u; i < 4u; ++i)
+        {
+            m_aLocalMatrices[auNodes[i]] = XMMATRIX(row0.r[i], row1.r[i], row2.r[i], t.r[i]);
+        }
+    }
+}
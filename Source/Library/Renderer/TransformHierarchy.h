@@ -0,0 +1,93 @@
+/*+===================================================================
+  File:      TRANSFORMHIERARCHY.H
+  Summary:   TransformHierarchy header file contains declarations of
+             TransformHierarchy class used to compute the world
+             matrices of parented transforms.
+  Classes: TransformHierarchy
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TransformHierarchy
+      Summary:  Parent / child transforms stored as structure of arrays.
+                A node is always added after its parent, so walking the
+                arrays front to back visits parents before children.
+                Changing a node marks it dirty; Update propagates the
+                flag to the descendants, recomputes the local matrices
+                of changed nodes four at a time and the world matrices
+                of changed subtrees only
+      Methods:  AddNode
+                  Adds a node under a parent
+                SetTranslation
+                  Sets the translation of a node
+                SetRotation
+                  Sets the rotation quaternion of a node
+                SetRotationRollPitchYaw
+                  Sets the rotation of a node from Euler angles
+                SetScale
+                  Sets the scale of a node
+                Update
+                  Recomputes the world matrices of dirty nodes
+                GetParent
+                  Returns the parent of a node
+                GetWorldMatrix
+                  Returns the world matrix of a node
+                GetNumNodes
+                  Returns the number of nodes
+                GetNumUpdatedNodes
+                  Returns the number of world matrices the last Update
+                  recomputed
+                TransformHierarchy
+                  Constructor.
+                ~TransformHierarchy
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TransformHierarchy final
+    {
+    public:
+        static constexpr const UINT INVALID_NODE = 0xFFFFFFFFu;
+
+    public:
+        TransformHierarchy();
+        TransformHierarchy(const TransformHierarchy& other) = delete;
+        TransformHierarchy(TransformHierarchy&& other) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy& other) = delete;
+        TransformHierarchy& operator=(TransformHierarchy&& other) = delete;
+        ~TransformHierarchy() = default;
+
+        UINT AddNode(_In_ UINT uParent = INVALID_NODE);
+
+        void SetTranslation(_In_ UINT uNode, _In_ const XMFLOAT3& translation);
+        void SetRotation(_In_ UINT uNode, _In_ FXMVECTOR quaternion);
+        void SetRotationRollPitchYaw(_In_ UINT uNode, _In_ FLOAT pitch, _In_ FLOAT yaw, _In_ FLOAT roll);
+        void SetScale(_In_ UINT uNode, _In_ const XMFLOAT3& scale);
+
+        void Update();
+
+        UINT GetParent(_In_ UINT uNode) const;
+        const XMMATRIX& GetWorldMatrix(_In_ UINT uNode) const;
+        UINT GetNumNodes() const;
+        UINT GetNumUpdatedNodes() const;
+
+    private:
+        static constexpr const BYTE DIRTY_LOCAL = 0x1u;
+        static constexpr const BYTE DIRTY_WORLD = 0x2u;
+
+        void computeLocalMatrices(_In_reads_(4) const UINT* auNodes);
+
+        std::vector<UINT> m_aParents;
+        std::vector<XMFLOAT3> m_aTranslations;
+        std::vector<XMFLOAT4> m_aRotations;
+        std::vector<XMFLOAT3> m_aScales;
+        std::vector<BYTE> m_aDirty;
+        std::vector<XMMATRIX> m_aLocalMatrices;
+        std::vector<XMMATRIX> m_aWorldMatrices;
+        std::vector<UINT> m_aLocalDirtyNodes;
+        UINT m_uNumUpdatedNodes;
+    };
+}
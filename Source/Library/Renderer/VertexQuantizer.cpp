@@ -0,0 +1,210 @@
+#include "Renderer/VertexQuantizer.h"
+
+#include <DirectXPackedVector.h>
+
+#include <cmath>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const FLOAT UNORM16_MAX = 65535.0f;
+        constexpr const FLOAT SNORM16_MAX = 32767.0f;
+        constexpr const FLOAT RADIANS_TO_DEGREES = 57.2957795f;
+
+        FLOAT signNotZero(FLOAT f)
+        {
+            return f >= 0.0f ? 1.0f : -1.0f;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexQuantizer::Quantize
+      Summary:  Packs vertices into CompactVertex. Positions are stored
+                relative to the bounding box of all vertices, so the
+                position error is at most half a step of 1/65535 of the
+                box extent per axis; the shader decodes them as
+                PositionBias + Position * PositionScale
+      Args:     const SimpleVertex* pVertices
+                  Vertices to pack
+                UINT uNumVertices
+                  Number of vertices
+                CompactVertex* pOutVertices
+                  Receives the packed vertices
+                XMFLOAT4& outPositionScale
+                  Receives the extent of the bounding box, W is 1
+                XMFLOAT4& outPositionBias
+                  Receives the minimum of the bounding box, W is 0
+                QuantizationError* pOutError
+                  Receives the measured error, can be nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexQuantizer::Quantize(
+        _In_reads_(uNumVertices) const SimpleVertex* pVertices,
+        _In_ UINT uNumVertices,
+        _Out_writes_(uNumVertices) CompactVertex* pOutVertices,
+        _Out_ XMFLOAT4& outPositionScale,
+        _Out_ XMFLOAT4& outPositionBias,
+        _Out_opt_ QuantizationError* pOutError
+    )
+    {
+        XMFLOAT3 boundsMin(0.0f, 0.0f, 0.0f);
+        XMFLOAT3 boundsMax(0.0f, 0.0f, 0.0f);
+
+        if (uNumVertices > 0u)
+        {
+            boundsMin = pVertices[0].Position;
+            boundsMax = pVertices[0].Position;
+        }
+
+        for (UINT i = 1u; i < uNumVertices; ++i)
+        {
+            const XMFLOAT3& position = pVertices[i].Position;
+
+            boundsMin = XMFLOAT3((std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y),
+                (std::min)(boundsMin.z, position.z));
+            boundsMax = XMFLOAT3((std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y),
+                (std::max)(boundsMax.z, position.z));
+        }
+
+        outPositionScale = XMFLOAT4(boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z, 1.0f);
+        outPositionBias = XMFLOAT4(boundsMin.x, boundsMin.y, boundsMin.z, 0.0f);
+
+        const FLOAT afMin[3] = { boundsMin.x, boundsMin.y, boundsMin.z };
+        const FLOAT afExtent[3] = { outPositionScale.x, outPositionScale.y, outPositionScale.z };
+
+        QuantizationError error = {};
+
+        for (UINT i = 0u; i < uNumVertices; ++i)
+        {
+            const SimpleVertex& vertex = pVertices[i];
+            CompactVertex& packed = pOutVertices[i];
+
+            const FLOAT afPosition[3] = { vertex.Position.x, vertex.Position.y, vertex.Position.z };
+
+            for (UINT k = 0u; k < 3u; ++k)
+            {
+                FLOAT fNormalized = afExtent[k] > 0.0f ? (afPosition[k] - afMin[k]) / afExtent[k] : 0.0f;
+                fNormalized = (std::min)((std::max)(fNormalized, 0.0f), 1.0f);
+
+                packed.Position[k] = static_cast<UINT16>(fNormalized * UNORM16_MAX + 0.5f);
+            }
+
+            packed.Position[3] = static_cast<UINT16>(UNORM16_MAX);
+
+            encodeOctahedral(vertex.Normal, packed.Normal);
+
+            packed.TexCoord[0] = PackedVector::XMConvertFloatToHalf(vertex.TexCoord.x);
+            packed.TexCoord[1] = PackedVector::XMConvertFloatToHalf(vertex.TexCoord.y);
+
+            // Measure what the shader will actually see
+            SimpleVertex decoded = Dequantize(packed, outPositionScale, outPositionBias);
+
+            FLOAT fDx = decoded.Position.x - vertex.Position.x;
+            FLOAT fDy = decoded.Position.y - vertex.Position.y;
+            FLOAT fDz = decoded.Position.z - vertex.Position.z;
+            error.fMaxPositionError = (std::max)(error.fMaxPositionError, std::sqrt(fDx * fDx + fDy * fDy + fDz * fDz));
+
+            FLOAT fLength = std::sqrt(vertex.Normal.x * vertex.Normal.x + vertex.Normal.y * vertex.Normal.y
+                + vertex.Normal.z * vertex.Normal.z);
+            if (fLength > 0.0f)
+            {
+                FLOAT fCos = (decoded.Normal.x * vertex.Normal.x + decoded.Normal.y * vertex.Normal.y
+                    + decoded.Normal.z * vertex.Normal.z) / fLength;
+                fCos = (std::min)((std::max)(fCos, -1.0f), 1.0f);
+                error.fMaxNormalErrorDegrees = (std::max)(error.fMaxNormalErrorDegrees, std::acos(fCos) * RADIANS_TO_DEGREES);
+            }
+
+            error.fMaxTexCoordError = (std::max)(error.fMaxTexCoordError,
+                (std::max)(std::fabs(decoded.TexCoord.x - vertex.TexCoord.x), std::fabs(decoded.TexCoord.y - vertex.TexCoord.y)));
+        }
+
+        if (pOutError)
+        {
+            *pOutError = error;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexQuantizer::Dequantize
+      Summary:  Unpacks one vertex the same way the compact vertex
+                shaders do
+      Args:     const CompactVertex& vertex
+                  Packed vertex
+                const XMFLOAT4& positionScale
+                  Scale returned by Quantize
+                const XMFLOAT4& positionBias
+                  Bias returned by Quantize
+      Returns:  SimpleVertex
+                  Unpacked vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SimpleVertex VertexQuantizer::Dequantize(
+        _In_ const CompactVertex& vertex,
+        _In_ const XMFLOAT4& positionScale,
+        _In_ const XMFLOAT4& positionBias
+    )
+    {
+        return SimpleVertex
+        {
+            .Position = XMFLOAT3(
+                positionBias.x + static_cast<FLOAT>(vertex.Position[0]) / UNORM16_MAX * positionScale.x,
+                positionBias.y + static_cast<FLOAT>(vertex.Position[1]) / UNORM16_MAX * positionScale.y,
+                positionBias.z + static_cast<FLOAT>(vertex.Position[2]) / UNORM16_MAX * positionScale.z),
+            .TexCoord = XMFLOAT2(
+                PackedVector::XMConvertHalfToFloat(vertex.TexCoord[0]),
+                PackedVector::XMConvertHalfToFloat(vertex.TexCoord[1])),
+            .Normal = decodeOctahedral(vertex.Normal)
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexQuantizer::encodeOctahedral
+      Summary:  Projects a normal onto the octahedron |x|+|y|+|z| = 1,
+                folds the lower half over the upper one and stores the
+                two remaining coordinates as SNORM16
+      Args:     const XMFLOAT3& normal
+                  Normal, need not be normalized
+                INT16 (&aEncoded)[2]
+                  Receives the encoded normal
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexQuantizer::encodeOctahedral(_In_ const XMFLOAT3& normal, _Out_ INT16 (&aEncoded)[2])
+    {
+        FLOAT fSum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+
+        FLOAT fX = fSum > 0.0f ? normal.x / fSum : 0.0f;
+        FLOAT fY = fSum > 0.0f ? normal.y / fSum : 0.0f;
+
+        if (normal.z < 0.0f)
+        {
+            FLOAT fFoldedX = (1.0f - std::fabs(fY)) * signNotZero(fX);
+            FLOAT fFoldedY = (1.0f - std::fabs(fX)) * signNotZero(fY);
+            fX = fFoldedX;
+            fY = fFoldedY;
+        }
+
+        aEncoded[0] = static_cast<INT16>(std::lround((std::min)((std::max)(fX, -1.0f), 1.0f) * SNORM16_MAX));
+        aEncoded[1] = static_cast<INT16>(std::lround((std::min)((std::max)(fY, -1.0f), 1.0f) * SNORM16_MAX));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexQuantizer::decodeOctahedral
+      Summary:  Inverse of encodeOctahedral
+      Args:     const INT16 (&aEncoded)[2]
+                  Encoded normal
+      Returns:  XMFLOAT3
+                  Unit normal
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMFLOAT3 VertexQuantizer::decodeOctahedral(_In_ const INT16 (&aEncoded)[2])
+    {
+        FLOAT fX = (std::max)(static_cast<FLOAT>(aEncoded[0]) / SNORM16_MAX, -1.0f);
+        FLOAT fY = (std::max)(static_cast<FLOAT>(aEncoded[1]) / SNORM16_MAX, -1.0f);
+        FLOAT fZ = 1.0f - std::fabs(fX) - std::fabs(fY);
+
+        FLOAT fFold = (std::max)(-fZ, 0.0f);
+        fX += fX >= 0.0f ? -fFold : fFold;
+        fY += fY >= 0.0f ? -fFold : fFold;
+
+        FLOAT fLength = std::sqrt(fX * fX + fY * fY + fZ * fZ);
+
+        return XMFLOAT3(fX / fLength, fY / fLength, fZ / fLength);
+    }
+}
@@ -0,0 +1,67 @@
+/*+===================================================================
+  File:      VERTEXQUANTIZER.H
+  Summary:   VertexQuantizer header file contains declarations of
+             VertexQuantizer class used to pack SimpleVertex buffers
+             into CompactVertex buffers.
+  Classes: VertexQuantizer
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   QuantizationError
+      Summary:  Largest error measured by decoding every quantized
+                vertex: position distance in object units, normal angle
+                in degrees and texture coordinate difference
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct QuantizationError
+    {
+        FLOAT fMaxPositionError;
+        FLOAT fMaxNormalErrorDegrees;
+        FLOAT fMaxTexCoordError;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    VertexQuantizer
+      Summary:  Converts between SimpleVertex and CompactVertex
+      Methods:  Quantize
+                  Packs vertices and returns the position decode
+                  constants and the error
+                Dequantize
+                  Unpacks one vertex
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class VertexQuantizer final
+    {
+    public:
+        VertexQuantizer() = delete;
+        VertexQuantizer(const VertexQuantizer& other) = delete;
+        VertexQuantizer(VertexQuantizer&& other) = delete;
+        VertexQuantizer& operator=(const VertexQuantizer& other) = delete;
+        VertexQuantizer& operator=(VertexQuantizer&& other) = delete;
+        ~VertexQuantizer() = delete;
+
+        static void Quantize(
+            _In_reads_(uNumVertices) const SimpleVertex* pVertices,
+            _In_ UINT uNumVertices,
+            _Out_writes_(uNumVertices) CompactVertex* pOutVertices,
+            _Out_ XMFLOAT4& outPositionScale,
+            _Out_ XMFLOAT4& outPositionBias,
+            _Out_opt_ QuantizationError* pOutError
+        );
+        static SimpleVertex Dequantize(
+            _In_ const CompactVertex& vertex,
+            _In_ const XMFLOAT4& positionScale,
+            _In_ const XMFLOAT4& positionBias
+        );
+
+    private:
+        static void encodeOctahedral(_In_ const XMFLOAT3& normal, _Out_ INT16 (&aEncoded)[2]);
+        static XMFLOAT3 decodeOctahedral(_In_ const INT16 (&aEncoded)[2]);
+    };
+}
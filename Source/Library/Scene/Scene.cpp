@@ -25,6 +25,9 @@ namespace library
     Scene::Scene(const std::filesystem::path& filePath)
         : m_filePath(filePath)
         , m_voxels()
+        , m_vertexShader()
+        , m_pixelShader()
+        , m_bInitialized(FALSE)
     {
         std::ifstream inputFile;
         inputFile.open(m_filePath.string());
@@ -160,9 +163,48 @@ namespace library
             }
         }
 
+        m_bInitialized = TRUE;
+
         return S_OK;
     }
 
+    // The shaders are kept with the scene, so a scene reloaded after its
+    // file changed can be given the same ones
+    void Scene::SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader)
+    {
+        m_vertexShader = vertexShader;
+
+        for (auto voxel : m_voxels)
+        {
+            voxel->SetVertexShader(vertexShader);
+        }
+    }
+
+    void Scene::SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader)
+    {
+        m_pixelShader = pixelShader;
+
+        for (auto voxel : m_voxels)
+        {
+            voxel->SetPixelShader(pixelShader);
+        }
+    }
+
+    const std::shared_ptr<VertexShader>& Scene::GetVertexShader() const
+    {
+        return m_vertexShader;
+    }
+
+    const std::shared_ptr<PixelShader>& Scene::GetPixelShader() const
+    {
+        return m_pixelShader;
+    }
+
+    BOOL Scene::IsInitialized() const
+    {
+        return m_bInitialized;
+    }
+
     std::vector<std::shared_ptr<Voxel>>& Scene::GetVoxels()
     {
         return m_voxels;
@@ -31,6 +31,12 @@ namespace library
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
+        void SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader);
+        void SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader);
+        const std::shared_ptr<VertexShader>& GetVertexShader() const;
+        const std::shared_ptr<PixelShader>& GetPixelShader() const;
+        BOOL IsInitialized() const;
+
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
         const std::filesystem::path& GetFilePath() const;
         PCWSTR GetFileName() const;
@@ -61,5 +67,8 @@ namespace library
     private:
         std::filesystem::path m_filePath;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
+        std::shared_ptr<VertexShader> m_vertexShader;
+        std::shared_ptr<PixelShader> m_pixelShader;
+        BOOL m_bInitialized;
     };
 }
\ No newline at end of file
@@ -13,51 +13,166 @@ namespace library
                 PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
-      Modifies: [m_pixelShader].
+                UINT uFeatures
+                  FEATURE_ bits the shader code is written for
+      Modifies: [m_aPixelShaders, m_aPendingPixelShaders].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    PixelShader::PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
-        Shader(pszFileName, pszEntryPoint, pszShaderModel), m_pixelShader(nullptr)
+    PixelShader::PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel,
+        _In_ UINT uFeatures) :
+        Shader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures), m_aPixelShaders(), m_aPendingPixelShaders()
     {
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PixelShader::Initialize
-      Summary:  Initializes the pixel shader
+      Summary:  Initializes the pixel shader variant with no features.
+                The other variants are prepared when the renderer first
+                asks for them. Errors are left to the caller to report,
+                with GetErrors
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the pixel shader
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT PixelShader::Initialize(_In_ ID3D11Device* pDevice) {
+        return PrepareVariant(pDevice, 0u);
+    }
 
-        HRESULT hr = S_OK;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::PrepareVariant
+      Summary:  Compiles the pixel shader of the variant of a key,
+                unless it is already compiled. A variant that failed is
+                not compiled again until the next CommitRecompile. Safe
+                to call from several threads for different variants,
+                outside of the recording of draws
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the pixel shader
+                UINT uKey
+                  Requested FEATURE_ bits
+      Modifies: [m_aPixelShaders, m_failedVariants].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT PixelShader::PrepareVariant(_In_ ID3D11Device* pDevice, _In_ UINT uKey) {
+        uKey = GetVariantKey(uKey);
 
-        ComPtr<ID3DBlob> pPsBlob;
-        hr = compile(pPsBlob.GetAddressOf());
+        if (m_aPixelShaders[uKey]) {
+            return S_OK;
+        }
 
-        if (FAILED(hr)) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
 
-            MessageBox(nullptr,
-                L"The FX file cannot be compiled.  Please run this executable from the directory that contains the FX file.",
-                L"Error", MB_OK);
-            return hr;
+            if (m_failedVariants.test(uKey)) {
+                return E_FAIL;
+            }
         }
 
-        hr = pDevice->CreatePixelShader(pPsBlob->GetBufferPointer(), pPsBlob->GetBufferSize(), NULL,
-            m_pixelShader.GetAddressOf());
+        ComPtr<ID3DBlob> pPsBlob;
+        ComPtr<ID3D11PixelShader> pixelShader;
+        HRESULT hr = compile(uKey, pPsBlob.GetAddressOf());
+
+        if (SUCCEEDED(hr)) {
+            hr = pDevice->CreatePixelShader(pPsBlob->GetBufferPointer(), pPsBlob->GetBufferSize(), NULL,
+                pixelShader.GetAddressOf());
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
 
         if (FAILED(hr)) {
+            m_failedVariants.set(uKey);
             return hr;
         }
+
+        m_aPixelShaders[uKey] = std::move(pixelShader);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::Recompile
+      Summary:  Compiles every variant in use again from the shader
+                file and creates the new shaders as pending objects.
+                The shaders in use are not touched, so this can run on
+                a worker thread while frames are drawn. Errors leave
+                the current variants in place and are reported to the
+                debugger only
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the pixel shader
+      Modifies: [m_aPendingPixelShaders, m_bRecompiled].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT PixelShader::Recompile(_In_ ID3D11Device* pDevice) {
+        std::bitset<NUM_VARIANTS> variants;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (UINT uKey = 0u; uKey < NUM_VARIANTS; ++uKey) {
+                variants[uKey] = m_aPixelShaders[uKey] != nullptr;
+            }
+        }
+
+        std::array<ComPtr<ID3D11PixelShader>, NUM_VARIANTS> aPixelShaders;
+
+        for (UINT uKey = 0u; uKey < NUM_VARIANTS; ++uKey) {
+            if (!variants[uKey]) {
+                continue;
+            }
+
+            ComPtr<ID3DBlob> pPsBlob;
+            HRESULT hr = compile(uKey, pPsBlob.GetAddressOf());
+
+            if (SUCCEEDED(hr)) {
+                hr = pDevice->CreatePixelShader(pPsBlob->GetBufferPointer(), pPsBlob->GetBufferSize(), NULL,
+                    aPixelShaders[uKey].GetAddressOf());
+            }
+
+            if (FAILED(hr)) {
+                return hr;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_aPendingPixelShaders = std::move(aPixelShaders);
+        m_bRecompiled = TRUE;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelShader::CommitRecompile
+      Summary:  Replaces the variants with the pending ones of a
+                successful Recompile. Variants prepared after it took
+                its list are dropped, and failed variants are tried
+                again, the next time they are prepared. Call on the
+                rendering thread between frames
+      Modifies: [m_aPixelShaders, m_aPendingPixelShaders,
+                 m_failedVariants, m_bRecompiled].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PixelShader::CommitRecompile() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_bRecompiled) {
+            m_aPixelShaders = std::move(m_aPendingPixelShaders);
+            m_failedVariants.reset();
+        }
+
+        m_aPendingPixelShaders.fill(nullptr);
+        m_bRecompiled = FALSE;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   PixelShader::GetPixelShader
-      Summary:  Returns the pixel shader
+      Summary:  Returns the pixel shader of the variant of a key
+      Args:     UINT uKey
+                  Requested FEATURE_ bits
       Returns:  ComPtr<ID3D11PixelShader>&
-                  Pixel shader. Could be a nullptr
+                  Pixel shader. Could be a nullptr if the variant was
+                  not prepared
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11PixelShader>& PixelShader::GetPixelShader() {
-        return m_pixelShader;
+    ComPtr<ID3D11PixelShader>& PixelShader::GetPixelShader(_In_ UINT uKey) {
+        return m_aPixelShaders[GetVariantKey(uKey)];
     }
 }
\ No newline at end of file
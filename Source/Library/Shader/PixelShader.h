@@ -10,6 +10,8 @@
 
 #include "Common.h"
 
+#include <array>
+
 #include "Shader/Shader.h"
 
 namespace library
@@ -18,9 +20,19 @@ namespace library
       Class:    PixelShader
       Summary:  Pixel shader
       Methods:  Initialize
-                  Initializes and compiles the pixel shader
+                  Initializes and compiles the pixel shader variant
+                  with no features
+                PrepareVariant
+                  Compiles the variant of a key if it is not compiled
+                  yet
+                Recompile
+                  Compiles the variants again into pending ones, safe
+                  to call from a worker thread
+                CommitRecompile
+                  Replaces the variants with the pending ones
                 GetPixelShader
-                  Returns the reference to the D3D11 pixel shader
+                  Returns the reference to the D3D11 pixel shader of a
+                  variant
                 Game
                   Constructor.
                 ~Game
@@ -30,7 +42,8 @@ namespace library
     {
     public:
         PixelShader() = delete;
-        PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        PixelShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel,
+            _In_ UINT uFeatures = 0u);
         PixelShader(const PixelShader& other) = delete;
         PixelShader(PixelShader&& other) = delete;
         PixelShader& operator=(const PixelShader& other) = delete;
@@ -38,10 +51,14 @@ namespace library
         virtual ~PixelShader() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+        virtual HRESULT PrepareVariant(_In_ ID3D11Device* pDevice, _In_ UINT uKey) override;
+        virtual HRESULT Recompile(_In_ ID3D11Device* pDevice) override;
+        virtual void CommitRecompile() override;
 
-        ComPtr<ID3D11PixelShader>& GetPixelShader();
+        ComPtr<ID3D11PixelShader>& GetPixelShader(_In_ UINT uKey = 0u);
 
     protected:
-        ComPtr<ID3D11PixelShader> m_pixelShader;
+        std::array<ComPtr<ID3D11PixelShader>, NUM_VARIANTS> m_aPixelShaders;
+        std::array<ComPtr<ID3D11PixelShader>, NUM_VARIANTS> m_aPendingPixelShaders;
     };
 }
\ No newline at end of file
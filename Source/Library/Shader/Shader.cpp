@@ -1,5 +1,7 @@
 #include "Shader.h"
 
+#include "Shader/ShaderCache.h"
+
 namespace library
 {
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -13,10 +15,15 @@ namespace library
               PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
-      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel].
+              UINT uFeatures
+                  FEATURE_ bits the shader code is written for
+      Modifies: [m_pszFileName, m_pszEntryPoint, m_pszShaderModel,
+                 m_uFeatures, m_mutex, m_failedVariants, m_aErrors,
+                 m_bRecompiled].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    Shader::Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
-        m_pszFileName(pszFileName), m_pszEntryPoint(pszEntryPoint), m_pszShaderModel(pszShaderModel) 
+    Shader::Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_ UINT uFeatures) :
+        m_pszFileName(pszFileName), m_pszEntryPoint(pszEntryPoint), m_pszShaderModel(pszShaderModel),
+        m_uFeatures(uFeatures & FEATURE_ALL), m_mutex(), m_failedVariants(), m_aErrors(), m_bRecompiled(FALSE)
     {
     }
 
@@ -30,16 +37,114 @@ namespace library
         return m_pszFileName;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetEntryPoint
+      Summary:  Returns the name of the shader entry point function
+      Returns:  PCSTR
+                  Entry point name
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCSTR Shader::GetEntryPoint() const {
+        return m_pszEntryPoint;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetFeatures
+      Summary:  Returns the features the shader declares
+      Returns:  UINT
+                  FEATURE_ bits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetFeatures() const {
+        return m_uFeatures;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetVariantKey
+      Summary:  Returns the key of the variant drawn for a requested
+                key, which keeps only the declared features
+      Args:     UINT uKey
+                  Requested FEATURE_ bits
+      Returns:  UINT
+                  Index of the variant, less than NUM_VARIANTS
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetVariantKey(_In_ UINT uKey) const {
+        return uKey & m_uFeatures;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetErrors
+      Summary:  Returns the messages of the compiler for the last
+                compilation of a variant that failed
+      Args:     UINT uKey
+                  Requested FEATURE_ bits
+      Returns:  std::string
+                  Compiler messages, empty if the last compilation
+                  succeeded or failed without any
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::string Shader::GetErrors(_In_ UINT uKey) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_aErrors[GetVariantKey(uKey)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetLightBucket
+      Summary:  Returns the light count bits of a key for a number of
+                lights. Counts are rounded up to a power of two, so few
+                variants cover every count; the lights past the count
+                are black and add nothing
+      Args:     UINT uNumLights
+                  Number of active lights
+      Returns:  UINT
+                  FEATURE_LIGHTS bits
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetLightBucket(_In_ UINT uNumLights) {
+        UINT uBucket = 0u;
+
+        while (uBucket < FEATURE_LIGHTS && GetNumLights(uBucket) < (std::min)(uNumLights, static_cast<UINT>(NUM_LIGHTS))) {
+            ++uBucket;
+        }
+
+        return uBucket;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Shader::GetNumLights
+      Summary:  Returns the number of lights the variant of a key shades
+                with
+      Args:     UINT uKey
+                  FEATURE_ bits
+      Returns:  UINT
+                  Number of lights, at most NUM_LIGHTS
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Shader::GetNumLights(_In_ UINT uKey) {
+        UINT uBucket = uKey & FEATURE_LIGHTS;
+
+        if (uBucket == 0u) {
+            return 0u;
+        }
+
+        return (std::min)(1u << (uBucket - 1u), static_cast<UINT>(NUM_LIGHTS));
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Shader::compile
-      Summary:  Compiles the given shader file
-      Args:     ID3DBlob** ppOutBlob
+      Summary:  Compiles a variant of the given shader file through the
+                shared ShaderCache, which returns cached bytecode when
+                the file, its includes and the options are unchanged.
+                The features of the key are passed as defines, along
+                with MAX_LIGHTS for the size of the light arrays.
+                Compiler messages of a failure are kept for GetErrors.
+                Safe to call from several threads
+      Args:     UINT uKey
+                  Key of the variant
+                ID3DBlob** ppOutBlob
                   Receives a pointer to the ID3DBlob interface that you
                   can use to access the compiled code
+      Modifies: [m_aErrors].
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Shader::compile(_Outptr_ ID3DBlob** ppOutBlob) {
+    HRESULT Shader::compile(_In_ UINT uKey, _Outptr_ ID3DBlob** ppOutBlob) {
 
         HRESULT hr = S_OK;
         DWORD dwShaderFlags = D3DCOMPILE_ENABLE_STRICTNESS;
@@ -49,15 +154,39 @@ namespace library
         dwShaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
+        uKey = GetVariantKey(uKey);
+
+        CHAR szNumLights[16];
+        CHAR szMaxLights[16];
+        sprintf_s(szNumLights, "%u", GetNumLights(uKey));
+        sprintf_s(szMaxLights, "%u", static_cast<UINT>(NUM_LIGHTS));
+
+        const D3D_SHADER_MACRO aDefines[] = {
+            { "NUM_LIGHTS", szNumLights },
+            { "MAX_LIGHTS", szMaxLights },
+            { "INSTANCING", (uKey & FEATURE_INSTANCING) ? "1" : "0" },
+            { "TEXTURING", (uKey & FEATURE_TEXTURING) ? "1" : "0" },
+            { "NORMAL_MAPPING", (uKey & FEATURE_NORMAL_MAPPING) ? "1" : "0" },
+            { nullptr, nullptr }
+        };
+
         ComPtr<ID3DBlob> pErrorBlob = nullptr;
-        hr = D3DCompileFromFile(m_pszFileName, nullptr, nullptr, m_pszEntryPoint, m_pszShaderModel,
-            dwShaderFlags, 0, ppOutBlob, pErrorBlob.GetAddressOf());
+        hr = ShaderCache::GetShared().Compile(m_pszFileName, aDefines, m_pszEntryPoint, m_pszShaderModel,
+            dwShaderFlags, ppOutBlob, pErrorBlob.GetAddressOf());
 
-        if (FAILED(hr)) {
-            if (pErrorBlob.Get() != NULL) {
-                OutputDebugStringA((char*)pErrorBlob->GetBufferPointer());
-            }
+        std::string szErrors;
 
+        if (FAILED(hr) && pErrorBlob.Get() != NULL) {
+            OutputDebugStringA((char*)pErrorBlob->GetBufferPointer());
+            szErrors = (char*)pErrorBlob->GetBufferPointer();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_aErrors[uKey] = std::move(szErrors);
+        }
+
+        if (FAILED(hr)) {
             return hr;
         }
 
@@ -10,17 +10,52 @@
 
 #include "Common.h"
 
+#include <array>
+#include <bitset>
+#include <mutex>
+
+#include "Renderer/DataTypes.h"
+
 namespace library
 {
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
-      Class:    PixelShader
-      Summary:  Pixel shader
+      Class:    Shader
+      Summary:  Shader compiled into variants. A shader declares the
+                features its code is written for, and each variant is
+                compiled with a define per feature, so a draw runs
+                only the code it needs. The renderer asks for a variant
+                by a key of feature bits; the bits the shader does not
+                declare are dropped, so variants that would compile to
+                the same code are shared. Variants are kept in a table
+                indexed by key and compiled the first time they are
+                prepared
       Methods:  Initialize
                   Pure virtual function that initializes the shader
+                PrepareVariant
+                  Pure virtual function that compiles the variant of a
+                  key if it is not compiled yet
                 GetFileName
                   Returns the name of the shader file to be compiled
+                GetEntryPoint
+                  Returns the name of the entry point function
+                GetFeatures
+                  Returns the features the shader declares
+                GetVariantKey
+                  Returns the key of the variant drawn for a key
+                GetErrors
+                  Returns the compiler messages of a variant
+                GetLightBucket
+                  Returns the light count bits for a number of lights
+                GetNumLights
+                  Returns the number of lights of a key
+                Recompile
+                  Pure virtual function that compiles the variants
+                  again into pending ones
+                CommitRecompile
+                  Pure virtual function that replaces the variants with
+                  the pending ones
                 compile
-                  Compiles the given shader file
+                  Compiles a variant of the given shader file
                 Game
                   Constructor.
                 ~Game
@@ -28,9 +63,21 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Shader
     {
+    public:
+        // Feature bits of a variant key. FEATURE_LIGHTS holds a light
+        // count bucket: 0 is unlit and bucket b shades with 2^(b-1)
+        // lights, up to NUM_LIGHTS. The renderer does not request
+        // FEATURE_INSTANCING yet, so shaders should not declare it
+        static constexpr const UINT FEATURE_LIGHTS = 0x7u;
+        static constexpr const UINT FEATURE_INSTANCING = 0x8u;
+        static constexpr const UINT FEATURE_TEXTURING = 0x10u;
+        static constexpr const UINT FEATURE_NORMAL_MAPPING = 0x20u;
+        static constexpr const UINT FEATURE_ALL = 0x3Fu;
+        static constexpr const UINT NUM_VARIANTS = FEATURE_ALL + 1u;
+
     public:
         Shader() = delete;
-        Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        Shader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel, _In_ UINT uFeatures);
         Shader(const Shader& other) = delete;
         Shader(Shader&& other) = delete;
         Shader& operator=(const Shader& other) = delete;
@@ -38,13 +85,32 @@ namespace library
         virtual ~Shader() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) = 0;
+        virtual HRESULT PrepareVariant(_In_ ID3D11Device* pDevice, _In_ UINT uKey) = 0;
+        virtual HRESULT Recompile(_In_ ID3D11Device* pDevice) = 0;
+        virtual void CommitRecompile() = 0;
         PCWSTR GetFileName() const;
+        PCSTR GetEntryPoint() const;
+        UINT GetFeatures() const;
+        UINT GetVariantKey(_In_ UINT uKey) const;
+        std::string GetErrors(_In_ UINT uKey);
+
+        static UINT GetLightBucket(_In_ UINT uNumLights);
+        static UINT GetNumLights(_In_ UINT uKey);
 
     protected:
-        HRESULT compile(_Outptr_ ID3DBlob** ppOutBlob);
+        HRESULT compile(_In_ UINT uKey, _Outptr_ ID3DBlob** ppOutBlob);
 
         PCWSTR m_pszFileName;
         PCSTR m_pszEntryPoint;
         PCSTR m_pszShaderModel;
+        UINT m_uFeatures;
+
+        // Guards the variant tables, failures and errors. A variant is
+        // created by one thread at a time, and only read without
+        // locking once created
+        std::mutex m_mutex;
+        std::bitset<NUM_VARIANTS> m_failedVariants;
+        std::array<std::string, NUM_VARIANTS> m_aErrors;
+        BOOL m_bRecompiled;
     };
 }
\ No newline at end of file
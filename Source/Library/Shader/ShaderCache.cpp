@@ -0,0 +1,413 @@
+#include "Shader/ShaderCache.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace library
+{
+    namespace
+    {
+        constexpr const UINT64 FNV_OFFSET_BASIS = 0xCBF29CE484222325ull;
+        constexpr const UINT64 FNV_PRIME = 0x100000001B3ull;
+
+        UINT64 hashBytes(_In_reads_bytes_(uSize) const void* pData, _In_ size_t uSize, _In_ UINT64 uHash = FNV_OFFSET_BASIS) {
+            const BYTE* pBytes = static_cast<const BYTE*>(pData);
+
+            for (size_t i = 0u; i < uSize; ++i) {
+                uHash = (uHash ^ pBytes[i]) * FNV_PRIME;
+            }
+
+            return uHash;
+        }
+
+        BOOL readFile(_In_ const std::filesystem::path& filePath, _Out_ std::string& outData) {
+            std::ifstream file(filePath, std::ios::binary);
+            if (!file) {
+                outData.clear();
+                return FALSE;
+            }
+
+            outData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+            return !file.bad();
+        }
+
+        /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+          Class:    ShaderInclude
+          Summary:  Opens the include files of a shader relative to the
+                    directory of the file that includes them, then to
+                    the directory of the shader, like D3DCompileFromFile
+        C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+        class ShaderInclude final : public ID3DInclude
+        {
+        public:
+            ShaderInclude(_In_ const std::filesystem::path& directory) :
+                m_directory(directory),
+                m_parentDirectories()
+            {
+            }
+
+            HRESULT __stdcall Open(_In_ D3D_INCLUDE_TYPE includeType, _In_ LPCSTR pFileName, _In_opt_ LPCVOID pParentData,
+                _Outptr_result_bytebuffer_(*pBytes) LPCVOID* ppData, _Out_ UINT* pBytes) override {
+                UNREFERENCED_PARAMETER(includeType);
+
+                *ppData = nullptr;
+                *pBytes = 0u;
+
+                // pParentData is the data returned for the including file, or the shader source itself
+                std::filesystem::path parentDirectory = m_directory;
+                if (pParentData) {
+                    auto it = m_parentDirectories.find(pParentData);
+                    if (it != m_parentDirectories.end()) {
+                        parentDirectory = it->second;
+                    }
+                }
+
+                std::filesystem::path filePath = parentDirectory / pFileName;
+                std::string data;
+                if (!readFile(filePath, data)) {
+                    filePath = m_directory / pFileName;
+                    if (!readFile(filePath, data)) {
+                        filePath = pFileName;
+                        if (!readFile(filePath, data)) {
+                            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+                        }
+                    }
+                }
+
+                char* pData = new char[data.size() + 1u];
+                memcpy(pData, data.data(), data.size());
+                pData[data.size()] = '\0';
+                m_parentDirectories.insert_or_assign(pData, filePath.parent_path());
+
+                *ppData = pData;
+                *pBytes = static_cast<UINT>(data.size());
+
+                return S_OK;
+            }
+
+            HRESULT __stdcall Close(_In_ LPCVOID pData) override {
+                m_parentDirectories.erase(pData);
+                delete[] static_cast<const char*>(pData);
+
+                return S_OK;
+            }
+
+        private:
+            std::filesystem::path m_directory;
+            std::unordered_map<LPCVOID, std::filesystem::path> m_parentDirectories;
+        };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::ShaderCache
+      Summary:  Constructor
+      Args:     const std::filesystem::path& directory
+                  Directory of the cached shader files, created on the
+                  first store
+      Modifies: [m_directory, m_mutex, m_entries, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCache::ShaderCache(_In_ const std::filesystem::path& directory) :
+        m_directory(directory),
+        m_mutex(),
+        m_entries(),
+        m_stats()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::Compile
+      Summary:  Returns the bytecode of a shader from memory, from disk,
+                or by compiling it, in this order. The file is
+                preprocessed first to find its key, and the preprocessed
+                source is what gets compiled, so the key always matches
+                the bytecode
+      Args:     PCWSTR pszFileName
+                  Name of the file that contains the shader code
+                const D3D_SHADER_MACRO* pDefines
+                  Defines terminated by a null entry, can be nullptr
+                PCSTR pszEntryPoint
+                  Name of the shader entry point
+                PCSTR pszShaderModel
+                  Shader target
+                UINT uFlags
+                  D3DCOMPILE flags
+                ID3DBlob** ppOutBlob
+                  Receives the bytecode
+                ID3DBlob** ppOutErrors
+                  Receives the messages of the preprocessor or compiler,
+                  can be nullptr
+      Modifies: [m_entries, m_stats].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::Compile(
+        _In_ PCWSTR pszFileName,
+        _In_opt_ const D3D_SHADER_MACRO* pDefines,
+        _In_ PCSTR pszEntryPoint,
+        _In_ PCSTR pszShaderModel,
+        _In_ UINT uFlags,
+        _Outptr_ ID3DBlob** ppOutBlob,
+        _Outptr_opt_result_maybenull_ ID3DBlob** ppOutErrors
+    ) {
+        *ppOutBlob = nullptr;
+        if (ppOutErrors) {
+            *ppOutErrors = nullptr;
+        }
+
+        std::filesystem::path filePath(pszFileName);
+
+        std::string source;
+        if (!readFile(filePath, source)) {
+            return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+        }
+
+        std::string sourceName = filePath.string();
+        ShaderInclude include(filePath.parent_path());
+
+        ComPtr<ID3DBlob> preprocessed;
+        ComPtr<ID3DBlob> errors;
+        HRESULT hr = D3DPreprocess(source.data(), source.size(), sourceName.c_str(), pDefines, &include,
+            preprocessed.GetAddressOf(), errors.GetAddressOf());
+
+        if (FAILED(hr)) {
+            if (ppOutErrors) {
+                *ppOutErrors = errors.Detach();
+            }
+
+            return hr;
+        }
+
+        // The preprocessed source ends with a null character
+        size_t uSourceSize = strnlen(static_cast<const char*>(preprocessed->GetBufferPointer()), preprocessed->GetBufferSize());
+
+        std::string key = sourceName;
+        key += '\0';
+        key += pszEntryPoint;
+        key += '\0';
+        key += pszShaderModel;
+        key += '\0';
+        key += std::to_string(uFlags);
+        key += '\0';
+        key += std::to_string(D3D_COMPILER_VERSION);
+        key += '\0';
+        key.append(static_cast<const char*>(preprocessed->GetBufferPointer()), uSourceSize);
+
+        UINT64 uKeyHash = hashBytes(key.data(), key.size());
+        UINT64 uKeySize = key.size();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Bytecode of another key with the same hash is a miss
+            auto it = m_entries.find(uKeyHash);
+            if (it != m_entries.end() && it->second.uKeySize == uKeySize && it->second.szSourceName == sourceName
+                && it->second.szEntryPoint == pszEntryPoint && it->second.szShaderModel == pszShaderModel) {
+                ++m_stats.uMemoryHits;
+                *ppOutBlob = ComPtr<ID3DBlob>(it->second.blob).Detach();
+
+                return S_OK;
+            }
+        }
+
+        ComPtr<ID3DBlob> blob;
+        if (SUCCEEDED(load(uKeyHash, uKeySize, blob.GetAddressOf()))) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            ++m_stats.uDiskHits;
+            m_entries.insert_or_assign(uKeyHash, ShaderCacheEntry{
+                .uKeySize = uKeySize,
+                .szSourceName = sourceName,
+                .szEntryPoint = pszEntryPoint,
+                .szShaderModel = pszShaderModel,
+                .blob = blob
+            });
+            *ppOutBlob = blob.Detach();
+
+            return S_OK;
+        }
+
+        // Defines and includes are already expanded in the source
+        hr = D3DCompile(preprocessed->GetBufferPointer(), uSourceSize, sourceName.c_str(), nullptr, nullptr, pszEntryPoint,
+            pszShaderModel, uFlags, 0u, blob.GetAddressOf(), errors.ReleaseAndGetAddressOf());
+
+        if (ppOutErrors) {
+            *ppOutErrors = errors.Detach();
+        }
+
+        if (FAILED(hr)) {
+            return hr;
+        }
+
+        if (FAILED(store(uKeyHash, uKeySize, blob.Get()))) {
+            OutputDebugString(L"ShaderCache::Compile: cannot write the cached shader file\n");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            ++m_stats.uCompiles;
+            m_entries.insert_or_assign(uKeyHash, ShaderCacheEntry{
+                .uKeySize = uKeySize,
+                .szSourceName = sourceName,
+                .szEntryPoint = pszEntryPoint,
+                .szShaderModel = pszShaderModel,
+                .blob = blob
+            });
+        }
+
+        *ppOutBlob = blob.Detach();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::GetStats
+      Summary:  Returns where the shaders asked for so far came from
+      Returns:  ShaderCacheStats
+                  Hits in memory and on disk, and compilations
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCacheStats ShaderCache::GetStats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::GetShared
+      Summary:  Returns the cache shared by the shaders, kept in the
+                ShaderCache directory of the working directory, where
+                the shader files are found too
+      Returns:  ShaderCache&
+                  Shared shader cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ShaderCache& ShaderCache::GetShared() {
+        static ShaderCache s_shaderCache(L"ShaderCache");
+
+        return s_shaderCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::load
+      Summary:  Reads the cached file of a key. Files of another
+                version or compiler, of another key with the same hash,
+                or with bytecode that does not match its hash are
+                rejected
+      Args:     UINT64 uKeyHash
+                  Hash of the key
+                UINT64 uKeySize
+                  Size of the key
+                ID3DBlob** ppOutBlob
+                  Receives the bytecode
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::load(_In_ UINT64 uKeyHash, _In_ UINT64 uKeySize, _Outptr_ ID3DBlob** ppOutBlob) const {
+        *ppOutBlob = nullptr;
+
+        std::string data;
+        if (!readFile(getFilePath(uKeyHash), data) || data.size() < sizeof(ShaderCacheFileHeader)) {
+            return E_FAIL;
+        }
+
+        ShaderCacheFileHeader header;
+        memcpy(&header, data.data(), sizeof(header));
+
+        const BYTE* pBytecode = reinterpret_cast<const BYTE*>(data.data()) + sizeof(header);
+
+        if (header.uMagic != MAGIC || header.uVersion != VERSION || header.uCompilerVersion != D3D_COMPILER_VERSION
+            || header.uKeyHash != uKeyHash || header.uKeySize != uKeySize
+            || header.uBytecodeSize == 0u || header.uBytecodeSize != data.size() - sizeof(header)
+            || header.uBytecodeHash != hashBytes(pBytecode, header.uBytecodeSize)) {
+            return E_FAIL;
+        }
+
+        ComPtr<ID3DBlob> blob;
+        HRESULT hr = D3DCreateBlob(header.uBytecodeSize, blob.GetAddressOf());
+        if (FAILED(hr)) {
+            return hr;
+        }
+
+        memcpy(blob->GetBufferPointer(), pBytecode, header.uBytecodeSize);
+        *ppOutBlob = blob.Detach();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::store
+      Summary:  Writes the cached file of a key. The file is written
+                under a temporary name and renamed, so another run never
+                reads it half written
+      Args:     UINT64 uKeyHash
+                  Hash of the key
+                UINT64 uKeySize
+                  Size of the key
+                ID3DBlob* pBlob
+                  Bytecode to cache
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ShaderCache::store(_In_ UINT64 uKeyHash, _In_ UINT64 uKeySize, _In_ ID3DBlob* pBlob) const {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if (error) {
+            return E_FAIL;
+        }
+
+        ShaderCacheFileHeader header = {
+            .uMagic = MAGIC,
+            .uVersion = VERSION,
+            .uCompilerVersion = D3D_COMPILER_VERSION,
+            .uBytecodeSize = static_cast<UINT>(pBlob->GetBufferSize()),
+            .uKeyHash = uKeyHash,
+            .uKeySize = uKeySize,
+            .uBytecodeHash = hashBytes(pBlob->GetBufferPointer(), pBlob->GetBufferSize())
+        };
+
+        std::filesystem::path filePath = getFilePath(uKeyHash);
+        std::filesystem::path tempPath = filePath;
+        tempPath += std::to_wstring(GetCurrentThreadId());
+        tempPath += L".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return E_FAIL;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(static_cast<const char*>(pBlob->GetBufferPointer()), static_cast<std::streamsize>(pBlob->GetBufferSize()));
+
+            if (!file) {
+                file.close();
+                std::filesystem::remove(tempPath, error);
+                return E_FAIL;
+            }
+        }
+
+        std::filesystem::rename(tempPath, filePath, error);
+        if (error) {
+            std::filesystem::remove(tempPath, error);
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ShaderCache::getFilePath
+      Summary:  Returns the path of the cached file of a key, named
+                after the hash of the key
+      Args:     UINT64 uKeyHash
+                  Hash of the key
+      Returns:  std::filesystem::path
+                  Path to the cached shader file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path ShaderCache::getFilePath(_In_ UINT64 uKeyHash) const {
+        WCHAR szName[32];
+        swprintf_s(szName, L"%016llx.cso", uKeyHash);
+
+        return m_directory / szName;
+    }
+}
@@ -0,0 +1,124 @@
+/*+===================================================================
+  File:      SHADERCACHE.H
+  Summary:   ShaderCache header file contains declarations of
+             ShaderCache class used to keep compiled shaders in memory
+             and on disk across runs.
+  Classes: ShaderCache
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCacheStats
+      Summary:  Where the shaders asked for so far came from
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCacheStats
+    {
+        UINT uMemoryHits;
+        UINT uDiskHits;
+        UINT uCompiles;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCacheFileHeader
+      Summary:  Header at the start of a cached shader file, followed by
+                the bytecode. The key is hashed from everything the
+                bytecode depends on, so a file is only used for the
+                exact compilation that wrote it
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCacheFileHeader
+    {
+        UINT uMagic;
+        UINT uVersion;
+        UINT uCompilerVersion;
+        UINT uBytecodeSize;
+        UINT64 uKeyHash;
+        UINT64 uKeySize;
+        UINT64 uBytecodeHash;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ShaderCacheEntry
+      Summary:  Bytecode kept in memory, with what its key is checked
+                against besides the hash
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ShaderCacheEntry
+    {
+        UINT64 uKeySize;
+        std::string szSourceName;
+        std::string szEntryPoint;
+        std::string szShaderModel;
+        ComPtr<ID3DBlob> blob;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ShaderCache
+      Summary:  Compiles shader files through a cache of bytecode kept
+                in memory and in a directory on disk. Files are only
+                preprocessed to find their key: the hash of the
+                preprocessed source, which holds every include file and
+                define, with the entry point, target, flags and compiler
+                version. The compiler runs only when no cached bytecode
+                has that key, compared by hash, size, file, entry point
+                and target, so a warm startup compiles nothing and an
+                edited file or include gets a new key. Cached files are
+                checked against their key, size and bytecode hash
+                before use. Thread safe
+      Methods:  Compile
+                  Returns the bytecode of a shader, compiling it if it
+                  is not cached
+                GetStats
+                  Returns where the shaders came from
+                GetShared
+                  Returns the cache shared by the shaders
+                ShaderCache
+                  Constructor.
+                ~ShaderCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ShaderCache final
+    {
+    public:
+        static constexpr const UINT MAGIC = 0x43444853u; // "SHDC"
+        static constexpr const UINT VERSION = 1u;
+
+    public:
+        ShaderCache() = delete;
+        ShaderCache(_In_ const std::filesystem::path& directory);
+        ShaderCache(const ShaderCache& other) = delete;
+        ShaderCache(ShaderCache&& other) = delete;
+        ShaderCache& operator=(const ShaderCache& other) = delete;
+        ShaderCache& operator=(ShaderCache&& other) = delete;
+        ~ShaderCache() = default;
+
+        HRESULT Compile(
+            _In_ PCWSTR pszFileName,
+            _In_opt_ const D3D_SHADER_MACRO* pDefines,
+            _In_ PCSTR pszEntryPoint,
+            _In_ PCSTR pszShaderModel,
+            _In_ UINT uFlags,
+            _Outptr_ ID3DBlob** ppOutBlob,
+            _Outptr_opt_result_maybenull_ ID3DBlob** ppOutErrors
+        );
+
+        ShaderCacheStats GetStats();
+
+        static ShaderCache& GetShared();
+
+    private:
+        HRESULT load(_In_ UINT64 uKeyHash, _In_ UINT64 uKeySize, _Outptr_ ID3DBlob** ppOutBlob) const;
+        HRESULT store(_In_ UINT64 uKeyHash, _In_ UINT64 uKeySize, _In_ ID3DBlob* pBlob) const;
+        std::filesystem::path getFilePath(_In_ UINT64 uKeyHash) const;
+
+        std::filesystem::path m_directory;
+        std::mutex m_mutex;
+        std::unordered_map<UINT64, ShaderCacheEntry> m_entries;
+        ShaderCacheStats m_stats;
+    };
+}
@@ -13,37 +13,194 @@ namespace library
                 PCSTR pszShaderModel
                   Specifies the shader target or set of shader features
                   to compile against
-      Modifies: [m_vertexShader].
+                eVertexFormat vertexFormat
+                  Format of the vertex buffers the shader reads
+                UINT uFeatures
+                  FEATURE_ bits the shader code is written for
+      Modifies: [m_aVertexShaders, m_aVertexLayouts,
+                 m_aPendingVertexShaders, m_aPendingVertexLayouts,
+                 m_vertexFormat].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    VertexShader::VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel) :
-        Shader(pszFileName, pszEntryPoint, pszShaderModel), m_vertexShader(nullptr), m_vertexLayout(nullptr)
+    VertexShader::VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel,
+        _In_ eVertexFormat vertexFormat, _In_ UINT uFeatures) :
+        Shader(pszFileName, pszEntryPoint, pszShaderModel, uFeatures), m_aVertexShaders(), m_aVertexLayouts(),
+        m_aPendingVertexShaders(), m_aPendingVertexLayouts(), m_vertexFormat(vertexFormat)
     {
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   VertexShader::Initialize
-      Summary:  Initializes the vertex shader and the input layout
+      Summary:  Initializes the vertex shader and the input layout of
+                the variant with no features. The other variants are
+                prepared when the renderer first asks for them. Errors
+                are left to the caller to report, with GetErrors
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the vertex shader
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT VertexShader::Initialize(_In_ ID3D11Device* pDevice) {
+        return PrepareVariant(pDevice, 0u);
+    }
 
-        HRESULT hr = S_OK;
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::PrepareVariant
+      Summary:  Compiles the vertex shader and the input layout of the
+                variant of a key, unless it is already compiled. A
+                variant that failed is not compiled again until the
+                next CommitRecompile. Safe to call from several threads
+                for different variants, outside of the recording of
+                draws
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shader
+                UINT uKey
+                  Requested FEATURE_ bits
+      Modifies: [m_aVertexShaders, m_aVertexLayouts, m_failedVariants].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VertexShader::PrepareVariant(_In_ ID3D11Device* pDevice, _In_ UINT uKey) {
+        uKey = GetVariantKey(uKey);
+
+        if (m_aVertexShaders[uKey]) {
+            return S_OK;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_failedVariants.test(uKey)) {
+                return E_FAIL;
+            }
+        }
 
         ComPtr<ID3DBlob> pVsBlob;
-        hr = compile(pVsBlob.GetAddressOf());
+        ComPtr<ID3D11VertexShader> vertexShader;
+        ComPtr<ID3D11InputLayout> vertexLayout;
+        HRESULT hr = compile(uKey, pVsBlob.GetAddressOf());
+
+        if (SUCCEEDED(hr)) {
+            hr = create(pDevice, pVsBlob.Get(), vertexShader, vertexLayout);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
 
         if (FAILED(hr)) {
-            MessageBox(nullptr,
-                L"The FX file cannot be compiled.  Please run this executable from the directory that contains the FX file.",
-                L"Error", MB_OK);
+            m_failedVariants.set(uKey);
             return hr;
         }
 
+        m_aVertexShaders[uKey] = std::move(vertexShader);
+        m_aVertexLayouts[uKey] = std::move(vertexLayout);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::Recompile
+      Summary:  Compiles every variant in use again from the shader
+                file and creates the new shaders and input layouts as
+                pending objects. The ones in use are not touched, so
+                this can run on a worker thread while frames are drawn.
+                Errors leave the current variants in place and are
+                reported to the debugger only
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shader
+      Modifies: [m_aPendingVertexShaders, m_aPendingVertexLayouts,
+                 m_bRecompiled].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VertexShader::Recompile(_In_ ID3D11Device* pDevice) {
+        std::bitset<NUM_VARIANTS> variants;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (UINT uKey = 0u; uKey < NUM_VARIANTS; ++uKey) {
+                variants[uKey] = m_aVertexShaders[uKey] != nullptr;
+            }
+        }
+
+        std::array<ComPtr<ID3D11VertexShader>, NUM_VARIANTS> aVertexShaders;
+        std::array<ComPtr<ID3D11InputLayout>, NUM_VARIANTS> aVertexLayouts;
+
+        for (UINT uKey = 0u; uKey < NUM_VARIANTS; ++uKey) {
+            if (!variants[uKey]) {
+                continue;
+            }
+
+            ComPtr<ID3DBlob> pVsBlob;
+            HRESULT hr = compile(uKey, pVsBlob.GetAddressOf());
+
+            if (SUCCEEDED(hr)) {
+                hr = create(pDevice, pVsBlob.Get(), aVertexShaders[uKey], aVertexLayouts[uKey]);
+            }
+
+            if (FAILED(hr)) {
+                return hr;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_aPendingVertexShaders = std::move(aVertexShaders);
+        m_aPendingVertexLayouts = std::move(aVertexLayouts);
+        m_bRecompiled = TRUE;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::CommitRecompile
+      Summary:  Replaces the variants with the pending ones of a
+                successful Recompile. Variants prepared after it took
+                its list are dropped, and failed variants are tried
+                again, the next time they are prepared. Call on the
+                rendering thread between frames
+      Modifies: [m_aVertexShaders, m_aVertexLayouts,
+                 m_aPendingVertexShaders, m_aPendingVertexLayouts,
+                 m_failedVariants, m_bRecompiled].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void VertexShader::CommitRecompile() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_bRecompiled) {
+            m_aVertexShaders = std::move(m_aPendingVertexShaders);
+            m_aVertexLayouts = std::move(m_aPendingVertexLayouts);
+            m_failedVariants.reset();
+        }
+
+        m_aPendingVertexShaders.fill(nullptr);
+        m_aPendingVertexLayouts.fill(nullptr);
+        m_bRecompiled = FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::create
+      Summary:  Creates the vertex shader and the input layout of the
+                vertex format from compiled code
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the vertex shader
+                ID3DBlob* pVsBlob
+                  Compiled shader code
+                ComPtr<ID3D11VertexShader>& outVertexShader
+                  Receives the vertex shader
+                ComPtr<ID3D11InputLayout>& outVertexLayout
+                  Receives the input layout
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT VertexShader::create(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3DBlob* pVsBlob,
+        _Out_ ComPtr<ID3D11VertexShader>& outVertexShader,
+        _Out_ ComPtr<ID3D11InputLayout>& outVertexLayout
+    ) {
+
+        HRESULT hr = S_OK;
+
         hr = pDevice->CreateVertexShader(pVsBlob->GetBufferPointer(), pVsBlob->GetBufferSize(), NULL,
-            m_vertexShader.GetAddressOf());
+            outVertexShader.ReleaseAndGetAddressOf());
 
         if (FAILED(hr)) {
             return hr;
@@ -59,10 +216,25 @@ namespace library
             { "MTX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1}
         };
 
-        UINT uNumElements = ARRAYSIZE(aLayouts);
+        // Matches CompactVertex; the shader decodes position and normal
+        D3D11_INPUT_ELEMENT_DESC aCompactLayouts[] = {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+            { "MTX", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            { "MTX", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            { "MTX", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            { "MTX", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1}
+        };
 
-        hr = pDevice->CreateInputLayout(aLayouts, uNumElements, pVsBlob->GetBufferPointer(), pVsBlob->GetBufferSize(),
-            m_vertexLayout.GetAddressOf());
+        if (m_vertexFormat == eVertexFormat::COMPACT) {
+            hr = pDevice->CreateInputLayout(aCompactLayouts, ARRAYSIZE(aCompactLayouts), pVsBlob->GetBufferPointer(),
+                pVsBlob->GetBufferSize(), outVertexLayout.ReleaseAndGetAddressOf());
+        }
+        else {
+            hr = pDevice->CreateInputLayout(aLayouts, ARRAYSIZE(aLayouts), pVsBlob->GetBufferPointer(),
+                pVsBlob->GetBufferSize(), outVertexLayout.ReleaseAndGetAddressOf());
+        }
 
         if (FAILED(hr)) {
             return hr;
@@ -73,21 +245,36 @@ namespace library
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   VertexShader::GetVertexShader
-      Summary:  Returns the vertex shader
+      Summary:  Returns the vertex shader of the variant of a key
+      Args:     UINT uKey
+                  Requested FEATURE_ bits
       Returns:  ComPtr<ID3D11VertexShader>&
-                  Vertex shader. Could be a nullptr
+                  Vertex shader. Could be a nullptr if the variant was
+                  not prepared
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11VertexShader>& VertexShader::GetVertexShader() {
-        return m_vertexShader;
+    ComPtr<ID3D11VertexShader>& VertexShader::GetVertexShader(_In_ UINT uKey) {
+        return m_aVertexShaders[GetVariantKey(uKey)];
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   VertexShader::GetVertexLayout
-      Summary:  Returns the vertex input layout
+      Summary:  Returns the vertex input layout of the variant of a key
+      Args:     UINT uKey
+                  Requested FEATURE_ bits
       Returns:  ComPtr<ID3D11InputLayout>&
                   Vertex input layout
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11InputLayout>& VertexShader::GetVertexLayout() {
-        return m_vertexLayout;
+    ComPtr<ID3D11InputLayout>& VertexShader::GetVertexLayout(_In_ UINT uKey) {
+        return m_aVertexLayouts[GetVariantKey(uKey)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   VertexShader::GetVertexFormat
+      Summary:  Returns the vertex format of the input layout
+      Returns:  eVertexFormat
+                  Vertex format
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eVertexFormat VertexShader::GetVertexFormat() const {
+        return m_vertexFormat;
     }
 }
\ No newline at end of file
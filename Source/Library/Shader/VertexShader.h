@@ -10,6 +10,9 @@
 
 #include "Common.h"
 
+#include <array>
+
+#include "Renderer/DataTypes.h"
 #include "Shader/Shader.h"
 
 namespace library
@@ -19,10 +22,21 @@ namespace library
       Summary:  Vertex shader
       Methods:  Initialize
                   Initializes the vertex shader and the input layout
+                  of the variant with no features
+                PrepareVariant
+                  Compiles the variant of a key if it is not compiled
+                  yet
+                Recompile
+                  Compiles the variants again into pending ones, safe
+                  to call from a worker thread
+                CommitRecompile
+                  Replaces the variants with the pending ones
                 GetVertexShader
-                  Returns the vertex shader
+                  Returns the vertex shader of a variant
                 GetVertexLayout
-                  Returns the vertex input layout
+                  Returns the vertex input layout of a variant
+                GetVertexFormat
+                  Returns the vertex format of the input layout
                 Game
                   Constructor.
                 ~Game
@@ -32,7 +46,8 @@ namespace library
     {
     public:
         VertexShader() = delete;
-        VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        VertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel,
+            _In_ eVertexFormat vertexFormat = eVertexFormat::SIMPLE, _In_ UINT uFeatures = 0u);
         VertexShader(const VertexShader& other) = delete;
         VertexShader(VertexShader&& other) = delete;
         VertexShader& operator=(const VertexShader& other) = delete;
@@ -40,12 +55,26 @@ namespace library
         virtual ~VertexShader() = default;
 
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+        virtual HRESULT PrepareVariant(_In_ ID3D11Device* pDevice, _In_ UINT uKey) override;
+        virtual HRESULT Recompile(_In_ ID3D11Device* pDevice) override;
+        virtual void CommitRecompile() override;
 
-        ComPtr<ID3D11VertexShader>& GetVertexShader();
-        ComPtr<ID3D11InputLayout>& GetVertexLayout();
+        ComPtr<ID3D11VertexShader>& GetVertexShader(_In_ UINT uKey = 0u);
+        ComPtr<ID3D11InputLayout>& GetVertexLayout(_In_ UINT uKey = 0u);
+        eVertexFormat GetVertexFormat() const;
 
     protected:
-        ComPtr<ID3D11VertexShader> m_vertexShader;
-        ComPtr<ID3D11InputLayout> m_vertexLayout;
+        HRESULT create(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3DBlob* pVsBlob,
+            _Out_ ComPtr<ID3D11VertexShader>& outVertexShader,
+            _Out_ ComPtr<ID3D11InputLayout>& outVertexLayout
+        );
+
+        std::array<ComPtr<ID3D11VertexShader>, NUM_VARIANTS> m_aVertexShaders;
+        std::array<ComPtr<ID3D11InputLayout>, NUM_VARIANTS> m_aVertexLayouts;
+        std::array<ComPtr<ID3D11VertexShader>, NUM_VARIANTS> m_aPendingVertexShaders;
+        std::array<ComPtr<ID3D11InputLayout>, NUM_VARIANTS> m_aPendingVertexLayouts;
+        eVertexFormat m_vertexFormat;
     };
 }
\ No newline at end of file
@@ -0,0 +1,775 @@
+#include "Texture/BlockCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLOCK_COMPRESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    namespace
+    {
+        // Texels of a block stored by channel, so four texels fill a
+        // vector
+        struct BlockTexels
+        {
+            alignas(16) float aafChannels[4][16];
+        };
+
+        // Interpolation weights of the 4-bit indices of BC7, in 64ths
+        constexpr const std::uint32_t BC7_WEIGHTS[16] = { 0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u };
+
+        // BC1 palette entry of each position along the endpoint line
+        constexpr const std::uint32_t BC1_INDICES[4] = { 0u, 2u, 3u, 1u };
+
+        struct BitWriter
+        {
+            std::uint8_t* pData;
+            std::uint32_t uBit;
+
+            void Write(std::uint32_t uValue, std::uint32_t uNumBits)
+            {
+                for (std::uint32_t i = 0u; i < uNumBits; ++i, ++uBit)
+                {
+                    if ((uValue >> i) & 1u)
+                    {
+                        pData[uBit >> 3u] |= static_cast<std::uint8_t>(1u << (uBit & 7u));
+                    }
+                }
+            }
+        };
+
+        void loadBlock(const std::uint8_t* pTexels, BlockTexels& block)
+        {
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                for (std::uint32_t c = 0u; c < 4u; ++c)
+                {
+                    block.aafChannels[c][i] = static_cast<float>(pTexels[i * 4u + c]);
+                }
+            }
+        }
+
+        float dot16(const float* pA, const float* pB)
+        {
+#ifdef BLOCK_COMPRESSOR_SSE2
+            __m128 sum = _mm_setzero_ps();
+            for (std::uint32_t i = 0u; i < 16u; i += 4u)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(pA + i), _mm_load_ps(pB + i)));
+            }
+
+            alignas(16) float afSum[4];
+            _mm_store_ps(afSum, sum);
+
+            return (afSum[0] + afSum[1]) + (afSum[2] + afSum[3]);
+#else
+            float fSum = 0.0f;
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                fSum += pA[i] * pB[i];
+            }
+
+            return fSum;
+#endif
+        }
+
+        // t = dot(texel - origin, direction) of every texel
+        void projectBlock(const BlockTexels& block, std::uint32_t uNumChannels, const float* pOrigin, const float* pDirection,
+            float* pT)
+        {
+#ifdef BLOCK_COMPRESSOR_SSE2
+            for (std::uint32_t i = 0u; i < 16u; i += 4u)
+            {
+                __m128 t = _mm_setzero_ps();
+                for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+                {
+                    __m128 offset = _mm_sub_ps(_mm_load_ps(block.aafChannels[c] + i), _mm_set1_ps(pOrigin[c]));
+                    t = _mm_add_ps(t, _mm_mul_ps(offset, _mm_set1_ps(pDirection[c])));
+                }
+
+                _mm_storeu_ps(pT + i, t);
+            }
+#else
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                pT[i] = 0.0f;
+                for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+                {
+                    pT[i] += (block.aafChannels[c][i] - pOrigin[c]) * pDirection[c];
+                }
+            }
+#endif
+        }
+
+        // Sum of the squared differences of two blocks
+        float blockError(const BlockTexels& block, const BlockTexels& decoded, std::uint32_t uNumChannels)
+        {
+#ifdef BLOCK_COMPRESSOR_SSE2
+            __m128 sum = _mm_setzero_ps();
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                for (std::uint32_t i = 0u; i < 16u; i += 4u)
+                {
+                    __m128 difference = _mm_sub_ps(_mm_load_ps(block.aafChannels[c] + i), _mm_load_ps(decoded.aafChannels[c] + i));
+                    sum = _mm_add_ps(sum, _mm_mul_ps(difference, difference));
+                }
+            }
+
+            alignas(16) float afSum[4];
+            _mm_store_ps(afSum, sum);
+
+            return (afSum[0] + afSum[1]) + (afSum[2] + afSum[3]);
+#else
+            float fSum = 0.0f;
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                for (std::uint32_t i = 0u; i < 16u; ++i)
+                {
+                    float fDifference = block.aafChannels[c][i] - decoded.aafChannels[c][i];
+                    fSum += fDifference * fDifference;
+                }
+            }
+
+            return fSum;
+#endif
+        }
+
+        // Mean and principal axis of the first channels of a block, by
+        // power iteration on their covariance. The axis is zero for a
+        // block of a single color
+        void computeAxis(const BlockTexels& block, std::uint32_t uNumChannels, float* pMean, float* pAxis)
+        {
+            alignas(16) float aafCentered[4][16];
+
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                float fSum = 0.0f;
+                for (std::uint32_t i = 0u; i < 16u; ++i)
+                {
+                    fSum += block.aafChannels[c][i];
+                }
+
+                pMean[c] = fSum / 16.0f;
+
+                for (std::uint32_t i = 0u; i < 16u; ++i)
+                {
+                    aafCentered[c][i] = block.aafChannels[c][i] - pMean[c];
+                }
+            }
+
+            float aafCovariance[4][4] = {};
+            std::uint32_t uLargest = 0u;
+
+            for (std::uint32_t c0 = 0u; c0 < uNumChannels; ++c0)
+            {
+                for (std::uint32_t c1 = c0; c1 < uNumChannels; ++c1)
+                {
+                    aafCovariance[c0][c1] = aafCovariance[c1][c0] = dot16(aafCentered[c0], aafCentered[c1]);
+                }
+
+                if (aafCovariance[c0][c0] > aafCovariance[uLargest][uLargest])
+                {
+                    uLargest = c0;
+                }
+            }
+
+            // The row of the largest variance is never orthogonal to the
+            // principal axis
+            float afAxis[4] = {};
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                afAxis[c] = aafCovariance[uLargest][c];
+            }
+
+            for (std::uint32_t uIteration = 0u; uIteration < 8u; ++uIteration)
+            {
+                float afNext[4] = {};
+                float fMax = 0.0f;
+
+                for (std::uint32_t c0 = 0u; c0 < uNumChannels; ++c0)
+                {
+                    for (std::uint32_t c1 = 0u; c1 < uNumChannels; ++c1)
+                    {
+                        afNext[c0] += aafCovariance[c0][c1] * afAxis[c1];
+                    }
+
+                    fMax = (std::max)(fMax, std::abs(afNext[c0]));
+                }
+
+                if (fMax <= 0.0f)
+                {
+                    break;
+                }
+
+                for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+                {
+                    afAxis[c] = afNext[c] / fMax;
+                }
+            }
+
+            float fLength = 0.0f;
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                fLength += afAxis[c] * afAxis[c];
+            }
+
+            fLength = std::sqrt(fLength);
+
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                pAxis[c] = fLength > 1e-6f ? afAxis[c] / fLength : 0.0f;
+            }
+        }
+
+        // Endpoints at the two ends of the projection of the block on
+        // its principal axis
+        void fitEndpoints(const BlockTexels& block, std::uint32_t uNumChannels, float* pEndpoint0, float* pEndpoint1)
+        {
+            float afMean[4] = {};
+            float afAxis[4] = {};
+            computeAxis(block, uNumChannels, afMean, afAxis);
+
+            float afT[16];
+            projectBlock(block, uNumChannels, afMean, afAxis, afT);
+
+            float fMin = *std::min_element(afT, afT + 16);
+            float fMax = *std::max_element(afT, afT + 16);
+
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                pEndpoint0[c] = std::clamp(afMean[c] + fMin * afAxis[c], 0.0f, 255.0f);
+                pEndpoint1[c] = std::clamp(afMean[c] + fMax * afAxis[c], 0.0f, 255.0f);
+            }
+        }
+
+        // Fractions of the way from the first to the second endpoint of
+        // the projection of every texel, clamped to [0, 1]
+        void projectOnEndpoints(const BlockTexels& block, std::uint32_t uNumChannels, const float* pEndpoint0,
+            const float* pEndpoint1, float* pT)
+        {
+            float afDirection[4] = {};
+            float fLengthSquared = 0.0f;
+
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                afDirection[c] = pEndpoint1[c] - pEndpoint0[c];
+                fLengthSquared += afDirection[c] * afDirection[c];
+            }
+
+            if (fLengthSquared < 1e-6f)
+            {
+                std::fill(pT, pT + 16, 0.0f);
+                return;
+            }
+
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                afDirection[c] /= fLengthSquared;
+            }
+
+            projectBlock(block, uNumChannels, pEndpoint0, afDirection, pT);
+
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                pT[i] = std::clamp(pT[i], 0.0f, 1.0f);
+            }
+        }
+
+        // Least squares endpoints of the block for fixed weights of the
+        // second endpoint. Returns false if the weights do not define
+        // both endpoints, such as when they are all equal
+        bool refineEndpoints(const BlockTexels& block, std::uint32_t uNumChannels, const float* pWeights, float* pEndpoint0,
+            float* pEndpoint1)
+        {
+            float fAlphaAlpha = 0.0f;
+            float fAlphaBeta = 0.0f;
+            float fBetaBeta = 0.0f;
+            float afAlphaX[4] = {};
+            float afBetaX[4] = {};
+
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                float fBeta = pWeights[i];
+                float fAlpha = 1.0f - fBeta;
+
+                fAlphaAlpha += fAlpha * fAlpha;
+                fAlphaBeta += fAlpha * fBeta;
+                fBetaBeta += fBeta * fBeta;
+
+                for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+                {
+                    afAlphaX[c] += fAlpha * block.aafChannels[c][i];
+                    afBetaX[c] += fBeta * block.aafChannels[c][i];
+                }
+            }
+
+            float fDeterminant = fAlphaAlpha * fBetaBeta - fAlphaBeta * fAlphaBeta;
+            if (std::abs(fDeterminant) < 1e-6f)
+            {
+                return false;
+            }
+
+            for (std::uint32_t c = 0u; c < uNumChannels; ++c)
+            {
+                pEndpoint0[c] = std::clamp((fBetaBeta * afAlphaX[c] - fAlphaBeta * afBetaX[c]) / fDeterminant, 0.0f, 255.0f);
+                pEndpoint1[c] = std::clamp((fAlphaAlpha * afBetaX[c] - fAlphaBeta * afAlphaX[c]) / fDeterminant, 0.0f, 255.0f);
+            }
+
+            return true;
+        }
+
+        std::uint16_t packRgb565(const float* pColor)
+        {
+            std::uint32_t uR = static_cast<std::uint32_t>(pColor[0] * (31.0f / 255.0f) + 0.5f);
+            std::uint32_t uG = static_cast<std::uint32_t>(pColor[1] * (63.0f / 255.0f) + 0.5f);
+            std::uint32_t uB = static_cast<std::uint32_t>(pColor[2] * (31.0f / 255.0f) + 0.5f);
+
+            return static_cast<std::uint16_t>((uR << 11u) | (uG << 5u) | uB);
+        }
+
+        void unpackRgb565(std::uint16_t uColor, float* pOutColor)
+        {
+            std::uint32_t uR = (uColor >> 11u) & 31u;
+            std::uint32_t uG = (uColor >> 5u) & 63u;
+            std::uint32_t uB = uColor & 31u;
+
+            pOutColor[0] = static_cast<float>((uR << 3u) | (uR >> 2u));
+            pOutColor[1] = static_cast<float>((uG << 2u) | (uG >> 4u));
+            pOutColor[2] = static_cast<float>((uB << 3u) | (uB >> 2u));
+        }
+
+        // Positions 0 to 3 along the line of two BC1 colors and the
+        // error of the block decoded with them
+        float evaluateBc1(const BlockTexels& block, std::uint16_t uColor0, std::uint16_t uColor1, std::uint32_t* pPositions)
+        {
+            float afColor0[3];
+            float afColor1[3];
+            unpackRgb565(uColor0, afColor0);
+            unpackRgb565(uColor1, afColor1);
+
+            float afT[16];
+            projectOnEndpoints(block, 3u, afColor0, afColor1, afT);
+
+            BlockTexels decoded;
+
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                pPositions[i] = static_cast<std::uint32_t>(afT[i] * 3.0f + 0.5f);
+
+                float fWeight = static_cast<float>(pPositions[i]) / 3.0f;
+                for (std::uint32_t c = 0u; c < 3u; ++c)
+                {
+                    decoded.aafChannels[c][i] = afColor0[c] + (afColor1[c] - afColor0[c]) * fWeight;
+                }
+            }
+
+            return blockError(block, decoded, 3u);
+        }
+
+        void encodeBc1(const BlockTexels& block, std::uint8_t* pOutBlock)
+        {
+            float afEndpoint0[3];
+            float afEndpoint1[3];
+            fitEndpoints(block, 3u, afEndpoint0, afEndpoint1);
+
+            std::uint16_t uColor0 = packRgb565(afEndpoint0);
+            std::uint16_t uColor1 = packRgb565(afEndpoint1);
+            std::uint32_t auPositions[16];
+            float fError = evaluateBc1(block, uColor0, uColor1, auPositions);
+
+            float afWeights[16];
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                afWeights[i] = static_cast<float>(auPositions[i]) / 3.0f;
+            }
+
+            if (fError > 0.0f && refineEndpoints(block, 3u, afWeights, afEndpoint0, afEndpoint1))
+            {
+                std::uint16_t uRefinedColor0 = packRgb565(afEndpoint0);
+                std::uint16_t uRefinedColor1 = packRgb565(afEndpoint1);
+                std::uint32_t auRefinedPositions[16];
+
+                if (evaluateBc1(block, uRefinedColor0, uRefinedColor1, auRefinedPositions) < fError)
+                {
+                    uColor0 = uRefinedColor0;
+                    uColor1 = uRefinedColor1;
+                    std::copy(auRefinedPositions, auRefinedPositions + 16, auPositions);
+                }
+            }
+
+            // The first color must be the larger for the four color mode
+            if (uColor0 < uColor1)
+            {
+                std::swap(uColor0, uColor1);
+                for (std::uint32_t& uPosition : auPositions)
+                {
+                    uPosition = 3u - uPosition;
+                }
+            }
+
+            std::uint32_t uIndices = 0u;
+            if (uColor0 != uColor1)
+            {
+                for (std::uint32_t i = 0u; i < 16u; ++i)
+                {
+                    uIndices |= BC1_INDICES[auPositions[i]] << (i * 2u);
+                }
+            }
+
+            std::memcpy(pOutBlock, &uColor0, sizeof(uColor0));
+            std::memcpy(pOutBlock + 2, &uColor1, sizeof(uColor1));
+            std::memcpy(pOutBlock + 4, &uIndices, sizeof(uIndices));
+        }
+
+        // Eight value mode, from the largest to the smallest value of the
+        // channel
+        void encodeBc4(const BlockTexels& block, std::uint32_t uChannel, std::uint8_t* pOutBlock)
+        {
+            const float* pValues = block.aafChannels[uChannel];
+
+            std::uint32_t uMin = static_cast<std::uint32_t>(*std::min_element(pValues, pValues + 16));
+            std::uint32_t uMax = static_cast<std::uint32_t>(*std::max_element(pValues, pValues + 16));
+
+            std::uint64_t uIndices = 0u;
+
+            if (uMax > uMin)
+            {
+                float afOrigin[4] = {};
+                float afDirection[4] = {};
+                afOrigin[uChannel] = static_cast<float>(uMin);
+                afDirection[uChannel] = 1.0f / static_cast<float>(uMax - uMin);
+
+                float afT[16];
+                projectBlock(block, uChannel + 1u, afOrigin, afDirection, afT);
+
+                for (std::uint32_t i = 0u; i < 16u; ++i)
+                {
+                    std::uint32_t uStep = static_cast<std::uint32_t>(std::clamp(afT[i], 0.0f, 1.0f) * 7.0f + 0.5f);
+                    std::uint64_t uIndex = uStep == 7u ? 0u : uStep == 0u ? 1u : 8u - uStep;
+
+                    uIndices |= uIndex << (i * 3u);
+                }
+            }
+
+            pOutBlock[0] = static_cast<std::uint8_t>(uMax);
+            pOutBlock[1] = static_cast<std::uint8_t>(uMin);
+            for (std::uint32_t i = 0u; i < 6u; ++i)
+            {
+                pOutBlock[2u + i] = static_cast<std::uint8_t>(uIndices >> (i * 8u));
+            }
+        }
+
+        // 7-bit values and p-bit of a BC7 mode 6 endpoint, choosing the
+        // p-bit closer to the endpoint
+        void quantizeBc7Endpoint(const float* pEndpoint, std::uint32_t* pOutValues, std::uint32_t& uOutPBit)
+        {
+            float fBestError = -1.0f;
+
+            for (std::uint32_t uPBit = 0u; uPBit < 2u; ++uPBit)
+            {
+                std::uint32_t auValues[4];
+                float fError = 0.0f;
+
+                for (std::uint32_t c = 0u; c < 4u; ++c)
+                {
+                    float fValue = std::clamp((pEndpoint[c] - static_cast<float>(uPBit)) * 0.5f + 0.5f, 0.0f, 127.0f);
+                    auValues[c] = static_cast<std::uint32_t>(fValue);
+
+                    float fDifference = static_cast<float>((auValues[c] << 1u) | uPBit) - pEndpoint[c];
+                    fError += fDifference * fDifference;
+                }
+
+                if (fBestError < 0.0f || fError < fBestError)
+                {
+                    fBestError = fError;
+                    std::copy(auValues, auValues + 4, pOutValues);
+                    uOutPBit = uPBit;
+                }
+            }
+        }
+
+        // Indices of the block for two BC7 mode 6 endpoints and the error
+        // of the block decoded with them
+        float evaluateBc7(const BlockTexels& block, const std::uint32_t* pValues0, std::uint32_t uPBit0,
+            const std::uint32_t* pValues1, std::uint32_t uPBit1, std::uint32_t* pIndices)
+        {
+            std::uint32_t auEndpoint0[4];
+            std::uint32_t auEndpoint1[4];
+            float afEndpoint0[4];
+            float afEndpoint1[4];
+
+            for (std::uint32_t c = 0u; c < 4u; ++c)
+            {
+                auEndpoint0[c] = (pValues0[c] << 1u) | uPBit0;
+                auEndpoint1[c] = (pValues1[c] << 1u) | uPBit1;
+                afEndpoint0[c] = static_cast<float>(auEndpoint0[c]);
+                afEndpoint1[c] = static_cast<float>(auEndpoint1[c]);
+            }
+
+            float afT[16];
+            projectOnEndpoints(block, 4u, afEndpoint0, afEndpoint1, afT);
+
+            BlockTexels decoded;
+
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                // Weights are nearly even, so the nearest one is next to
+                // the rounded position
+                float fWeight = afT[i] * 64.0f;
+                std::uint32_t uIndex = static_cast<std::uint32_t>(afT[i] * 15.0f + 0.5f);
+
+                if (uIndex > 0u && std::abs(fWeight - BC7_WEIGHTS[uIndex - 1u]) < std::abs(fWeight - BC7_WEIGHTS[uIndex]))
+                {
+                    --uIndex;
+                }
+                else if (uIndex < 15u && std::abs(fWeight - BC7_WEIGHTS[uIndex + 1u]) < std::abs(fWeight - BC7_WEIGHTS[uIndex]))
+                {
+                    ++uIndex;
+                }
+
+                pIndices[i] = uIndex;
+
+                for (std::uint32_t c = 0u; c < 4u; ++c)
+                {
+                    decoded.aafChannels[c][i] = static_cast<float>(
+                        ((64u - BC7_WEIGHTS[uIndex]) * auEndpoint0[c] + BC7_WEIGHTS[uIndex] * auEndpoint1[c] + 32u) >> 6u);
+                }
+            }
+
+            return blockError(block, decoded, 4u);
+        }
+
+        void encodeBc7(const BlockTexels& block, std::uint8_t* pOutBlock)
+        {
+            float afEndpoint0[4];
+            float afEndpoint1[4];
+            fitEndpoints(block, 4u, afEndpoint0, afEndpoint1);
+
+            std::uint32_t auValues0[4];
+            std::uint32_t auValues1[4];
+            std::uint32_t uPBit0 = 0u;
+            std::uint32_t uPBit1 = 0u;
+            quantizeBc7Endpoint(afEndpoint0, auValues0, uPBit0);
+            quantizeBc7Endpoint(afEndpoint1, auValues1, uPBit1);
+
+            std::uint32_t auIndices[16];
+            float fError = evaluateBc7(block, auValues0, uPBit0, auValues1, uPBit1, auIndices);
+
+            float afWeights[16];
+            for (std::uint32_t i = 0u; i < 16u; ++i)
+            {
+                afWeights[i] = static_cast<float>(BC7_WEIGHTS[auIndices[i]]) / 64.0f;
+            }
+
+            if (fError > 0.0f && refineEndpoints(block, 4u, afWeights, afEndpoint0, afEndpoint1))
+            {
+                std::uint32_t auRefinedValues0[4];
+                std::uint32_t auRefinedValues1[4];
+                std::uint32_t uRefinedPBit0 = 0u;
+                std::uint32_t uRefinedPBit1 = 0u;
+                quantizeBc7Endpoint(afEndpoint0, auRefinedValues0, uRefinedPBit0);
+                quantizeBc7Endpoint(afEndpoint1, auRefinedValues1, uRefinedPBit1);
+
+                std::uint32_t auRefinedIndices[16];
+                if (evaluateBc7(block, auRefinedValues0, uRefinedPBit0, auRefinedValues1, uRefinedPBit1, auRefinedIndices) < fError)
+                {
+                    std::copy(auRefinedValues0, auRefinedValues0 + 4, auValues0);
+                    std::copy(auRefinedValues1, auRefinedValues1 + 4, auValues1);
+                    uPBit0 = uRefinedPBit0;
+                    uPBit1 = uRefinedPBit1;
+                    std::copy(auRefinedIndices, auRefinedIndices + 16, auIndices);
+                }
+            }
+
+            // The most significant bit of the first index is implied zero
+            if (auIndices[0] & 8u)
+            {
+                std::swap(auValues0, auValues1);
+                std::swap(uPBit0, uPBit1);
+                for (std::uint32_t& uIndex : auIndices)
+                {
+                    uIndex = 15u - uIndex;
+                }
+            }
+
+            std::memset(pOutBlock, 0, 16u);
+            BitWriter writer = { .pData = pOutBlock, .uBit = 0u };
+
+            writer.Write(1u << 6u, 7u);
+            for (std::uint32_t c = 0u; c < 4u; ++c)
+            {
+                writer.Write(auValues0[c], 7u);
+                writer.Write(auValues1[c], 7u);
+            }
+            writer.Write(uPBit0, 1u);
+            writer.Write(uPBit1, 1u);
+
+            writer.Write(auIndices[0], 3u);
+            for (std::uint32_t i = 1u; i < 16u; ++i)
+            {
+                writer.Write(auIndices[i], 4u);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::IsSupported
+      Summary:  Returns whether a format can be encoded
+      Args:     eDdsFormat format
+                  Pixel format
+      Returns:  bool
+                  True for the UNORM and sRGB variants of BC1, BC3,
+                  BC7 and the UNORM variants of BC4 and BC5
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool BlockCompressor::IsSupported(eDdsFormat format)
+    {
+        switch (format)
+        {
+        case eDdsFormat::BC1_UNORM:
+        case eDdsFormat::BC1_UNORM_SRGB:
+        case eDdsFormat::BC3_UNORM:
+        case eDdsFormat::BC3_UNORM_SRGB:
+        case eDdsFormat::BC4_UNORM:
+        case eDdsFormat::BC5_UNORM:
+        case eDdsFormat::BC7_UNORM:
+        case eDdsFormat::BC7_UNORM_SRGB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::GetBlockSize
+      Summary:  Returns the bytes of one 4x4 block of a format
+      Args:     eDdsFormat format
+                  Pixel format
+      Returns:  std::uint32_t
+                  8 for BC1 and BC4, 16 otherwise
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t BlockCompressor::GetBlockSize(eDdsFormat format)
+    {
+        switch (format)
+        {
+        case eDdsFormat::BC1_UNORM:
+        case eDdsFormat::BC1_UNORM_SRGB:
+        case eDdsFormat::BC4_UNORM:
+            return 8u;
+
+        default:
+            return 16u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::CompressBlock
+      Summary:  Encodes one block of 4x4 texels. sRGB variants encode
+                the texels as they are, as the encoders only see
+                values
+      Args:     const std::uint8_t* pTexels
+                  16 RGBA8 texels, row by row
+                eDdsFormat format
+                  Supported block compressed format
+                std::uint8_t* pOutBlock
+                  Receives GetBlockSize bytes
+      Modifies: [pOutBlock].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::CompressBlock(const std::uint8_t* pTexels, eDdsFormat format, std::uint8_t* pOutBlock)
+    {
+        BlockTexels block;
+        loadBlock(pTexels, block);
+
+        switch (format)
+        {
+        case eDdsFormat::BC1_UNORM:
+        case eDdsFormat::BC1_UNORM_SRGB:
+            encodeBc1(block, pOutBlock);
+            break;
+
+        case eDdsFormat::BC3_UNORM:
+        case eDdsFormat::BC3_UNORM_SRGB:
+            encodeBc4(block, 3u, pOutBlock);
+            encodeBc1(block, pOutBlock + 8);
+            break;
+
+        case eDdsFormat::BC4_UNORM:
+            encodeBc4(block, 0u, pOutBlock);
+            break;
+
+        case eDdsFormat::BC5_UNORM:
+            encodeBc4(block, 0u, pOutBlock);
+            encodeBc4(block, 1u, pOutBlock + 8);
+            break;
+
+        case eDdsFormat::BC7_UNORM:
+        case eDdsFormat::BC7_UNORM_SRGB:
+            encodeBc7(block, pOutBlock);
+            break;
+
+        default:
+            std::memset(pOutBlock, 0, GetBlockSize(format));
+            break;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   BlockCompressor::CompressRows
+      Summary:  Encodes rows of blocks of an image. Blocks past the
+                edges of images whose size is not a multiple of four
+                repeat the last row and column
+      Args:     const std::uint8_t* pPixels
+                  RGBA8 texels, rows tightly packed
+                std::uint32_t uWidth
+                  Width of the image
+                std::uint32_t uHeight
+                  Height of the image
+                eDdsFormat format
+                  Supported block compressed format
+                std::uint32_t uFirstBlockRow
+                  First row of blocks to encode
+                std::uint32_t uNumBlockRows
+                  Number of rows of blocks to encode
+                std::uint8_t* pOutBlocks
+                  First block of the image, rows of blocks tightly
+                  packed
+      Modifies: [pOutBlocks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void BlockCompressor::CompressRows(const std::uint8_t* pPixels, std::uint32_t uWidth, std::uint32_t uHeight, eDdsFormat format,
+        std::uint32_t uFirstBlockRow, std::uint32_t uNumBlockRows, std::uint8_t* pOutBlocks)
+    {
+        std::uint32_t uBlocksWide = (uWidth + 3u) / 4u;
+        std::uint32_t uBlocksHigh = (uHeight + 3u) / 4u;
+        std::uint32_t uBlockSize = GetBlockSize(format);
+
+        std::uint32_t uLastBlockRow = (std::min)(uFirstBlockRow + uNumBlockRows, uBlocksHigh);
+
+        std::uint8_t auTexels[64];
+
+        for (std::uint32_t uBlockY = uFirstBlockRow; uBlockY < uLastBlockRow; ++uBlockY)
+        {
+            for (std::uint32_t uBlockX = 0u; uBlockX < uBlocksWide; ++uBlockX)
+            {
+                for (std::uint32_t y = 0u; y < 4u; ++y)
+                {
+                    std::uint32_t uY = (std::min)(uBlockY * 4u + y, uHeight - 1u);
+
+                    for (std::uint32_t x = 0u; x < 4u; ++x)
+                    {
+                        std::uint32_t uX = (std::min)(uBlockX * 4u + x, uWidth - 1u);
+
+                        std::memcpy(auTexels + (y * 4u + x) * 4u, pPixels + (static_cast<std::size_t>(uY) * uWidth + uX) * 4u, 4u);
+                    }
+                }
+
+                CompressBlock(auTexels, format,
+                    pOutBlocks + (static_cast<std::size_t>(uBlockY) * uBlocksWide + uBlockX) * uBlockSize);
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*+===================================================================
+  File:      BLOCKCOMPRESSOR.H
+  Summary:   BlockCompressor header file contains declarations of
+             BlockCompressor class used to encode baked textures to
+             block compressed formats on the CPU.
+  Classes: BlockCompressor
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+
+#include "Texture/DdsParser.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    BlockCompressor
+      Summary:  Encodes RGBA8 images to BC1, BC3, BC4, BC5 and BC7, one
+                4x4 block at a time, so rows of blocks can be encoded in
+                parallel. Endpoints are fitted along the principal axis
+                of the block colors, then refined once by least squares
+                on the chosen indices, keeping the better of the two.
+                Texels are projected on the endpoint line and measured
+                four at a time with SSE2 (scalar code elsewhere).
+                BC1 is opaque, BC4 encodes red and BC5 red and green,
+                such as the X and Y of normal maps. BC7 is the fast
+                single mode 6 encoding, with RGBA endpoints of 7 bits
+                and a p-bit, and 16 weights
+      Methods:  IsSupported
+                  Returns whether a format can be encoded
+                GetBlockSize
+                  Returns the bytes of one block of a format
+                CompressBlock
+                  Encodes one block of 4x4 texels
+                CompressRows
+                  Encodes rows of blocks of an image
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class BlockCompressor final
+    {
+    public:
+        BlockCompressor() = delete;
+        BlockCompressor(const BlockCompressor& other) = delete;
+        BlockCompressor(BlockCompressor&& other) = delete;
+        BlockCompressor& operator=(const BlockCompressor& other) = delete;
+        BlockCompressor& operator=(BlockCompressor&& other) = delete;
+        ~BlockCompressor() = delete;
+
+        static bool IsSupported(eDdsFormat format);
+        static std::uint32_t GetBlockSize(eDdsFormat format);
+
+        static void CompressBlock(const std::uint8_t* pTexels, eDdsFormat format, std::uint8_t* pOutBlock);
+        static void CompressRows(const std::uint8_t* pPixels, std::uint32_t uWidth, std::uint32_t uHeight, eDdsFormat format,
+            std::uint32_t uFirstBlockRow, std::uint32_t uNumBlockRows, std::uint8_t* pOutBlocks);
+    };
+}
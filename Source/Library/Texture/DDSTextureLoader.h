@@ -19,6 +19,9 @@
 #include "Common.h"
 
 #include <cstdint>
+#include <vector>
+
+#include "Texture/DdsParser.h"
 
 namespace DirectX
 {
@@ -129,4 +132,21 @@ namespace DirectX
         _Outptr_opt_ ID3D11Resource** texture,
         _Outptr_opt_ ID3D11ShaderResourceView** textureView,
         _Out_opt_ DDS_ALPHA_MODE* alphaMode = nullptr) noexcept;
+
+    // Extended version for files already parsed by library::DdsParser, such as
+    // mapped by library::DdsFile; reads the pixels from the subresource views
+    HRESULT CreateDDSTextureFromImageEx(
+        _In_ ID3D11Device* d3dDevice,
+        _In_opt_ ID3D11DeviceContext* d3dContext,
+        _In_ const library::DdsImage& image,
+        _In_ const std::vector<library::DdsSubresource>& subresources,
+        _In_ size_t maxsize,
+        _In_ D3D11_USAGE usage,
+        _In_ unsigned int bindFlags,
+        _In_ unsigned int cpuAccessFlags,
+        _In_ unsigned int miscFlags,
+        _In_ bool forceSRGB,
+        _Outptr_opt_ ID3D11Resource** texture,
+        _Outptr_opt_ ID3D11ShaderResourceView** textureView,
+        _Out_opt_ DDS_ALPHA_MODE* alphaMode = nullptr) noexcept;
 }
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "Texture/DdsFile.h"
+
+#include <fstream>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::DdsFile
+      Summary:  Constructor
+      Modifies: [m_hFile, m_hMapping, m_pData, m_image,
+                 m_aSubresources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DdsFile::DdsFile() :
+        m_hFile(INVALID_HANDLE_VALUE),
+        m_hMapping(nullptr),
+        m_pData(nullptr),
+        m_image(),
+        m_aSubresources()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::~DdsFile
+      Summary:  Destructor. Unmaps the file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DdsFile::~DdsFile()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::Open
+      Summary:  Maps a DDS file and parses its headers and subresource
+                layout. No pixel is read until the views are used
+      Args:     const std::filesystem::path& filePath
+                  Path to the DDS file
+      Modifies: [m_hFile, m_hMapping, m_pData, m_image,
+                 m_aSubresources].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT DdsFile::Open(_In_ const std::filesystem::path& filePath)
+    {
+        Close();
+
+        m_hFile = CreateFile(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > static_cast<LONGLONG>(UINT_MAX))
+        {
+            Close();
+            return E_FAIL;
+        }
+
+        m_hMapping = CreateFileMapping(m_hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+        if (!m_hMapping)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        m_pData = static_cast<const BYTE*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+        if (!m_pData)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Close();
+            return hr;
+        }
+
+        HRESULT hr = ToHResult(DdsParser::Parse(m_pData, static_cast<size_t>(fileSize.QuadPart), m_image, m_aSubresources));
+        if (FAILED(hr))
+        {
+            Close();
+            return hr;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::Close
+      Summary:  Unmaps the file, invalidating the subresource views
+      Modifies: [m_hFile, m_hMapping, m_pData, m_image,
+                 m_aSubresources].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DdsFile::Close()
+    {
+        m_aSubresources.clear();
+        m_image = DdsImage();
+
+        if (m_pData)
+        {
+            UnmapViewOfFile(m_pData);
+            m_pData = nullptr;
+        }
+
+        if (m_hMapping)
+        {
+            CloseHandle(m_hMapping);
+            m_hMapping = nullptr;
+        }
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_hFile);
+            m_hFile = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::IsOpen
+      Summary:  Returns whether a file is mapped and parsed
+      Returns:  BOOL
+                  TRUE if the file is open
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL DdsFile::IsOpen() const
+    {
+        return m_pData != nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::GetImage
+      Summary:  Returns the image description
+      Returns:  const DdsImage&
+                  Image description
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DdsImage& DdsFile::GetImage() const
+    {
+        return m_image;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::GetSubresources
+      Summary:  Returns the subresource views, in Direct3D subresource
+                order
+      Returns:  const std::vector<DdsSubresource>&
+                  Subresource views
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<DdsSubresource>& DdsFile::GetSubresources() const
+    {
+        return m_aSubresources;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::GetSubresource
+      Summary:  Returns the view of a mip of an array slice
+      Args:     UINT uMip
+                  Mip level
+                UINT uSlice
+                  Array slice, or cube face
+      Returns:  const DdsSubresource&
+                  Subresource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const DdsSubresource& DdsFile::GetSubresource(_In_ UINT uMip, _In_ UINT uSlice) const
+    {
+        assert(uMip < m_image.uMipLevels && uSlice < m_image.uArraySize);
+
+        return m_aSubresources[static_cast<size_t>(uSlice) * m_image.uMipLevels + uMip];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::Write
+      Summary:  Writes a texture to a DDS file
+      Args:     const std::filesystem::path& filePath
+                  Path to write to
+                const DdsImage& image
+                  Description of the texture
+                const std::vector<DdsSubresource>& aSubresources
+                  Views of every mip of every slice
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT DdsFile::Write(
+        _In_ const std::filesystem::path& filePath,
+        _In_ const DdsImage& image,
+        _In_ const std::vector<DdsSubresource>& aSubresources
+    )
+    {
+        std::vector<BYTE> aData;
+
+        HRESULT hr = ToHResult(DdsParser::Write(image, aSubresources, aData));
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return E_FAIL;
+        }
+
+        file.write(reinterpret_cast<const char*>(aData.data()), static_cast<std::streamsize>(aData.size()));
+
+        return file ? S_OK : E_FAIL;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::GetBakedPath
+      Summary:  Returns the path of the baked file of a source image,
+                which is the source path followed by ".dds"
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+      Returns:  std::filesystem::path
+                  Path to the baked DDS file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::filesystem::path DdsFile::GetBakedPath(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::filesystem::path bakedPath = sourcePath;
+        bakedPath += L".dds";
+
+        return bakedPath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::IsUpToDate
+      Summary:  Returns whether the baked file of a source image exists
+                and is not older than the source, like
+                MeshFile::IsUpToDate
+      Args:     const std::filesystem::path& sourcePath
+                  Path to the source image
+      Returns:  BOOL
+                  Whether the baked file can be loaded instead
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL DdsFile::IsUpToDate(_In_ const std::filesystem::path& sourcePath)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type bakedTime = std::filesystem::last_write_time(GetBakedPath(sourcePath), error);
+        if (error)
+        {
+            return FALSE;
+        }
+
+        std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, error);
+        if (error)
+        {
+            return TRUE;
+        }
+
+        return bakedTime >= sourceTime ? TRUE : FALSE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsFile::ToHResult
+      Summary:  Converts a parser status to the status code the DDS
+                texture loader returned for the same error
+      Args:     eDdsStatus status
+                  Parser status
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT DdsFile::ToHResult(_In_ eDdsStatus status)
+    {
+        switch (status)
+        {
+        case eDdsStatus::OK:
+            return S_OK;
+
+        case eDdsStatus::NOT_SUPPORTED:
+            return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+        case eDdsStatus::END_OF_FILE:
+            return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+
+        case eDdsStatus::ARITHMETIC_OVERFLOW:
+            return HRESULT_FROM_WIN32(ERROR_ARITHMETIC_OVERFLOW);
+
+        case eDdsStatus::INVALID_DATA:
+        default:
+            return E_FAIL;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*+===================================================================
+  File:      DDSFILE.H
+  Summary:   DdsFile header file contains declarations of DdsFile
+             class used to map DDS files and read their subresources
+             in place.
+  Classes: DdsFile
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/DdsParser.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DdsFile
+      Summary:  A DDS file mapped read only like MeshFile and parsed by
+                DdsParser. The subresource views point into the mapping
+                and stay valid until the file is closed, so textures
+                are created from the file pages without reading them
+                into a buffer first
+      Methods:  Open
+                  Maps and parses a DDS file
+                Close
+                  Unmaps the file
+                IsOpen
+                  Returns whether a file is mapped
+                GetImage
+                  Returns the image description
+                GetSubresources
+                  Returns the subresource views
+                GetSubresource
+                  Returns the view of a mip of an array slice
+                Write
+                  Writes a DDS file
+                GetBakedPath
+                  Returns the baked file path of a source image
+                IsUpToDate
+                  Returns whether the baked file of a source image
+                  exists and is not older than the source
+                ToHResult
+                  Converts a parser status to a status code
+                DdsFile
+                  Constructor.
+                ~DdsFile
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DdsFile final
+    {
+    public:
+        DdsFile();
+        DdsFile(const DdsFile& other) = delete;
+        DdsFile(DdsFile&& other) = delete;
+        DdsFile& operator=(const DdsFile& other) = delete;
+        DdsFile& operator=(DdsFile&& other) = delete;
+        ~DdsFile();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath);
+        void Close();
+        BOOL IsOpen() const;
+
+        const DdsImage& GetImage() const;
+        const std::vector<DdsSubresource>& GetSubresources() const;
+        const DdsSubresource& GetSubresource(_In_ UINT uMip, _In_ UINT uSlice) const;
+
+        static HRESULT Write(
+            _In_ const std::filesystem::path& filePath,
+            _In_ const DdsImage& image,
+            _In_ const std::vector<DdsSubresource>& aSubresources
+        );
+        static std::filesystem::path GetBakedPath(_In_ const std::filesystem::path& sourcePath);
+        static BOOL IsUpToDate(_In_ const std::filesystem::path& sourcePath);
+        static HRESULT ToHResult(_In_ eDdsStatus status);
+
+    private:
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+        const BYTE* m_pData;
+        DdsImage m_image;
+        std::vector<DdsSubresource> m_aSubresources;
+    };
+}
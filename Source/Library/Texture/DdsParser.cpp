@@ -0,0 +1,779 @@
+#include "Texture/DdsParser.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace library
+{
+    namespace
+    {
+        // File structures, see DDS.h in the DirectXTex library. Fields
+        // are read with memcpy, as mapped data has no alignment promise
+        struct DdsPixelFormat
+        {
+            std::uint32_t uSize;
+            std::uint32_t uFlags;
+            std::uint32_t uFourCC;
+            std::uint32_t uRgbBitCount;
+            std::uint32_t uRBitMask;
+            std::uint32_t uGBitMask;
+            std::uint32_t uBBitMask;
+            std::uint32_t uABitMask;
+        };
+
+        struct DdsHeader
+        {
+            std::uint32_t uSize;
+            std::uint32_t uFlags;
+            std::uint32_t uHeight;
+            std::uint32_t uWidth;
+            std::uint32_t uPitchOrLinearSize;
+            std::uint32_t uDepth;
+            std::uint32_t uMipMapCount;
+            std::uint32_t auReserved1[11];
+            DdsPixelFormat pixelFormat;
+            std::uint32_t uCaps;
+            std::uint32_t uCaps2;
+            std::uint32_t uCaps3;
+            std::uint32_t uCaps4;
+            std::uint32_t uReserved2;
+        };
+
+        struct DdsHeaderDxt10
+        {
+            std::uint32_t uDxgiFormat;
+            std::uint32_t uResourceDimension;
+            std::uint32_t uMiscFlag;
+            std::uint32_t uArraySize;
+            std::uint32_t uMiscFlags2;
+        };
+
+        static_assert(sizeof(DdsPixelFormat) == 32u);
+        static_assert(sizeof(DdsHeader) == 124u);
+        static_assert(sizeof(DdsHeaderDxt10) == 20u);
+
+        constexpr std::uint32_t makeFourCC(char a, char b, char c, char d)
+        {
+            return static_cast<std::uint32_t>(static_cast<std::uint8_t>(a))
+                | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8u)
+                | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16u)
+                | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24u);
+        }
+
+        constexpr const std::uint32_t DDPF_ALPHA = 0x00000002u;
+        constexpr const std::uint32_t DDPF_FOURCC = 0x00000004u;
+        constexpr const std::uint32_t DDPF_RGB = 0x00000040u;
+        constexpr const std::uint32_t DDPF_LUMINANCE = 0x00020000u;
+        constexpr const std::uint32_t DDPF_BUMPDUDV = 0x00080000u;
+
+        constexpr const std::uint32_t DDSD_CAPS = 0x00000001u;
+        constexpr const std::uint32_t DDSD_HEIGHT = 0x00000002u;
+        constexpr const std::uint32_t DDSD_WIDTH = 0x00000004u;
+        constexpr const std::uint32_t DDSD_PIXELFORMAT = 0x00001000u;
+        constexpr const std::uint32_t DDSD_MIPMAPCOUNT = 0x00020000u;
+        constexpr const std::uint32_t DDSD_DEPTH = 0x00800000u;
+
+        constexpr const std::uint32_t DDSCAPS_COMPLEX = 0x00000008u;
+        constexpr const std::uint32_t DDSCAPS_TEXTURE = 0x00001000u;
+        constexpr const std::uint32_t DDSCAPS_MIPMAP = 0x00400000u;
+
+        constexpr const std::uint32_t DDSCAPS2_CUBEMAP = 0x00000200u;
+        constexpr const std::uint32_t DDSCAPS2_CUBEMAP_ALLFACES = 0x0000FE00u;
+        constexpr const std::uint32_t DDSCAPS2_VOLUME = 0x00200000u;
+
+        constexpr const std::uint32_t RESOURCE_MISC_TEXTURECUBE = 0x4u;
+        constexpr const std::uint32_t MISC_FLAGS2_ALPHA_MODE_MASK = 0x7u;
+
+        constexpr const std::uint32_t ALPHA_MODE_UNKNOWN = 0u;
+        constexpr const std::uint32_t ALPHA_MODE_PREMULTIPLIED = 2u;
+        constexpr const std::uint32_t ALPHA_MODE_CUSTOM = 4u;
+
+        // Returns the format of a legacy header without the DX10 extension
+        eDdsFormat getLegacyFormat(const DdsPixelFormat& pixelFormat)
+        {
+            auto isBitMask = [&pixelFormat](std::uint32_t r, std::uint32_t g, std::uint32_t b, std::uint32_t a)
+            {
+                return pixelFormat.uRBitMask == r && pixelFormat.uGBitMask == g && pixelFormat.uBBitMask == b
+                    && pixelFormat.uABitMask == a;
+            };
+
+            if (pixelFormat.uFlags & DDPF_RGB)
+            {
+                switch (pixelFormat.uRgbBitCount)
+                {
+                case 32u:
+                    if (isBitMask(0x000000ffu, 0x0000ff00u, 0x00ff0000u, 0xff000000u))
+                    {
+                        return eDdsFormat::R8G8B8A8_UNORM;
+                    }
+                    if (isBitMask(0x00ff0000u, 0x0000ff00u, 0x000000ffu, 0xff000000u))
+                    {
+                        return eDdsFormat::B8G8R8A8_UNORM;
+                    }
+                    if (isBitMask(0x00ff0000u, 0x0000ff00u, 0x000000ffu, 0u))
+                    {
+                        return eDdsFormat::B8G8R8X8_UNORM;
+                    }
+                    // D3DX writes 10:10:10:2 with the red and blue masks
+                    // swapped
+                    if (isBitMask(0x3ff00000u, 0x000ffc00u, 0x000003ffu, 0xc0000000u))
+                    {
+                        return eDdsFormat::R10G10B10A2_UNORM;
+                    }
+                    if (isBitMask(0x0000ffffu, 0xffff0000u, 0u, 0u))
+                    {
+                        return eDdsFormat::R16G16_UNORM;
+                    }
+                    if (isBitMask(0xffffffffu, 0u, 0u, 0u))
+                    {
+                        return eDdsFormat::R32_FLOAT;
+                    }
+                    break;
+
+                case 16u:
+                    if (isBitMask(0x7c00u, 0x03e0u, 0x001fu, 0x8000u))
+                    {
+                        return eDdsFormat::B5G5R5A1_UNORM;
+                    }
+                    if (isBitMask(0xf800u, 0x07e0u, 0x001fu, 0u))
+                    {
+                        return eDdsFormat::B5G6R5_UNORM;
+                    }
+                    if (isBitMask(0x0f00u, 0x00f0u, 0x000fu, 0xf000u))
+                    {
+                        return eDdsFormat::B4G4R4A4_UNORM;
+                    }
+                    break;
+
+                default:
+                    break;
+                }
+            }
+            else if (pixelFormat.uFlags & DDPF_LUMINANCE)
+            {
+                if (pixelFormat.uRgbBitCount == 8u && isBitMask(0xffu, 0u, 0u, 0u))
+                {
+                    return eDdsFormat::R8_UNORM;
+                }
+                if (pixelFormat.uRgbBitCount == 16u && isBitMask(0xffffu, 0u, 0u, 0u))
+                {
+                    return eDdsFormat::R16_UNORM;
+                }
+                // Some writers store 8:8 luminance alpha with a bit count
+                // of 8 instead of 16
+                if ((pixelFormat.uRgbBitCount == 8u || pixelFormat.uRgbBitCount == 16u)
+                    && isBitMask(0x00ffu, 0u, 0u, 0xff00u))
+                {
+                    return eDdsFormat::R8G8_UNORM;
+                }
+            }
+            else if (pixelFormat.uFlags & DDPF_ALPHA)
+            {
+                if (pixelFormat.uRgbBitCount == 8u)
+                {
+                    return eDdsFormat::A8_UNORM;
+                }
+            }
+            else if (pixelFormat.uFlags & DDPF_BUMPDUDV)
+            {
+                if (pixelFormat.uRgbBitCount == 16u && isBitMask(0x00ffu, 0xff00u, 0u, 0u))
+                {
+                    return eDdsFormat::R8G8_SNORM;
+                }
+                if (pixelFormat.uRgbBitCount == 32u && isBitMask(0x000000ffu, 0x0000ff00u, 0x00ff0000u, 0xff000000u))
+                {
+                    return eDdsFormat::R8G8B8A8_SNORM;
+                }
+                if (pixelFormat.uRgbBitCount == 32u && isBitMask(0x0000ffffu, 0xffff0000u, 0u, 0u))
+                {
+                    return eDdsFormat::R16G16_SNORM;
+                }
+            }
+            else if (pixelFormat.uFlags & DDPF_FOURCC)
+            {
+                switch (pixelFormat.uFourCC)
+                {
+                case makeFourCC('D', 'X', 'T', '1'):
+                    return eDdsFormat::BC1_UNORM;
+
+                // Premultiplied alpha is stored the same way
+                case makeFourCC('D', 'X', 'T', '2'):
+                case makeFourCC('D', 'X', 'T', '3'):
+                    return eDdsFormat::BC2_UNORM;
+
+                case makeFourCC('D', 'X', 'T', '4'):
+                case makeFourCC('D', 'X', 'T', '5'):
+                    return eDdsFormat::BC3_UNORM;
+
+                case makeFourCC('A', 'T', 'I', '1'):
+                case makeFourCC('B', 'C', '4', 'U'):
+                    return eDdsFormat::BC4_UNORM;
+
+                case makeFourCC('B', 'C', '4', 'S'):
+                    return eDdsFormat::BC4_SNORM;
+
+                case makeFourCC('A', 'T', 'I', '2'):
+                case makeFourCC('B', 'C', '5', 'U'):
+                    return eDdsFormat::BC5_UNORM;
+
+                case makeFourCC('B', 'C', '5', 'S'):
+                    return eDdsFormat::BC5_SNORM;
+
+                case makeFourCC('R', 'G', 'B', 'G'):
+                    return eDdsFormat::R8G8_B8G8_UNORM;
+
+                case makeFourCC('G', 'R', 'G', 'B'):
+                    return eDdsFormat::G8R8_G8B8_UNORM;
+
+                case makeFourCC('Y', 'U', 'Y', '2'):
+                    return eDdsFormat::YUY2;
+
+                // D3DFORMAT values stored as FourCC
+                case 36u:
+                    return eDdsFormat::R16G16B16A16_UNORM;
+                case 110u:
+                    return eDdsFormat::R16G16B16A16_SNORM;
+                case 111u:
+                    return eDdsFormat::R16_FLOAT;
+                case 112u:
+                    return eDdsFormat::R16G16_FLOAT;
+                case 113u:
+                    return eDdsFormat::R16G16B16A16_FLOAT;
+                case 114u:
+                    return eDdsFormat::R32_FLOAT;
+                case 115u:
+                    return eDdsFormat::R32G32_FLOAT;
+                case 116u:
+                    return eDdsFormat::R32G32B32A32_FLOAT;
+
+                default:
+                    break;
+                }
+            }
+
+            return eDdsFormat::UNKNOWN;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsParser::Parse
+      Summary:  Reads the headers of a DDS file and the views of its
+                subresources, ordered like Direct3D subresource
+                indices: every mip of the first slice, then of the next
+      Args:     const std::uint8_t* pData
+                  Data of the whole file
+                std::size_t uSize
+                  Size of the file in bytes
+                DdsImage& outImage
+                  Receives the image description
+                std::vector<DdsSubresource>& aOutSubresources
+                  Receives uArraySize * uMipLevels views into pData
+      Returns:  eDdsStatus
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eDdsStatus DdsParser::Parse(const std::uint8_t* pData, std::size_t uSize, DdsImage& outImage,
+        std::vector<DdsSubresource>& aOutSubresources)
+    {
+        aOutSubresources.clear();
+
+        if (!pData || uSize < sizeof(std::uint32_t) + sizeof(DdsHeader) || uSize > UINT32_MAX)
+        {
+            return eDdsStatus::INVALID_DATA;
+        }
+
+        std::uint32_t uMagic = 0u;
+        std::memcpy(&uMagic, pData, sizeof(uMagic));
+
+        DdsHeader header;
+        std::memcpy(&header, pData + sizeof(std::uint32_t), sizeof(header));
+
+        if (uMagic != MAGIC || header.uSize != sizeof(DdsHeader) || header.pixelFormat.uSize != sizeof(DdsPixelFormat))
+        {
+            return eDdsStatus::INVALID_DATA;
+        }
+
+        std::size_t uOffset = sizeof(std::uint32_t) + sizeof(DdsHeader);
+
+        DdsImage image =
+        {
+            .format = eDdsFormat::UNKNOWN,
+            .dimension = eDdsDimension::UNKNOWN,
+            .uWidth = header.uWidth,
+            .uHeight = header.uHeight,
+            .uDepth = header.uDepth,
+            .uArraySize = 1u,
+            .uMipLevels = (std::max)(header.uMipMapCount, 1u),
+            .uAlphaMode = ALPHA_MODE_UNKNOWN,
+            .bCubeMap = false
+        };
+
+        if ((header.pixelFormat.uFlags & DDPF_FOURCC) && header.pixelFormat.uFourCC == makeFourCC('D', 'X', '1', '0'))
+        {
+            if (uSize < uOffset + sizeof(DdsHeaderDxt10))
+            {
+                return eDdsStatus::INVALID_DATA;
+            }
+
+            DdsHeaderDxt10 headerDxt10;
+            std::memcpy(&headerDxt10, pData + uOffset, sizeof(headerDxt10));
+            uOffset += sizeof(DdsHeaderDxt10);
+
+            image.format = static_cast<eDdsFormat>(headerDxt10.uDxgiFormat);
+            image.uArraySize = headerDxt10.uArraySize;
+
+            if (image.uArraySize == 0u)
+            {
+                return eDdsStatus::INVALID_DATA;
+            }
+
+            // Palettized formats have no Direct3D 11 texture support
+            if (GetBitsPerPixel(image.format) == 0u || image.format == eDdsFormat::AI44 || image.format == eDdsFormat::IA44
+                || image.format == eDdsFormat::P8 || image.format == eDdsFormat::A8P8)
+            {
+                return eDdsStatus::NOT_SUPPORTED;
+            }
+
+            std::uint32_t uAlphaMode = headerDxt10.uMiscFlags2 & MISC_FLAGS2_ALPHA_MODE_MASK;
+            image.uAlphaMode = uAlphaMode <= ALPHA_MODE_CUSTOM ? uAlphaMode : ALPHA_MODE_UNKNOWN;
+
+            switch (static_cast<eDdsDimension>(headerDxt10.uResourceDimension))
+            {
+            case eDdsDimension::TEXTURE1D:
+                // D3DX writes 1D textures with a fixed height of 1
+                if ((header.uFlags & DDSD_HEIGHT) && image.uHeight != 1u)
+                {
+                    return eDdsStatus::INVALID_DATA;
+                }
+                image.uHeight = 1u;
+                image.uDepth = 1u;
+                break;
+
+            case eDdsDimension::TEXTURE2D:
+                if (headerDxt10.uMiscFlag & RESOURCE_MISC_TEXTURECUBE)
+                {
+                    if (image.uArraySize > MAX_ARRAY_SIZE / 6u)
+                    {
+                        return eDdsStatus::NOT_SUPPORTED;
+                    }
+
+                    image.uArraySize *= 6u;
+                    image.bCubeMap = true;
+                }
+                image.uDepth = 1u;
+                break;
+
+            case eDdsDimension::TEXTURE3D:
+                if (!(header.uFlags & DDSD_DEPTH))
+                {
+                    return eDdsStatus::INVALID_DATA;
+                }
+                if (image.uArraySize > 1u)
+                {
+                    return eDdsStatus::NOT_SUPPORTED;
+                }
+                break;
+
+            default:
+                return eDdsStatus::NOT_SUPPORTED;
+            }
+
+            image.dimension = static_cast<eDdsDimension>(headerDxt10.uResourceDimension);
+        }
+        else
+        {
+            image.format = getLegacyFormat(header.pixelFormat);
+
+            if (image.format == eDdsFormat::UNKNOWN)
+            {
+                return eDdsStatus::NOT_SUPPORTED;
+            }
+
+            if ((header.pixelFormat.uFlags & DDPF_FOURCC)
+                && (header.pixelFormat.uFourCC == makeFourCC('D', 'X', 'T', '2')
+                    || header.pixelFormat.uFourCC == makeFourCC('D', 'X', 'T', '4')))
+            {
+                image.uAlphaMode = ALPHA_MODE_PREMULTIPLIED;
+            }
+
+            if (header.uFlags & DDSD_DEPTH)
+            {
+                image.dimension = eDdsDimension::TEXTURE3D;
+            }
+            else
+            {
+                if (header.uCaps2 & DDSCAPS2_CUBEMAP)
+                {
+                    // All six faces are required
+                    if ((header.uCaps2 & DDSCAPS2_CUBEMAP_ALLFACES) != DDSCAPS2_CUBEMAP_ALLFACES)
+                    {
+                        return eDdsStatus::NOT_SUPPORTED;
+                    }
+
+                    image.uArraySize = 6u;
+                    image.bCubeMap = true;
+                }
+
+                image.uDepth = 1u;
+                image.dimension = eDdsDimension::TEXTURE2D;
+            }
+        }
+
+        // The file is not trusted past the Direct3D 11 limits
+        std::uint32_t uMaxSize = image.dimension == eDdsDimension::TEXTURE1D ? MAX_TEXTURE1D_SIZE
+            : (image.dimension == eDdsDimension::TEXTURE2D ? MAX_TEXTURE2D_SIZE : MAX_TEXTURE3D_SIZE);
+
+        if (image.uMipLevels > MAX_MIP_LEVELS || image.uArraySize > MAX_ARRAY_SIZE
+            || image.uWidth > uMaxSize || image.uHeight > uMaxSize || image.uDepth > uMaxSize)
+        {
+            return eDdsStatus::NOT_SUPPORTED;
+        }
+
+        if (image.uWidth == 0u || image.uHeight == 0u || image.uDepth == 0u)
+        {
+            return eDdsStatus::INVALID_DATA;
+        }
+
+        aOutSubresources.reserve(static_cast<std::size_t>(image.uArraySize) * image.uMipLevels);
+
+        const std::uint8_t* pBits = pData + uOffset;
+        std::uint64_t uRemaining = uSize - uOffset;
+
+        for (std::uint32_t uSlice = 0u; uSlice < image.uArraySize; ++uSlice)
+        {
+            std::uint32_t uWidth = image.uWidth;
+            std::uint32_t uHeight = image.uHeight;
+            std::uint32_t uDepth = image.uDepth;
+
+            for (std::uint32_t uMip = 0u; uMip < image.uMipLevels; ++uMip)
+            {
+                std::uint64_t uNumBytes = 0u;
+                std::uint64_t uRowBytes = 0u;
+                std::uint64_t uNumRows = 0u;
+
+                eDdsStatus status = GetSurfaceInfo(uWidth, uHeight, image.format, uNumBytes, uRowBytes, uNumRows);
+                if (status != eDdsStatus::OK)
+                {
+                    aOutSubresources.clear();
+                    return status;
+                }
+
+                if (uNumBytes > UINT32_MAX || uRowBytes > UINT32_MAX || uNumRows > UINT32_MAX)
+                {
+                    aOutSubresources.clear();
+                    return eDdsStatus::ARITHMETIC_OVERFLOW;
+                }
+
+                std::uint64_t uMipBytes = uNumBytes * uDepth;
+                if (uMipBytes > uRemaining)
+                {
+                    aOutSubresources.clear();
+                    return eDdsStatus::END_OF_FILE;
+                }
+
+                aOutSubresources.push_back(DdsSubresource
+                    {
+                        .pData = pBits,
+                        .uWidth = uWidth,
+                        .uHeight = uHeight,
+                        .uDepth = uDepth,
+                        .uRowPitch = static_cast<std::uint32_t>(uRowBytes),
+                        .uSlicePitch = static_cast<std::uint32_t>(uNumBytes),
+                        .uNumRows = static_cast<std::uint32_t>(uNumRows)
+                    });
+
+                pBits += uMipBytes;
+                uRemaining -= uMipBytes;
+
+                uWidth = (std::max)(uWidth >> 1u, 1u);
+                uHeight = (std::max)(uHeight >> 1u, 1u);
+                uDepth = (std::max)(uDepth >> 1u, 1u);
+            }
+        }
+
+        outImage = image;
+
+        return eDdsStatus::OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsParser::Write
+      Summary:  Serializes a texture to a DDS file with the DX10 header
+                extension, which every format can be written with.
+                Subresources are packed without row padding, so views
+                with any pitch can be written, such as mapped mips
+      Args:     const DdsImage& image
+                  Description of the texture
+                const std::vector<DdsSubresource>& aSubresources
+                  uArraySize * uMipLevels views, mips of each slice in
+                  a row like Parse returns them
+                std::vector<std::uint8_t>& aOutData
+                  Receives the file
+      Returns:  eDdsStatus
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eDdsStatus DdsParser::Write(const DdsImage& image, const std::vector<DdsSubresource>& aSubresources,
+        std::vector<std::uint8_t>& aOutData)
+    {
+        aOutData.clear();
+
+        if (image.uMipLevels == 0u || image.uArraySize == 0u
+            || aSubresources.size() != static_cast<std::size_t>(image.uArraySize) * image.uMipLevels)
+        {
+            return eDdsStatus::INVALID_DATA;
+        }
+
+        if (GetBitsPerPixel(image.format) == 0u)
+        {
+            return eDdsStatus::NOT_SUPPORTED;
+        }
+
+        bool bVolume = image.dimension == eDdsDimension::TEXTURE3D;
+        std::uint32_t uNumCubes = image.bCubeMap ? image.uArraySize / 6u : 0u;
+        if (image.bCubeMap && (image.uArraySize % 6u != 0u || image.dimension != eDdsDimension::TEXTURE2D))
+        {
+            return eDdsStatus::INVALID_DATA;
+        }
+
+        DdsHeader header = {};
+        header.uSize = sizeof(DdsHeader);
+        header.uFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | (bVolume ? DDSD_DEPTH : 0u);
+        header.uHeight = image.uHeight;
+        header.uWidth = image.uWidth;
+        header.uDepth = bVolume ? image.uDepth : 0u;
+        header.uMipMapCount = image.uMipLevels;
+        header.pixelFormat.uSize = sizeof(DdsPixelFormat);
+        header.pixelFormat.uFlags = DDPF_FOURCC;
+        header.pixelFormat.uFourCC = makeFourCC('D', 'X', '1', '0');
+        header.uCaps = DDSCAPS_TEXTURE
+            | (image.uMipLevels > 1u ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0u)
+            | (image.bCubeMap || bVolume ? DDSCAPS_COMPLEX : 0u);
+        header.uCaps2 = (image.bCubeMap ? DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_ALLFACES : 0u) | (bVolume ? DDSCAPS2_VOLUME : 0u);
+
+        DdsHeaderDxt10 headerDxt10 =
+        {
+            .uDxgiFormat = static_cast<std::uint32_t>(image.format),
+            .uResourceDimension = static_cast<std::uint32_t>(image.dimension),
+            .uMiscFlag = image.bCubeMap ? RESOURCE_MISC_TEXTURECUBE : 0u,
+            .uArraySize = image.bCubeMap ? uNumCubes : image.uArraySize,
+            .uMiscFlags2 = image.uAlphaMode & MISC_FLAGS2_ALPHA_MODE_MASK
+        };
+
+        std::uint64_t uFileSize = sizeof(std::uint32_t) + sizeof(DdsHeader) + sizeof(DdsHeaderDxt10);
+
+        for (const DdsSubresource& subresource : aSubresources)
+        {
+            std::uint64_t uNumBytes = 0u;
+            std::uint64_t uRowBytes = 0u;
+            std::uint64_t uNumRows = 0u;
+
+            eDdsStatus status = GetSurfaceInfo(subresource.uWidth, subresource.uHeight, image.format, uNumBytes, uRowBytes, uNumRows);
+            if (status != eDdsStatus::OK)
+            {
+                return status;
+            }
+
+            if (!subresource.pData || subresource.uRowPitch < uRowBytes || subresource.uNumRows < uNumRows)
+            {
+                return eDdsStatus::INVALID_DATA;
+            }
+
+            uFileSize += uNumBytes * subresource.uDepth;
+        }
+
+        if (uFileSize > UINT32_MAX)
+        {
+            return eDdsStatus::ARITHMETIC_OVERFLOW;
+        }
+
+        aOutData.resize(static_cast<std::size_t>(uFileSize));
+
+        std::uint8_t* pOut = aOutData.data();
+        std::memcpy(pOut, &MAGIC, sizeof(MAGIC));
+        pOut += sizeof(MAGIC);
+        std::memcpy(pOut, &header, sizeof(header));
+        pOut += sizeof(header);
+        std::memcpy(pOut, &headerDxt10, sizeof(headerDxt10));
+        pOut += sizeof(headerDxt10);
+
+        for (const DdsSubresource& subresource : aSubresources)
+        {
+            std::uint64_t uNumBytes = 0u;
+            std::uint64_t uRowBytes = 0u;
+            std::uint64_t uNumRows = 0u;
+            GetSurfaceInfo(subresource.uWidth, subresource.uHeight, image.format, uNumBytes, uRowBytes, uNumRows);
+
+            for (std::uint32_t z = 0u; z < subresource.uDepth; ++z)
+            {
+                const std::uint8_t* pSlice = subresource.pData + static_cast<std::size_t>(z) * subresource.uSlicePitch;
+
+                for (std::uint64_t uRow = 0u; uRow < uNumRows; ++uRow)
+                {
+                    std::memcpy(pOut, pSlice + uRow * subresource.uRowPitch, static_cast<std::size_t>(uRowBytes));
+                    pOut += uRowBytes;
+                }
+            }
+        }
+
+        return eDdsStatus::OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsParser::GetBitsPerPixel
+      Summary:  Returns the bits per pixel of a format. Block compressed
+                formats return their average
+      Args:     eDdsFormat format
+                  Pixel format
+      Returns:  std::uint32_t
+                  Bits per pixel, 0 for unknown formats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t DdsParser::GetBitsPerPixel(eDdsFormat format)
+    {
+        // DXGI groups the formats of each size in consecutive values
+        struct FormatRange
+        {
+            eDdsFormat first;
+            eDdsFormat last;
+            std::uint32_t uBitsPerPixel;
+        };
+
+        static constexpr const FormatRange s_aRanges[] =
+        {
+            { eDdsFormat::R32G32B32A32_TYPELESS, eDdsFormat::R32G32B32A32_SINT, 128u },
+            { eDdsFormat::R32G32B32_TYPELESS, eDdsFormat::R32G32B32_SINT, 96u },
+            { eDdsFormat::R16G16B16A16_TYPELESS, eDdsFormat::X32_TYPELESS_G8X24_UINT, 64u },
+            { eDdsFormat::R10G10B10A2_TYPELESS, eDdsFormat::X24_TYPELESS_G8_UINT, 32u },
+            { eDdsFormat::R8G8_TYPELESS, eDdsFormat::R16_SINT, 16u },
+            { eDdsFormat::R8_TYPELESS, eDdsFormat::A8_UNORM, 8u },
+            { eDdsFormat::R1_UNORM, eDdsFormat::R1_UNORM, 1u },
+            { eDdsFormat::R9G9B9E5_SHAREDEXP, eDdsFormat::G8R8_G8B8_UNORM, 32u },
+            { eDdsFormat::BC1_TYPELESS, eDdsFormat::BC1_UNORM_SRGB, 4u },
+            { eDdsFormat::BC2_TYPELESS, eDdsFormat::BC3_UNORM_SRGB, 8u },
+            { eDdsFormat::BC4_TYPELESS, eDdsFormat::BC4_SNORM, 4u },
+            { eDdsFormat::BC5_TYPELESS, eDdsFormat::BC5_SNORM, 8u },
+            { eDdsFormat::B5G6R5_UNORM, eDdsFormat::B5G5R5A1_UNORM, 16u },
+            { eDdsFormat::B8G8R8A8_UNORM, eDdsFormat::B8G8R8X8_UNORM_SRGB, 32u },
+            { eDdsFormat::BC6H_TYPELESS, eDdsFormat::BC7_UNORM_SRGB, 8u },
+            { eDdsFormat::AYUV, eDdsFormat::Y410, 32u },
+            { eDdsFormat::Y416, eDdsFormat::Y416, 64u },
+            { eDdsFormat::NV12, eDdsFormat::NV12, 12u },
+            { eDdsFormat::P010, eDdsFormat::P016, 24u },
+            { eDdsFormat::OPAQUE_420, eDdsFormat::OPAQUE_420, 12u },
+            { eDdsFormat::YUY2, eDdsFormat::YUY2, 32u },
+            { eDdsFormat::Y210, eDdsFormat::Y216, 64u },
+            { eDdsFormat::NV11, eDdsFormat::NV11, 12u },
+            { eDdsFormat::AI44, eDdsFormat::P8, 8u },
+            { eDdsFormat::A8P8, eDdsFormat::B4G4R4A4_UNORM, 16u }
+        };
+
+        for (const FormatRange& range : s_aRanges)
+        {
+            if (format >= range.first && format <= range.last)
+            {
+                return range.uBitsPerPixel;
+            }
+        }
+
+        return 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsParser::GetSurfaceInfo
+      Summary:  Returns the size, row pitch and number of rows of a
+                surface, counting rows of blocks for block compressed
+                formats and both planes for planar formats
+      Args:     std::uint32_t uWidth
+                  Width of the surface
+                std::uint32_t uHeight
+                  Height of the surface
+                eDdsFormat format
+                  Pixel format
+                std::uint64_t& uOutNumBytes
+                  Receives the size of the surface in bytes
+                std::uint64_t& uOutRowBytes
+                  Receives the size of a row in bytes
+                std::uint64_t& uOutNumRows
+                  Receives the number of rows
+      Returns:  eDdsStatus
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    eDdsStatus DdsParser::GetSurfaceInfo(std::uint32_t uWidth, std::uint32_t uHeight, eDdsFormat format,
+        std::uint64_t& uOutNumBytes, std::uint64_t& uOutRowBytes, std::uint64_t& uOutNumRows)
+    {
+        std::uint64_t uWidth64 = uWidth;
+        std::uint64_t uHeight64 = uHeight;
+
+        if (IsBlockCompressed(format))
+        {
+            std::uint64_t uBytesPerBlock = GetBitsPerPixel(format) * 2u;
+
+            uOutRowBytes = uWidth64 > 0u ? (std::max<std::uint64_t>)(1u, (uWidth64 + 3u) / 4u) * uBytesPerBlock : 0u;
+            uOutNumRows = uHeight64 > 0u ? (std::max<std::uint64_t>)(1u, (uHeight64 + 3u) / 4u) : 0u;
+            uOutNumBytes = uOutRowBytes * uOutNumRows;
+
+            return eDdsStatus::OK;
+        }
+
+        switch (format)
+        {
+        case eDdsFormat::R8G8_B8G8_UNORM:
+        case eDdsFormat::G8R8_G8B8_UNORM:
+        case eDdsFormat::YUY2:
+        case eDdsFormat::Y210:
+        case eDdsFormat::Y216:
+            // Packed formats store two pixels per element
+            uOutRowBytes = ((uWidth64 + 1u) >> 1u) * (GetBitsPerPixel(format) / 8u);
+            uOutNumRows = uHeight64;
+            uOutNumBytes = uOutRowBytes * uOutNumRows;
+            return eDdsStatus::OK;
+
+        case eDdsFormat::NV11:
+            // Direct3D assumes two full planes, more than the 4:1:1 data
+            uOutRowBytes = ((uWidth64 + 3u) >> 2u) * 4u;
+            uOutNumRows = uHeight64 * 2u;
+            uOutNumBytes = uOutRowBytes * uOutNumRows;
+            return eDdsStatus::OK;
+
+        case eDdsFormat::NV12:
+        case eDdsFormat::OPAQUE_420:
+        case eDdsFormat::P010:
+        case eDdsFormat::P016:
+        {
+            std::uint64_t uBytesPerElement = (format == eDdsFormat::P010 || format == eDdsFormat::P016) ? 4u : 2u;
+
+            uOutRowBytes = ((uWidth64 + 1u) >> 1u) * uBytesPerElement;
+            uOutNumBytes = uOutRowBytes * uHeight64 + ((uOutRowBytes * uHeight64 + 1u) >> 1u);
+            uOutNumRows = uHeight64 + ((uHeight64 + 1u) >> 1u);
+            return eDdsStatus::OK;
+        }
+
+        default:
+            break;
+        }
+
+        std::uint64_t uBitsPerPixel = GetBitsPerPixel(format);
+        if (uBitsPerPixel == 0u)
+        {
+            return eDdsStatus::NOT_SUPPORTED;
+        }
+
+        uOutRowBytes = (uWidth64 * uBitsPerPixel + 7u) / 8u;
+        uOutNumRows = uHeight64;
+        uOutNumBytes = uOutRowBytes * uOutNumRows;
+
+        return eDdsStatus::OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DdsParser::IsBlockCompressed
+      Summary:  Returns whether a format is stored in 4x4 blocks
+      Args:     eDdsFormat format
+                  Pixel format
+      Returns:  bool
+                  true for the BC formats
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool DdsParser::IsBlockCompressed(eDdsFormat format)
+    {
+        return (format >= eDdsFormat::BC1_TYPELESS && format <= eDdsFormat::BC5_SNORM)
+            || (format >= eDdsFormat::BC6H_TYPELESS && format <= eDdsFormat::BC7_UNORM_SRGB);
+    }
+}
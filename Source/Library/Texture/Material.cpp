@@ -5,11 +5,15 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Material::Material
       Summary:  Constructor
-      Modifies: [pDiffuse, pSpecular].
+      Modifies: [pDiffuse, pSpecular, pNormal, pDiffuseArray,
+                 uDiffuseSlice].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Material::Material() :
         pDiffuse(nullptr),
-        pSpecular(nullptr)
+        pSpecular(nullptr),
+        pNormal(nullptr),
+        pDiffuseArray(nullptr),
+        uDiffuseSlice(0u)
     {
     }
 }
\ No newline at end of file
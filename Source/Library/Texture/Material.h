@@ -10,9 +10,17 @@
 #include "Common.h"
 
 #include "Texture/Texture.h"
+#include "Texture/TextureArray.h"
 
 namespace library
 {
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Material
+      Summary:  Textures of a mesh. A diffuse texture packed into a
+                TextureArray is drawn from pDiffuseArray at
+                uDiffuseSlice, set by TextureArray::Pack. pNormal holds
+                tangent space normals in red and green
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Material
     {
     public:
@@ -26,5 +34,8 @@ namespace library
     public:
         std::shared_ptr<Texture> pDiffuse;
         std::shared_ptr<Texture> pSpecular;
+        std::shared_ptr<Texture> pNormal;
+        std::shared_ptr<TextureArray> pDiffuseArray;
+        UINT uDiffuseSlice;
     };
 }
\ No newline at end of file
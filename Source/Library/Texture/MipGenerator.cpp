@@ -0,0 +1,388 @@
+#include "Texture/MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    namespace
+    {
+        constexpr const std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+        // Source texels and weights of every texel of one axis of a mip.
+        // The taps of texel i are [aFirstTaps[i], aFirstTaps[i + 1])
+        struct FilterTaps
+        {
+            std::vector<std::uint32_t> aFirstTaps;
+            std::vector<std::uint32_t> aIndices;
+            std::vector<float> aWeights;
+        };
+
+        // Zeroth order modified Bessel function of the first kind, from
+        // its power series
+        double besselI0(double x)
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            double halfX = x * 0.5;
+
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (halfX / k) * (halfX / k);
+                sum += term;
+
+                if (term < sum * 1e-12)
+                {
+                    break;
+                }
+            }
+
+            return sum;
+        }
+
+        double sinc(double x)
+        {
+            constexpr const double PI = 3.14159265358979323846;
+
+            if (std::abs(x) < 1e-6)
+            {
+                return 1.0;
+            }
+
+            return std::sin(PI * x) / (PI * x);
+        }
+
+        std::uint32_t wrapIndex(std::int64_t i, std::uint32_t uSize)
+        {
+            std::int64_t iSize = static_cast<std::int64_t>(uSize);
+
+            return static_cast<std::uint32_t>(((i % iSize) + iSize) % iSize);
+        }
+
+        void buildTaps(std::uint32_t uSourceSize, std::uint32_t uSize, eMipFilter filter, FilterTaps& taps)
+        {
+            double scale = static_cast<double>(uSourceSize) / static_cast<double>(uSize);
+
+            taps.aFirstTaps.assign(1u, 0u);
+            taps.aIndices.clear();
+            taps.aWeights.clear();
+
+            double kaiserNorm = 1.0 / besselI0(MipGenerator::KAISER_ALPHA);
+
+            for (std::uint32_t i = 0u; i < uSize; ++i)
+            {
+                std::size_t uFirst = taps.aWeights.size();
+
+                if (filter == eMipFilter::BOX)
+                {
+                    // Weighted by the covered part of each source texel, so
+                    // odd sizes are filtered exactly
+                    double begin = i * scale;
+                    double end = (i + 1u) * scale;
+
+                    for (std::int64_t s = static_cast<std::int64_t>(std::floor(begin)); s < static_cast<std::int64_t>(std::ceil(end)); ++s)
+                    {
+                        double weight = (std::min)(end, static_cast<double>(s + 1)) - (std::max)(begin, static_cast<double>(s));
+                        if (weight > 0.0)
+                        {
+                            taps.aIndices.push_back(wrapIndex(s, uSourceSize));
+                            taps.aWeights.push_back(static_cast<float>(weight));
+                        }
+                    }
+                }
+                else
+                {
+                    double center = (i + 0.5) * scale;
+                    double support = MipGenerator::KAISER_RADIUS * scale;
+
+                    for (std::int64_t s = static_cast<std::int64_t>(std::floor(center - support));
+                        s <= static_cast<std::int64_t>(std::ceil(center + support)); ++s)
+                    {
+                        double t = (static_cast<double>(s) + 0.5 - center) / scale;
+                        double x = t / MipGenerator::KAISER_RADIUS;
+                        if (std::abs(x) >= 1.0)
+                        {
+                            continue;
+                        }
+
+                        double window = besselI0(MipGenerator::KAISER_ALPHA * std::sqrt(1.0 - x * x)) * kaiserNorm;
+
+                        taps.aIndices.push_back(wrapIndex(s, uSourceSize));
+                        taps.aWeights.push_back(static_cast<float>(sinc(t) * window));
+                    }
+                }
+
+                double sum = 0.0;
+                for (std::size_t k = uFirst; k < taps.aWeights.size(); ++k)
+                {
+                    sum += taps.aWeights[k];
+                }
+
+                for (std::size_t k = uFirst; k < taps.aWeights.size(); ++k)
+                {
+                    taps.aWeights[k] = static_cast<float>(taps.aWeights[k] / sum);
+                }
+
+                taps.aFirstTaps.push_back(static_cast<std::uint32_t>(taps.aWeights.size()));
+            }
+        }
+
+        // Filters one source row to the width of the mip, one RGBA texel
+        // per vector
+        void filterRow(const float* pRow, const FilterTaps& taps, std::uint32_t uWidth, float* pOut)
+        {
+            for (std::uint32_t x = 0u; x < uWidth; ++x)
+            {
+#ifdef MIP_GENERATOR_SSE2
+                __m128 sum = _mm_setzero_ps();
+
+                for (std::uint32_t k = taps.aFirstTaps[x]; k < taps.aFirstTaps[x + 1u]; ++k)
+                {
+                    __m128 texel = _mm_loadu_ps(pRow + static_cast<std::size_t>(taps.aIndices[k]) * 4u);
+                    sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(taps.aWeights[k])));
+                }
+
+                _mm_storeu_ps(pOut + static_cast<std::size_t>(x) * 4u, sum);
+#else
+                float aSum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+                for (std::uint32_t k = taps.aFirstTaps[x]; k < taps.aFirstTaps[x + 1u]; ++k)
+                {
+                    const float* pTexel = pRow + static_cast<std::size_t>(taps.aIndices[k]) * 4u;
+                    for (std::uint32_t c = 0u; c < 4u; ++c)
+                    {
+                        aSum[c] += pTexel[c] * taps.aWeights[k];
+                    }
+                }
+
+                std::copy(aSum, aSum + 4, pOut + static_cast<std::size_t>(x) * 4u);
+#endif
+            }
+        }
+
+        // Adds a filtered row times its weight to the row being summed,
+        // four floats at a time. Rows hold whole texels, so their length
+        // is a multiple of four
+        void addScaledRow(const float* pRow, float fWeight, std::size_t uNumFloats, float* pSum)
+        {
+#ifdef MIP_GENERATOR_SSE2
+            __m128 weight = _mm_set1_ps(fWeight);
+
+            for (std::size_t i = 0u; i < uNumFloats; i += 4u)
+            {
+                _mm_storeu_ps(pSum + i, _mm_add_ps(_mm_loadu_ps(pSum + i), _mm_mul_ps(_mm_loadu_ps(pRow + i), weight)));
+            }
+#else
+            for (std::size_t i = 0u; i < uNumFloats; ++i)
+            {
+                pSum[i] += pRow[i] * fWeight;
+            }
+#endif
+        }
+
+        float linearToSrgb(float fValue)
+        {
+            return fValue <= 0.0031308f ? fValue * 12.92f : 1.055f * std::pow(fValue, 1.0f / 2.4f) - 0.055f;
+        }
+
+        std::uint8_t quantize(float fValue)
+        {
+            return static_cast<std::uint8_t>(std::clamp(fValue, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::GetNumLevels
+      Summary:  Returns the number of levels of a full mip chain, down
+                to one texel
+      Args:     std::uint32_t uWidth
+                  Width of the top level
+                std::uint32_t uHeight
+                  Height of the top level
+      Returns:  std::uint32_t
+                  Number of levels, including the top level
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t MipGenerator::GetNumLevels(std::uint32_t uWidth, std::uint32_t uHeight)
+    {
+        std::uint32_t uSize = (std::max)(uWidth, uHeight);
+        std::uint32_t uNumLevels = 1u;
+
+        while (uSize > 1u)
+        {
+            uSize >>= 1u;
+            ++uNumLevels;
+        }
+
+        return uNumLevels;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::GetLevelSize
+      Summary:  Returns the size of a mip, halved per level and rounded
+                down like Direct3D does
+      Args:     std::uint32_t uWidth
+                  Width of the top level
+                std::uint32_t uHeight
+                  Height of the top level
+                std::uint32_t uLevel
+                  Mip level
+                std::uint32_t& uOutWidth
+                  Receives the width of the mip
+                std::uint32_t& uOutHeight
+                  Receives the height of the mip
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::GetLevelSize(std::uint32_t uWidth, std::uint32_t uHeight, std::uint32_t uLevel,
+        std::uint32_t& uOutWidth, std::uint32_t& uOutHeight)
+    {
+        uOutWidth = uLevel < 32u ? (std::max)(uWidth >> uLevel, 1u) : 1u;
+        uOutHeight = uLevel < 32u ? (std::max)(uHeight >> uLevel, 1u) : 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::ConvertToLinear
+      Summary:  Converts RGBA8 texels to floats in [0, 1]. Color of sRGB
+                images is decoded to linear light so it is averaged
+                correctly; alpha is always linear
+      Args:     const std::uint8_t* pPixels
+                  RGBA8 texels, rows tightly packed
+                std::uint32_t uWidth
+                  Width of the image
+                std::uint32_t uHeight
+                  Height of the image
+                bool bSrgb
+                  Whether color is sRGB encoded
+                std::vector<float>& aOutTexels
+                  Receives four floats per texel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::ConvertToLinear(const std::uint8_t* pPixels, std::uint32_t uWidth, std::uint32_t uHeight, bool bSrgb,
+        std::vector<float>& aOutTexels)
+    {
+        float aToLinear[256];
+        for (std::uint32_t i = 0u; i < 256u; ++i)
+        {
+            float fValue = static_cast<float>(i) / 255.0f;
+            aToLinear[i] = !bSrgb ? fValue
+                : fValue <= 0.04045f ? fValue / 12.92f : std::pow((fValue + 0.055f) / 1.055f, 2.4f);
+        }
+
+        std::size_t uNumTexels = static_cast<std::size_t>(uWidth) * uHeight;
+        aOutTexels.resize(uNumTexels * 4u);
+
+        for (std::size_t i = 0u; i < uNumTexels; ++i)
+        {
+            aOutTexels[i * 4u + 0u] = aToLinear[pPixels[i * 4u + 0u]];
+            aOutTexels[i * 4u + 1u] = aToLinear[pPixels[i * 4u + 1u]];
+            aOutTexels[i * 4u + 2u] = aToLinear[pPixels[i * 4u + 2u]];
+            aOutTexels[i * 4u + 3u] = static_cast<float>(pPixels[i * 4u + 3u]) / 255.0f;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MipGenerator::GenerateRows
+      Summary:  Filters rows of a mip from the linear mip above, keeps
+                them linear for the next mip and writes them as RGBA8,
+                encoding color back to sRGB for sRGB images. Only the
+                source rows under the filter of these rows are filtered
+                horizontally, so bands of rows of a level can be
+                generated in parallel
+      Args:     const float* pSourceTexels
+                  Mip above, from ConvertToLinear for the top level or
+                  pOutTexels of the previous level
+                std::uint32_t uSourceWidth
+                  Width of the mip above
+                std::uint32_t uSourceHeight
+                  Height of the mip above
+                eMipFilter filter
+                  Filter to downsample with
+                bool bSrgb
+                  Whether color is sRGB encoded
+                std::uint32_t uFirstRow
+                  First row of the mip to write
+                std::uint32_t uNumRows
+                  Number of rows to write
+                float* pOutTexels
+                  First row of the mip in linear floats, four per texel,
+                  can be nullptr for the last level
+                std::uint8_t* pOutPixels
+                  First row of the mip, rows tightly packed
+      Modifies: [pOutTexels, pOutPixels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MipGenerator::GenerateRows(const float* pSourceTexels, std::uint32_t uSourceWidth, std::uint32_t uSourceHeight,
+        eMipFilter filter, bool bSrgb, std::uint32_t uFirstRow, std::uint32_t uNumRows, float* pOutTexels,
+        std::uint8_t* pOutPixels)
+    {
+        std::uint32_t uLevelWidth = 0u;
+        std::uint32_t uLevelHeight = 0u;
+        GetLevelSize(uSourceWidth, uSourceHeight, 1u, uLevelWidth, uLevelHeight);
+
+        uNumRows = (std::min)(uNumRows, uLevelHeight - (std::min)(uFirstRow, uLevelHeight));
+
+        FilterTaps horizontalTaps;
+        FilterTaps verticalTaps;
+        buildTaps(uSourceWidth, uLevelWidth, filter, horizontalTaps);
+        buildTaps(uSourceHeight, uLevelHeight, filter, verticalTaps);
+
+        std::size_t uRowFloats = static_cast<std::size_t>(uLevelWidth) * 4u;
+
+        // Source rows filtered horizontally, made on first use as the
+        // filters of neighbouring rows overlap
+        std::vector<std::uint32_t> aRowSlots(uSourceHeight, NO_SLOT);
+        std::vector<float> aFilteredRows;
+        std::uint32_t uNumSlots = 0u;
+
+        std::vector<float> aSum(uRowFloats);
+
+        for (std::uint32_t y = uFirstRow; y < uFirstRow + uNumRows; ++y)
+        {
+            std::fill(aSum.begin(), aSum.end(), 0.0f);
+
+            for (std::uint32_t k = verticalTaps.aFirstTaps[y]; k < verticalTaps.aFirstTaps[y + 1u]; ++k)
+            {
+                std::uint32_t uSourceRow = verticalTaps.aIndices[k];
+
+                if (aRowSlots[uSourceRow] == NO_SLOT)
+                {
+                    aRowSlots[uSourceRow] = uNumSlots++;
+                    aFilteredRows.resize(uNumSlots * uRowFloats);
+
+                    filterRow(pSourceTexels + static_cast<std::size_t>(uSourceRow) * uSourceWidth * 4u, horizontalTaps,
+                        uLevelWidth, aFilteredRows.data() + aRowSlots[uSourceRow] * uRowFloats);
+                }
+
+                addScaledRow(aFilteredRows.data() + aRowSlots[uSourceRow] * uRowFloats, verticalTaps.aWeights[k], uRowFloats,
+                    aSum.data());
+            }
+
+            // Clamped like the RGBA8 texels, so the ringing of the
+            // Kaiser filter does not build up down the chain
+            if (pOutTexels)
+            {
+                float* pTexelRow = pOutTexels + static_cast<std::size_t>(y) * uRowFloats;
+
+                for (std::size_t i = 0u; i < uRowFloats; ++i)
+                {
+                    pTexelRow[i] = std::clamp(aSum[i], 0.0f, 1.0f);
+                }
+            }
+
+            std::uint8_t* pRow = pOutPixels + static_cast<std::size_t>(y) * uRowFloats;
+
+            for (std::size_t i = 0u; i < uRowFloats; i += 4u)
+            {
+                for (std::size_t c = 0u; c < 3u; ++c)
+                {
+                    float fValue = std::clamp(aSum[i + c], 0.0f, 1.0f);
+                    pRow[i + c] = quantize(bSrgb ? linearToSrgb(fValue) : fValue);
+                }
+
+                pRow[i + 3u] = quantize(aSum[i + 3u]);
+            }
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*+===================================================================
+  File:      MIPGENERATOR.H
+  Summary:   MipGenerator header file contains declarations of
+             MipGenerator class used to build the mip chains of baked
+             textures on the CPU.
+  Classes: MipGenerator
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eMipFilter
+      Summary:  Filters to downsample mips with. BOX averages the texels
+                covered by each mip texel, like the GPU mip generation;
+                KAISER is a Kaiser windowed sinc, which keeps small mips
+                sharper without aliasing
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMipFilter : std::uint32_t
+    {
+        BOX = 0u,
+        KAISER
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MipGenerator
+      Summary:  Downsamples RGBA8 images in linear space. Every mip is
+                filtered from the mip above with the same kernel, kept
+                in linear floats so no precision is lost to RGBA8
+                between levels, and each level reads a quarter of the
+                texels of the one before. Levels are generated in order;
+                the rows of a level can be generated in any order on any
+                thread. Filters are separable: each source row is
+                filtered horizontally one texel at a time, then each mip
+                row is the weighted sum of those rows, four floats at a
+                time with SSE2 (scalar code elsewhere). Texels wrap
+                around the edges like the sampler of the textures, so
+                tiling textures filter seamlessly
+      Methods:  GetNumLevels
+                  Returns the number of levels of a full mip chain
+                GetLevelSize
+                  Returns the size of a mip
+                ConvertToLinear
+                  Converts RGBA8 texels to linear floats
+                GenerateRows
+                  Filters rows of a mip from the linear mip above
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MipGenerator final
+    {
+    public:
+        // Radius of the Kaiser filter in texels of the mip, and
+        // steepness of its window
+        static constexpr const float KAISER_RADIUS = 3.0f;
+        static constexpr const float KAISER_ALPHA = 4.0f;
+
+    public:
+        MipGenerator() = delete;
+        MipGenerator(const MipGenerator& other) = delete;
+        MipGenerator(MipGenerator&& other) = delete;
+        MipGenerator& operator=(const MipGenerator& other) = delete;
+        MipGenerator& operator=(MipGenerator&& other) = delete;
+        ~MipGenerator() = delete;
+
+        static std::uint32_t GetNumLevels(std::uint32_t uWidth, std::uint32_t uHeight);
+        static void GetLevelSize(std::uint32_t uWidth, std::uint32_t uHeight, std::uint32_t uLevel,
+            std::uint32_t& uOutWidth, std::uint32_t& uOutHeight);
+
+        static void ConvertToLinear(const std::uint8_t* pPixels, std::uint32_t uWidth, std::uint32_t uHeight, bool bSrgb,
+            std::vector<float>& aOutTexels);
+        static void GenerateRows(const float* pSourceTexels, std::uint32_t uSourceWidth, std::uint32_t uSourceHeight,
+            eMipFilter filter, bool bSrgb, std::uint32_t uFirstRow, std::uint32_t uNumRows, float* pOutTexels,
+            std::uint8_t* pOutPixels);
+    };
+}
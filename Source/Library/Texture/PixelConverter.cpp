@@ -0,0 +1,550 @@
+#include "Texture/PixelConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_CONVERTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace library
+{
+    namespace
+    {
+        // Linear value of every sRGB value, and the linear values halfway
+        // between consecutive sRGB values, so a linear value is encoded
+        // to the nearest sRGB value by searching the thresholds
+        struct SrgbTables
+        {
+            float afToLinear[256];
+            float afThresholds[255];
+
+            SrgbTables()
+            {
+                for (std::uint32_t i = 0u; i < 256u; ++i)
+                {
+                    afToLinear[i] = decode(static_cast<float>(i) / 255.0f);
+                }
+
+                for (std::uint32_t i = 0u; i < 255u; ++i)
+                {
+                    afThresholds[i] = decode((static_cast<float>(i) + 0.5f) / 255.0f);
+                }
+            }
+
+            static float decode(float fValue)
+            {
+                return fValue <= 0.04045f ? fValue / 12.92f : std::pow((fValue + 0.055f) / 1.055f, 2.4f);
+            }
+        };
+
+        const SrgbTables& getSrgbTables()
+        {
+            static const SrgbTables tables;
+
+            return tables;
+        }
+
+        std::uint8_t encodeSrgb(const SrgbTables& tables, float fValue)
+        {
+            return static_cast<std::uint8_t>(std::upper_bound(tables.afThresholds, tables.afThresholds + 255,
+                std::clamp(fValue, 0.0f, 1.0f)) - tables.afThresholds);
+        }
+
+        std::uint8_t quantize(float fValue)
+        {
+            return static_cast<std::uint8_t>(std::clamp(fValue, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        // Source pixels and weights of every pixel of one axis of the
+        // resized image. The taps of pixel i are
+        // [aFirstTaps[i], aFirstTaps[i + 1])
+        struct FilterTaps
+        {
+            std::vector<std::uint32_t> aFirstTaps;
+            std::vector<std::uint32_t> aIndices;
+            std::vector<float> aWeights;
+        };
+
+        double sinc(double x)
+        {
+            constexpr const double PI = 3.14159265358979323846;
+
+            if (std::abs(x) < 1e-6)
+            {
+                return 1.0;
+            }
+
+            return std::sin(PI * x) / (PI * x);
+        }
+
+        std::uint32_t clampIndex(std::int64_t i, std::uint32_t uSize)
+        {
+            return static_cast<std::uint32_t>(std::clamp<std::int64_t>(i, 0, static_cast<std::int64_t>(uSize) - 1));
+        }
+
+        void buildTaps(std::uint32_t uSourceSize, std::uint32_t uSize, eResizeFilter filter, FilterTaps& taps)
+        {
+            double scale = static_cast<double>(uSourceSize) / static_cast<double>(uSize);
+
+            // Enlarging interpolates between source pixels instead of
+            // widening the filter
+            double filterScale = (std::max)(scale, 1.0);
+
+            taps.aFirstTaps.assign(1u, 0u);
+            taps.aIndices.clear();
+            taps.aWeights.clear();
+
+            for (std::uint32_t i = 0u; i < uSize; ++i)
+            {
+                std::size_t uFirst = taps.aWeights.size();
+
+                if (filter == eResizeFilter::BOX)
+                {
+                    double begin = i * scale;
+                    double end = (i + 1u) * scale;
+
+                    for (std::int64_t s = static_cast<std::int64_t>(std::floor(begin)); s < static_cast<std::int64_t>(std::ceil(end)); ++s)
+                    {
+                        double weight = (std::min)(end, static_cast<double>(s + 1)) - (std::max)(begin, static_cast<double>(s));
+                        if (weight > 0.0)
+                        {
+                            taps.aIndices.push_back(clampIndex(s, uSourceSize));
+                            taps.aWeights.push_back(static_cast<float>(weight));
+                        }
+                    }
+                }
+                else
+                {
+                    double center = (i + 0.5) * scale;
+                    double support = PixelConverter::LANCZOS_RADIUS * filterScale;
+
+                    for (std::int64_t s = static_cast<std::int64_t>(std::floor(center - support));
+                        s <= static_cast<std::int64_t>(std::ceil(center + support)); ++s)
+                    {
+                        double t = (static_cast<double>(s) + 0.5 - center) / filterScale;
+                        if (std::abs(t) >= PixelConverter::LANCZOS_RADIUS)
+                        {
+                            continue;
+                        }
+
+                        taps.aIndices.push_back(clampIndex(s, uSourceSize));
+                        taps.aWeights.push_back(static_cast<float>(sinc(t) * sinc(t / PixelConverter::LANCZOS_RADIUS)));
+                    }
+                }
+
+                double sum = 0.0;
+                for (std::size_t k = uFirst; k < taps.aWeights.size(); ++k)
+                {
+                    sum += taps.aWeights[k];
+                }
+
+                for (std::size_t k = uFirst; k < taps.aWeights.size(); ++k)
+                {
+                    taps.aWeights[k] = static_cast<float>(taps.aWeights[k] / sum);
+                }
+
+                taps.aFirstTaps.push_back(static_cast<std::uint32_t>(taps.aWeights.size()));
+            }
+        }
+
+        // Swaps red and blue of 32-bit pixels, making the fourth byte
+        // opaque for BGRX8
+        void swapRedBlue(const std::uint8_t* pRow, std::uint32_t uWidth, bool bOpaque, std::uint8_t* pOut)
+        {
+            std::uint32_t x = 0u;
+
+#ifdef PIXEL_CONVERTER_SSE2
+            const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+            const __m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
+            const __m128i alpha = _mm_set1_epi32(bOpaque ? static_cast<int>(0xFF000000u) : 0);
+
+            for (; x + 4u <= uWidth; x += 4u)
+            {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + static_cast<std::size_t>(x) * 4u));
+                __m128i redBlue = _mm_and_si128(pixels, redBlueMask);
+                redBlue = _mm_or_si128(_mm_slli_epi32(redBlue, 16), _mm_srli_epi32(redBlue, 16));
+
+                pixels = _mm_or_si128(_mm_or_si128(_mm_and_si128(pixels, greenAlphaMask), redBlue), alpha);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + static_cast<std::size_t>(x) * 4u), pixels);
+            }
+#endif
+
+            for (; x < uWidth; ++x)
+            {
+                const std::uint8_t* pPixel = pRow + static_cast<std::size_t>(x) * 4u;
+                std::uint8_t* pOutPixel = pOut + static_cast<std::size_t>(x) * 4u;
+
+                pOutPixel[0] = pPixel[2];
+                pOutPixel[1] = pPixel[1];
+                pOutPixel[2] = pPixel[0];
+                pOutPixel[3] = bOpaque ? 255u : pPixel[3];
+            }
+        }
+
+        // Adds an opaque alpha to 24-bit pixels, swapping red and blue
+        // for BGR8
+        void expandRgb(const std::uint8_t* pRow, std::uint32_t uWidth, bool bSwap, std::uint8_t* pOut)
+        {
+            std::uint32_t x = 0u;
+
+#ifdef PIXEL_CONVERTER_SSE2
+            // Pixel i moves from byte 3i to byte 4i. Four pixels take 12
+            // bytes but 16 are loaded, so the last pixels of the row are
+            // left to the scalar loop
+            const __m128i aMasks[4] =
+            {
+                _mm_setr_epi32(0x00FFFFFF, 0, 0, 0),
+                _mm_setr_epi32(0, 0x00FFFFFF, 0, 0),
+                _mm_setr_epi32(0, 0, 0x00FFFFFF, 0),
+                _mm_setr_epi32(0, 0, 0, 0x00FFFFFF)
+            };
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+            const __m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
+
+            for (; x + 6u <= uWidth; x += 4u)
+            {
+                __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + static_cast<std::size_t>(x) * 3u));
+
+                __m128i pixels = _mm_or_si128(_mm_and_si128(source, aMasks[0]), _mm_and_si128(_mm_slli_si128(source, 1), aMasks[1]));
+                pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_slli_si128(source, 2), aMasks[2]));
+                pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_slli_si128(source, 3), aMasks[3]));
+
+                if (bSwap)
+                {
+                    __m128i redBlue = _mm_and_si128(pixels, redBlueMask);
+                    redBlue = _mm_or_si128(_mm_slli_epi32(redBlue, 16), _mm_srli_epi32(redBlue, 16));
+                    pixels = _mm_or_si128(_mm_and_si128(pixels, greenAlphaMask), redBlue);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + static_cast<std::size_t>(x) * 4u), _mm_or_si128(pixels, alpha));
+            }
+#endif
+
+            for (; x < uWidth; ++x)
+            {
+                const std::uint8_t* pPixel = pRow + static_cast<std::size_t>(x) * 3u;
+                std::uint8_t* pOutPixel = pOut + static_cast<std::size_t>(x) * 4u;
+
+                pOutPixel[0] = pPixel[bSwap ? 2 : 0];
+                pOutPixel[1] = pPixel[1];
+                pOutPixel[2] = pPixel[bSwap ? 0 : 2];
+                pOutPixel[3] = 255u;
+            }
+        }
+
+        // Copies gray to red, green and blue with an opaque alpha
+        void expandGray(const std::uint8_t* pRow, std::uint32_t uWidth, std::uint8_t* pOut)
+        {
+            std::uint32_t x = 0u;
+
+#ifdef PIXEL_CONVERTER_SSE2
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+            for (; x + 16u <= uWidth; x += 16u)
+            {
+                __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + x));
+                __m128i grayLow = _mm_unpacklo_epi8(gray, gray);
+                __m128i grayHigh = _mm_unpackhi_epi8(gray, gray);
+
+                __m128i* pOutPixels = reinterpret_cast<__m128i*>(pOut + static_cast<std::size_t>(x) * 4u);
+                _mm_storeu_si128(pOutPixels + 0, _mm_or_si128(_mm_unpacklo_epi16(grayLow, grayLow), alpha));
+                _mm_storeu_si128(pOutPixels + 1, _mm_or_si128(_mm_unpackhi_epi16(grayLow, grayLow), alpha));
+                _mm_storeu_si128(pOutPixels + 2, _mm_or_si128(_mm_unpacklo_epi16(grayHigh, grayHigh), alpha));
+                _mm_storeu_si128(pOutPixels + 3, _mm_or_si128(_mm_unpackhi_epi16(grayHigh, grayHigh), alpha));
+            }
+#endif
+
+            for (; x < uWidth; ++x)
+            {
+                std::uint8_t* pOutPixel = pOut + static_cast<std::size_t>(x) * 4u;
+
+                pOutPixel[0] = pRow[x];
+                pOutPixel[1] = pRow[x];
+                pOutPixel[2] = pRow[x];
+                pOutPixel[3] = 255u;
+            }
+        }
+
+        // Converts a row of RGBA8 pixels to floats in [0, 1], decoding
+        // sRGB color to linear light
+        void toLinearRow(const std::uint8_t* pRow, std::uint32_t uWidth, bool bSrgb, float* pOut)
+        {
+            const SrgbTables& tables = getSrgbTables();
+
+            for (std::size_t i = 0u; i < static_cast<std::size_t>(uWidth) * 4u; i += 4u)
+            {
+                for (std::size_t c = 0u; c < 3u; ++c)
+                {
+                    pOut[i + c] = bSrgb ? tables.afToLinear[pRow[i + c]] : static_cast<float>(pRow[i + c]) / 255.0f;
+                }
+
+                pOut[i + 3u] = static_cast<float>(pRow[i + 3u]) / 255.0f;
+            }
+        }
+
+        // Filters a row of pixels horizontally, one pixel of four floats
+        // at a time
+        void filterRow(const float* pRow, const FilterTaps& taps, std::uint32_t uWidth, float* pOut)
+        {
+            for (std::uint32_t x = 0u; x < uWidth; ++x)
+            {
+#ifdef PIXEL_CONVERTER_SSE2
+                __m128 sum = _mm_setzero_ps();
+
+                for (std::uint32_t k = taps.aFirstTaps[x]; k < taps.aFirstTaps[x + 1u]; ++k)
+                {
+                    __m128 pixel = _mm_loadu_ps(pRow + static_cast<std::size_t>(taps.aIndices[k]) * 4u);
+                    sum = _mm_add_ps(sum, _mm_mul_ps(pixel, _mm_set1_ps(taps.aWeights[k])));
+                }
+
+                _mm_storeu_ps(pOut + static_cast<std::size_t>(x) * 4u, sum);
+#else
+                float aSum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+                for (std::uint32_t k = taps.aFirstTaps[x]; k < taps.aFirstTaps[x + 1u]; ++k)
+                {
+                    const float* pPixel = pRow + static_cast<std::size_t>(taps.aIndices[k]) * 4u;
+                    for (std::uint32_t c = 0u; c < 4u; ++c)
+                    {
+                        aSum[c] += pPixel[c] * taps.aWeights[k];
+                    }
+                }
+
+                std::copy(aSum, aSum + 4, pOut + static_cast<std::size_t>(x) * 4u);
+#endif
+            }
+        }
+
+        void addScaledRow(const float* pRow, float fWeight, std::size_t uNumFloats, float* pSum)
+        {
+#ifdef PIXEL_CONVERTER_SSE2
+            __m128 weight = _mm_set1_ps(fWeight);
+
+            for (std::size_t i = 0u; i < uNumFloats; i += 4u)
+            {
+                _mm_storeu_ps(pSum + i, _mm_add_ps(_mm_loadu_ps(pSum + i), _mm_mul_ps(_mm_loadu_ps(pRow + i), weight)));
+            }
+#else
+            for (std::size_t i = 0u; i < uNumFloats; ++i)
+            {
+                pSum[i] += pRow[i] * fWeight;
+            }
+#endif
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelConverter::GetBytesPerPixel
+      Summary:  Returns the size of one pixel of a format
+      Args:     ePixelFormat format
+                  Format of the pixels
+      Returns:  std::uint32_t
+                  Bytes of one pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t PixelConverter::GetBytesPerPixel(ePixelFormat format)
+    {
+        switch (format)
+        {
+        case ePixelFormat::RGB8:
+        case ePixelFormat::BGR8:
+            return 3u;
+        case ePixelFormat::GRAY8:
+            return 1u;
+        default:
+            return 4u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelConverter::ConvertRows
+      Summary:  Converts rows of pixels to RGBA8. Rows are independent,
+                so bands of rows can be converted in parallel
+      Args:     const std::uint8_t* pPixels
+                  First row of the pixels to convert
+                std::size_t uPitch
+                  Bytes from one row of the pixels to the next
+                ePixelFormat format
+                  Format of the pixels
+                std::uint32_t uWidth
+                  Width of the image
+                std::uint32_t uHeight
+                  Height of the image
+                std::uint32_t uFirstRow
+                  First row to convert
+                std::uint32_t uNumRows
+                  Number of rows to convert
+                std::uint8_t* pOutPixels
+                  First row of the RGBA8 image, rows tightly packed
+      Modifies: [pOutPixels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PixelConverter::ConvertRows(const std::uint8_t* pPixels, std::size_t uPitch, ePixelFormat format, std::uint32_t uWidth,
+        std::uint32_t uHeight, std::uint32_t uFirstRow, std::uint32_t uNumRows, std::uint8_t* pOutPixels)
+    {
+        uNumRows = (std::min)(uNumRows, uHeight - (std::min)(uFirstRow, uHeight));
+
+        for (std::uint32_t y = uFirstRow; y < uFirstRow + uNumRows; ++y)
+        {
+            const std::uint8_t* pRow = pPixels + y * uPitch;
+            std::uint8_t* pOutRow = pOutPixels + static_cast<std::size_t>(y) * uWidth * 4u;
+
+            switch (format)
+            {
+            case ePixelFormat::RGBA8:
+                std::memcpy(pOutRow, pRow, static_cast<std::size_t>(uWidth) * 4u);
+                break;
+            case ePixelFormat::BGRA8:
+            case ePixelFormat::BGRX8:
+                swapRedBlue(pRow, uWidth, format == ePixelFormat::BGRX8, pOutRow);
+                break;
+            case ePixelFormat::RGB8:
+            case ePixelFormat::BGR8:
+                expandRgb(pRow, uWidth, format == ePixelFormat::BGR8, pOutRow);
+                break;
+            case ePixelFormat::GRAY8:
+                expandGray(pRow, uWidth, pOutRow);
+                break;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelConverter::SrgbToLinear
+      Summary:  Decodes sRGB values to linear floats in [0, 1] from a
+                table
+      Args:     const std::uint8_t* pValues
+                  sRGB values
+                std::size_t uNumValues
+                  Number of values
+                float* pOutValues
+                  Receives the linear values
+      Modifies: [pOutValues].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PixelConverter::SrgbToLinear(const std::uint8_t* pValues, std::size_t uNumValues, float* pOutValues)
+    {
+        const SrgbTables& tables = getSrgbTables();
+
+        for (std::size_t i = 0u; i < uNumValues; ++i)
+        {
+            pOutValues[i] = tables.afToLinear[pValues[i]];
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelConverter::LinearToSrgb
+      Summary:  Encodes linear floats to the nearest sRGB values, found
+                among the thresholds between sRGB values instead of
+                raising every value to a power
+      Args:     const float* pValues
+                  Linear values, clamped to [0, 1]
+                std::size_t uNumValues
+                  Number of values
+                std::uint8_t* pOutValues
+                  Receives the sRGB values
+      Modifies: [pOutValues].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PixelConverter::LinearToSrgb(const float* pValues, std::size_t uNumValues, std::uint8_t* pOutValues)
+    {
+        const SrgbTables& tables = getSrgbTables();
+
+        for (std::size_t i = 0u; i < uNumValues; ++i)
+        {
+            pOutValues[i] = encodeSrgb(tables, pValues[i]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PixelConverter::ResizeRows
+      Summary:  Filters rows of a resized RGBA8 image. Only the source
+                rows under the filter of these rows are filtered
+                horizontally, so bands of rows can be resized in
+                parallel
+      Args:     const std::uint8_t* pPixels
+                  RGBA8 image, rows tightly packed
+                std::uint32_t uWidth
+                  Width of the image
+                std::uint32_t uHeight
+                  Height of the image
+                std::uint32_t uNewWidth
+                  Width of the resized image
+                std::uint32_t uNewHeight
+                  Height of the resized image
+                eResizeFilter filter
+                  Filter to resize with
+                bool bSrgb
+                  Whether color is sRGB encoded
+                std::uint32_t uFirstRow
+                  First row of the resized image to write
+                std::uint32_t uNumRows
+                  Number of rows to write
+                std::uint8_t* pOutPixels
+                  First row of the resized image, rows tightly packed
+      Modifies: [pOutPixels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PixelConverter::ResizeRows(const std::uint8_t* pPixels, std::uint32_t uWidth, std::uint32_t uHeight, std::uint32_t uNewWidth,
+        std::uint32_t uNewHeight, eResizeFilter filter, bool bSrgb, std::uint32_t uFirstRow, std::uint32_t uNumRows,
+        std::uint8_t* pOutPixels)
+    {
+        uNumRows = (std::min)(uNumRows, uNewHeight - (std::min)(uFirstRow, uNewHeight));
+        if (uNumRows == 0u)
+        {
+            return;
+        }
+
+        FilterTaps horizontalTaps;
+        FilterTaps verticalTaps;
+        buildTaps(uWidth, uNewWidth, filter, horizontalTaps);
+        buildTaps(uHeight, uNewHeight, filter, verticalTaps);
+
+        // Taps are clamped, so the source rows of the band are one range
+        std::uint32_t uFirstSourceRow = uHeight;
+        std::uint32_t uLastSourceRow = 0u;
+
+        for (std::uint32_t k = verticalTaps.aFirstTaps[uFirstRow]; k < verticalTaps.aFirstTaps[uFirstRow + uNumRows]; ++k)
+        {
+            uFirstSourceRow = (std::min)(uFirstSourceRow, verticalTaps.aIndices[k]);
+            uLastSourceRow = (std::max)(uLastSourceRow, verticalTaps.aIndices[k]);
+        }
+
+        std::size_t uRowFloats = static_cast<std::size_t>(uNewWidth) * 4u;
+
+        std::vector<float> aLinearRow(static_cast<std::size_t>(uWidth) * 4u);
+        std::vector<float> aFilteredRows((uLastSourceRow - uFirstSourceRow + 1u) * uRowFloats);
+
+        for (std::uint32_t uSourceRow = uFirstSourceRow; uSourceRow <= uLastSourceRow; ++uSourceRow)
+        {
+            toLinearRow(pPixels + static_cast<std::size_t>(uSourceRow) * uWidth * 4u, uWidth, bSrgb, aLinearRow.data());
+            filterRow(aLinearRow.data(), horizontalTaps, uNewWidth, aFilteredRows.data() + (uSourceRow - uFirstSourceRow) * uRowFloats);
+        }
+
+        const SrgbTables& tables = getSrgbTables();
+        std::vector<float> aSum(uRowFloats);
+
+        for (std::uint32_t y = uFirstRow; y < uFirstRow + uNumRows; ++y)
+        {
+            std::fill(aSum.begin(), aSum.end(), 0.0f);
+
+            for (std::uint32_t k = verticalTaps.aFirstTaps[y]; k < verticalTaps.aFirstTaps[y + 1u]; ++k)
+            {
+                addScaledRow(aFilteredRows.data() + (verticalTaps.aIndices[k] - uFirstSourceRow) * uRowFloats, verticalTaps.aWeights[k],
+                    uRowFloats, aSum.data());
+            }
+
+            std::uint8_t* pRow = pOutPixels + static_cast<std::size_t>(y) * uRowFloats;
+
+            for (std::size_t i = 0u; i < uRowFloats; i += 4u)
+            {
+                for (std::size_t c = 0u; c < 3u; ++c)
+                {
+                    pRow[i + c] = bSrgb ? encodeSrgb(tables, aSum[i + c]) : quantize(aSum[i + c]);
+                }
+
+                pRow[i + 3u] = quantize(aSum[i + 3u]);
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*+===================================================================
+  File:      PIXELCONVERTER.H
+  Summary:   PixelConverter header file contains declarations of
+             PixelConverter class used to convert decoded images to
+             RGBA8 and resize them on the CPU.
+  Classes: PixelConverter
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     ePixelFormat
+      Summary:  Layouts of 8-bit pixels converted to RGBA8. BGRX8 has
+                an unused fourth byte, read as opaque; GRAY8 is copied
+                to red, green and blue
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class ePixelFormat : std::uint32_t
+    {
+        RGBA8 = 0u,
+        BGRA8,
+        BGRX8,
+        RGB8,
+        BGR8,
+        GRAY8
+    };
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eResizeFilter
+      Summary:  Filters to resize images with. BOX averages the pixels
+                covered by each resized pixel; LANCZOS3 is a Lanczos
+                windowed sinc of three lobes, sharper when shrinking
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eResizeFilter : std::uint32_t
+    {
+        BOX = 0u,
+        LANCZOS3
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    PixelConverter
+      Summary:  Converts rows of decoded pixels to RGBA8 and resizes
+                RGBA8 images, so formats are converted and images are
+                scaled down without WIC. Both work on ranges of rows, so
+                callers split an image in bands across threads. Four
+                pixels are converted at a time with SSE2, and resized
+                four floats at a time (scalar code elsewhere). Resizing
+                is separable like MipGenerator, with pixels clamped at
+                the edges, and filters color in linear light when it is
+                sRGB encoded
+      Methods:  GetBytesPerPixel
+                  Returns the size of one pixel of a format
+                ConvertRows
+                  Converts rows of pixels to RGBA8
+                SrgbToLinear
+                  Decodes sRGB values to linear floats
+                LinearToSrgb
+                  Encodes linear floats to sRGB values
+                ResizeRows
+                  Filters rows of a resized RGBA8 image
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class PixelConverter final
+    {
+    public:
+        // Lobes of the Lanczos filter on each side, in pixels of the
+        // resized image
+        static constexpr const float LANCZOS_RADIUS = 3.0f;
+
+    public:
+        PixelConverter() = delete;
+        PixelConverter(const PixelConverter& other) = delete;
+        PixelConverter(PixelConverter&& other) = delete;
+        PixelConverter& operator=(const PixelConverter& other) = delete;
+        PixelConverter& operator=(PixelConverter&& other) = delete;
+        ~PixelConverter() = delete;
+
+        static std::uint32_t GetBytesPerPixel(ePixelFormat format);
+
+        static void ConvertRows(const std::uint8_t* pPixels, std::size_t uPitch, ePixelFormat format, std::uint32_t uWidth,
+            std::uint32_t uHeight, std::uint32_t uFirstRow, std::uint32_t uNumRows, std::uint8_t* pOutPixels);
+
+        static void SrgbToLinear(const std::uint8_t* pValues, std::size_t uNumValues, float* pOutValues);
+        static void LinearToSrgb(const float* pValues, std::size_t uNumValues, std::uint8_t* pOutValues);
+
+        static void ResizeRows(const std::uint8_t* pPixels, std::uint32_t uWidth, std::uint32_t uHeight, std::uint32_t uNewWidth,
+            std::uint32_t uNewHeight, eResizeFilter filter, bool bSrgb, std::uint32_t uFirstRow, std::uint32_t uNumRows,
+            std::uint8_t* pOutPixels);
+    };
+}
@@ -0,0 +1,101 @@
+#include "Texture/SamplerCache.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::SamplerCache
+      Summary:  Constructor
+      Modifies: [m_aEntries].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SamplerCache::SamplerCache() :
+        m_aEntries(),
+        m_mutex()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetSamplerState
+      Summary:  Returns the sampler state of a descriptor, creating it
+                on first use
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the sampler state
+                const D3D11_SAMPLER_DESC& samplerDesc
+                  Descriptor of the sampler state
+                ComPtr<ID3D11SamplerState>& outSamplerState
+                  Receives the shared sampler state
+      Modifies: [m_aEntries].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SamplerCache::GetSamplerState(
+        _In_ ID3D11Device* pDevice,
+        _In_ const D3D11_SAMPLER_DESC& samplerDesc,
+        _Out_ ComPtr<ID3D11SamplerState>& outSamplerState
+    )
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const Entry& entry : m_aEntries)
+        {
+            if (entry.pDevice == pDevice && memcmp(&entry.samplerDesc, &samplerDesc, sizeof(D3D11_SAMPLER_DESC)) == 0)
+            {
+                outSamplerState = entry.samplerState;
+                return S_OK;
+            }
+        }
+
+        ComPtr<ID3D11SamplerState> samplerState;
+
+        HRESULT hr = pDevice->CreateSamplerState(&samplerDesc, samplerState.GetAddressOf());
+        if (FAILED(hr))
+        {
+            outSamplerState.Reset();
+            return hr;
+        }
+
+        m_aEntries.push_back(Entry{ .pDevice = pDevice, .samplerDesc = samplerDesc, .samplerState = samplerState });
+        outSamplerState = samplerState;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::Clear
+      Summary:  Releases the cache's references to every sampler state,
+                for example before the device is destroyed
+      Modifies: [m_aEntries].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SamplerCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_aEntries.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetNumSamplerStates
+      Summary:  Returns the number of cached sampler states
+      Returns:  UINT
+                  Number of sampler states
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SamplerCache::GetNumSamplerStates()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return static_cast<UINT>(m_aEntries.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SamplerCache::GetShared
+      Summary:  Returns the cache shared by every texture, created on
+                first use
+      Returns:  SamplerCache&
+                  Shared sampler cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SamplerCache& SamplerCache::GetShared()
+    {
+        static SamplerCache s_samplerCache;
+
+        return s_samplerCache;
+    }
+}
@@ -0,0 +1,66 @@
+/*+===================================================================
+  File:      SAMPLERCACHE.H
+  Summary:   SamplerCache header file contains declarations of
+             SamplerCache class used to share sampler states between
+             textures.
+  Classes: SamplerCache
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SamplerCache
+      Summary:  Creates every distinct sampler state once per device.
+                Lookups compare the whole descriptor; there are only a
+                handful of distinct samplers, so a list is enough
+      Methods:  GetSamplerState
+                  Returns the sampler state of a descriptor
+                Clear
+                  Releases every sampler state
+                GetNumSamplerStates
+                  Returns the number of cached sampler states
+                GetShared
+                  Returns the cache shared by the textures
+                SamplerCache
+                  Constructor.
+                ~SamplerCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SamplerCache final
+    {
+    public:
+        SamplerCache();
+        SamplerCache(const SamplerCache& other) = delete;
+        SamplerCache(SamplerCache&& other) = delete;
+        SamplerCache& operator=(const SamplerCache& other) = delete;
+        SamplerCache& operator=(SamplerCache&& other) = delete;
+        ~SamplerCache() = default;
+
+        HRESULT GetSamplerState(
+            _In_ ID3D11Device* pDevice,
+            _In_ const D3D11_SAMPLER_DESC& samplerDesc,
+            _Out_ ComPtr<ID3D11SamplerState>& outSamplerState
+        );
+        void Clear();
+        UINT GetNumSamplerStates();
+
+        static SamplerCache& GetShared();
+
+    private:
+        struct Entry
+        {
+            ID3D11Device* pDevice;
+            D3D11_SAMPLER_DESC samplerDesc;
+            ComPtr<ID3D11SamplerState> samplerState;
+        };
+
+        std::vector<Entry> m_aEntries;
+        std::mutex m_mutex;
+    };
+}
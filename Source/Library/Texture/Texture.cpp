@@ -1,26 +1,138 @@
 #include "Texture.h"
 
-#include "Texture/WICTextureLoader.h"
+#include "Texture/DDSTextureLoader.h"
+#include "Texture/PixelConverter.h"
+#include "Texture/SamplerCache.h"
+#include "Texture/TextureArray.h"
+#include "Thread/ThreadPool.h"
 
 namespace library
 {
+    namespace
+    {
+        // Mips are baked in bands of rows, so the large top mips are
+        // spread over every worker
+        constexpr const UINT BAKE_BAND_ROWS = 32u;
+
+        // Rows of blocks encoded per task, as many texel rows as a band
+        constexpr const UINT BAKE_BAND_BLOCK_ROWS = BAKE_BAND_ROWS / 4u;
+
+        // Decoded images are converted and resized in bands of rows
+        constexpr const UINT DECODE_BAND_ROWS = 64u;
+
+        // Formats of decoded images PixelConverter converts; images in
+        // other formats are converted by WIC
+        BOOL getPixelFormat(_In_ REFWICPixelFormatGUID pixelFormat, _Out_ ePixelFormat& outFormat)
+        {
+            static const std::pair<WICPixelFormatGUID, ePixelFormat> FORMATS[] =
+            {
+                { GUID_WICPixelFormat32bppRGBA, ePixelFormat::RGBA8 },
+                { GUID_WICPixelFormat32bppBGRA, ePixelFormat::BGRA8 },
+                { GUID_WICPixelFormat32bppBGR, ePixelFormat::BGRX8 },
+                { GUID_WICPixelFormat24bppRGB, ePixelFormat::RGB8 },
+                { GUID_WICPixelFormat24bppBGR, ePixelFormat::BGR8 },
+                { GUID_WICPixelFormat8bppGray, ePixelFormat::GRAY8 },
+            };
+
+            for (const auto& [guid, format] : FORMATS)
+            {
+                if (IsEqualGUID(pixelFormat, guid))
+                {
+                    outFormat = format;
+                    return TRUE;
+                }
+            }
+
+            outFormat = ePixelFormat::RGBA8;
+            return FALSE;
+        }
+
+        // Direct3D 11 creates block compressed textures only with a top
+        // mip whose size is a multiple of 4
+        BOOL isValidTopMip(_In_ const DdsImage& image, _In_ UINT uMip)
+        {
+            if (!DdsParser::IsBlockCompressed(image.format))
+            {
+                return TRUE;
+            }
+
+            return ((std::max)(image.uWidth >> uMip, 1u) % 4u == 0u) && ((std::max)(image.uHeight >> uMip, 1u) % 4u == 0u);
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Texture
       Summary:  Constructor
       Args:     const std::filesystem::path& textureFilePath
                   Path to the texture to use
-      Modifies: [m_filePath, m_textureRV, m_samplerLinear].
+                const TextureLoadOptions& options
+                  Options to load the texture with
+      Modifies: [m_filePath, m_options, m_decodeResult, m_aPixels,
+                  m_pDdsFile, m_pStreamFile, m_streamResult,
+                  m_aStreamedMips, m_uTopMip, m_uTailMip,
+                  m_uResidentMip, m_uStreamingMip, m_uWidth, m_uHeight,
+                  m_textureRV, m_samplerLinear].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    Texture::Texture(_In_ const std::filesystem::path& filePath) :
+    Texture::Texture(_In_ const std::filesystem::path& filePath, _In_ const TextureLoadOptions& options) :
         m_filePath(filePath),
+        m_options(options),
+        m_decodeResult(),
+        m_aPixels(),
+        m_pDdsFile(),
+        m_pStreamFile(),
+        m_streamResult(),
+        m_aStreamedMips(),
+        m_uTopMip(0u),
+        m_uTailMip(0u),
+        m_uResidentMip(0u),
+        m_uStreamingMip(0u),
+        m_uWidth(0u),
+        m_uHeight(0u),
         m_textureRV(nullptr),
         m_samplerLinear(nullptr)
     {
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::~Texture
+      Summary:  Destructor. Waits for a queued decode or mip stream,
+                which write into this object
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Texture::~Texture()
+    {
+        if (m_decodeResult.valid())
+        {
+            m_decodeResult.wait();
+        }
+
+        waitForStream();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::BeginDecode
+      Summary:  Queues the decode of the file on the shared thread pool.
+                Call at most once, before Initialize
+      Modifies: [m_decodeResult].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::BeginDecode()
+    {
+        if (!m_decodeResult.valid())
+        {
+            m_decodeResult = ThreadPool::GetShared().Submit([this]()
+                {
+                    return decode();
+                }).share();
+        }
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Initialize
-      Summary:  Initializes the texture
+      Summary:  Initializes the texture on the device thread. Waits for
+                the decode queued by BeginDecode, or decodes now if none
+                was queued, then creates the Direct3D resources. A
+                texture shared by several materials is only created by
+                the first call. The linear wrap sampler is shared with
+                every other texture through SamplerCache
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
@@ -29,10 +141,17 @@ namespace library
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) {
 
-        HRESULT hr = S_OK;
+        if (m_textureRV) {
+            return S_OK;
+        }
+
+        HRESULT hr = m_decodeResult.valid() ? m_decodeResult.get() : decode();
+
+        if (FAILED(hr)) {
+            return hr;
+        }
 
-        hr = CreateWICTextureFromFile(pDevice, pImmediateContext,
-            m_filePath.c_str(), nullptr, m_textureRV.GetAddressOf());
+        hr = createResources(pDevice, pImmediateContext);
 
         if (FAILED(hr)) {
             return hr;
@@ -48,7 +167,7 @@ namespace library
             .MaxLOD = D3D11_FLOAT32_MAX
         };
 
-        hr = pDevice->CreateSamplerState(&sampDesc, m_samplerLinear.GetAddressOf());
+        hr = SamplerCache::GetShared().GetSamplerState(pDevice, sampDesc, m_samplerLinear);
 
         if (FAILED(hr)) {
             return hr;
@@ -57,6 +176,492 @@ namespace library
         return S_OK;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::BeginReload
+      Summary:  Queues a new decode of the file on the shared thread
+                pool after the file changed. The texture in use is not
+                touched until CommitReload. The previous decode writes
+                the same pixels, so callers wait until IsDecoding is
+                FALSE instead of blocking here
+      Modifies: [m_decodeResult].
+      Returns:  std::shared_future<HRESULT>
+                  Result of the decode
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_future<HRESULT> Texture::BeginReload()
+    {
+        assert(!IsDecoding());
+
+        m_decodeResult = ThreadPool::GetShared().Submit([this]()
+            {
+                return decode();
+            }).share();
+
+        return m_decodeResult;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::CommitReload
+      Summary:  Replaces the texture with the one decoded by
+                BeginReload, waiting for the decode if needed. Every
+                material sharing this texture sees the new one. A
+                failed decode keeps the current texture
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to generate mips with
+      Modifies: [m_textureRV, m_aPixels, m_pDdsFile].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::CommitReload(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = m_decodeResult.valid() ? m_decodeResult.get() : decode();
+
+        if (FAILED(hr))
+        {
+            m_aPixels.clear();
+            m_aPixels.shrink_to_fit();
+            m_pDdsFile.reset();
+            return hr;
+        }
+
+        if (!m_textureRV)
+        {
+            return Initialize(pDevice, pImmediateContext);
+        }
+
+        return createResources(pDevice, pImmediateContext);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Bake
+      Summary:  Decodes the image with WIC and writes its baked DDS
+                file with the whole mip chain, so the texture loads
+                fully mipped without generating mips at run time. Every
+                mip is filtered from the mip above by MipGenerator, one
+                level after the other, in bands of rows spread over the
+                shared thread pool, then
+                encoded by BlockCompressor the same way when a block
+                compressed format is asked for. Images whose size is
+                not a multiple of four, which Direct3D cannot create
+                block compressed, stay RGBA8. Texels stay in an UNORM
+                format, as the shaders sample them. No Direct3D device
+                is needed
+      Args:     const TextureBakeOptions& options
+                  Filter, color space and format of the mips
+      Modifies: [m_aPixels, m_uWidth, m_uHeight].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::Bake(_In_ const TextureBakeOptions& options)
+    {
+        HRESULT hr = decodeImage();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        UINT uNumLevels = MipGenerator::GetNumLevels(m_uWidth, m_uHeight);
+
+        // Linear texels of the mip above and of the mip being filtered
+        std::vector<float> aSourceTexels;
+        std::vector<float> aTexels;
+        MipGenerator::ConvertToLinear(m_aPixels.data(), m_uWidth, m_uHeight, options.bSrgb ? true : false, aSourceTexels);
+
+        std::vector<std::vector<BYTE>> aLevels(uNumLevels);
+        aLevels[0].swap(m_aPixels);
+
+        for (UINT uLevel = 1u; uLevel < uNumLevels; ++uLevel)
+        {
+            UINT uSourceWidth = 0u;
+            UINT uSourceHeight = 0u;
+            UINT uLevelWidth = 0u;
+            UINT uLevelHeight = 0u;
+            MipGenerator::GetLevelSize(m_uWidth, m_uHeight, uLevel - 1u, uSourceWidth, uSourceHeight);
+            MipGenerator::GetLevelSize(m_uWidth, m_uHeight, uLevel, uLevelWidth, uLevelHeight);
+
+            aLevels[uLevel].resize(static_cast<size_t>(uLevelWidth) * uLevelHeight * 4u);
+            aTexels.resize(static_cast<size_t>(uLevelWidth) * uLevelHeight * 4u);
+
+            UINT uNumBands = (uLevelHeight + BAKE_BAND_ROWS - 1u) / BAKE_BAND_ROWS;
+            BOOL bLastLevel = uLevel + 1u == uNumLevels;
+
+            ThreadPool::GetShared().ParallelFor(uNumBands, [&](UINT i)
+                {
+                    MipGenerator::GenerateRows(aSourceTexels.data(), uSourceWidth, uSourceHeight, options.filter,
+                        options.bSrgb ? true : false, i * BAKE_BAND_ROWS, BAKE_BAND_ROWS, bLastLevel ? nullptr : aTexels.data(),
+                        aLevels[uLevel].data());
+                });
+
+            aSourceTexels.swap(aTexels);
+        }
+
+        eDdsFormat format = eDdsFormat::R8G8B8A8_UNORM;
+
+        if (BlockCompressor::IsSupported(options.format))
+        {
+            if (m_uWidth % 4u == 0u && m_uHeight % 4u == 0u)
+            {
+                format = options.format;
+            }
+            else
+            {
+                OutputDebugString(L"Texture::Bake: image size is not a multiple of 4, keeping RGBA8\n");
+            }
+        }
+
+        std::vector<UINT> aRowBytes(uNumLevels);
+        std::vector<UINT> aNumRows(uNumLevels);
+
+        for (UINT uLevel = 0u; uLevel < uNumLevels; ++uLevel)
+        {
+            UINT uLevelWidth = 0u;
+            UINT uLevelHeight = 0u;
+            MipGenerator::GetLevelSize(m_uWidth, m_uHeight, uLevel, uLevelWidth, uLevelHeight);
+
+            std::uint64_t uNumBytes = 0u;
+            std::uint64_t uRowBytes = 0u;
+            std::uint64_t uNumRows = 0u;
+            if (DdsParser::GetSurfaceInfo(uLevelWidth, uLevelHeight, format, uNumBytes, uRowBytes, uNumRows) != eDdsStatus::OK)
+            {
+                return E_FAIL;
+            }
+
+            aRowBytes[uLevel] = static_cast<UINT>(uRowBytes);
+            aNumRows[uLevel] = static_cast<UINT>(uNumRows);
+        }
+
+        if (format != eDdsFormat::R8G8B8A8_UNORM)
+        {
+            std::vector<std::vector<BYTE>> aBlocks(uNumLevels);
+            std::vector<std::pair<UINT, UINT>> aBands;
+
+            for (UINT uLevel = 0u; uLevel < uNumLevels; ++uLevel)
+            {
+                aBlocks[uLevel].resize(static_cast<size_t>(aRowBytes[uLevel]) * aNumRows[uLevel]);
+
+                for (UINT uBlockRow = 0u; uBlockRow < aNumRows[uLevel]; uBlockRow += BAKE_BAND_BLOCK_ROWS)
+                {
+                    aBands.emplace_back(uLevel, uBlockRow);
+                }
+            }
+
+            ThreadPool::GetShared().ParallelFor(static_cast<UINT>(aBands.size()), [&](UINT i)
+                {
+                    auto [uLevel, uFirstBlockRow] = aBands[i];
+
+                    UINT uLevelWidth = 0u;
+                    UINT uLevelHeight = 0u;
+                    MipGenerator::GetLevelSize(m_uWidth, m_uHeight, uLevel, uLevelWidth, uLevelHeight);
+
+                    BlockCompressor::CompressRows(aLevels[uLevel].data(), uLevelWidth, uLevelHeight, format, uFirstBlockRow,
+                        BAKE_BAND_BLOCK_ROWS, aBlocks[uLevel].data());
+                });
+
+            aLevels.swap(aBlocks);
+        }
+
+        DdsImage image =
+        {
+            .format = format,
+            .dimension = eDdsDimension::TEXTURE2D,
+            .uWidth = m_uWidth,
+            .uHeight = m_uHeight,
+            .uDepth = 1u,
+            .uArraySize = 1u,
+            .uMipLevels = uNumLevels,
+            .uAlphaMode = 0u,
+            .bCubeMap = false
+        };
+
+        std::vector<DdsSubresource> aSubresources(uNumLevels);
+
+        for (UINT uLevel = 0u; uLevel < uNumLevels; ++uLevel)
+        {
+            UINT uLevelWidth = 0u;
+            UINT uLevelHeight = 0u;
+            MipGenerator::GetLevelSize(m_uWidth, m_uHeight, uLevel, uLevelWidth, uLevelHeight);
+
+            aSubresources[uLevel] = DdsSubresource
+            {
+                .pData = aLevels[uLevel].data(),
+                .uWidth = uLevelWidth,
+                .uHeight = uLevelHeight,
+                .uDepth = 1u,
+                .uRowPitch = aRowBytes[uLevel],
+                .uSlicePitch = aRowBytes[uLevel] * aNumRows[uLevel],
+                .uNumRows = aNumRows[uLevel]
+            };
+        }
+
+        return DdsFile::Write(DdsFile::GetBakedPath(m_filePath), image, aSubresources);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::IsDecoding
+      Summary:  Returns whether a decode queued on the thread pool is
+                still running
+      Returns:  BOOL
+                  TRUE if the decode has not finished
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::IsDecoding() const
+    {
+        return m_decodeResult.valid()
+            && m_decodeResult.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::IsStreamed
+      Summary:  Returns whether the mips of the texture are streamed
+      Returns:  BOOL
+                  TRUE if the texture was created from a DDS file with
+                  its mip tail only
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::IsStreamed() const
+    {
+        return m_pStreamFile != nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetTopMip
+      Summary:  Returns the most detailed mip that can be resident,
+                below the maximum size of the load options
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetTopMip() const
+    {
+        return m_uTopMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetTailMip
+      Summary:  Returns the most detailed mip of the tail, which is
+                never evicted
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetTailMip() const
+    {
+        return m_uTailMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetResidentMip
+      Summary:  Returns the most detailed mip resident on the GPU
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetResidentMip() const
+    {
+        return m_uResidentMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetMipSize
+      Summary:  Returns the largest dimension of a mip of a streamed
+                texture
+      Args:     UINT uMip
+                  Mip index
+      Returns:  UINT
+                  Size in texels, 0 if the texture is not streamed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetMipSize(_In_ UINT uMip) const
+    {
+        if (!m_pStreamFile)
+        {
+            return 0u;
+        }
+
+        const DdsImage& image = m_pStreamFile->GetImage();
+
+        return (std::max)((std::max)(image.uWidth, image.uHeight) >> uMip, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetMipBytes
+      Summary:  Returns the size of the mips from a mip down to the
+                least detailed one, which is the memory the texture
+                takes with that mip resident
+      Args:     UINT uMip
+                  Most detailed mip
+      Returns:  UINT64
+                  Size in bytes, 0 if the texture is not streamed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 Texture::GetMipBytes(_In_ UINT uMip) const
+    {
+        if (!m_pStreamFile)
+        {
+            return 0u;
+        }
+
+        UINT64 uBytes = 0u;
+        for (UINT uLevel = uMip; uLevel < m_pStreamFile->GetImage().uMipLevels; ++uLevel)
+        {
+            uBytes += m_pStreamFile->GetSubresource(uLevel, 0u).uSlicePitch;
+        }
+
+        return uBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::BeginStreamMips
+      Summary:  Queues the copy of the mips finer than the resident ones
+                out of the mapped file on the shared thread pool, so
+                the pages are read by a worker. Block compressed
+                textures can only start at a mip whose size is a
+                multiple of 4, so the mip is moved to the nearest finer
+                one that can
+      Args:     UINT uMip
+                  Most detailed mip to stream in
+      Modifies: [m_streamResult, m_aStreamedMips, m_uStreamingMip].
+      Returns:  BOOL
+                  TRUE if a stream was queued, FALSE if one is already
+                  in flight or the mip is resident
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::BeginStreamMips(_In_ UINT uMip)
+    {
+        if (!m_pStreamFile || IsStreaming())
+        {
+            return FALSE;
+        }
+
+        uMip = (std::max)(uMip, m_uTopMip);
+        while (uMip > m_uTopMip && !isValidTopMip(m_pStreamFile->GetImage(), uMip))
+        {
+            --uMip;
+        }
+
+        if (uMip >= m_uResidentMip || !isValidTopMip(m_pStreamFile->GetImage(), uMip))
+        {
+            return FALSE;
+        }
+
+        m_uStreamingMip = uMip;
+        m_aStreamedMips.resize(m_uResidentMip - uMip);
+
+        m_streamResult = ThreadPool::GetShared().Submit([this, pFile = m_pStreamFile, uFirstMip = uMip, uLastMip = m_uResidentMip]()
+            {
+                for (UINT uLevel = uFirstMip; uLevel < uLastMip; ++uLevel)
+                {
+                    const DdsSubresource& subresource = pFile->GetSubresource(uLevel, 0u);
+
+                    m_aStreamedMips[uLevel - uFirstMip].assign(subresource.pData, subresource.pData + subresource.uSlicePitch);
+                }
+
+                return S_OK;
+            }).share();
+
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::IsStreaming
+      Summary:  Returns whether mips are being streamed in
+      Returns:  BOOL
+                  TRUE between BeginStreamMips and CommitStreamedMips
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::IsStreaming() const
+    {
+        return m_streamResult.valid();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetStreamingMip
+      Summary:  Returns the most detailed mip being streamed in
+      Returns:  UINT
+                  Mip index, the resident mip if none is streamed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Texture::GetStreamingMip() const
+    {
+        return IsStreaming() ? m_uStreamingMip : m_uResidentMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::IsStreamReady
+      Summary:  Returns whether the streamed mips were copied, so
+                CommitStreamedMips does not wait
+      Returns:  BOOL
+                  TRUE if the stream finished
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL Texture::IsStreamReady() const
+    {
+        return m_streamResult.valid() && m_streamResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::CommitStreamedMips
+      Summary:  Recreates the texture with the mips streamed by
+                BeginStreamMips, waiting for the stream if needed. Must
+                be called on the device thread
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the mips with
+      Modifies: [m_textureRV, m_streamResult, m_aStreamedMips,
+                  m_uResidentMip].
+      Returns:  HRESULT
+                  Status code, S_FALSE if no stream was queued
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::CommitStreamedMips(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        if (!m_streamResult.valid())
+        {
+            return S_FALSE;
+        }
+
+        HRESULT hr = m_streamResult.get();
+        m_streamResult = std::shared_future<HRESULT>();
+
+        if (SUCCEEDED(hr))
+        {
+            hr = resizeMips(pDevice, pImmediateContext, m_uStreamingMip);
+        }
+
+        m_aStreamedMips.clear();
+        m_aStreamedMips.shrink_to_fit();
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::EvictMips
+      Summary:  Recreates the texture without the mips finer than a
+                mip, to free their memory. The mip is moved to the
+                nearest coarser one a block compressed texture can
+                start at, and never past the tail. Must be called on the
+                device thread
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the mips with
+                UINT uMip
+                  Most detailed mip to keep
+      Modifies: [m_textureRV, m_uResidentMip].
+      Returns:  HRESULT
+                  Status code, S_FALSE if nothing was evicted
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::EvictMips(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uMip)
+    {
+        if (!m_pStreamFile || IsStreaming())
+        {
+            return S_FALSE;
+        }
+
+        uMip = (std::min)(uMip, m_uTailMip);
+        while (uMip < m_uTailMip && !isValidTopMip(m_pStreamFile->GetImage(), uMip))
+        {
+            ++uMip;
+        }
+
+        if (uMip <= m_uResidentMip)
+        {
+            return S_FALSE;
+        }
+
+        return resizeMips(pDevice, pImmediateContext, uMip);
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::GetTextureResourceView
       Summary:  Constructor
@@ -78,4 +683,516 @@ namespace library
     {
         return m_samplerLinear;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetFilePath
+      Summary:  Returns the path of the texture file
+      Returns:  const std::filesystem::path&
+                  Path to the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Texture::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetLoadOptions
+      Summary:  Returns the options the texture is loaded with
+      Returns:  const TextureLoadOptions&
+                  Load options
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TextureLoadOptions& Texture::GetLoadOptions() const
+    {
+        return m_options;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::decode
+      Summary:  Prepares the file for createResources. DDS files, and
+                images whose baked DDS file is up to date, are mapped
+                and parsed, their pixels already being in a Direct3D
+                format; other images are decoded with WIC. Touches no
+                Direct3D object, so it can run on any thread
+      Modifies: [m_aPixels, m_pDdsFile, m_uWidth, m_uHeight].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::decode()
+    {
+        BOOL bDds = _wcsicmp(m_filePath.extension().c_str(), L".dds") == 0;
+
+        if (bDds || DdsFile::IsUpToDate(m_filePath))
+        {
+            std::unique_ptr<DdsFile> pDdsFile = std::make_unique<DdsFile>();
+
+            HRESULT hr = pDdsFile->Open(bDds ? m_filePath : DdsFile::GetBakedPath(m_filePath));
+            if (SUCCEEDED(hr))
+            {
+                m_pDdsFile = std::move(pDdsFile);
+
+                return S_OK;
+            }
+
+            if (bDds)
+            {
+                return hr;
+            }
+
+            OutputDebugString(L"Error opening baked texture file of ");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L", decoding the image instead\n");
+        }
+
+        return decodeImage();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::decodeImage
+      Summary:  Decodes the image to RGBA8 pixels with WIC, scaling it
+                down if it is larger than the load options or Direct3D
+                allow
+      Modifies: [m_aPixels, m_uWidth, m_uHeight].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::decodeImage()
+    {
+        return DecodeImage(m_filePath, m_options.uMaxSize, m_aPixels, m_uWidth, m_uHeight);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::DecodeImage
+      Summary:  Decodes an image file to RGBA8 pixels with WIC, scaling
+                it down if it is larger than a maximum size or Direct3D
+                allow. Common formats are copied as decoded and
+                converted by PixelConverter, and oversized images are
+                scaled down with its Lanczos filter, both in bands of
+                rows on the shared thread pool; WIC only converts the
+                other formats. Touches no Direct3D object and
+                initializes COM for the calling thread if needed
+      Args:     const std::filesystem::path& filePath
+                  Path to the image
+                UINT uMaxSize
+                  Largest dimension, 0 for the device limit
+                std::vector<BYTE>& aOutPixels
+                  Receives the rows of pixels, without padding
+                UINT& uOutWidth
+                  Receives the width of the pixels
+                UINT& uOutHeight
+                  Receives the height of the pixels
+      Modifies: [aOutPixels, uOutWidth, uOutHeight].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::DecodeImage(
+        _In_ const std::filesystem::path& filePath,
+        _In_ UINT uMaxSize,
+        _Out_ std::vector<BYTE>& aOutPixels,
+        _Out_ UINT& uOutWidth,
+        _Out_ UINT& uOutHeight
+    )
+    {
+        // Worker threads have not initialized COM yet
+        HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        HRESULT hr = S_OK;
+
+        aOutPixels.clear();
+        uOutWidth = 0u;
+        uOutHeight = 0u;
+
+        {
+            ComPtr<IWICImagingFactory> factory;
+            hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(factory.GetAddressOf()));
+
+            ComPtr<IWICBitmapDecoder> decoder;
+            if (SUCCEEDED(hr))
+            {
+                hr = factory->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand,
+                    decoder.GetAddressOf());
+            }
+
+            ComPtr<IWICBitmapFrameDecode> frame;
+            if (SUCCEEDED(hr))
+            {
+                hr = decoder->GetFrame(0u, frame.GetAddressOf());
+            }
+
+            UINT uWidth = 0u;
+            UINT uHeight = 0u;
+            if (SUCCEEDED(hr))
+            {
+                hr = frame->GetSize(&uWidth, &uHeight);
+            }
+
+            WICPixelFormatGUID pixelFormat = GUID_WICPixelFormatUndefined;
+            if (SUCCEEDED(hr))
+            {
+                hr = frame->GetPixelFormat(&pixelFormat);
+            }
+
+            ComPtr<IWICBitmapSource> source = frame;
+            ePixelFormat format = ePixelFormat::RGBA8;
+
+            if (SUCCEEDED(hr) && !getPixelFormat(pixelFormat, format))
+            {
+                ComPtr<IWICFormatConverter> converter;
+                hr = factory->CreateFormatConverter(converter.GetAddressOf());
+                if (SUCCEEDED(hr))
+                {
+                    hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0,
+                        WICBitmapPaletteTypeCustom);
+                    source = converter;
+                }
+            }
+
+            std::vector<BYTE> aDecoded;
+            UINT uPitch = uWidth * PixelConverter::GetBytesPerPixel(format);
+            if (SUCCEEDED(hr))
+            {
+                aDecoded.resize(static_cast<size_t>(uPitch) * uHeight);
+                hr = source->CopyPixels(nullptr, uPitch, static_cast<UINT>(aDecoded.size()), aDecoded.data());
+            }
+
+            if (SUCCEEDED(hr))
+            {
+                ThreadPool& pool = ThreadPool::GetShared();
+                UINT uNumBands = (uHeight + DECODE_BAND_ROWS - 1u) / DECODE_BAND_ROWS;
+
+                std::vector<BYTE> aPixels;
+                if (format == ePixelFormat::RGBA8)
+                {
+                    aPixels = std::move(aDecoded);
+                }
+                else
+                {
+                    aPixels.resize(static_cast<size_t>(uWidth) * uHeight * 4u);
+
+                    pool.ParallelFor(uNumBands, [&](UINT i)
+                        {
+                            PixelConverter::ConvertRows(aDecoded.data(), uPitch, format, uWidth, uHeight, i * DECODE_BAND_ROWS,
+                                DECODE_BAND_ROWS, aPixels.data());
+                        });
+                }
+
+                UINT uLimit = uMaxSize > 0u
+                    ? (std::min)(uMaxSize, static_cast<UINT>(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION))
+                    : static_cast<UINT>(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+
+                if (uWidth > uLimit || uHeight > uLimit)
+                {
+                    FLOAT fRatio = static_cast<FLOAT>(uLimit) / static_cast<FLOAT>((std::max)(uWidth, uHeight));
+                    UINT uNewWidth = (std::max)(static_cast<UINT>(static_cast<FLOAT>(uWidth) * fRatio), 1u);
+                    UINT uNewHeight = (std::max)(static_cast<UINT>(static_cast<FLOAT>(uHeight) * fRatio), 1u);
+                    UINT uNumNewBands = (uNewHeight + DECODE_BAND_ROWS - 1u) / DECODE_BAND_ROWS;
+
+                    aOutPixels.resize(static_cast<size_t>(uNewWidth) * uNewHeight * 4u);
+
+                    // Pixels are filtered as stored, like the WIC scaler
+                    // did, since a texture does not know whether it holds
+                    // color
+                    pool.ParallelFor(uNumNewBands, [&](UINT i)
+                        {
+                            PixelConverter::ResizeRows(aPixels.data(), uWidth, uHeight, uNewWidth, uNewHeight, eResizeFilter::LANCZOS3,
+                                false, i * DECODE_BAND_ROWS, DECODE_BAND_ROWS, aOutPixels.data());
+                        });
+
+                    uWidth = uNewWidth;
+                    uHeight = uNewHeight;
+                }
+                else
+                {
+                    aOutPixels = std::move(aPixels);
+                }
+
+                uOutWidth = uWidth;
+                uOutHeight = uHeight;
+            }
+        }
+
+        if (SUCCEEDED(hrCom))
+        {
+            CoUninitialize();
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::createResources
+      Summary:  Creates the texture and its view from the decoded
+                pixels, generating the mip chain on the GPU when asked,
+                and frees the pixels. A DDS file keeps its own mips,
+                skipping the ones above the maximum size, and is
+                unmapped once uploaded
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to generate mips with, can be
+                  nullptr for a single level
+      Modifies: [m_textureRV, m_aPixels, m_pDdsFile, m_pStreamFile].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::createResources(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        BOOL bGenerateMips = m_options.bGenerateMips && pImmediateContext;
+
+        // A reloaded file replaces the one being streamed
+        waitForStream();
+        m_pStreamFile.reset();
+
+        if (m_pDdsFile && m_options.bStream && pImmediateContext)
+        {
+            HRESULT hr = createStreamedResources(pDevice, pImmediateContext);
+            if (hr != S_FALSE)
+            {
+                return hr;
+            }
+        }
+
+        if (m_pDdsFile)
+        {
+            // Mips are only generated for files with a single level
+            HRESULT hr = DirectX::CreateDDSTextureFromImageEx(pDevice, bGenerateMips ? pImmediateContext : nullptr,
+                m_pDdsFile->GetImage(), m_pDdsFile->GetSubresources(), m_options.uMaxSize, D3D11_USAGE_DEFAULT,
+                D3D11_BIND_SHADER_RESOURCE, 0u, 0u, false, nullptr, m_textureRV.ReleaseAndGetAddressOf());
+
+            m_pDdsFile.reset();
+
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+
+            // 2D textures are viewed as arrays like the other textures;
+            // 1D and volume textures keep the view of the loader
+            ComPtr<ID3D11Resource> resource;
+            m_textureRV->GetResource(resource.GetAddressOf());
+
+            ComPtr<ID3D11Texture2D> texture;
+            if (FAILED(resource.As(&texture)))
+            {
+                return S_OK;
+            }
+
+            D3D11_TEXTURE2D_DESC textureDesc;
+            texture->GetDesc(&textureDesc);
+
+            return TextureArray::CreateView(pDevice, texture.Get(), 0u, textureDesc.ArraySize,
+                m_textureRV.ReleaseAndGetAddressOf());
+        }
+
+        UINT uRowPitch = m_uWidth * 4u;
+
+        D3D11_TEXTURE2D_DESC textureDesc =
+        {
+            .Width = m_uWidth,
+            .Height = m_uHeight,
+            .MipLevels = bGenerateMips ? 0u : 1u,
+            .ArraySize = 1u,
+            .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
+            .SampleDesc = {.Count = 1u, .Quality = 0u },
+            .Usage = bGenerateMips ? D3D11_USAGE_DEFAULT : D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE | (bGenerateMips ? D3D11_BIND_RENDER_TARGET : 0u),
+            .CPUAccessFlags = 0u,
+            .MiscFlags = bGenerateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0u
+        };
+
+        D3D11_SUBRESOURCE_DATA initialData =
+        {
+            .pSysMem = m_aPixels.data(),
+            .SysMemPitch = uRowPitch,
+            .SysMemSlicePitch = static_cast<UINT>(m_aPixels.size())
+        };
+
+        ComPtr<ID3D11Texture2D> texture;
+        HRESULT hr = pDevice->CreateTexture2D(&textureDesc, bGenerateMips ? nullptr : &initialData, texture.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        hr = TextureArray::CreateView(pDevice, texture.Get(), 0u, 1u, m_textureRV.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        if (bGenerateMips)
+        {
+            pImmediateContext->UpdateSubresource(texture.Get(), 0u, nullptr, m_aPixels.data(), uRowPitch,
+                static_cast<UINT>(m_aPixels.size()));
+            pImmediateContext->GenerateMips(m_textureRV.Get());
+        }
+
+        m_aPixels.clear();
+        m_aPixels.shrink_to_fit();
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::createStreamedResources
+      Summary:  Creates the texture of a 2D DDS file with only its mip
+                tail resident and keeps the file mapped to stream the
+                finer mips from. Mips above the maximum size of the load
+                options are never streamed in
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to upload the tail with
+      Modifies: [m_pDdsFile, m_pStreamFile, m_uTopMip, m_uTailMip,
+                  m_uResidentMip, m_textureRV].
+      Returns:  HRESULT
+                  Status code, S_FALSE if the file is not worth
+                  streaming and is left to createResources
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::createStreamedResources(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        const DdsImage& image = m_pDdsFile->GetImage();
+
+        if (image.dimension != eDdsDimension::TEXTURE2D || image.uArraySize != 1u || image.bCubeMap || image.uMipLevels < 2u)
+        {
+            return S_FALSE;
+        }
+
+        UINT uMaxSize = m_options.uMaxSize > 0u
+            ? (std::min)(m_options.uMaxSize, static_cast<UINT>(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION))
+            : static_cast<UINT>(D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION);
+
+        UINT uTopMip = 0u;
+        while (uTopMip + 1u < image.uMipLevels && (std::max)(image.uWidth >> uTopMip, image.uHeight >> uTopMip) > uMaxSize)
+        {
+            ++uTopMip;
+        }
+
+        UINT uTailMip = uTopMip;
+        while (uTailMip + 1u < image.uMipLevels
+            && (std::max)(image.uWidth >> uTailMip, image.uHeight >> uTailMip) > STREAM_TAIL_SIZE)
+        {
+            ++uTailMip;
+        }
+
+        while (uTailMip > uTopMip && !isValidTopMip(image, uTailMip))
+        {
+            --uTailMip;
+        }
+
+        if (uTailMip <= uTopMip || !isValidTopMip(image, uTopMip))
+        {
+            return S_FALSE;
+        }
+
+        m_pStreamFile = std::move(m_pDdsFile);
+        m_uTopMip = uTopMip;
+        m_uTailMip = uTailMip;
+
+        // Nothing of the new file is resident yet
+        m_uResidentMip = m_pStreamFile->GetImage().uMipLevels;
+
+        HRESULT hr = resizeMips(pDevice, pImmediateContext, uTailMip);
+        if (FAILED(hr))
+        {
+            m_pStreamFile.reset();
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::resizeMips
+      Summary:  Recreates a streamed texture from a mip down. Mips that
+                were resident are copied from the current texture on
+                the GPU; the others are uploaded from the streamed
+                copies, or from the mapped file for the tail
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy and upload with
+                UINT uMip
+                  Most detailed mip of the new texture
+      Modifies: [m_textureRV, m_uResidentMip].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::resizeMips(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uMip)
+    {
+        const DdsImage& image = m_pStreamFile->GetImage();
+
+        D3D11_TEXTURE2D_DESC textureDesc =
+        {
+            .Width = (std::max)(image.uWidth >> uMip, 1u),
+            .Height = (std::max)(image.uHeight >> uMip, 1u),
+            .MipLevels = image.uMipLevels - uMip,
+            .ArraySize = 1u,
+            .Format = static_cast<DXGI_FORMAT>(image.format),
+            .SampleDesc = {.Count = 1u, .Quality = 0u },
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u
+        };
+
+        ComPtr<ID3D11Texture2D> texture;
+        HRESULT hr = pDevice->CreateTexture2D(&textureDesc, nullptr, texture.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        ComPtr<ID3D11Resource> residentTexture;
+        if (m_textureRV)
+        {
+            m_textureRV->GetResource(residentTexture.GetAddressOf());
+        }
+
+        for (UINT uLevel = uMip; uLevel < image.uMipLevels; ++uLevel)
+        {
+            if (residentTexture && uLevel >= m_uResidentMip)
+            {
+                pImmediateContext->CopySubresourceRegion(texture.Get(), uLevel - uMip, 0u, 0u, 0u, residentTexture.Get(),
+                    uLevel - m_uResidentMip, nullptr);
+                continue;
+            }
+
+            const DdsSubresource& subresource = m_pStreamFile->GetSubresource(uLevel, 0u);
+            const BYTE* pData = subresource.pData;
+
+            if (uLevel >= m_uStreamingMip && uLevel - m_uStreamingMip < m_aStreamedMips.size()
+                && !m_aStreamedMips[uLevel - m_uStreamingMip].empty())
+            {
+                pData = m_aStreamedMips[uLevel - m_uStreamingMip].data();
+            }
+
+            pImmediateContext->UpdateSubresource(texture.Get(), uLevel - uMip, nullptr, pData, subresource.uRowPitch,
+                subresource.uSlicePitch);
+        }
+
+        hr = TextureArray::CreateView(pDevice, texture.Get(), 0u, 1u, m_textureRV.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        m_uResidentMip = uMip;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::waitForStream
+      Summary:  Waits for a queued mip stream and drops its mips
+      Modifies: [m_streamResult, m_aStreamedMips].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Texture::waitForStream()
+    {
+        if (m_streamResult.valid())
+        {
+            m_streamResult.wait();
+            m_streamResult = std::shared_future<HRESULT>();
+        }
+
+        m_aStreamedMips.clear();
+        m_aStreamedMips.shrink_to_fit();
+    }
 }
\ No newline at end of file
@@ -9,27 +9,190 @@
 
 #include "Common.h"
 
+#include <future>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/DdsFile.h"
+#include "Texture/MipGenerator.h"
+
 namespace library
 {
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureLoadOptions
+      Summary:  How a texture file is turned into a texture. uMaxSize
+                limits the largest dimension, 0 for the device limit;
+                bGenerateMips builds the mip chain on the GPU; bStream
+                creates DDS files with only their small mips resident,
+                leaving the finer mips to TextureStreamer
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureLoadOptions
+    {
+        UINT uMaxSize = 0u;
+        BOOL bGenerateMips = TRUE;
+        BOOL bStream = TRUE;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureBakeOptions
+      Summary:  How the mip chain of a baked texture is filtered and
+                stored. bSrgb filters color in linear light, for color
+                textures such as diffuse maps; data textures are
+                filtered as is. format is R8G8B8A8_UNORM or a format
+                BlockCompressor encodes
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureBakeOptions
+    {
+        eMipFilter filter = eMipFilter::KAISER;
+        BOOL bSrgb = TRUE;
+        eDdsFormat format = eDdsFormat::R8G8B8A8_UNORM;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Texture
+      Summary:  2D texture loaded from an image file in two steps: the
+                file is decoded to RGBA8 pixels on the CPU, which is
+                thread safe and can run on the thread pool, and the
+                Direct3D resources are created from the pixels on the
+                device thread. DDS files skip the decode: they are
+                mapped and parsed on the pool instead, and the texture
+                is created straight from the mapped mips. An image with
+                an up to date baked DDS file next to it loads that file,
+                which holds the whole mip chain. A streamed DDS texture
+                starts with its mip tail, the mips of at most
+                STREAM_TAIL_SIZE texels, and stays mapped: finer mips
+                are copied out of the mapping on the shared thread pool,
+                then the texture is recreated with them on the device
+                thread, the resident mips being copied over on the GPU.
+                Mip indices are the levels of the file. The view is a
+                Texture2DArray view of one slice, which TextureArray
+                points into its array when the texture is packed
+      Methods:  BeginDecode
+                  Queues the decode on the shared thread pool
+                Initialize
+                  Waits for the decode and creates the texture
+                BeginReload
+                  Queues a new decode of the file on the shared thread
+                  pool
+                CommitReload
+                  Replaces the texture with the reloaded one
+                Bake
+                  Writes the baked DDS file of the image with its mip
+                  chain
+                IsDecoding
+                  Returns whether a queued decode is still running
+                IsStreamed
+                  Returns whether the mips are streamed
+                GetTopMip
+                  Returns the most detailed mip that can be resident
+                GetTailMip
+                  Returns the most detailed mip always resident
+                GetResidentMip
+                  Returns the most detailed mip resident
+                GetMipSize
+                  Returns the largest dimension of a mip
+                GetMipBytes
+                  Returns the size of the mips from a mip down
+                BeginStreamMips
+                  Queues the copy of finer mips out of the file
+                IsStreaming
+                  Returns whether mips are being streamed in
+                GetStreamingMip
+                  Returns the most detailed mip being streamed in
+                IsStreamReady
+                  Returns whether the streamed mips can be committed
+                CommitStreamedMips
+                  Makes the streamed mips resident
+                EvictMips
+                  Releases the mips finer than a mip
+                GetTextureResourceView
+                  Returns the shader resource view
+                GetSamplerState
+                  Returns the sampler state
+                GetFilePath
+                  Returns the path of the texture file
+                GetLoadOptions
+                  Returns the load options
+                DecodeImage
+                  Decodes an image file to RGBA8 pixels with WIC
+                Texture
+                  Constructor.
+                ~Texture
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Texture
     {
+    public:
+        // Largest dimension of the most detailed mip of the tail
+        static constexpr const UINT STREAM_TAIL_SIZE = 64u;
+
     public:
         Texture() = delete;
-        Texture(_In_ const std::filesystem::path& filePath);
+        Texture(_In_ const std::filesystem::path& filePath, _In_ const TextureLoadOptions& options = TextureLoadOptions());
         Texture(const Texture& other) = delete;
         Texture(Texture&& other) = delete;
         Texture& operator=(const Texture& other) = delete;
         Texture& operator=(Texture&& other) = delete;
-        virtual ~Texture() = default;
+        virtual ~Texture();
+
+        void BeginDecode();
 
         // Should be called once to load the texture
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
+        std::shared_future<HRESULT> BeginReload();
+        HRESULT CommitReload(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+
+        HRESULT Bake(_In_ const TextureBakeOptions& options = TextureBakeOptions());
+
+        BOOL IsDecoding() const;
+        BOOL IsStreamed() const;
+        UINT GetTopMip() const;
+        UINT GetTailMip() const;
+        UINT GetResidentMip() const;
+        UINT GetMipSize(_In_ UINT uMip) const;
+        UINT64 GetMipBytes(_In_ UINT uMip) const;
+        BOOL BeginStreamMips(_In_ UINT uMip);
+        BOOL IsStreaming() const;
+        UINT GetStreamingMip() const;
+        BOOL IsStreamReady() const;
+        HRESULT CommitStreamedMips(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT EvictMips(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uMip);
+
         ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
         ComPtr<ID3D11SamplerState>& GetSamplerState();
+        const std::filesystem::path& GetFilePath() const;
+        const TextureLoadOptions& GetLoadOptions() const;
+
+        static HRESULT DecodeImage(
+            _In_ const std::filesystem::path& filePath,
+            _In_ UINT uMaxSize,
+            _Out_ std::vector<BYTE>& aOutPixels,
+            _Out_ UINT& uOutWidth,
+            _Out_ UINT& uOutHeight
+        );
 
     private:
+        HRESULT decode();
+        HRESULT decodeImage();
+        HRESULT createResources(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT createStreamedResources(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        HRESULT resizeMips(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uMip);
+        void waitForStream();
+
         std::filesystem::path m_filePath;
+        TextureLoadOptions m_options;
+        std::shared_future<HRESULT> m_decodeResult;
+        std::vector<BYTE> m_aPixels;
+        std::unique_ptr<DdsFile> m_pDdsFile;
+        std::shared_ptr<DdsFile> m_pStreamFile;
+        std::shared_future<HRESULT> m_streamResult;
+        std::vector<std::vector<BYTE>> m_aStreamedMips;
+        UINT m_uTopMip;
+        UINT m_uTailMip;
+        UINT m_uResidentMip;
+        UINT m_uStreamingMip;
+        UINT m_uWidth;
+        UINT m_uHeight;
         ComPtr<ID3D11ShaderResourceView> m_textureRV;
         ComPtr<ID3D11SamplerState> m_samplerLinear;
     };
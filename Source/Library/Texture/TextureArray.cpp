@@ -0,0 +1,358 @@
+#include "Texture/TextureArray.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include "Texture/Material.h"
+
+namespace library
+{
+    namespace
+    {
+        // Textures are packed together when their slices can be copied
+        // into one array and sampled the same way
+        using ArrayKey = std::tuple<UINT, UINT, UINT, DXGI_FORMAT, ID3D11SamplerState*>;
+
+        // Finds the 2D texture and slice a texture view shows. Views of
+        // a single slice of all the mips can be packed
+        BOOL getViewSource(
+            _In_ ID3D11ShaderResourceView* pView,
+            _Out_ ComPtr<ID3D11Texture2D>& outTexture,
+            _Out_ D3D11_TEXTURE2D_DESC& outDesc,
+            _Out_ UINT& uOutSlice
+        )
+        {
+            outTexture.Reset();
+            outDesc = {};
+            uOutSlice = 0u;
+
+            if (!pView)
+            {
+                return FALSE;
+            }
+
+            D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+            pView->GetDesc(&viewDesc);
+
+            if (viewDesc.ViewDimension == D3D11_SRV_DIMENSION_TEXTURE2DARRAY)
+            {
+                if (viewDesc.Texture2DArray.MostDetailedMip != 0u || viewDesc.Texture2DArray.ArraySize != 1u)
+                {
+                    return FALSE;
+                }
+
+                uOutSlice = viewDesc.Texture2DArray.FirstArraySlice;
+            }
+            else if (viewDesc.ViewDimension != D3D11_SRV_DIMENSION_TEXTURE2D || viewDesc.Texture2D.MostDetailedMip != 0u)
+            {
+                return FALSE;
+            }
+
+            ComPtr<ID3D11Resource> resource;
+            pView->GetResource(resource.GetAddressOf());
+
+            if (FAILED(resource.As(&outTexture)))
+            {
+                return FALSE;
+            }
+
+            outTexture->GetDesc(&outDesc);
+
+            return outDesc.SampleDesc.Count == 1u && outDesc.Format == viewDesc.Format;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::TextureArray
+      Summary:  Constructor
+      Modifies: [m_textureRV, m_samplerState, m_uNumSlices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureArray::TextureArray() :
+        m_textureRV(nullptr),
+        m_samplerState(nullptr),
+        m_uNumSlices(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::Initialize
+      Summary:  Creates an array with one slice per texture and copies
+                every mip of the textures into their slice on the GPU.
+                The textures must have the same size, mips, format and
+                sampler. Once every copy is recorded, each texture's
+                view is replaced by a view of its slice, which releases
+                the texture's own resource
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the array
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the textures with
+                const std::vector<std::shared_ptr<Texture>>& aTextures
+                  Initialized textures, in the order of the slices
+      Modifies: [m_textureRV, m_samplerState, m_uNumSlices].
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the textures cannot be
+                  packed together
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureArray::Initialize(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::vector<std::shared_ptr<Texture>>& aTextures
+    )
+    {
+        if (aTextures.empty() || aTextures.size() > MAX_SLICES)
+        {
+            return E_INVALIDARG;
+        }
+
+        UINT uNumSlices = static_cast<UINT>(aTextures.size());
+
+        std::vector<ComPtr<ID3D11Texture2D>> aSources(uNumSlices);
+        std::vector<UINT> aSourceSlices(uNumSlices);
+        D3D11_TEXTURE2D_DESC textureDesc = {};
+
+        for (UINT i = 0u; i < uNumSlices; ++i)
+        {
+            D3D11_TEXTURE2D_DESC sourceDesc;
+            if (!getViewSource(aTextures[i]->GetTextureResourceView().Get(), aSources[i], sourceDesc, aSourceSlices[i]))
+            {
+                return E_INVALIDARG;
+            }
+
+            if (i == 0u)
+            {
+                textureDesc = sourceDesc;
+            }
+            else if (sourceDesc.Width != textureDesc.Width || sourceDesc.Height != textureDesc.Height
+                || sourceDesc.MipLevels != textureDesc.MipLevels || sourceDesc.Format != textureDesc.Format
+                || aTextures[i]->GetSamplerState() != aTextures[0]->GetSamplerState())
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        textureDesc.ArraySize = uNumSlices;
+        textureDesc.Usage = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        textureDesc.CPUAccessFlags = 0u;
+        textureDesc.MiscFlags = 0u;
+
+        ComPtr<ID3D11Texture2D> texture;
+        HRESULT hr = pDevice->CreateTexture2D(&textureDesc, nullptr, texture.GetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        for (UINT i = 0u; i < uNumSlices; ++i)
+        {
+            for (UINT uMip = 0u; uMip < textureDesc.MipLevels; ++uMip)
+            {
+                pImmediateContext->CopySubresourceRegion(texture.Get(),
+                    D3D11CalcSubresource(uMip, i, textureDesc.MipLevels), 0u, 0u, 0u, aSources[i].Get(),
+                    D3D11CalcSubresource(uMip, aSourceSlices[i], textureDesc.MipLevels), nullptr);
+            }
+        }
+
+        std::vector<ComPtr<ID3D11ShaderResourceView>> aSliceViews(uNumSlices);
+
+        for (UINT i = 0u; i < uNumSlices; ++i)
+        {
+            hr = CreateView(pDevice, texture.Get(), i, 1u, aSliceViews[i].GetAddressOf());
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        hr = CreateView(pDevice, texture.Get(), 0u, uNumSlices, m_textureRV.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        for (UINT i = 0u; i < uNumSlices; ++i)
+        {
+            aTextures[i]->GetTextureResourceView() = std::move(aSliceViews[i]);
+        }
+
+        m_samplerState = aTextures[0]->GetSamplerState();
+        m_uNumSlices = uNumSlices;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::GetTextureResourceView
+      Summary:  Returns the shader resource view of every slice
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& TextureArray::GetTextureResourceView()
+    {
+        return m_textureRV;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::GetSamplerState
+      Summary:  Returns the sampler state shared by the textures
+      Returns:  ComPtr<ID3D11SamplerState>&
+                  Sampler state
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11SamplerState>& TextureArray::GetSamplerState()
+    {
+        return m_samplerState;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::GetNumSlices
+      Summary:  Returns the number of slices
+      Returns:  UINT
+                  Number of packed textures
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureArray::GetNumSlices() const
+    {
+        return m_uNumSlices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::CreateView
+      Summary:  Creates a Texture2DArray view of every mip of a range
+                of slices of a 2D texture. A texture with a single slice
+                is viewed as an array of one
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the view
+                ID3D11Texture2D* pTexture
+                  Texture to view
+                UINT uFirstSlice
+                  First slice of the view
+                UINT uNumSlices
+                  Number of slices of the view
+                ID3D11ShaderResourceView** ppView
+                  Receives the view
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureArray::CreateView(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11Texture2D* pTexture,
+        _In_ UINT uFirstSlice,
+        _In_ UINT uNumSlices,
+        _Out_ ID3D11ShaderResourceView** ppView
+    )
+    {
+        D3D11_TEXTURE2D_DESC textureDesc;
+        pTexture->GetDesc(&textureDesc);
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc =
+        {
+            .Format = textureDesc.Format,
+            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY,
+            .Texture2DArray =
+            {
+                .MostDetailedMip = 0u,
+                .MipLevels = static_cast<UINT>(-1),
+                .FirstArraySlice = uFirstSlice,
+                .ArraySize = uNumSlices
+            }
+        };
+
+        return pDevice->CreateShaderResourceView(pTexture, &srvDesc, ppView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::Pack
+      Summary:  Groups the diffuse textures of the materials by size,
+                mips, format and sampler, and packs every group of at
+                least MIN_SLICES textures into arrays of at most
+                MAX_SLICES slices. Each material then references the
+                array and slice of its texture; the others reference no
+                array. Packing again, after textures are reloaded,
+                copies the packed slices into new arrays. Streamed
+                textures are skipped, as their resident mips change;
+                Model loads diffuse textures unstreamed for this
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the arrays
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the textures with
+                const std::vector<Material*>& apMaterials
+                  Materials with initialized textures
+      Modifies: [apMaterials].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureArray::Pack(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::vector<Material*>& apMaterials
+    )
+    {
+        std::map<ArrayKey, std::vector<std::shared_ptr<Texture>>> groups;
+        std::unordered_set<Texture*> visited;
+
+        for (Material* pMaterial : apMaterials)
+        {
+            pMaterial->pDiffuseArray.reset();
+            pMaterial->uDiffuseSlice = 0u;
+
+            const std::shared_ptr<Texture>& pTexture = pMaterial->pDiffuse;
+            if (!pTexture || pTexture->IsStreamed() || !visited.insert(pTexture.get()).second)
+            {
+                continue;
+            }
+
+            ComPtr<ID3D11Texture2D> texture;
+            D3D11_TEXTURE2D_DESC textureDesc;
+            UINT uSlice;
+            if (!getViewSource(pTexture->GetTextureResourceView().Get(), texture, textureDesc, uSlice))
+            {
+                continue;
+            }
+
+            groups[ArrayKey(textureDesc.Width, textureDesc.Height, textureDesc.MipLevels, textureDesc.Format,
+                pTexture->GetSamplerState().Get())].push_back(pTexture);
+        }
+
+        std::unordered_map<Texture*, std::pair<std::shared_ptr<TextureArray>, UINT>> slices;
+
+        for (const auto& [key, aTextures] : groups)
+        {
+            for (size_t uFirst = 0u; uFirst < aTextures.size(); uFirst += MAX_SLICES)
+            {
+                size_t uCount = (std::min)(aTextures.size() - uFirst, static_cast<size_t>(MAX_SLICES));
+                if (uCount < MIN_SLICES)
+                {
+                    break;
+                }
+
+                std::vector<std::shared_ptr<Texture>> aSliceTextures(aTextures.begin() + uFirst,
+                    aTextures.begin() + uFirst + uCount);
+
+                std::shared_ptr<TextureArray> pArray = std::make_shared<TextureArray>();
+
+                HRESULT hr = pArray->Initialize(pDevice, pImmediateContext, aSliceTextures);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+
+                for (UINT i = 0u; i < static_cast<UINT>(uCount); ++i)
+                {
+                    slices[aSliceTextures[i].get()] = std::make_pair(pArray, i);
+                }
+            }
+        }
+
+        for (Material* pMaterial : apMaterials)
+        {
+            auto it = slices.find(pMaterial->pDiffuse.get());
+            if (it != slices.end())
+            {
+                pMaterial->pDiffuseArray = it->second.first;
+                pMaterial->uDiffuseSlice = it->second.second;
+            }
+        }
+
+        return S_OK;
+    }
+}
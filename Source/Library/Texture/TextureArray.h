@@ -0,0 +1,92 @@
+/*+===================================================================
+  File:      TEXTUREARRAY.H
+  Summary:   TextureArray header file contains declarations of
+             TextureArray class used to pack textures of the same size
+             and format into one texture array.
+  Classes: TextureArray
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/Texture.h"
+
+namespace library
+{
+    class Material;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureArray
+      Summary:  Texture2DArray holding one slice per texture, so draws
+                of materials with different textures bind the same view
+                and sampler, and only the slice changes. Textures are
+                copied into their slice on the GPU, and each texture's
+                own view is then pointed at its slice, so the texture
+                is not held twice in memory. Every texture view is a
+                Texture2DArray view, so shaders sample any texture at a
+                slice, 0 for a texture that is not packed. Streamed
+                textures are never packed: their resources are recreated
+                as their mips change
+      Methods:  Initialize
+                  Copies textures into the slices of a new array
+                GetTextureResourceView
+                  Returns the shader resource view of the array
+                GetSamplerState
+                  Returns the sampler state of the textures
+                GetNumSlices
+                  Returns the number of slices
+                CreateView
+                  Creates a Texture2DArray view of a 2D texture
+                Pack
+                  Packs the diffuse textures of materials into arrays
+                TextureArray
+                  Constructor.
+                ~TextureArray
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureArray final
+    {
+    public:
+        static constexpr const UINT MAX_SLICES = D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION;
+
+        // Textures alone in their group keep their own resource
+        static constexpr const UINT MIN_SLICES = 2u;
+
+    public:
+        TextureArray();
+        TextureArray(const TextureArray& other) = delete;
+        TextureArray(TextureArray&& other) = delete;
+        TextureArray& operator=(const TextureArray& other) = delete;
+        TextureArray& operator=(TextureArray&& other) = delete;
+        ~TextureArray() = default;
+
+        HRESULT Initialize(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::vector<std::shared_ptr<Texture>>& aTextures
+        );
+
+        ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
+        ComPtr<ID3D11SamplerState>& GetSamplerState();
+        UINT GetNumSlices() const;
+
+        static HRESULT CreateView(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11Texture2D* pTexture,
+            _In_ UINT uFirstSlice,
+            _In_ UINT uNumSlices,
+            _Out_ ID3D11ShaderResourceView** ppView
+        );
+        static HRESULT Pack(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::vector<Material*>& apMaterials
+        );
+
+    private:
+        ComPtr<ID3D11ShaderResourceView> m_textureRV;
+        ComPtr<ID3D11SamplerState> m_samplerState;
+        UINT m_uNumSlices;
+    };
+}
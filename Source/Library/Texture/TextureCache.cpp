@@ -0,0 +1,187 @@
+#include "Texture/TextureCache.h"
+
+#include <cwctype>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::TextureCache
+      Summary:  Constructor
+      Modifies: [m_textures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCache::TextureCache() :
+        m_textures(),
+        m_mutex()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::RequestTexture
+      Summary:  Returns the texture of a file. A texture still used
+                elsewhere is shared, otherwise a new texture is created
+                and its decode is queued on the thread pool right away.
+                Call Initialize on the device thread before using it.
+                Failed textures are not kept by their users, so they
+                expire and load again next time
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureLoadOptions& options
+                  Options to load the texture with
+      Modifies: [m_textures].
+      Returns:  std::shared_ptr<Texture>
+                  Shared texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::shared_ptr<Texture> TextureCache::RequestTexture(
+        _In_ const std::filesystem::path& filePath,
+        _In_ const TextureLoadOptions& options
+    )
+    {
+        std::wstring szKey = makeKey(filePath, options);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::weak_ptr<Texture>& entry = m_textures[szKey];
+
+        std::shared_ptr<Texture> pTexture = entry.lock();
+        if (!pTexture)
+        {
+            pTexture = std::make_shared<Texture>(filePath, options);
+            pTexture->BeginDecode();
+            entry = pTexture;
+        }
+
+        return pTexture;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetTexture
+      Summary:  Returns the texture of a file, initialized. Must be
+                called on the device thread
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the texture
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to generate mips with
+                const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureLoadOptions& options
+                  Options to load the texture with
+                std::shared_ptr<Texture>& pOutTexture
+                  Receives the texture, nullptr on failure
+      Modifies: [m_textures].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureCache::GetTexture(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::filesystem::path& filePath,
+        _In_ const TextureLoadOptions& options,
+        _Out_ std::shared_ptr<Texture>& pOutTexture
+    )
+    {
+        pOutTexture = RequestTexture(filePath, options);
+
+        HRESULT hr = pOutTexture->Initialize(pDevice, pImmediateContext);
+        if (FAILED(hr))
+        {
+            pOutTexture.reset();
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetNumTextures
+      Summary:  Drops the entries of released textures and returns the
+                number of textures still alive
+      Modifies: [m_textures].
+      Returns:  UINT
+                  Number of textures
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureCache::GetNumTextures()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::erase_if(m_textures, [](const auto& entry)
+            {
+                return entry.second.expired();
+            });
+
+        return static_cast<UINT>(m_textures.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetTextures
+      Summary:  Returns the textures still alive, such as to reload the
+                ones whose file changed
+      Args:     std::vector<std::shared_ptr<Texture>>& aOutTextures
+                  Receives the textures
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureCache::GetTextures(_Out_ std::vector<std::shared_ptr<Texture>>& aOutTextures)
+    {
+        aOutTextures.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        aOutTextures.reserve(m_textures.size());
+        for (const auto& [szKey, entry] : m_textures)
+        {
+            if (std::shared_ptr<Texture> pTexture = entry.lock())
+            {
+                aOutTextures.push_back(std::move(pTexture));
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::GetShared
+      Summary:  Returns the cache shared by every model, created on
+                first use
+      Returns:  TextureCache&
+                  Shared texture cache
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureCache& TextureCache::GetShared()
+    {
+        static TextureCache s_textureCache;
+
+        return s_textureCache;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureCache::makeKey
+      Summary:  Builds the cache key of a texture. Paths are made
+                absolute, normalized and lower case, as Windows paths
+                are case insensitive, so "a/../B.png" and "b.png" from
+                the same directory share a texture
+      Args:     const std::filesystem::path& filePath
+                  Path to the texture
+                const TextureLoadOptions& options
+                  Options to load the texture with
+      Returns:  std::wstring
+                  Cache key
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::wstring TextureCache::makeKey(
+        _In_ const std::filesystem::path& filePath,
+        _In_ const TextureLoadOptions& options
+    )
+    {
+        std::error_code error;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, error);
+        if (error)
+        {
+            canonicalPath = std::filesystem::absolute(filePath, error).lexically_normal();
+        }
+
+        std::wstring szKey = canonicalPath.wstring();
+
+        for (WCHAR& c : szKey)
+        {
+            c = static_cast<WCHAR>(std::towlower(c));
+        }
+
+        szKey += L'|' + std::to_wstring(options.uMaxSize) + L'|' + std::to_wstring(options.bGenerateMips) + L'|'
+            + std::to_wstring(options.bStream);
+
+        return szKey;
+    }
+}
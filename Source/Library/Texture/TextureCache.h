@@ -0,0 +1,76 @@
+/*+===================================================================
+  File:      TEXTURECACHE.H
+  Summary:   TextureCache header file contains declarations of
+             TextureCache class used to share loaded textures between
+             models and materials.
+  Classes: TextureCache
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+
+#include "Texture/Texture.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureCache
+      Summary:  Loads every texture once per canonical path and load
+                options. The cache only keeps weak references, so a
+                texture is released with the last material using it
+                and loaded again if it is requested later
+      Methods:  RequestTexture
+                  Returns the texture of a file, queuing its decode on
+                  first use
+                GetTexture
+                  Returns the initialized texture of a file
+                GetNumTextures
+                  Returns the number of textures still alive
+                GetTextures
+                  Returns the textures still alive
+                GetShared
+                  Returns the cache shared by the models
+                TextureCache
+                  Constructor.
+                ~TextureCache
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureCache final
+    {
+    public:
+        TextureCache();
+        TextureCache(const TextureCache& other) = delete;
+        TextureCache(TextureCache&& other) = delete;
+        TextureCache& operator=(const TextureCache& other) = delete;
+        TextureCache& operator=(TextureCache&& other) = delete;
+        ~TextureCache() = default;
+
+        std::shared_ptr<Texture> RequestTexture(
+            _In_ const std::filesystem::path& filePath,
+            _In_ const TextureLoadOptions& options
+        );
+        HRESULT GetTexture(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::filesystem::path& filePath,
+            _In_ const TextureLoadOptions& options,
+            _Out_ std::shared_ptr<Texture>& pOutTexture
+        );
+        UINT GetNumTextures();
+        void GetTextures(_Out_ std::vector<std::shared_ptr<Texture>>& aOutTextures);
+
+        static TextureCache& GetShared();
+
+    private:
+        static std::wstring makeKey(
+            _In_ const std::filesystem::path& filePath,
+            _In_ const TextureLoadOptions& options
+        );
+
+        std::unordered_map<std::wstring, std::weak_ptr<Texture>> m_textures;
+        std::mutex m_mutex;
+    };
+}
@@ -0,0 +1,366 @@
+#include "Texture/TextureStreamer.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::TextureStreamer
+      Summary:  Constructor
+      Modifies: [m_textures, m_aCandidates, m_uFrame, m_uMemoryBudget,
+                  m_uUploadBudget, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureStreamer::TextureStreamer() :
+        m_textures(),
+        m_aCandidates(),
+        m_uFrame(1u),
+        m_uMemoryBudget(DEFAULT_MEMORY_BUDGET),
+        m_uUploadBudget(DEFAULT_UPLOAD_BUDGET),
+        m_stats()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::SetMemoryBudget
+      Summary:  Sets the memory the streamed textures can take. Mip
+                tails are always resident, so the streamed textures can
+                go over a budget smaller than their tails
+      Args:     UINT64 uBytes
+                  Budget in bytes
+      Modifies: [m_uMemoryBudget].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::SetMemoryBudget(_In_ UINT64 uBytes)
+    {
+        m_uMemoryBudget = uBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetMemoryBudget
+      Summary:  Returns the memory the streamed textures can take
+      Returns:  UINT64
+                  Budget in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 TextureStreamer::GetMemoryBudget() const
+    {
+        return m_uMemoryBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::SetUploadBudget
+      Summary:  Sets the bytes of streamed mips made resident per
+                frame, which bounds the hitch of an update
+      Args:     UINT64 uBytes
+                  Budget in bytes
+      Modifies: [m_uUploadBudget].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::SetUploadBudget(_In_ UINT64 uBytes)
+    {
+        m_uUploadBudget = uBytes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetUploadBudget
+      Summary:  Returns the bytes of streamed mips made resident per
+                frame
+      Returns:  UINT64
+                  Budget in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 TextureStreamer::GetUploadBudget() const
+    {
+        return m_uUploadBudget;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::RequestTexture
+      Summary:  Records that a texture is drawn this frame over a size
+                on screen. A texture drawn several times needs the mip
+                of its largest size. Textures that are not streamed are
+                ignored
+      Args:     const std::shared_ptr<Texture>& pTexture
+                  Drawn texture, can be nullptr
+                FLOAT fScreenSize
+                  Pixels the texture covers across on screen
+      Modifies: [m_textures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::RequestTexture(_In_ const std::shared_ptr<Texture>& pTexture, _In_ FLOAT fScreenSize)
+    {
+        if (!pTexture || !pTexture->IsStreamed())
+        {
+            return;
+        }
+
+        UINT uMip = std::clamp(ComputeMip(pTexture->GetMipSize(0u), fScreenSize), pTexture->GetTopMip(), pTexture->GetTailMip());
+
+        StreamedTexture& entry = m_textures[pTexture.get()];
+
+        // A new texture can take the address of a released one
+        if (entry.pTexture.lock() != pTexture)
+        {
+            entry = StreamedTexture
+            {
+                .pTexture = pTexture,
+                .uWantedMip = uMip,
+                .uLastUsedFrame = m_uFrame
+            };
+
+            return;
+        }
+
+        if (entry.uLastUsedFrame != m_uFrame)
+        {
+            entry.uWantedMip = uMip;
+            entry.uLastUsedFrame = m_uFrame;
+        }
+        else
+        {
+            entry.uWantedMip = (std::min)(entry.uWantedMip, uMip);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::Update
+      Summary:  Ends the frame of requests. Finished streams are made
+                resident, most recently drawn first, until the upload
+                budget is spent; the first one always is, so a mip
+                larger than the budget is not starved. Then the textures
+                drawn this frame that miss mips queue a stream, the
+                largest gap first, as many mips at once as fit in the
+                upload budget, making room in the memory budget first.
+                Must be called on the device thread, before the draws
+                read the views of the textures
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the textures
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the mips with
+      Modifies: [m_textures, m_aCandidates, m_uFrame, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TextureStreamer::Update(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        m_stats = TextureStreamingStats();
+        m_aCandidates.clear();
+
+        for (auto it = m_textures.begin(); it != m_textures.end();)
+        {
+            std::shared_ptr<Texture> pTexture = it->second.pTexture.lock();
+
+            // A reloaded file may not be streamed anymore
+            if (!pTexture || !pTexture->IsStreamed())
+            {
+                it = m_textures.erase(it);
+                continue;
+            }
+
+            m_stats.uResidentBytes += pTexture->GetMipBytes(pTexture->GetStreamingMip());
+
+            if (pTexture->IsStreaming())
+            {
+                ++m_stats.uNumStreaming;
+
+                if (pTexture->IsStreamReady())
+                {
+                    m_aCandidates.emplace_back(std::move(pTexture), &it->second);
+                }
+            }
+
+            ++it;
+        }
+
+        m_stats.uNumTextures = static_cast<UINT>(m_textures.size());
+
+        std::sort(m_aCandidates.begin(), m_aCandidates.end(), [](const auto& a, const auto& b)
+            {
+                return a.second->uLastUsedFrame > b.second->uLastUsedFrame;
+            });
+
+        for (const auto& [pTexture, pEntry] : m_aCandidates)
+        {
+            UINT64 uBytes = pTexture->GetMipBytes(pTexture->GetStreamingMip()) - pTexture->GetMipBytes(pTexture->GetResidentMip());
+
+            if (m_stats.uUploadedBytes > 0u && m_stats.uUploadedBytes + uBytes > m_uUploadBudget)
+            {
+                break;
+            }
+
+            HRESULT hr = pTexture->CommitStreamedMips(pDevice, pImmediateContext);
+            --m_stats.uNumStreaming;
+
+            if (FAILED(hr))
+            {
+                OutputDebugString(L"Error streaming mips of ");
+                OutputDebugString(pTexture->GetFilePath().c_str());
+                OutputDebugString(L"\n");
+
+                m_stats.uResidentBytes -= uBytes;
+                continue;
+            }
+
+            m_stats.uUploadedBytes += uBytes;
+            ++m_stats.uNumCommitted;
+        }
+
+        m_aCandidates.clear();
+
+        for (auto& [pKey, entry] : m_textures)
+        {
+            if (entry.uLastUsedFrame != m_uFrame)
+            {
+                continue;
+            }
+
+            std::shared_ptr<Texture> pTexture = entry.pTexture.lock();
+            if (pTexture && !pTexture->IsStreaming() && entry.uWantedMip < pTexture->GetResidentMip())
+            {
+                m_aCandidates.emplace_back(std::move(pTexture), &entry);
+            }
+        }
+
+        std::sort(m_aCandidates.begin(), m_aCandidates.end(), [](const auto& a, const auto& b)
+            {
+                return a.first->GetResidentMip() - a.second->uWantedMip > b.first->GetResidentMip() - b.second->uWantedMip;
+            });
+
+        for (const auto& [pTexture, pEntry] : m_aCandidates)
+        {
+            if (m_stats.uNumStreaming >= MAX_STREAMS_IN_FLIGHT)
+            {
+                break;
+            }
+
+            UINT uResidentMip = pTexture->GetResidentMip();
+            UINT64 uResidentBytes = pTexture->GetMipBytes(uResidentMip);
+
+            // Finest mip that one frame of uploads commits, at least the
+            // next one
+            UINT uMip = uResidentMip - 1u;
+            while (uMip > pEntry->uWantedMip && pTexture->GetMipBytes(uMip - 1u) - uResidentBytes <= m_uUploadBudget)
+            {
+                --uMip;
+            }
+
+            UINT64 uBytes = pTexture->GetMipBytes(uMip) - uResidentBytes;
+
+            if (m_stats.uResidentBytes + uBytes > m_uMemoryBudget
+                && !makeRoom(pDevice, pImmediateContext, uBytes, pTexture.get()))
+            {
+                continue;
+            }
+
+            if (pTexture->BeginStreamMips(uMip))
+            {
+                m_stats.uResidentBytes += pTexture->GetMipBytes(pTexture->GetStreamingMip()) - uResidentBytes;
+                ++m_stats.uNumStreaming;
+            }
+        }
+
+        m_aCandidates.clear();
+
+        ++m_uFrame;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::GetStats
+      Summary:  Returns the counters of the last update
+      Returns:  const TextureStreamingStats&
+                  Counters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TextureStreamingStats& TextureStreamer::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::ComputeMip
+      Summary:  Returns the least detailed mip of a texture that still
+                has a texel for every pixel it covers on screen
+      Args:     UINT uSize
+                  Largest dimension of the most detailed mip
+                FLOAT fScreenSize
+                  Pixels the texture covers across on screen
+      Returns:  UINT
+                  Mip index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT TextureStreamer::ComputeMip(_In_ UINT uSize, _In_ FLOAT fScreenSize)
+    {
+        UINT uMip = 0u;
+
+        while ((uSize >> (uMip + 1u)) > 0u && static_cast<FLOAT>(uSize >> (uMip + 1u)) >= fScreenSize)
+        {
+            ++uMip;
+        }
+
+        return uMip;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureStreamer::makeRoom
+      Summary:  Evicts mips until more bytes fit in the memory budget.
+                Textures are evicted least recently drawn first: the
+                ones not drawn this frame down to their tail, the ones
+                drawn down to the mip they need. Textures being streamed
+                are left alone
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the textures
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the mips with
+                UINT64 uBytes
+                  Bytes to make room for
+                const Texture* pKeptTexture
+                  Texture the room is made for, never evicted
+      Modifies: [m_stats].
+      Returns:  BOOL
+                  TRUE if the bytes fit in the budget
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TextureStreamer::makeRoom(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ UINT64 uBytes,
+        _In_ const Texture* pKeptTexture
+    )
+    {
+        std::vector<std::tuple<UINT64, UINT, std::shared_ptr<Texture>>> aEvictable;
+
+        for (const auto& [pKey, entry] : m_textures)
+        {
+            std::shared_ptr<Texture> pTexture = entry.pTexture.lock();
+            if (!pTexture || pTexture.get() == pKeptTexture || pTexture->IsStreaming())
+            {
+                continue;
+            }
+
+            UINT uKeptMip = entry.uLastUsedFrame == m_uFrame ? entry.uWantedMip : pTexture->GetTailMip();
+            if (pTexture->GetResidentMip() < uKeptMip)
+            {
+                aEvictable.emplace_back(entry.uLastUsedFrame, uKeptMip, std::move(pTexture));
+            }
+        }
+
+        std::sort(aEvictable.begin(), aEvictable.end(), [](const auto& a, const auto& b)
+            {
+                return std::get<0>(a) < std::get<0>(b);
+            });
+
+        for (const auto& [uLastUsedFrame, uKeptMip, pTexture] : aEvictable)
+        {
+            if (m_stats.uResidentBytes + uBytes <= m_uMemoryBudget)
+            {
+                break;
+            }
+
+            UINT64 uBefore = pTexture->GetMipBytes(pTexture->GetResidentMip());
+            if (FAILED(pTexture->EvictMips(pDevice, pImmediateContext, uKeptMip)))
+            {
+                continue;
+            }
+
+            UINT64 uAfter = pTexture->GetMipBytes(pTexture->GetResidentMip());
+            if (uAfter < uBefore)
+            {
+                m_stats.uResidentBytes -= uBefore - uAfter;
+                ++m_stats.uNumEvicted;
+            }
+        }
+
+        return m_stats.uResidentBytes + uBytes <= m_uMemoryBudget;
+    }
+}
@@ -0,0 +1,117 @@
+/*+===================================================================
+  File:      TEXTURESTREAMER.H
+  Summary:   TextureStreamer header file contains declarations of
+             TextureStreamer class used to stream the mips of textures
+             in and out as they are needed on screen.
+  Classes: TextureStreamer
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/Texture.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TextureStreamingStats
+      Summary:  Counters of the last update of the streamer.
+                uResidentBytes is the memory of the streamed textures
+                drawn at least once, mips being streamed in included
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TextureStreamingStats
+    {
+        UINT uNumTextures;
+        UINT uNumStreaming;
+        UINT uNumCommitted;
+        UINT uNumEvicted;
+        UINT64 uResidentBytes;
+        UINT64 uUploadedBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureStreamer
+      Summary:  Streams the mips of streamed textures from the feedback
+                of the renderer. Every frame, each drawn texture is
+                requested with the pixels it covers on screen, which
+                gives the mip it needs. Update then makes the streamed
+                mips resident, no more bytes per frame than the upload
+                budget, and queues the streams of the textures missing
+                mips on the thread pool. When resident and queued mips
+                would go over the memory budget, the least recently
+                drawn textures are evicted down to their tail first,
+                then the ones holding finer mips than they need
+      Methods:  SetMemoryBudget
+                  Sets the memory the streamed textures can take
+                GetMemoryBudget
+                  Returns the memory budget
+                SetUploadBudget
+                  Sets the bytes of mips made resident per frame
+                GetUploadBudget
+                  Returns the upload budget
+                RequestTexture
+                  Records the mip a texture needs this frame
+                Update
+                  Commits, queues and evicts mips
+                GetStats
+                  Returns the counters of the last update
+                ComputeMip
+                  Returns the mip of a texture that covers a size on
+                  screen
+                TextureStreamer
+                  Constructor.
+                ~TextureStreamer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureStreamer final
+    {
+    public:
+        static constexpr const UINT64 DEFAULT_MEMORY_BUDGET = 256ull * 1024ull * 1024ull;
+        static constexpr const UINT64 DEFAULT_UPLOAD_BUDGET = 8ull * 1024ull * 1024ull;
+        static constexpr const UINT MAX_STREAMS_IN_FLIGHT = 8u;
+
+    public:
+        TextureStreamer();
+        TextureStreamer(const TextureStreamer& other) = delete;
+        TextureStreamer(TextureStreamer&& other) = delete;
+        TextureStreamer& operator=(const TextureStreamer& other) = delete;
+        TextureStreamer& operator=(TextureStreamer&& other) = delete;
+        ~TextureStreamer() = default;
+
+        void SetMemoryBudget(_In_ UINT64 uBytes);
+        UINT64 GetMemoryBudget() const;
+        void SetUploadBudget(_In_ UINT64 uBytes);
+        UINT64 GetUploadBudget() const;
+
+        void RequestTexture(_In_ const std::shared_ptr<Texture>& pTexture, _In_ FLOAT fScreenSize);
+        void Update(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        const TextureStreamingStats& GetStats() const;
+
+        static UINT ComputeMip(_In_ UINT uSize, _In_ FLOAT fScreenSize);
+
+    private:
+        // A texture drawn at least once, with the mip it needed the last
+        // frame it was drawn
+        struct StreamedTexture
+        {
+            std::weak_ptr<Texture> pTexture;
+            UINT uWantedMip;
+            UINT64 uLastUsedFrame;
+        };
+
+        BOOL makeRoom(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ UINT64 uBytes,
+            _In_ const Texture* pKeptTexture
+        );
+
+        std::unordered_map<Texture*, StreamedTexture> m_textures;
+        std::vector<std::pair<std::shared_ptr<Texture>, StreamedTexture*>> m_aCandidates;
+        UINT64 m_uFrame;
+        UINT64 m_uMemoryBudget;
+        UINT64 m_uUploadBudget;
+        TextureStreamingStats m_stats;
+    };
+}
@@ -0,0 +1,334 @@
+#include "Thread/AssetWatcher.h"
+
+#include <cwctype>
+
+namespace library
+{
+    namespace
+    {
+        // The stop and wake events take the first two wait slots
+        constexpr const UINT MAX_NOTIFICATIONS = MAXIMUM_WAIT_OBJECTS - 2u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::AssetWatcher
+      Summary:  Constructor
+      Modifies: [m_files, m_aDirectories, m_aChangedFiles, m_thread,
+                 m_hStopEvent, m_hWakeEvent, m_dwPollIntervalMs].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetWatcher::AssetWatcher() :
+        m_files(),
+        m_aDirectories(),
+        m_aChangedFiles(),
+        m_mutex(),
+        m_thread(),
+        m_hStopEvent(nullptr),
+        m_hWakeEvent(nullptr),
+        m_dwPollIntervalMs(DEFAULT_POLL_INTERVAL_MS)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::~AssetWatcher
+      Summary:  Destructor. Stops the watching thread and closes the
+                notification handles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetWatcher::~AssetWatcher()
+    {
+        Stop();
+
+        for (WatchedDirectory& directory : m_aDirectories)
+        {
+            if (directory.hNotification)
+            {
+                FindCloseChangeNotification(directory.hNotification);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::Start
+      Summary:  Starts the watching thread
+      Args:     DWORD dwPollIntervalMs
+                  Interval at which directories without change
+                  notifications are polled
+      Modifies: [m_thread, m_hStopEvent, m_hWakeEvent,
+                 m_dwPollIntervalMs].
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT AssetWatcher::Start(_In_ DWORD dwPollIntervalMs)
+    {
+        if (m_thread.joinable())
+        {
+            return S_OK;
+        }
+
+        m_dwPollIntervalMs = dwPollIntervalMs;
+
+        m_hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        m_hWakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (!m_hStopEvent || !m_hWakeEvent)
+        {
+            HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+            Stop();
+            return hr;
+        }
+
+        m_thread = std::thread([this]()
+            {
+                run();
+            });
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::Stop
+      Summary:  Stops and joins the watching thread. Watched files are
+                kept, so Start resumes watching them
+      Modifies: [m_thread, m_hStopEvent, m_hWakeEvent].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetWatcher::Stop()
+    {
+        if (m_thread.joinable())
+        {
+            SetEvent(m_hStopEvent);
+            m_thread.join();
+        }
+
+        if (m_hStopEvent)
+        {
+            CloseHandle(m_hStopEvent);
+            m_hStopEvent = nullptr;
+        }
+
+        if (m_hWakeEvent)
+        {
+            CloseHandle(m_hWakeEvent);
+            m_hWakeEvent = nullptr;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::Watch
+      Summary:  Adds a file to watch. Its current write time is the
+                reference, so only later edits are reported. Watching
+                a file twice has no effect
+      Args:     const std::filesystem::path& filePath
+                  Path to the file, which may not exist yet
+      Modifies: [m_files, m_aDirectories].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetWatcher::Watch(_In_ const std::filesystem::path& filePath)
+    {
+        std::wstring szKey = MakeKey(filePath);
+
+        std::error_code error;
+        std::filesystem::path absolutePath = std::filesystem::absolute(filePath, error).lexically_normal();
+        if (error)
+        {
+            absolutePath = filePath;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_files.contains(szKey))
+        {
+            return;
+        }
+
+        WatchedFile file =
+        {
+            .filePath = absolutePath,
+            .lastWriteTime = std::filesystem::last_write_time(absolutePath, error),
+            .uSize = std::filesystem::file_size(absolutePath, error),
+            .bPending = FALSE,
+            .ullChangeTime = 0ull
+        };
+        m_files.emplace(szKey, std::move(file));
+
+        std::filesystem::path directoryPath = absolutePath.parent_path();
+        std::wstring szDirectoryKey = MakeKey(directoryPath);
+
+        for (const WatchedDirectory& directory : m_aDirectories)
+        {
+            if (directory.szKey == szDirectoryKey)
+            {
+                return;
+            }
+        }
+
+        // Directories past the wait limit or without notifications are
+        // covered by polling
+        HANDLE hNotification = nullptr;
+        if (m_aDirectories.size() < MAX_NOTIFICATIONS)
+        {
+            hNotification = FindFirstChangeNotification(directoryPath.c_str(), FALSE,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+            if (hNotification == INVALID_HANDLE_VALUE)
+            {
+                hNotification = nullptr;
+            }
+        }
+
+        m_aDirectories.push_back(WatchedDirectory{ .szKey = szDirectoryKey, .hNotification = hNotification });
+
+        if (m_hWakeEvent)
+        {
+            SetEvent(m_hWakeEvent);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::GetChangedFiles
+      Summary:  Returns the files that changed and settled since the
+                last call, each once
+      Args:     std::vector<std::filesystem::path>& aOutChangedFiles
+                  Receives the absolute paths of the changed files
+      Modifies: [m_aChangedFiles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetWatcher::GetChangedFiles(_Out_ std::vector<std::filesystem::path>& aOutChangedFiles)
+    {
+        aOutChangedFiles.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        aOutChangedFiles.swap(m_aChangedFiles);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::MakeKey
+      Summary:  Returns a path made absolute, normalized and lower case,
+                as Windows paths are case insensitive, so different
+                spellings of a file compare equal
+      Args:     const std::filesystem::path& filePath
+                  Path to normalize
+      Returns:  std::wstring
+                  Normalized path
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::wstring AssetWatcher::MakeKey(_In_ const std::filesystem::path& filePath)
+    {
+        std::error_code error;
+        std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(filePath, error);
+        if (error)
+        {
+            canonicalPath = std::filesystem::absolute(filePath, error).lexically_normal();
+        }
+
+        std::wstring szKey = canonicalPath.wstring();
+
+        for (WCHAR& c : szKey)
+        {
+            c = static_cast<WCHAR>(std::towlower(c));
+        }
+
+        return szKey;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::run
+      Summary:  Body of the watching thread. Sleeps until a directory
+                reports a change, a file is added, the poll interval
+                passes or a pending change is due to settle, then
+                rescans the watched files. With every directory on
+                notifications and nothing pending it does not wake up
+                at all
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetWatcher::run()
+    {
+        std::vector<HANDLE> aHandles;
+        BOOL bPending = FALSE;
+
+        for (;;)
+        {
+            BOOL bPolling = FALSE;
+
+            aHandles.assign({ m_hStopEvent, m_hWakeEvent });
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                for (const WatchedDirectory& directory : m_aDirectories)
+                {
+                    if (directory.hNotification)
+                    {
+                        aHandles.push_back(directory.hNotification);
+                    }
+                    else
+                    {
+                        bPolling = TRUE;
+                    }
+                }
+            }
+
+            DWORD dwTimeout = bPending ? SETTLE_TIME_MS : (bPolling ? m_dwPollIntervalMs : INFINITE);
+
+            DWORD dwResult = WaitForMultipleObjects(static_cast<DWORD>(aHandles.size()), aHandles.data(), FALSE, dwTimeout);
+
+            if (dwResult == WAIT_OBJECT_0 || dwResult == WAIT_FAILED)
+            {
+                break;
+            }
+
+            // A notification handle stays signaled until it is rearmed
+            if (dwResult >= WAIT_OBJECT_0 + 2u && dwResult < WAIT_OBJECT_0 + aHandles.size())
+            {
+                FindNextChangeNotification(aHandles[dwResult - WAIT_OBJECT_0]);
+            }
+
+            bPending = scan(GetTickCount64());
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetWatcher::scan
+      Summary:  Compares the write time and size of every watched file
+                with the last seen ones. A change starts or restarts
+                the settle time of the file; a file whose settle time
+                passed is queued as changed. Files that are missing,
+                which happens while some editors save, are skipped
+      Args:     ULONGLONG ullNow
+                  Current tick count in milliseconds
+      Modifies: [m_files, m_aChangedFiles].
+      Returns:  BOOL
+                  TRUE if some change has not settled yet
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL AssetWatcher::scan(_In_ ULONGLONG ullNow)
+    {
+        BOOL bPending = FALSE;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& [szKey, file] : m_files)
+        {
+            std::error_code error;
+            std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(file.filePath, error);
+            if (error)
+            {
+                continue;
+            }
+
+            std::uintmax_t uSize = std::filesystem::file_size(file.filePath, error);
+            if (error)
+            {
+                continue;
+            }
+
+            if (lastWriteTime != file.lastWriteTime || uSize != file.uSize)
+            {
+                file.lastWriteTime = lastWriteTime;
+                file.uSize = uSize;
+                file.bPending = TRUE;
+                file.ullChangeTime = ullNow;
+            }
+            else if (file.bPending && ullNow - file.ullChangeTime >= SETTLE_TIME_MS)
+            {
+                file.bPending = FALSE;
+                m_aChangedFiles.push_back(file.filePath);
+            }
+
+            bPending = bPending || file.bPending;
+        }
+
+        return bPending;
+    }
+}
@@ -0,0 +1,91 @@
+/*+===================================================================
+  File:      ASSETWATCHER.H
+  Summary:   AssetWatcher header file contains declarations of
+             AssetWatcher class used to detect edited asset files while
+             the program runs.
+  Classes: AssetWatcher
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AssetWatcher
+      Summary:  Watches a set of files from a background thread. The
+                directories of the files are watched with change
+                notifications; directories that cannot be watched, such
+                as some network shares, are polled instead. A file is
+                reported once its write time and size have stopped
+                changing for SETTLE_TIME_MS, so editors that save in
+                several writes trigger a single reload
+      Methods:  Start
+                  Starts the watching thread
+                Stop
+                  Stops the watching thread
+                Watch
+                  Adds a file to watch
+                GetChangedFiles
+                  Returns the files that changed since the last call
+                MakeKey
+                  Returns the normalized form of a path
+                AssetWatcher
+                  Constructor.
+                ~AssetWatcher
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AssetWatcher final
+    {
+    public:
+        static constexpr const DWORD DEFAULT_POLL_INTERVAL_MS = 500u;
+        static constexpr const DWORD SETTLE_TIME_MS = 150u;
+
+    public:
+        AssetWatcher();
+        AssetWatcher(const AssetWatcher& other) = delete;
+        AssetWatcher(AssetWatcher&& other) = delete;
+        AssetWatcher& operator=(const AssetWatcher& other) = delete;
+        AssetWatcher& operator=(AssetWatcher&& other) = delete;
+        ~AssetWatcher();
+
+        HRESULT Start(_In_ DWORD dwPollIntervalMs = DEFAULT_POLL_INTERVAL_MS);
+        void Stop();
+        void Watch(_In_ const std::filesystem::path& filePath);
+        void GetChangedFiles(_Out_ std::vector<std::filesystem::path>& aOutChangedFiles);
+
+        static std::wstring MakeKey(_In_ const std::filesystem::path& filePath);
+
+    private:
+        struct WatchedFile
+        {
+            std::filesystem::path filePath;
+            std::filesystem::file_time_type lastWriteTime;
+            std::uintmax_t uSize;
+            BOOL bPending;
+            ULONGLONG ullChangeTime;
+        };
+
+        struct WatchedDirectory
+        {
+            std::wstring szKey;
+            HANDLE hNotification;
+        };
+
+        void run();
+        BOOL scan(_In_ ULONGLONG ullNow);
+
+        std::unordered_map<std::wstring, WatchedFile> m_files;
+        std::vector<WatchedDirectory> m_aDirectories;
+        std::vector<std::filesystem::path> m_aChangedFiles;
+        std::mutex m_mutex;
+        std::thread m_thread;
+        HANDLE m_hStopEvent;
+        HANDLE m_hWakeEvent;
+        DWORD m_dwPollIntervalMs;
+    };
+}
@@ -0,0 +1,190 @@
+#include "Thread/ThreadPool.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ThreadPool
+      Summary:  Constructor. Starts the worker threads
+      Args:     UINT uNumThreads
+                  Number of worker threads. 0 uses one thread per
+                  hardware thread except the calling one
+      Modifies: [m_aWorkers, m_aTasks, m_mutex, m_condition,
+                  m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::ThreadPool(_In_ UINT uNumThreads) :
+        m_aWorkers(),
+        m_aTasks(),
+        m_mutex(),
+        m_condition(),
+        m_bStopping(FALSE)
+    {
+        if (uNumThreads == 0u)
+        {
+            UINT uHardwareThreads = std::thread::hardware_concurrency();
+            uNumThreads = uHardwareThreads > 1u ? uHardwareThreads - 1u : 1u;
+        }
+
+        m_aWorkers.reserve(uNumThreads);
+
+        for (UINT i = 0u; i < uNumThreads; ++i)
+        {
+            m_aWorkers.emplace_back(&ThreadPool::workerMain, this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::~ThreadPool
+      Summary:  Destructor. Runs the queued tasks and joins the workers
+      Modifies: [m_aWorkers, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bStopping = TRUE;
+        }
+
+        m_condition.notify_all();
+
+        for (std::thread& worker : m_aWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::ParallelFor
+      Summary:  Calls a function once for every index in [0, uCount).
+                Indices are handed out one at a time to the workers and
+                the calling thread, and the call returns when all of
+                them have finished
+      Args:     UINT uCount
+                  Number of indices
+                const std::function<void(UINT)>& function
+                  Function called with each index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::ParallelFor(_In_ UINT uCount, _In_ const std::function<void(UINT)>& function)
+    {
+        if (uCount == 0u)
+        {
+            return;
+        }
+
+        if (uCount == 1u)
+        {
+            function(0u);
+            return;
+        }
+
+        struct ParallelForState
+        {
+            std::atomic<UINT> uNext;
+            std::atomic<UINT> uRemaining;
+            std::mutex mutex;
+            std::condition_variable condition;
+        };
+
+        // Helpers that start late find no index left and return at once,
+        // so the state is shared rather than owned by this frame
+        std::shared_ptr<ParallelForState> pState = std::make_shared<ParallelForState>();
+        pState->uNext = 0u;
+        pState->uRemaining = uCount;
+
+        auto run = [pState, uCount, &function]()
+        {
+            for (UINT uIndex = pState->uNext++; uIndex < uCount; uIndex = pState->uNext++)
+            {
+                function(uIndex);
+
+                if (--pState->uRemaining == 0u)
+                {
+                    std::lock_guard<std::mutex> lock(pState->mutex);
+                    pState->condition.notify_all();
+                }
+            }
+        };
+
+        UINT uNumHelpers = (std::min)(uCount - 1u, GetNumThreads());
+
+        for (UINT i = 0u; i < uNumHelpers; ++i)
+        {
+            enqueue(std::function<void()>(run));
+        }
+
+        run();
+
+        std::unique_lock<std::mutex> lock(pState->mutex);
+        pState->condition.wait(lock, [&pState]() { return pState->uRemaining == 0u; });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetNumThreads
+      Summary:  Returns the number of worker threads
+      Returns:  UINT
+                  Number of worker threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ThreadPool::GetNumThreads() const
+    {
+        return static_cast<UINT>(m_aWorkers.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::GetShared
+      Summary:  Returns the pool shared by the renderer and the asset
+                loaders, created on first use
+      Returns:  ThreadPool&
+                  Shared thread pool
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ThreadPool& ThreadPool::GetShared()
+    {
+        static ThreadPool s_threadPool;
+
+        return s_threadPool;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::enqueue
+      Summary:  Pushes a task to the queue and wakes one worker
+      Args:     std::function<void()>&& task
+                  Task to run
+      Modifies: [m_aTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::enqueue(_In_ std::function<void()>&& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_aTasks.push_back(std::move(task));
+        }
+
+        m_condition.notify_one();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::workerMain
+      Summary:  Worker loop. Runs queued tasks until the pool stops and
+                the queue is empty
+      Modifies: [m_aTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ThreadPool::workerMain()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_bStopping || !m_aTasks.empty(); });
+
+                if (m_aTasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_aTasks.front());
+                m_aTasks.pop_front();
+            }
+
+            task();
+        }
+    }
+}
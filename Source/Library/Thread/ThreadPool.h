@@ -0,0 +1,95 @@
+/*+===================================================================
+  File:      THREADPOOL.H
+  Summary:   ThreadPool header file contains declarations of
+             ThreadPool class used to run engine work on a fixed set
+             of worker threads.
+  Classes: ThreadPool
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ThreadPool
+      Summary:  Fixed set of worker threads fed from one task queue.
+                Submit queues a task and returns its future; ParallelFor
+                splits a range across the workers and the calling thread
+                and returns once every index has run. The calling thread
+                always takes part, so ParallelFor can be nested inside a
+                task without deadlocking
+      Methods:  Submit
+                  Queues a task and returns its future
+                ParallelFor
+                  Runs a function for every index of a range
+                GetNumThreads
+                  Returns the number of worker threads
+                GetShared
+                  Returns the pool shared by the engine
+                ThreadPool
+                  Constructor.
+                ~ThreadPool
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ThreadPool final
+    {
+    public:
+        ThreadPool(_In_ UINT uNumThreads = 0u);
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) = delete;
+        ~ThreadPool();
+
+        template <class Function>
+        std::future<std::invoke_result_t<Function>> Submit(_In_ Function&& task);
+
+        void ParallelFor(_In_ UINT uCount, _In_ const std::function<void(UINT)>& function);
+
+        UINT GetNumThreads() const;
+
+        static ThreadPool& GetShared();
+
+    private:
+        void enqueue(_In_ std::function<void()>&& task);
+        void workerMain();
+
+        std::vector<std::thread> m_aWorkers;
+        std::deque<std::function<void()>> m_aTasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        BOOL m_bStopping;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ThreadPool::Submit
+      Summary:  Queues a task to run on a worker thread
+      Args:     Function&& task
+                  Callable taking no arguments
+      Returns:  std::future<std::invoke_result_t<Function>>
+                  Future holding the result of the task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class Function>
+    std::future<std::invoke_result_t<Function>> ThreadPool::Submit(_In_ Function&& task)
+    {
+        using Result = std::invoke_result_t<Function>;
+
+        std::shared_ptr<std::packaged_task<Result()>> pTask =
+            std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(task));
+        std::future<Result> result = pTask->get_future();
+
+        enqueue([pTask]() { (*pTask)(); });
+
+        return result;
+    }
+}
@@ -0,0 +1,1110 @@
+﻿/*+===================================================================
+  File:      MAIN.CPP
+  Summary:   Tests of the parts of the library that run on the CPU
+             alone. Every test runs without a window or a Direct3D
+             device and prints whether it passed
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+#include "Model/MeshletBuilder.h"
+#include "Model/MeshOptimizer.h"
+#include "Model/MeshSimplifier.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/RingAllocator.h"
+#include "Texture/BlockCompressor.h"
+#include "Texture/DdsParser.h"
+#include "Texture/MipGenerator.h"
+#include "Texture/PixelConverter.h"
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   TestCase
+  Summary:  Named test, whose function returns TRUE if it passes
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct TestCase
+{
+    const char* pszName;
+    BOOL (*pfnRun)();
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: buildGrid
+  Summary:  Builds a flat grid of quads in the xy plane, two triangles
+            per quad, with a vertex at every integer point
+  Args:     UINT uNumQuads
+              Number of quads along each side
+            std::vector<float>& aOutPositions
+              Receives three floats per vertex
+            std::vector<std::uint32_t>& aOutIndices
+              Receives the triangle list, row by row
+  Modifies: [aOutPositions, aOutIndices].
+-----------------------------------------------------------------F-F*/
+void buildGrid(_In_ UINT uNumQuads, _Out_ std::vector<float>& aOutPositions, _Out_ std::vector<std::uint32_t>& aOutIndices)
+{
+    UINT uRowSize = uNumQuads + 1u;
+
+    aOutPositions.clear();
+    aOutIndices.clear();
+
+    for (UINT y = 0u; y < uRowSize; ++y)
+    {
+        for (UINT x = 0u; x < uRowSize; ++x)
+        {
+            aOutPositions.insert(aOutPositions.end(), { static_cast<float>(x), static_cast<float>(y), 0.0f });
+        }
+    }
+
+    for (UINT y = 0u; y < uNumQuads; ++y)
+    {
+        for (UINT x = 0u; x < uNumQuads; ++x)
+        {
+            std::uint32_t uCorner = y * uRowSize + x;
+
+            aOutIndices.insert(aOutIndices.end(), { uCorner, uCorner + uRowSize, uCorner + 1u });
+            aOutIndices.insert(aOutIndices.end(), { uCorner + 1u, uCorner + uRowSize, uCorner + uRowSize + 1u });
+        }
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: getGridTriangles
+  Summary:  Returns the triangles of a grid as the grid points of
+            their corners, each rotated to start at its lowest point
+            and then sorted, so two meshes with the same triangles
+            compare equal whatever the order of their triangles and
+            vertices
+  Args:     UINT uNumQuads
+              Number of quads along each side of the grid
+            const std::vector<float>& aPositions
+              Three floats per vertex
+            const std::vector<std::uint32_t>& aIndices
+              Triangle list
+  Returns:  std::vector<std::array<std::uint32_t, 3>>
+              Sorted triangles
+-----------------------------------------------------------------F-F*/
+std::vector<std::array<std::uint32_t, 3>> getGridTriangles(
+    _In_ UINT uNumQuads,
+    _In_ const std::vector<float>& aPositions,
+    _In_ const std::vector<std::uint32_t>& aIndices
+)
+{
+    std::vector<std::array<std::uint32_t, 3>> aTriangles;
+
+    for (size_t i = 0u; i + 2u < aIndices.size(); i += 3u)
+    {
+        std::array<std::uint32_t, 3> triangle;
+        for (size_t j = 0u; j < 3u; ++j)
+        {
+            const float* pPosition = &aPositions[aIndices[i + j] * 3u];
+            triangle[j] = static_cast<std::uint32_t>(pPosition[1]) * (uNumQuads + 1u) + static_cast<std::uint32_t>(pPosition[0]);
+        }
+
+        // Rotating keeps the winding
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        aTriangles.push_back(triangle);
+    }
+
+    std::sort(aTriangles.begin(), aTriangles.end());
+
+    return aTriangles;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: getAcmr
+  Summary:  Returns the average cache miss ratio of a triangle list
+            with the default cache size of MeshOptimizer
+  Args:     const std::vector<std::uint32_t>& aIndices
+              Triangle list
+            UINT uNumVertices
+              Number of vertices
+  Returns:  float
+              Transformed vertices per triangle
+-----------------------------------------------------------------F-F*/
+float getAcmr(_In_ const std::vector<std::uint32_t>& aIndices, _In_ UINT uNumVertices)
+{
+    library::VertexCacheStats stats = {};
+    library::MeshOptimizer::AnalyzeVertexCache(aIndices.data(), static_cast<std::uint32_t>(aIndices.size()), uNumVertices,
+        library::MeshOptimizer::DEFAULT_CACHE_SIZE, stats);
+
+    return library::MeshOptimizer::GetAcmr(stats);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: readBits
+  Summary:  Reads bits of a block, least significant bit first, like
+            the block formats store them
+  Args:     const std::uint8_t* pBlock
+              Block to read
+            UINT& uBit
+              Bit to start at, advanced past the bits read
+            UINT uNumBits
+              Number of bits, at most 32
+  Modifies: [uBit].
+  Returns:  UINT
+              The bits read
+-----------------------------------------------------------------F-F*/
+UINT readBits(_In_ const std::uint8_t* pBlock, _Inout_ UINT& uBit, _In_ UINT uNumBits)
+{
+    UINT uValue = 0u;
+
+    for (UINT i = 0u; i < uNumBits; ++i, ++uBit)
+    {
+        uValue |= ((pBlock[uBit >> 3u] >> (uBit & 7u)) & 1u) << i;
+    }
+
+    return uValue;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: decodeColorBlock
+  Summary:  Decodes the color of a BC1 block, or of the color half of
+            a BC3 block, which always uses four colors
+  Args:     const std::uint8_t* pBlock
+              8 bytes of the color block
+            BOOL bAlwaysFourColors
+              TRUE for BC3
+            std::uint8_t* pOutTexels
+              Receives the RGB of 16 RGBA8 texels; alpha is not written
+  Modifies: [pOutTexels].
+-----------------------------------------------------------------F-F*/
+void decodeColorBlock(_In_ const std::uint8_t* pBlock, _In_ BOOL bAlwaysFourColors, _Out_ std::uint8_t* pOutTexels)
+{
+    UINT auEndpoints[2] =
+    {
+        static_cast<UINT>(pBlock[0]) | (static_cast<UINT>(pBlock[1]) << 8u),
+        static_cast<UINT>(pBlock[2]) | (static_cast<UINT>(pBlock[3]) << 8u)
+    };
+    UINT aauPalette[4][3] = {};
+
+    for (UINT e = 0u; e < 2u; ++e)
+    {
+        UINT uRed = auEndpoints[e] >> 11u;
+        UINT uGreen = (auEndpoints[e] >> 5u) & 63u;
+        UINT uBlue = auEndpoints[e] & 31u;
+
+        aauPalette[e][0] = (uRed << 3u) | (uRed >> 2u);
+        aauPalette[e][1] = (uGreen << 2u) | (uGreen >> 4u);
+        aauPalette[e][2] = (uBlue << 3u) | (uBlue >> 2u);
+    }
+
+    for (UINT c = 0u; c < 3u; ++c)
+    {
+        if (bAlwaysFourColors || auEndpoints[0] > auEndpoints[1])
+        {
+            aauPalette[2][c] = (2u * aauPalette[0][c] + aauPalette[1][c] + 1u) / 3u;
+            aauPalette[3][c] = (aauPalette[0][c] + 2u * aauPalette[1][c] + 1u) / 3u;
+        }
+        else
+        {
+            aauPalette[2][c] = (aauPalette[0][c] + aauPalette[1][c]) / 2u;
+            aauPalette[3][c] = 0u;
+        }
+    }
+
+    UINT uBit = 32u;
+    for (UINT i = 0u; i < 16u; ++i)
+    {
+        UINT uIndex = readBits(pBlock, uBit, 2u);
+        for (UINT c = 0u; c < 3u; ++c)
+        {
+            pOutTexels[i * 4u + c] = static_cast<std::uint8_t>(aauPalette[uIndex][c]);
+        }
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: decodeChannelBlock
+  Summary:  Decodes a BC4 block, the alpha half of a BC3 block or a
+            channel of a BC5 block
+  Args:     const std::uint8_t* pBlock
+              8 bytes of the channel block
+            UINT uChannel
+              Channel of the texels to write
+            std::uint8_t* pOutTexels
+              Receives the channel of 16 RGBA8 texels
+  Modifies: [pOutTexels].
+-----------------------------------------------------------------F-F*/
+void decodeChannelBlock(_In_ const std::uint8_t* pBlock, _In_ UINT uChannel, _Out_ std::uint8_t* pOutTexels)
+{
+    UINT auPalette[8] = { pBlock[0], pBlock[1] };
+
+    for (UINT i = 1u; i < 7u; ++i)
+    {
+        auPalette[i + 1u] = pBlock[0] > pBlock[1]
+            ? ((7u - i) * pBlock[0] + i * pBlock[1] + 3u) / 7u
+            : i < 5u ? ((5u - i) * pBlock[0] + i * pBlock[1] + 2u) / 5u : (i == 5u ? 0u : 255u);
+    }
+
+    UINT uBit = 16u;
+    for (UINT i = 0u; i < 16u; ++i)
+    {
+        pOutTexels[i * 4u + uChannel] = static_cast<std::uint8_t>(auPalette[readBits(pBlock, uBit, 3u)]);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: decodeBc7Mode6Block
+  Summary:  Decodes a BC7 block encoded with mode 6, the only mode
+            BlockCompressor writes
+  Args:     const std::uint8_t* pBlock
+              16 bytes of the block
+            std::uint8_t* pOutTexels
+              Receives 16 RGBA8 texels
+  Modifies: [pOutTexels].
+  Returns:  BOOL
+              TRUE if the block is a mode 6 block
+-----------------------------------------------------------------F-F*/
+BOOL decodeBc7Mode6Block(_In_ const std::uint8_t* pBlock, _Out_ std::uint8_t* pOutTexels)
+{
+    static const UINT s_auWeights[16] = { 0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u };
+
+    UINT uBit = 0u;
+    if (readBits(pBlock, uBit, 7u) != 1u << 6u)
+    {
+        return FALSE;
+    }
+
+    UINT aauEndpoints[2][4] = {};
+    for (UINT c = 0u; c < 4u; ++c)
+    {
+        aauEndpoints[0][c] = readBits(pBlock, uBit, 7u) << 1u;
+        aauEndpoints[1][c] = readBits(pBlock, uBit, 7u) << 1u;
+    }
+
+    for (UINT e = 0u; e < 2u; ++e)
+    {
+        UINT uPBit = readBits(pBlock, uBit, 1u);
+        for (UINT c = 0u; c < 4u; ++c)
+        {
+            aauEndpoints[e][c] |= uPBit;
+        }
+    }
+
+    // The first index drops its most significant bit, which is 0
+    for (UINT i = 0u; i < 16u; ++i)
+    {
+        UINT uWeight = s_auWeights[readBits(pBlock, uBit, i == 0u ? 3u : 4u)];
+        for (UINT c = 0u; c < 4u; ++c)
+        {
+            pOutTexels[i * 4u + c] = static_cast<std::uint8_t>(((64u - uWeight) * aauEndpoints[0][c]
+                + uWeight * aauEndpoints[1][c] + 32u) >> 6u);
+        }
+    }
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testBlockCompressorGradient
+  Summary:  Encodes a smooth RGBA gradient to every supported format,
+            decodes it back and measures the largest error of each
+            channel the format stores. Every channel follows the same
+            ramp, so the colors of a block lie on one line, as block
+            compression expects
+  Returns:  BOOL
+              TRUE if no channel is off by more than the endpoint
+              precision and interpolation of its format allow
+-----------------------------------------------------------------F-F*/
+BOOL testBlockCompressorGradient()
+{
+    constexpr const UINT WIDTH = 16u;
+    constexpr const UINT HEIGHT = 8u;
+
+    std::vector<std::uint8_t> aPixels(static_cast<size_t>(WIDTH) * HEIGHT * 4u);
+    for (UINT y = 0u; y < HEIGHT; ++y)
+    {
+        for (UINT x = 0u; x < WIDTH; ++x)
+        {
+            std::uint8_t* pPixel = &aPixels[(static_cast<size_t>(y) * WIDTH + x) * 4u];
+
+            UINT uRamp = x + y * 4u;
+
+            pPixel[0] = static_cast<std::uint8_t>(64u + uRamp * 2u);
+            pPixel[1] = static_cast<std::uint8_t>(192u - uRamp * 2u);
+            pPixel[2] = static_cast<std::uint8_t>(96u + uRamp);
+            pPixel[3] = static_cast<std::uint8_t>(255u - uRamp * 2u);
+        }
+    }
+
+    static const struct
+    {
+        library::eDdsFormat format;
+        UINT uNumChannels;
+        int iMaxError;
+    } s_aFormats[] =
+    {
+        { library::eDdsFormat::BC1_UNORM, 3u, 6 },
+        { library::eDdsFormat::BC3_UNORM, 4u, 6 },
+        { library::eDdsFormat::BC4_UNORM, 1u, 3 },
+        { library::eDdsFormat::BC5_UNORM, 2u, 3 },
+        { library::eDdsFormat::BC7_UNORM, 4u, 2 },
+    };
+
+    for (const auto& entry : s_aFormats)
+    {
+        if (!library::BlockCompressor::IsSupported(entry.format))
+        {
+            return FALSE;
+        }
+
+        UINT uBlockSize = library::BlockCompressor::GetBlockSize(entry.format);
+        std::vector<std::uint8_t> aBlocks(static_cast<size_t>(WIDTH / 4u) * (HEIGHT / 4u) * uBlockSize);
+        library::BlockCompressor::CompressRows(aPixels.data(), WIDTH, HEIGHT, entry.format, 0u, HEIGHT / 4u, aBlocks.data());
+
+        for (UINT uBlock = 0u; uBlock < (WIDTH / 4u) * (HEIGHT / 4u); ++uBlock)
+        {
+            const std::uint8_t* pBlock = &aBlocks[static_cast<size_t>(uBlock) * uBlockSize];
+            std::uint8_t auDecoded[64] = {};
+
+            switch (entry.format)
+            {
+            case library::eDdsFormat::BC1_UNORM:
+                decodeColorBlock(pBlock, FALSE, auDecoded);
+                break;
+            case library::eDdsFormat::BC3_UNORM:
+                decodeChannelBlock(pBlock, 3u, auDecoded);
+                decodeColorBlock(pBlock + 8u, TRUE, auDecoded);
+                break;
+            case library::eDdsFormat::BC4_UNORM:
+                decodeChannelBlock(pBlock, 0u, auDecoded);
+                break;
+            case library::eDdsFormat::BC5_UNORM:
+                decodeChannelBlock(pBlock, 0u, auDecoded);
+                decodeChannelBlock(pBlock + 8u, 1u, auDecoded);
+                break;
+            default:
+                if (!decodeBc7Mode6Block(pBlock, auDecoded))
+                {
+                    return FALSE;
+                }
+                break;
+            }
+
+            UINT uBlockX = uBlock % (WIDTH / 4u);
+            UINT uBlockY = uBlock / (WIDTH / 4u);
+
+            for (UINT i = 0u; i < 16u; ++i)
+            {
+                const std::uint8_t* pPixel = &aPixels[((uBlockY * 4u + i / 4u) * WIDTH + uBlockX * 4u + i % 4u) * 4u];
+
+                for (UINT c = 0u; c < entry.uNumChannels; ++c)
+                {
+                    if (std::abs(static_cast<int>(auDecoded[i * 4u + c]) - static_cast<int>(pPixel[c])) > entry.iMaxError)
+                    {
+                        return FALSE;
+                    }
+                }
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testDdsRoundTrip
+  Summary:  Writes a BC1 texture array of two slices and three mips,
+            parses it back, then parses it truncated, with a wrong
+            magic number and with a width over the Direct3D limit
+  Returns:  BOOL
+              TRUE if the texture reads back identical and each broken
+              file is rejected with its status
+-----------------------------------------------------------------F-F*/
+BOOL testDdsRoundTrip()
+{
+    library::DdsImage image =
+    {
+        .format = library::eDdsFormat::BC1_UNORM,
+        .dimension = library::eDdsDimension::TEXTURE2D,
+        .uWidth = 16u,
+        .uHeight = 8u,
+        .uDepth = 1u,
+        .uArraySize = 2u,
+        .uMipLevels = 3u,
+        .uAlphaMode = 0u,
+        .bCubeMap = false
+    };
+
+    // 64, 16 and 8 bytes of blocks per slice
+    std::vector<std::uint8_t> aPixels(2u * (64u + 16u + 8u));
+    for (size_t i = 0u; i < aPixels.size(); ++i)
+    {
+        aPixels[i] = static_cast<std::uint8_t>(i * 7u + 3u);
+    }
+
+    std::vector<library::DdsSubresource> aSubresources;
+    const std::uint8_t* pPixels = aPixels.data();
+
+    for (UINT uSlice = 0u; uSlice < image.uArraySize; ++uSlice)
+    {
+        for (UINT uMip = 0u; uMip < image.uMipLevels; ++uMip)
+        {
+            UINT uWidth = (std::max)(image.uWidth >> uMip, 1u);
+            UINT uHeight = (std::max)(image.uHeight >> uMip, 1u);
+            std::uint64_t uNumBytes = 0u;
+            std::uint64_t uRowBytes = 0u;
+            std::uint64_t uNumRows = 0u;
+            library::DdsParser::GetSurfaceInfo(uWidth, uHeight, image.format, uNumBytes, uRowBytes, uNumRows);
+
+            aSubresources.push_back(library::DdsSubresource{
+                .pData = pPixels,
+                .uWidth = uWidth,
+                .uHeight = uHeight,
+                .uDepth = 1u,
+                .uRowPitch = static_cast<std::uint32_t>(uRowBytes),
+                .uSlicePitch = static_cast<std::uint32_t>(uNumBytes),
+                .uNumRows = static_cast<std::uint32_t>(uNumRows)
+            });
+
+            pPixels += uNumBytes;
+        }
+    }
+
+    std::vector<std::uint8_t> aFile;
+    if (library::DdsParser::Write(image, aSubresources, aFile) != library::eDdsStatus::OK)
+    {
+        return FALSE;
+    }
+
+    library::DdsImage parsedImage = {};
+    std::vector<library::DdsSubresource> aParsedSubresources;
+    if (library::DdsParser::Parse(aFile.data(), aFile.size(), parsedImage, aParsedSubresources) != library::eDdsStatus::OK
+        || parsedImage.format != image.format || parsedImage.dimension != image.dimension
+        || parsedImage.uWidth != image.uWidth || parsedImage.uHeight != image.uHeight || parsedImage.uDepth != image.uDepth
+        || parsedImage.uArraySize != image.uArraySize || parsedImage.uMipLevels != image.uMipLevels
+        || parsedImage.bCubeMap || aParsedSubresources.size() != aSubresources.size())
+    {
+        return FALSE;
+    }
+
+    for (size_t i = 0u; i < aSubresources.size(); ++i)
+    {
+        const library::DdsSubresource& expected = aSubresources[i];
+        const library::DdsSubresource& parsed = aParsedSubresources[i];
+
+        if (parsed.uWidth != expected.uWidth || parsed.uHeight != expected.uHeight
+            || parsed.uRowPitch != expected.uRowPitch || parsed.uNumRows != expected.uNumRows
+            || parsed.uSlicePitch != expected.uSlicePitch
+            || memcmp(parsed.pData, expected.pData, expected.uSlicePitch) != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    if (library::DdsParser::Parse(aFile.data(), aFile.size() - 1u, parsedImage, aParsedSubresources)
+        != library::eDdsStatus::END_OF_FILE)
+    {
+        return FALSE;
+    }
+
+    std::vector<std::uint8_t> aBroken = aFile;
+    aBroken[0] = 'X';
+    if (library::DdsParser::Parse(aBroken.data(), aBroken.size(), parsedImage, aParsedSubresources)
+        != library::eDdsStatus::INVALID_DATA)
+    {
+        return FALSE;
+    }
+
+    // The width follows the magic number and the size, flags and
+    // height of the header
+    const std::uint32_t uHugeWidth = library::DdsParser::MAX_TEXTURE2D_SIZE * 2u;
+    aBroken = aFile;
+    memcpy(&aBroken[16], &uHugeWidth, sizeof(uHugeWidth));
+
+    return library::DdsParser::Parse(aBroken.data(), aBroken.size(), parsedImage, aParsedSubresources)
+        == library::eDdsStatus::NOT_SUPPORTED;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testMeshletBuilderGrid
+  Summary:  Groups the triangles of a grid into meshlets, then culls
+            them from a camera in front of the grid, from one looking
+            away from it and from one behind it
+  Returns:  BOOL
+              TRUE if the meshlets keep every triangle within the
+              limits, and are all drawn from the front, all outside
+              the frustum looking away, and all backfacing from behind
+-----------------------------------------------------------------F-F*/
+BOOL testMeshletBuilderGrid()
+{
+    constexpr const UINT NUM_QUADS = 16u;
+
+    std::vector<float> aPositions;
+    std::vector<std::uint32_t> aIndices;
+    buildGrid(NUM_QUADS, aPositions, aIndices);
+
+    UINT uNumIndices = static_cast<UINT>(aIndices.size());
+    std::vector<std::array<std::uint32_t, 3>> aExpectedTriangles = getGridTriangles(NUM_QUADS, aPositions, aIndices);
+
+    std::vector<library::Meshlet> aMeshlets;
+    library::MeshletBuilder::Build(aIndices.data(), uNumIndices, aPositions.data(), 3u * sizeof(float),
+        static_cast<std::uint32_t>(aPositions.size() / 3u), aMeshlets);
+
+    if (aMeshlets.size() < 2u || getGridTriangles(NUM_QUADS, aPositions, aIndices) != aExpectedTriangles)
+    {
+        return FALSE;
+    }
+
+    UINT uNextIndex = 0u;
+    for (const library::Meshlet& meshlet : aMeshlets)
+    {
+        std::vector<std::uint32_t> aVertices(aIndices.begin() + meshlet.uFirstIndex,
+            aIndices.begin() + meshlet.uFirstIndex + meshlet.uNumIndices);
+        std::sort(aVertices.begin(), aVertices.end());
+        aVertices.erase(std::unique(aVertices.begin(), aVertices.end()), aVertices.end());
+
+        if (meshlet.uFirstIndex != uNextIndex || meshlet.uNumIndices > library::MeshletBuilder::MAX_TRIANGLES * 3u
+            || meshlet.uNumVertices != aVertices.size() || meshlet.uNumVertices > library::MeshletBuilder::MAX_VERTICES)
+        {
+            return FALSE;
+        }
+
+        uNextIndex += meshlet.uNumIndices;
+    }
+
+    if (uNextIndex != uNumIndices)
+    {
+        return FALSE;
+    }
+
+    // Left-handed perspective with a 90 degree field of view, near
+    // plane at 1 and far plane at 100, times views of cameras 10 units
+    // from the center of the grid. The grid faces -z
+    constexpr const float NEAR_Z = 1.0f;
+    constexpr const float FAR_Z = 100.0f;
+    constexpr const float DEPTH_SCALE = FAR_Z / (FAR_Z - NEAR_Z);
+    constexpr const float CENTER = NUM_QUADS * 0.5f;
+    const float aFrontToClip[16] =
+    {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, DEPTH_SCALE, 1.0f,
+        -CENTER, -CENTER, (10.0f - NEAR_Z) * DEPTH_SCALE, 10.0f,
+    };
+    const float aAwayToClip[16] =
+    {
+        -1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, -DEPTH_SCALE, -1.0f,
+        CENTER, -CENTER, (-10.0f - NEAR_Z) * DEPTH_SCALE, -10.0f,
+    };
+    const float aBehindToClip[16] =
+    {
+        -1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, -DEPTH_SCALE, -1.0f,
+        CENTER, -CENTER, (10.0f - NEAR_Z) * DEPTH_SCALE, 10.0f,
+    };
+    const float aFrontPosition[3] = { CENTER, CENTER, -10.0f };
+    const float aBehindPosition[3] = { CENTER, CENTER, 10.0f };
+
+    UINT uNumMeshlets = static_cast<UINT>(aMeshlets.size());
+    std::vector<library::MeshletRange> aRanges(uNumMeshlets);
+    library::MeshletCullStats frontStats = {};
+    library::MeshletCullStats awayStats = {};
+    library::MeshletCullStats behindStats = {};
+
+    UINT uNumFrontRanges = library::MeshletBuilder::Cull(aMeshlets.data(), uNumMeshlets, aFrontToClip, aFrontPosition,
+        aRanges.data(), &frontStats);
+    if (uNumFrontRanges != 1u || aRanges[0].uFirstIndex != 0u || aRanges[0].uNumIndices != uNumIndices)
+    {
+        return FALSE;
+    }
+
+    UINT uNumAwayRanges = library::MeshletBuilder::Cull(aMeshlets.data(), uNumMeshlets, aAwayToClip, aFrontPosition,
+        aRanges.data(), &awayStats);
+    UINT uNumBehindRanges = library::MeshletBuilder::Cull(aMeshlets.data(), uNumMeshlets, aBehindToClip, aBehindPosition,
+        aRanges.data(), &behindStats);
+
+    return frontStats.uNumTested == uNumMeshlets && frontStats.uNumBackfacing == 0u && frontStats.uNumOutsideFrustum == 0u
+        && uNumAwayRanges == 0u && awayStats.uNumOutsideFrustum == uNumMeshlets
+        && uNumBehindRanges == 0u && behindStats.uNumBackfacing == uNumMeshlets;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testMeshOptimizerGrid
+  Summary:  Shuffles the triangles of a grid, then runs the vertex
+            cache, overdraw and vertex fetch passes on it
+  Returns:  BOOL
+              TRUE if the passes keep every triangle, the cache passes
+              bring the miss ratio under 1, and the vertices end up in
+              the order they are first used
+-----------------------------------------------------------------F-F*/
+BOOL testMeshOptimizerGrid()
+{
+    constexpr const UINT NUM_QUADS = 16u;
+
+    std::vector<float> aPositions;
+    std::vector<std::uint32_t> aGridIndices;
+    buildGrid(NUM_QUADS, aPositions, aGridIndices);
+
+    UINT uNumVertices = static_cast<UINT>(aPositions.size() / 3u);
+    UINT uNumIndices = static_cast<UINT>(aGridIndices.size());
+    UINT uNumTriangles = uNumIndices / 3u;
+
+    // 37 is prime to the 512 triangles, so this visits each of them once
+    std::vector<std::uint32_t> aIndices(uNumIndices);
+    for (UINT t = 0u; t < uNumTriangles; ++t)
+    {
+        std::copy_n(&aGridIndices[(t * 37u % uNumTriangles) * 3u], 3u, &aIndices[t * 3u]);
+    }
+
+    std::vector<std::array<std::uint32_t, 3>> aExpectedTriangles = getGridTriangles(NUM_QUADS, aPositions, aGridIndices);
+    float fShuffledAcmr = getAcmr(aIndices, uNumVertices);
+
+    library::MeshOptimizer::OptimizeVertexCache(aIndices.data(), uNumIndices, uNumVertices);
+    float fOptimizedAcmr = getAcmr(aIndices, uNumVertices);
+
+    library::MeshOptimizer::OptimizeOverdraw(aIndices.data(), uNumIndices, aPositions.data(), 3u * sizeof(float), uNumVertices);
+    float fOverdrawAcmr = getAcmr(aIndices, uNumVertices);
+
+    library::MeshOptimizer::OptimizeVertexFetch(aPositions.data(), 3u * sizeof(float), uNumVertices, aIndices.data(),
+        uNumIndices);
+
+    std::uint32_t uNextVertex = 0u;
+    for (std::uint32_t uIndex : aIndices)
+    {
+        if (uIndex > uNextVertex)
+        {
+            return FALSE;
+        }
+
+        uNextVertex = (std::max)(uNextVertex, uIndex + 1u);
+    }
+
+    return fOptimizedAcmr < 1.0f && fOptimizedAcmr < fShuffledAcmr && fOverdrawAcmr <= fOptimizedAcmr
+        && getAcmr(aIndices, uNumVertices) == fOverdrawAcmr
+        && getGridTriangles(NUM_QUADS, aPositions, aIndices) == aExpectedTriangles;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testMeshSimplifierGrid
+  Summary:  Simplifies a flat grid to an eighth of its triangles.
+            A plane can lose its inner vertices for free, and its
+            border vertices only slide along the border
+  Returns:  BOOL
+              TRUE if the grid is simplified with no error, and the
+              triangles left all face the same way and cover the
+              same area
+-----------------------------------------------------------------F-F*/
+BOOL testMeshSimplifierGrid()
+{
+    constexpr const UINT NUM_QUADS = 16u;
+
+    std::vector<float> aPositions;
+    std::vector<std::uint32_t> aIndices;
+    buildGrid(NUM_QUADS, aPositions, aIndices);
+
+    UINT uNumIndices = static_cast<UINT>(aIndices.size());
+    std::vector<std::uint32_t> aSimplified(uNumIndices);
+    float fError = -1.0f;
+
+    UINT uNumSimplified = library::MeshSimplifier::Simplify(aSimplified.data(), aIndices.data(), uNumIndices,
+        aPositions.data(), 3u * sizeof(float), static_cast<std::uint32_t>(aPositions.size() / 3u), uNumIndices / 8u,
+        0.01f, &fError);
+
+    if (uNumSimplified == 0u || uNumSimplified > uNumIndices / 8u || fError < 0.0f || fError > 1e-4f)
+    {
+        return FALSE;
+    }
+
+    // Grid triangles wind clockwise in the xy plane, so their doubled
+    // signed areas are negative
+    float fArea = 0.0f;
+    for (UINT i = 0u; i < uNumSimplified; i += 3u)
+    {
+        const float* p0 = &aPositions[aSimplified[i + 0u] * 3u];
+        const float* p1 = &aPositions[aSimplified[i + 1u] * 3u];
+        const float* p2 = &aPositions[aSimplified[i + 2u] * 3u];
+
+        float fDoubleArea = (p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]);
+        if (fDoubleArea >= 0.0f)
+        {
+            return FALSE;
+        }
+
+        fArea -= fDoubleArea * 0.5f;
+    }
+
+    return fArea > NUM_QUADS * NUM_QUADS - 1e-3f && fArea < NUM_QUADS * NUM_QUADS + 1e-3f;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testMipGeneratorCheckerboard
+  Summary:  Builds the mip chain of a black and white checkerboard
+            with both filters, as linear and as sRGB color, each mip
+            filtered from the one above
+  Returns:  BOOL
+              TRUE if every texel of every mip is the average of black
+              and white in linear light, 128 in linear and 188 in sRGB
+              color, with alpha kept opaque
+-----------------------------------------------------------------F-F*/
+BOOL testMipGeneratorCheckerboard()
+{
+    constexpr const UINT WIDTH = 64u;
+    constexpr const UINT HEIGHT = 32u;
+
+    std::vector<std::uint8_t> aPixels(static_cast<size_t>(WIDTH) * HEIGHT * 4u);
+    for (UINT y = 0u; y < HEIGHT; ++y)
+    {
+        for (UINT x = 0u; x < WIDTH; ++x)
+        {
+            std::uint8_t uValue = static_cast<std::uint8_t>((x + y) % 2u == 0u ? 0u : 255u);
+            std::uint8_t* pPixel = &aPixels[(static_cast<size_t>(y) * WIDTH + x) * 4u];
+
+            pPixel[0] = uValue;
+            pPixel[1] = uValue;
+            pPixel[2] = uValue;
+            pPixel[3] = 255u;
+        }
+    }
+
+    UINT uNumLevels = library::MipGenerator::GetNumLevels(WIDTH, HEIGHT);
+    if (uNumLevels != 7u)
+    {
+        return FALSE;
+    }
+
+    for (library::eMipFilter filter : { library::eMipFilter::BOX, library::eMipFilter::KAISER })
+    {
+        for (bool bSrgb : { false, true })
+        {
+            std::uint8_t uExpected = static_cast<std::uint8_t>(bSrgb ? 188u : 128u);
+
+            std::vector<float> aSourceTexels;
+            std::vector<float> aTexels;
+            library::MipGenerator::ConvertToLinear(aPixels.data(), WIDTH, HEIGHT, bSrgb, aSourceTexels);
+
+            for (UINT uLevel = 1u; uLevel < uNumLevels; ++uLevel)
+            {
+                UINT uSourceWidth = 0u;
+                UINT uSourceHeight = 0u;
+                UINT uLevelWidth = 0u;
+                UINT uLevelHeight = 0u;
+                library::MipGenerator::GetLevelSize(WIDTH, HEIGHT, uLevel - 1u, uSourceWidth, uSourceHeight);
+                library::MipGenerator::GetLevelSize(WIDTH, HEIGHT, uLevel, uLevelWidth, uLevelHeight);
+
+                aTexels.resize(static_cast<size_t>(uLevelWidth) * uLevelHeight * 4u);
+                std::vector<std::uint8_t> aLevel(aTexels.size());
+
+                // Two bands, as the baker splits levels into bands of rows
+                UINT uHalfHeight = uLevelHeight / 2u;
+                library::MipGenerator::GenerateRows(aSourceTexels.data(), uSourceWidth, uSourceHeight, filter, bSrgb, 0u,
+                    uHalfHeight, aTexels.data(), aLevel.data());
+                library::MipGenerator::GenerateRows(aSourceTexels.data(), uSourceWidth, uSourceHeight, filter, bSrgb,
+                    uHalfHeight, uLevelHeight - uHalfHeight, aTexels.data(), aLevel.data());
+
+                for (size_t i = 0u; i < aLevel.size(); i += 4u)
+                {
+                    if (aLevel[i + 0u] != uExpected || aLevel[i + 1u] != uExpected || aLevel[i + 2u] != uExpected
+                        || aLevel[i + 3u] != 255u)
+                    {
+                        return FALSE;
+                    }
+                }
+
+                aSourceTexels.swap(aTexels);
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testOcclusionRejection
+  Summary:  Rasterizes a wall five units in front of a camera at the
+            origin, then tests a box hidden behind the wall, one
+            beside it and one in front of it
+  Returns:  BOOL
+              TRUE if only the hidden box is rejected
+-----------------------------------------------------------------F-F*/
+BOOL testOcclusionRejection()
+{
+    // Left-handed perspective looking down +z with a 90 degree field
+    // of view, near plane at 1 and far plane at 100
+    constexpr const float NEAR_Z = 1.0f;
+    constexpr const float FAR_Z = 100.0f;
+    constexpr const float DEPTH_SCALE = FAR_Z / (FAR_Z - NEAR_Z);
+    const float aViewProjection[16] =
+    {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 2.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, DEPTH_SCALE, 1.0f,
+        0.0f, 0.0f, -NEAR_Z * DEPTH_SCALE, 0.0f,
+    };
+    const float aIdentity[16] =
+    {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f,
+    };
+
+    const float aWallMin[3] = { -2.0f, -2.0f, 5.0f };
+    const float aWallMax[3] = { 2.0f, 2.0f, 5.5f };
+    const float aHiddenMin[3] = { -0.5f, -0.5f, 9.0f };
+    const float aHiddenMax[3] = { 0.5f, 0.5f, 10.0f };
+    const float aBesideMin[3] = { 6.0f, -0.5f, 9.0f };
+    const float aBesideMax[3] = { 7.0f, 0.5f, 10.0f };
+    const float aFrontMin[3] = { -0.5f, -0.5f, 2.0f };
+    const float aFrontMax[3] = { 0.5f, 0.5f, 3.0f };
+
+    library::OcclusionCuller occlusionCuller;
+    occlusionCuller.BeginFrame(aViewProjection);
+    occlusionCuller.RasterizeBox(aIdentity, aWallMin, aWallMax);
+
+    return !occlusionCuller.IsBoxVisible(aIdentity, aHiddenMin, aHiddenMax)
+        && occlusionCuller.IsBoxVisible(aIdentity, aBesideMin, aBesideMax)
+        && occlusionCuller.IsBoxVisible(aIdentity, aFrontMin, aFrontMax)
+        && occlusionCuller.GetStats().uNumRejectedBoxes == 1u;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testPixelConverterFormats
+  Summary:  Converts rows of every pixel format to RGBA8, seven pixels
+            wide so the vector code has a remainder, from rows padded
+            past their width, in two bands
+  Returns:  BOOL
+              TRUE if every pixel has its channels in RGBA order, with
+              opaque alpha for the formats without it
+-----------------------------------------------------------------F-F*/
+BOOL testPixelConverterFormats()
+{
+    constexpr const UINT WIDTH = 7u;
+    constexpr const UINT HEIGHT = 3u;
+
+    static const library::ePixelFormat s_aFormats[] =
+    {
+        library::ePixelFormat::RGBA8,
+        library::ePixelFormat::BGRA8,
+        library::ePixelFormat::BGRX8,
+        library::ePixelFormat::RGB8,
+        library::ePixelFormat::BGR8,
+        library::ePixelFormat::GRAY8,
+    };
+
+    for (library::ePixelFormat format : s_aFormats)
+    {
+        UINT uBytesPerPixel = library::PixelConverter::GetBytesPerPixel(format);
+        size_t uPitch = static_cast<size_t>(WIDTH) * uBytesPerPixel + 5u;
+
+        std::vector<std::uint8_t> aPixels(uPitch * HEIGHT);
+        for (size_t i = 0u; i < aPixels.size(); ++i)
+        {
+            aPixels[i] = static_cast<std::uint8_t>(i * 13u + 1u);
+        }
+
+        std::vector<std::uint8_t> aConverted(static_cast<size_t>(WIDTH) * HEIGHT * 4u);
+        library::PixelConverter::ConvertRows(aPixels.data(), uPitch, format, WIDTH, HEIGHT, 0u, 1u, aConverted.data());
+        library::PixelConverter::ConvertRows(aPixels.data(), uPitch, format, WIDTH, HEIGHT, 1u, HEIGHT - 1u, aConverted.data());
+
+        for (UINT y = 0u; y < HEIGHT; ++y)
+        {
+            for (UINT x = 0u; x < WIDTH; ++x)
+            {
+                const std::uint8_t* p = &aPixels[y * uPitch + static_cast<size_t>(x) * uBytesPerPixel];
+                std::uint8_t auExpected[4] = {};
+
+                switch (format)
+                {
+                case library::ePixelFormat::RGBA8:
+                    std::copy_n(p, 4u, auExpected);
+                    break;
+                case library::ePixelFormat::BGRA8:
+                    auExpected[0] = p[2];
+                    auExpected[1] = p[1];
+                    auExpected[2] = p[0];
+                    auExpected[3] = p[3];
+                    break;
+                case library::ePixelFormat::BGRX8:
+                case library::ePixelFormat::BGR8:
+                    auExpected[0] = p[2];
+                    auExpected[1] = p[1];
+                    auExpected[2] = p[0];
+                    auExpected[3] = 255u;
+                    break;
+                case library::ePixelFormat::RGB8:
+                    std::copy_n(p, 3u, auExpected);
+                    auExpected[3] = 255u;
+                    break;
+                default:
+                    std::fill_n(auExpected, 3u, p[0]);
+                    auExpected[3] = 255u;
+                    break;
+                }
+
+                if (!std::equal(auExpected, auExpected + 4, &aConverted[(static_cast<size_t>(y) * WIDTH + x) * 4u]))
+                {
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testPixelConverterResize
+  Summary:  Round trips every 8-bit value through sRGB decoding and
+            encoding, then resizes an image of one color to odd
+            sizes with both filters, as linear and as sRGB color
+  Returns:  BOOL
+              TRUE if every value round trips exactly and the resized
+              images keep the color of every pixel
+-----------------------------------------------------------------F-F*/
+BOOL testPixelConverterResize()
+{
+    std::uint8_t auValues[256];
+    for (UINT i = 0u; i < 256u; ++i)
+    {
+        auValues[i] = static_cast<std::uint8_t>(i);
+    }
+
+    float afLinear[256];
+    std::uint8_t auRoundTrip[256];
+    library::PixelConverter::SrgbToLinear(auValues, 256u, afLinear);
+    library::PixelConverter::LinearToSrgb(afLinear, 256u, auRoundTrip);
+
+    if (!std::equal(auValues, auValues + 256, auRoundTrip))
+    {
+        return FALSE;
+    }
+
+    constexpr const UINT WIDTH = 8u;
+    constexpr const UINT HEIGHT = 8u;
+    constexpr const UINT NEW_WIDTH = 3u;
+    constexpr const UINT NEW_HEIGHT = 5u;
+    const std::uint8_t auColor[4] = { 200u, 100u, 30u, 150u };
+
+    std::vector<std::uint8_t> aPixels(static_cast<size_t>(WIDTH) * HEIGHT * 4u);
+    for (size_t i = 0u; i < aPixels.size(); ++i)
+    {
+        aPixels[i] = auColor[i % 4u];
+    }
+
+    for (library::eResizeFilter filter : { library::eResizeFilter::BOX, library::eResizeFilter::LANCZOS3 })
+    {
+        for (bool bSrgb : { false, true })
+        {
+            std::vector<std::uint8_t> aResized(static_cast<size_t>(NEW_WIDTH) * NEW_HEIGHT * 4u);
+            library::PixelConverter::ResizeRows(aPixels.data(), WIDTH, HEIGHT, NEW_WIDTH, NEW_HEIGHT, filter, bSrgb, 0u,
+                NEW_HEIGHT, aResized.data());
+
+            for (size_t i = 0u; i < aResized.size(); ++i)
+            {
+                if (aResized[i] != auColor[i % 4u])
+                {
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: testRingAllocatorWrap
+  Summary:  Fills a ring with two frames, checks that a third
+            allocation fails until the oldest frame is released, then
+            that it wraps to the start of the ring
+  Returns:  BOOL
+              TRUE if the offsets and the space in use are as expected
+-----------------------------------------------------------------F-F*/
+BOOL testRingAllocatorWrap()
+{
+    library::RingAllocator allocator(256u);
+    UINT uOffset = 0u;
+
+    if (!allocator.Allocate(100u, 16u, uOffset) || uOffset != 0u)
+    {
+        return FALSE;
+    }
+    allocator.FinishFrame(0u);
+
+    // Aligned up from 100
+    if (!allocator.Allocate(100u, 16u, uOffset) || uOffset != 112u)
+    {
+        return FALSE;
+    }
+    allocator.FinishFrame(1u);
+
+    // Neither the end of the ring nor its start is free
+    if (allocator.Allocate(64u, 16u, uOffset))
+    {
+        return FALSE;
+    }
+
+    allocator.ReleaseFrame();
+    if (allocator.GetOldestFrameIndex() != 1u || allocator.GetUsedSize() != 112u)
+    {
+        return FALSE;
+    }
+
+    // The skipped end of the ring counts as used until frame 2 is released
+    if (!allocator.Allocate(64u, 16u, uOffset) || uOffset != 0u || allocator.GetUsedSize() != 220u)
+    {
+        return FALSE;
+    }
+    allocator.FinishFrame(2u);
+
+    allocator.ReleaseFrame();
+    allocator.ReleaseFrame();
+
+    return allocator.GetNumFramesInFlight() == 0u && allocator.GetUsedSize() == 0u;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+  Summary:  Entry point to the tests. Runs every test and prints its
+            result
+  Args:     INT argc
+              Number of arguments
+            WCHAR* argv[]
+              Program name
+  Returns:  INT
+              0 if every test passed, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+    UNREFERENCED_PARAMETER(argc);
+    UNREFERENCED_PARAMETER(argv);
+
+    static const TestCase s_aTests[] =
+    {
+        { "BlockCompressor encodes a gradient to every format", testBlockCompressorGradient },
+        { "DdsParser reads back what it writes and rejects broken files", testDdsRoundTrip },
+        { "MeshletBuilder groups a grid into meshlets and culls them", testMeshletBuilderGrid },
+        { "MeshOptimizer reorders a shuffled grid for the vertex cache", testMeshOptimizerGrid },
+        { "MeshSimplifier reduces a flat grid without error", testMeshSimplifierGrid },
+        { "MipGenerator averages a checkerboard in linear light", testMipGeneratorCheckerboard },
+        { "OcclusionCuller rejects a box behind an occluder", testOcclusionRejection },
+        { "PixelConverter converts every pixel format to RGBA8", testPixelConverterFormats },
+        { "PixelConverter round trips sRGB and resizes one color exactly", testPixelConverterResize },
+        { "RingAllocator wraps once the oldest frame is released", testRingAllocatorWrap },
+    };
+
+    UINT uNumFailed = 0u;
+
+    for (const TestCase& test : s_aTests)
+    {
+        BOOL bPassed = test.pfnRun();
+        if (!bPassed)
+        {
+            ++uNumFailed;
+        }
+
+        printf("%s %s\n", bPassed ? "PASS" : "FAIL", test.pszName);
+    }
+
+    printf("%u of %u tests failed\n", uNumFailed, static_cast<UINT>(std::size(s_aTests)));
+
+    return uNumFailed == 0u ? 0 : 1;
+}
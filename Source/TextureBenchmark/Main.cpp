@@ -0,0 +1,704 @@
+﻿/*+===================================================================
+  File:      MAIN.CPP
+  Summary:   Texture loading benchmark. Times every stage of the
+             texture loaders on a set of images and DDS files and
+             writes the timings as JSON, to track the startup cost
+             of textures across changes
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include "Common.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "Texture/BlockCompressor.h"
+#include "Texture/DdsFile.h"
+#include "Texture/DdsParser.h"
+#include "Texture/MipGenerator.h"
+#include "Texture/PixelConverter.h"
+#include "Texture/Texture.h"
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   StageResult
+  Summary:  Timings of one stage of loading one file. uBytes is what
+            the stage reads: the file for decode, parse, open and
+            load, the RGBA8 pixels for mips and block compression
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct StageResult
+{
+    const char* pszName;
+    UINT64 uBytes;
+    double dMeanMs;
+    double dMinMs;
+};
+
+/*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+  Struct:   FileResult
+  Summary:  Stages measured for one file. bBaked tells that the load
+            stage of an image went through its baked DDS file
+S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+struct FileResult
+{
+    std::filesystem::path filePath;
+    BOOL bDds;
+    BOOL bBaked;
+    UINT64 uFileBytes;
+    UINT uWidth;
+    UINT uHeight;
+    UINT uMipLevels;
+    HRESULT hr;
+    std::vector<StageResult> aStages;
+};
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: isImageFile
+  Summary:  Returns whether a file is an image decoded with WIC
+  Args:     const std::filesystem::path& filePath
+              Path of the file
+  Returns:  BOOL
+              TRUE for the image formats WIC decodes
+-----------------------------------------------------------------F-F*/
+BOOL isImageFile(_In_ const std::filesystem::path& filePath)
+{
+    static const WCHAR* s_aszExtensions[] = { L".bmp", L".gif", L".jpeg", L".jpg", L".png", L".tif", L".tiff" };
+
+    for (const WCHAR* pszExtension : s_aszExtensions)
+    {
+        if (_wcsicmp(filePath.extension().c_str(), pszExtension) == 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: isDdsFile
+  Summary:  Returns whether a file is a DDS file
+  Args:     const std::filesystem::path& filePath
+              Path of the file
+  Returns:  BOOL
+              TRUE for the ".dds" extension
+-----------------------------------------------------------------F-F*/
+BOOL isDdsFile(_In_ const std::filesystem::path& filePath)
+{
+    return _wcsicmp(filePath.extension().c_str(), L".dds") == 0;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: measure
+  Summary:  Runs a stage once to warm the caches and check that it
+            succeeds, then times it over the iterations
+  Args:     const char* pszName
+              Name of the stage in the JSON output
+            UINT64 uBytes
+              Bytes the stage reads
+            UINT uIterations
+              Number of timed runs
+            Function&& function
+              Runs the stage, returns FALSE on failure
+            std::vector<StageResult>& aOutStages
+              Receives the timings
+  Modifies: [aOutStages].
+  Returns:  BOOL
+              TRUE if the stage succeeded
+-----------------------------------------------------------------F-F*/
+template <typename Function>
+BOOL measure(
+    _In_z_ const char* pszName,
+    _In_ UINT64 uBytes,
+    _In_ UINT uIterations,
+    _In_ Function&& function,
+    _Inout_ std::vector<StageResult>& aOutStages
+)
+{
+    if (!function())
+    {
+        return FALSE;
+    }
+
+    double dTotalMs = 0.0;
+    double dMinMs = DBL_MAX;
+
+    for (UINT i = 0u; i < uIterations; ++i)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if (!function())
+        {
+            return FALSE;
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        dTotalMs += elapsed.count();
+        dMinMs = (std::min)(dMinMs, elapsed.count());
+    }
+
+    aOutStages.push_back(StageResult{ .pszName = pszName, .uBytes = uBytes, .dMeanMs = dTotalMs / uIterations, .dMinMs = dMinMs });
+
+    return TRUE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: readFile
+  Summary:  Reads a whole file into memory
+  Args:     const std::filesystem::path& filePath
+              Path of the file
+            std::vector<std::uint8_t>& aOutData
+              Receives the bytes of the file
+  Modifies: [aOutData].
+  Returns:  BOOL
+              TRUE if the file was read
+-----------------------------------------------------------------F-F*/
+BOOL readFile(_In_ const std::filesystem::path& filePath, _Out_ std::vector<std::uint8_t>& aOutData)
+{
+    aOutData.clear();
+
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return FALSE;
+    }
+
+    aOutData.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+
+    return file.read(reinterpret_cast<char*>(aOutData.data()), static_cast<std::streamsize>(aOutData.size())) ? TRUE : FALSE;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: waitForGpu
+  Summary:  Waits until the GPU has run every command submitted so
+            far, so uploads are timed to their end
+  Args:     ID3D11Device* pDevice
+              The Direct3D device
+            ID3D11DeviceContext* pImmediateContext
+              The Direct3D context the uploads were recorded on
+-----------------------------------------------------------------F-F*/
+void waitForGpu(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+{
+    D3D11_QUERY_DESC queryDesc = { .Query = D3D11_QUERY_EVENT, .MiscFlags = 0u };
+
+    ComPtr<ID3D11Query> query;
+    if (FAILED(pDevice->CreateQuery(&queryDesc, query.GetAddressOf())))
+    {
+        pImmediateContext->Flush();
+        return;
+    }
+
+    pImmediateContext->End(query.Get());
+
+    BOOL bDone = FALSE;
+    while (pImmediateContext->GetData(query.Get(), &bDone, sizeof(bDone), 0u) == S_FALSE)
+    {
+        SwitchToThread();
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: benchmarkImage
+  Summary:  Times the WIC decode of an image, the generation of its
+            mip chain on the CPU, its Lanczos resize to half size as
+            the loader scales oversized images, and its encoding to
+            BC1 and BC7, as the asset baker runs them but on a single
+            thread
+  Args:     FileResult& result
+              File to benchmark, receives the timings
+            UINT uIterations
+              Number of timed runs of each stage
+  Modifies: [result].
+-----------------------------------------------------------------F-F*/
+void benchmarkImage(_Inout_ FileResult& result, _In_ UINT uIterations)
+{
+    std::vector<BYTE> aPixels;
+    UINT uWidth = 0u;
+    UINT uHeight = 0u;
+
+    BOOL bDecoded = measure("decode", result.uFileBytes, uIterations, [&]()
+        {
+            result.hr = library::Texture::DecodeImage(result.filePath, 0u, aPixels, uWidth, uHeight);
+            return SUCCEEDED(result.hr);
+        }, result.aStages);
+
+    if (!bDecoded)
+    {
+        return;
+    }
+
+    result.uWidth = uWidth;
+    result.uHeight = uHeight;
+    result.uMipLevels = library::MipGenerator::GetNumLevels(uWidth, uHeight);
+
+    std::vector<float> aSourceTexels;
+    std::vector<float> aTexels;
+    std::vector<std::vector<std::uint8_t>> aLevels(result.uMipLevels);
+
+    for (UINT uLevel = 1u; uLevel < result.uMipLevels; ++uLevel)
+    {
+        UINT uLevelWidth = 0u;
+        UINT uLevelHeight = 0u;
+        library::MipGenerator::GetLevelSize(uWidth, uHeight, uLevel, uLevelWidth, uLevelHeight);
+
+        aLevels[uLevel].resize(static_cast<size_t>(uLevelWidth) * uLevelHeight * 4u);
+    }
+
+    measure("mips", aPixels.size(), uIterations, [&]()
+        {
+            library::MipGenerator::ConvertToLinear(aPixels.data(), uWidth, uHeight, true, aSourceTexels);
+
+            for (UINT uLevel = 1u; uLevel < result.uMipLevels; ++uLevel)
+            {
+                UINT uSourceWidth = 0u;
+                UINT uSourceHeight = 0u;
+                UINT uLevelWidth = 0u;
+                UINT uLevelHeight = 0u;
+                library::MipGenerator::GetLevelSize(uWidth, uHeight, uLevel - 1u, uSourceWidth, uSourceHeight);
+                library::MipGenerator::GetLevelSize(uWidth, uHeight, uLevel, uLevelWidth, uLevelHeight);
+
+                aTexels.resize(static_cast<size_t>(uLevelWidth) * uLevelHeight * 4u);
+                library::MipGenerator::GenerateRows(aSourceTexels.data(), uSourceWidth, uSourceHeight, library::eMipFilter::KAISER,
+                    true, 0u, uLevelHeight, aTexels.data(), aLevels[uLevel].data());
+
+                aSourceTexels.swap(aTexels);
+            }
+
+            return TRUE;
+        }, result.aStages);
+
+    UINT uHalfWidth = (std::max)(uWidth / 2u, 1u);
+    UINT uHalfHeight = (std::max)(uHeight / 2u, 1u);
+    std::vector<std::uint8_t> aResized(static_cast<size_t>(uHalfWidth) * uHalfHeight * 4u);
+
+    measure("resize", aPixels.size(), uIterations, [&]()
+        {
+            library::PixelConverter::ResizeRows(aPixels.data(), uWidth, uHeight, uHalfWidth, uHalfHeight,
+                library::eResizeFilter::LANCZOS3, false, 0u, uHalfHeight, aResized.data());
+            return TRUE;
+        }, result.aStages);
+
+    // Block compression needs whole blocks, as when baking
+    if (uWidth % 4u != 0u || uHeight % 4u != 0u)
+    {
+        return;
+    }
+
+    static const struct
+    {
+        const char* pszName;
+        library::eDdsFormat format;
+    } s_aFormats[] =
+    {
+        { "bc1", library::eDdsFormat::BC1_UNORM },
+        { "bc7", library::eDdsFormat::BC7_UNORM },
+    };
+
+    for (const auto& entry : s_aFormats)
+    {
+        std::vector<std::uint8_t> aBlocks(static_cast<size_t>(uWidth / 4u) * (uHeight / 4u)
+            * library::BlockCompressor::GetBlockSize(entry.format));
+
+        measure(entry.pszName, aPixels.size(), uIterations, [&]()
+            {
+                library::BlockCompressor::CompressRows(aPixels.data(), uWidth, uHeight, entry.format, 0u, uHeight / 4u,
+                    aBlocks.data());
+                return TRUE;
+            }, result.aStages);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: benchmarkDds
+  Summary:  Times the parse of a DDS file already in memory, and its
+            opening, which maps the file and parses it
+  Args:     FileResult& result
+              File to benchmark, receives the timings
+            UINT uIterations
+              Number of timed runs of each stage
+  Modifies: [result].
+-----------------------------------------------------------------F-F*/
+void benchmarkDds(_Inout_ FileResult& result, _In_ UINT uIterations)
+{
+    std::vector<std::uint8_t> aData;
+    if (!readFile(result.filePath, aData))
+    {
+        result.hr = HRESULT_FROM_WIN32(ERROR_READ_FAULT);
+        return;
+    }
+
+    library::DdsImage image = {};
+    std::vector<library::DdsSubresource> aSubresources;
+
+    BOOL bParsed = measure("parse", result.uFileBytes, uIterations, [&]()
+        {
+            library::eDdsStatus status = library::DdsParser::Parse(aData.data(), aData.size(), image, aSubresources);
+            result.hr = library::DdsFile::ToHResult(status);
+            return SUCCEEDED(result.hr);
+        }, result.aStages);
+
+    if (!bParsed)
+    {
+        return;
+    }
+
+    result.uWidth = image.uWidth;
+    result.uHeight = image.uHeight;
+    result.uMipLevels = image.uMipLevels;
+
+    measure("open", result.uFileBytes, uIterations, [&]()
+        {
+            library::DdsFile ddsFile;
+            result.hr = ddsFile.Open(result.filePath);
+            return SUCCEEDED(result.hr);
+        }, result.aStages);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: benchmarkLoad
+  Summary:  Times the whole load of a texture as the game runs it at
+            startup: decode or mapping, creation of the texture and
+            generation of its mips on the GPU, until the GPU is done.
+            Streaming is off, so every mip is uploaded
+  Args:     FileResult& result
+              File to benchmark, receives the timings
+            UINT uIterations
+              Number of timed runs
+            ID3D11Device* pDevice
+              The Direct3D device to create the textures
+            ID3D11DeviceContext* pImmediateContext
+              The Direct3D context to upload with
+  Modifies: [result].
+-----------------------------------------------------------------F-F*/
+void benchmarkLoad(
+    _Inout_ FileResult& result,
+    _In_ UINT uIterations,
+    _In_ ID3D11Device* pDevice,
+    _In_ ID3D11DeviceContext* pImmediateContext
+)
+{
+    measure("load", result.uFileBytes, uIterations, [&]()
+        {
+            library::Texture texture(result.filePath, library::TextureLoadOptions{ .uMaxSize = 0u, .bGenerateMips = TRUE,
+                .bStream = FALSE });
+
+            result.hr = texture.Initialize(pDevice, pImmediateContext);
+            waitForGpu(pDevice, pImmediateContext);
+
+            return SUCCEEDED(result.hr);
+        }, result.aStages);
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: escapeJson
+  Summary:  Returns a string quoted for JSON
+  Args:     const std::string& szValue
+              UTF-8 string
+  Returns:  std::string
+              Quoted and escaped string
+-----------------------------------------------------------------F-F*/
+std::string escapeJson(_In_ const std::string& szValue)
+{
+    std::string szEscaped = "\"";
+
+    for (char c : szValue)
+    {
+        if (c == '"' || c == '\\')
+        {
+            szEscaped += '\\';
+            szEscaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20u)
+        {
+            char szCode[8];
+            sprintf_s(szCode, "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+            szEscaped += szCode;
+        }
+        else
+        {
+            szEscaped += c;
+        }
+    }
+
+    return szEscaped + "\"";
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: getMegabytesPerSecond
+  Summary:  Returns the throughput of a stage
+  Args:     UINT64 uBytes
+              Bytes read by the stage
+            double dMs
+              Time of the stage in milliseconds
+  Returns:  double
+              Millions of bytes per second, 0 for no time
+-----------------------------------------------------------------F-F*/
+double getMegabytesPerSecond(_In_ UINT64 uBytes, _In_ double dMs)
+{
+    return dMs > 0.0 ? static_cast<double>(uBytes) / (dMs * 1000.0) : 0.0;
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: writeJson
+  Summary:  Writes the timings of every file, then the totals of
+            each stage over the files
+  Args:     FILE* pFile
+              Stream to write to
+            const std::vector<FileResult>& aResults
+              Timings of the files
+            UINT uIterations
+              Number of timed runs of each stage
+            const char* pszDevice
+              Driver the load stage ran on, "none" without device
+-----------------------------------------------------------------F-F*/
+void writeJson(
+    _In_ FILE* pFile,
+    _In_ const std::vector<FileResult>& aResults,
+    _In_ UINT uIterations,
+    _In_z_ const char* pszDevice
+)
+{
+    fprintf(pFile, "{\n  \"iterations\": %u,\n  \"device\": %s,\n  \"files\": [", uIterations, escapeJson(pszDevice).c_str());
+
+    std::vector<StageResult> aTotals;
+
+    for (size_t i = 0u; i < aResults.size(); ++i)
+    {
+        const FileResult& result = aResults[i];
+        std::u8string szPath = result.filePath.generic_u8string();
+
+        fprintf(pFile, "%s\n    {\n      \"file\": %s,\n      \"type\": \"%s\",\n      \"baked\": %s,\n"
+            "      \"bytes\": %llu,\n      \"width\": %u,\n      \"height\": %u,\n      \"mipLevels\": %u,\n"
+            "      \"hresult\": \"0x%08lX\",\n      \"stages\": {",
+            i > 0u ? "," : "", escapeJson(std::string(szPath.begin(), szPath.end())).c_str(), result.bDds ? "dds" : "image",
+            result.bBaked ? "true" : "false", static_cast<unsigned long long>(result.uFileBytes), result.uWidth, result.uHeight,
+            result.uMipLevels, static_cast<ULONG>(result.hr));
+
+        for (size_t j = 0u; j < result.aStages.size(); ++j)
+        {
+            const StageResult& stage = result.aStages[j];
+
+            fprintf(pFile, "%s\n        \"%s\": { \"bytes\": %llu, \"meanMs\": %.4f, \"minMs\": %.4f, \"mbPerSecond\": %.2f }",
+                j > 0u ? "," : "", stage.pszName, static_cast<unsigned long long>(stage.uBytes), stage.dMeanMs, stage.dMinMs,
+                getMegabytesPerSecond(stage.uBytes, stage.dMeanMs));
+
+            auto it = std::find_if(aTotals.begin(), aTotals.end(), [&stage](const StageResult& total)
+                {
+                    return strcmp(total.pszName, stage.pszName) == 0;
+                });
+
+            if (it == aTotals.end())
+            {
+                aTotals.push_back(StageResult{ .pszName = stage.pszName, .uBytes = 0u, .dMeanMs = 0.0, .dMinMs = 0.0 });
+                it = aTotals.end() - 1;
+            }
+
+            it->uBytes += stage.uBytes;
+            it->dMeanMs += stage.dMeanMs;
+            it->dMinMs += stage.dMinMs;
+        }
+
+        fprintf(pFile, "%s}\n    }", result.aStages.empty() ? "" : "\n      ");
+    }
+
+    fprintf(pFile, "\n  ],\n  \"totals\": {");
+
+    for (size_t j = 0u; j < aTotals.size(); ++j)
+    {
+        const StageResult& total = aTotals[j];
+
+        fprintf(pFile, "%s\n    \"%s\": { \"bytes\": %llu, \"meanMs\": %.4f, \"minMs\": %.4f, \"mbPerSecond\": %.2f }",
+            j > 0u ? "," : "", total.pszName, static_cast<unsigned long long>(total.uBytes), total.dMeanMs, total.dMinMs,
+            getMegabytesPerSecond(total.uBytes, total.dMeanMs));
+    }
+
+    fprintf(pFile, "%s}\n}\n", aTotals.empty() ? "" : "\n  ");
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: wmain
+  Summary:  Entry point to the benchmark. Every argument is a file,
+            or a directory whose images and DDS files are all
+            benchmarked. Without files, the textures of the game are
+            benchmarked from its directory: the nanosuit, texture.dds
+            and seafloor.dds. -iterations <n> sets the timed runs of
+            each stage, -out <file> writes the JSON to a file instead
+            of the standard output, and -nodevice skips the load
+            stage, which needs a Direct3D device
+  Args:     INT argc
+              Number of arguments
+            WCHAR* argv[]
+              Program name followed by the options and files
+  Returns:  INT
+              0 if every file was benchmarked, 1 otherwise
+-----------------------------------------------------------------F-F*/
+INT wmain(_In_ INT argc, _In_reads_(argc) WCHAR* argv[])
+{
+    UINT uIterations = 5u;
+    BOOL bDevice = TRUE;
+    std::filesystem::path outputPath;
+    std::vector<std::filesystem::path> aInputPaths;
+
+    for (INT i = 1; i < argc; ++i)
+    {
+        if (wcscmp(argv[i], L"-iterations") == 0 && i + 1 < argc)
+        {
+            uIterations = (std::max)(static_cast<UINT>(_wtoi(argv[++i])), 1u);
+            continue;
+        }
+
+        if (wcscmp(argv[i], L"-out") == 0 && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+            continue;
+        }
+
+        if (wcscmp(argv[i], L"-nodevice") == 0)
+        {
+            bDevice = FALSE;
+            continue;
+        }
+
+        if (argv[i][0] == L'-')
+        {
+            fwprintf(stderr, L"Usage: TextureBenchmark [-iterations <n>] [-out <file>] [-nodevice] [<file or directory> ...]\n");
+            return 1;
+        }
+
+        aInputPaths.emplace_back(argv[i]);
+    }
+
+    if (aInputPaths.empty())
+    {
+        aInputPaths = { L"nanosuit", L"texture.dds", L"seafloor.dds" };
+    }
+
+    std::vector<FileResult> aResults;
+
+    for (const std::filesystem::path& inputPath : aInputPaths)
+    {
+        std::vector<std::filesystem::path> aFilePaths;
+        std::error_code error;
+
+        if (std::filesystem::is_directory(inputPath, error))
+        {
+            for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(inputPath, error))
+            {
+                if (entry.is_regular_file(error) && (isImageFile(entry.path()) || isDdsFile(entry.path())))
+                {
+                    aFilePaths.push_back(entry.path());
+                }
+            }
+
+            std::sort(aFilePaths.begin(), aFilePaths.end());
+        }
+        else
+        {
+            aFilePaths.push_back(inputPath);
+        }
+
+        for (const std::filesystem::path& filePath : aFilePaths)
+        {
+            aResults.push_back(FileResult{
+                .filePath = filePath,
+                .bDds = isDdsFile(filePath),
+                .bBaked = !isDdsFile(filePath) && library::DdsFile::IsUpToDate(filePath),
+                .uFileBytes = static_cast<UINT64>(std::filesystem::file_size(filePath, error)),
+                .uWidth = 0u,
+                .uHeight = 0u,
+                .uMipLevels = 0u,
+                .hr = error ? HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) : S_OK,
+                .aStages = std::vector<StageResult>()
+            });
+        }
+    }
+
+    // WIC needs COM, which the decode would otherwise initialize and
+    // release on every call
+    HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+    ComPtr<ID3D11Device> device;
+    ComPtr<ID3D11DeviceContext> immediateContext;
+    const char* pszDevice = "none";
+
+    if (bDevice)
+    {
+        if (SUCCEEDED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0u, nullptr, 0u, D3D11_SDK_VERSION,
+            device.GetAddressOf(), nullptr, immediateContext.GetAddressOf())))
+        {
+            pszDevice = "hardware";
+        }
+        else if (SUCCEEDED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0u, nullptr, 0u, D3D11_SDK_VERSION,
+            device.GetAddressOf(), nullptr, immediateContext.GetAddressOf())))
+        {
+            pszDevice = "warp";
+        }
+        else
+        {
+            fwprintf(stderr, L"Failed to create a Direct3D device, skipping the load stage\n");
+        }
+    }
+
+    INT iResult = 0;
+
+    for (FileResult& result : aResults)
+    {
+        if (SUCCEEDED(result.hr))
+        {
+            if (result.bDds)
+            {
+                benchmarkDds(result, uIterations);
+            }
+            else
+            {
+                benchmarkImage(result, uIterations);
+            }
+        }
+
+        if (SUCCEEDED(result.hr) && device)
+        {
+            benchmarkLoad(result, uIterations, device.Get(), immediateContext.Get());
+        }
+
+        if (FAILED(result.hr))
+        {
+            fwprintf(stderr, L"Failed to benchmark %s (0x%08lX)\n", result.filePath.c_str(), static_cast<ULONG>(result.hr));
+            iResult = 1;
+            continue;
+        }
+
+        fwprintf(stderr, L"Benchmarked %s (%u x %u, %u stages)\n", result.filePath.c_str(), result.uWidth, result.uHeight,
+            static_cast<UINT>(result.aStages.size()));
+    }
+
+    immediateContext.Reset();
+    device.Reset();
+
+    if (SUCCEEDED(hrCom))
+    {
+        CoUninitialize();
+    }
+
+    FILE* pFile = stdout;
+
+    if (!outputPath.empty() && _wfopen_s(&pFile, outputPath.c_str(), L"w") != 0)
+    {
+        fwprintf(stderr, L"Failed to open %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    writeJson(pFile, aResults, uIterations, pszDevice);
+
+    if (pFile != stdout)
+    {
+        fclose(pFile);
+    }
+
+    return iResult;
+}